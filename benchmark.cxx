@@ -27,12 +27,15 @@
 #include <boost/filesystem.hpp>
 
 #include "include/xerus.h"
+#include "include/xerus/misc/internal.h"
 
 std::mt19937_64 rnd = xerus::misc::randomEngine;
 std::normal_distribution<double> normalDist(0,1);
 
 using namespace xerus;
 
+XERUS_SET_LOGGING(benchmark, xerus::misc::internal::LOGGING_FULL)
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 // ------------------------------------------------- general settings --------------------------------------------------------------
 
@@ -128,17 +131,23 @@ namespace ls {
 }
 
 
+ALSVariant als_variant(const bool _assumeSPD) {
+	ALSVariant variant(1, 0, ALSVariant::lapack_solver, _assumeSPD);
+	variant.convergenceEpsilon = 1e-8;
+	return variant;
+}
+
 std::vector<LeastSquaresSolver> leastSquaresAlgorithms{
-	{"ALS", ALSVariant(1, 0, 1e-8, ALSVariant::lapack_solver, true)}, 
-	{"CG", GeometricCGVariant(0, 0, 1e-8, false, SubmanifoldRetractionI, ProjectiveVectorTransport)}, 
+	{"ALS", als_variant(true)}, 
+	{"CG", GeometricCGVariant(0, 1e-8, false, SubmanifoldRetractionI, ProjectiveVectorTransport)}, 
 	{"SteepestDescent_submanifold", SteepestDescentVariant(0, 1e-8, false, SubmanifoldRetractionII)},
 	{"SteepestDescent_als", SteepestDescentVariant(0, 1e-8, false, ALSRetractionII)},
 	{"SteepestDescent_hosvd", SteepestDescentVariant(0, 1e-8, false, HOSVDRetraction(3))}, //TODO
 };
 
 std::vector<LeastSquaresSolver> leastSquaresAlgorithmsSPD{
-	{"ALS", ALSVariant(1, 0, 1e-8, ALSVariant::lapack_solver, true)}, 
-	{"CG", GeometricCGVariant(0, 0, 1e-8, true, SubmanifoldRetractionI, ProjectiveVectorTransport)}, 
+	{"ALS", als_variant(true)}, 
+	{"CG", GeometricCGVariant(0, 1e-8, true, SubmanifoldRetractionI, ProjectiveVectorTransport)}, 
 	{"SteepestDescent_submanifold", SteepestDescentVariant(0, 1e-8, true, SubmanifoldRetractionII)},
 	{"SteepestDescent_als", SteepestDescentVariant(0, 1e-8, true, ALSRetractionII)},
 	{"SteepestDescent_hosvd", SteepestDescentVariant(0, 1e-8, true, HOSVDRetraction(3))}, //TODO
@@ -155,8 +164,8 @@ struct Approximation_Variant {
 
 std::vector<LeastSquaresProblem> leastSquaresProblems{
 	ls::approximation(2, 10, 4, 2, std::vector<LeastSquaresSolver>{
-		{"ALS", Approximation_Variant(ALSVariant(1, 0, 1e-8, ALSVariant::lapack_solver, true))}, 
-		{"CG", Approximation_Variant(GeometricCGVariant(0, 0, 1e-8, true, SubmanifoldRetractionI, ProjectiveVectorTransport))}, 
+		{"ALS", Approximation_Variant(als_variant(true))}, 
+		{"CG", Approximation_Variant(GeometricCGVariant(0, 1e-8, true, SubmanifoldRetractionI, ProjectiveVectorTransport))}, 
 		{"SteepestDescent_submanifold", Approximation_Variant(SteepestDescentVariant(0, 1e-8, true, SubmanifoldRetractionII))},
 		{"SteepestDescent_als", Approximation_Variant(SteepestDescentVariant(0, 1e-8, true, ALSRetractionII))},
 		{"SteepestDescent_hosvd", Approximation_Variant(SteepestDescentVariant(0, 1e-8, true, HOSVDRetraction(2)))}, //TODO
@@ -168,6 +177,71 @@ std::vector<LeastSquaresProblem> leastSquaresProblems{
 
 
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// ------------------------------------------------- randomized TT-SVD -------------------------------------------------------------
+
+struct DecompositionProblem {
+	std::string name;
+	Tensor x;
+	std::vector<size_t> ranks;
+};
+
+std::vector<DecompositionProblem> decompositionProblems() {
+	std::vector<DecompositionProblem> problems;
+	
+	const std::vector<size_t> denseDims(7, 8);
+	Tensor lowRank(TTTensor::random(denseDims, std::vector<size_t>(6, 5)));
+	lowRank /= frob_norm(lowRank);
+	problems.push_back({"dense_lowrank_plus_noise", lowRank + 1e-4*Tensor::random(denseDims)/std::sqrt(double(misc::product(denseDims))), std::vector<size_t>(6, 5)});
+	
+	// sum of 20 rank one tensors whose factors have two non-zero entries each, i.e. a sparse tensor of TT rank 20
+	const std::vector<size_t> sparseDims(7, 10);
+	Tensor sparseLowRank(sparseDims, Tensor::Representation::Sparse);
+	std::uniform_int_distribution<size_t> entryDist(0, 9);
+	for (size_t k = 0; k < 20; ++k) {
+		std::vector<std::vector<std::pair<size_t, value_t>>> factors(7);
+		for (auto &factor : factors) {
+			for (size_t j = 0; j < 2; ++j) {
+				factor.emplace_back(entryDist(misc::randomEngine), misc::defaultNormalDistribution(misc::randomEngine));
+			}
+		}
+		for (size_t combination = 0; combination < (size_t(1) << 7); ++combination) {
+			size_t position = 0;
+			value_t value = 1.0;
+			for (size_t mu = 0; mu < 7; ++mu) {
+				const std::pair<size_t, value_t> &entry = factors[mu][(combination>>mu)&1];
+				position = position*10 + entry.first;
+				value *= entry.second;
+			}
+			sparseLowRank.get_sparse_data().emplace_back_unsorted(position, value);
+		}
+	}
+	sparseLowRank.get_sparse_data().sort_and_sum_duplicates();
+	sparseLowRank /= frob_norm(sparseLowRank);
+	problems.push_back({"sparse_lowrank", sparseLowRank, std::vector<size_t>(6, 20)});
+	
+	return problems;
+}
+
+void benchmark_random_tt_svd() {
+	for (const DecompositionProblem &prob : decompositionProblems()) {
+		size_t start = misc::uTime();
+		const TTTensor exact(prob.x, 0.0, prob.ranks);
+		const size_t exactTime = misc::uTime() - start;
+		const value_t exactError = frob_norm(Tensor(exact) - prob.x)/frob_norm(prob.x);
+		LOG(benchmark, prob.name << ": exact TT-SVD " << exactTime/1000 << " ms, relative error " << exactError);
+		
+		for (const size_t powerIterations : std::vector<size_t>({0, 1, 2})) {
+			start = misc::uTime();
+			const TTTensor randomized = randomTTSVD(prob.x, prob.ranks, 10, powerIterations);
+			const size_t randomTime = misc::uTime() - start;
+			const value_t randomError = frob_norm(Tensor(randomized) - prob.x)/frob_norm(prob.x);
+			LOG(benchmark, prob.name << ": randomized TT-SVD with " << powerIterations << " power iterations " << randomTime/1000 << " ms, relative error " << randomError);
+		}
+	}
+}
+
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 // ------------------------------------------------- benchmark routines ------------------------------------------------------------
 
@@ -179,7 +253,7 @@ std::string generate_profile_name() {
 #endif
 	
 #ifdef XERUS_VERSION
-	profileName += STRINGIFY(XERUS_VERSION);
+	profileName += XERUS_STRINGIFY(XERUS_VERSION);
 #else
 	profileName += "unknownVersion";
 #endif
@@ -215,6 +289,7 @@ std::string generate_profile_name() {
 int main() {
 	std::string profileName(generate_profile_name());
 	LOG(benchmark, "running profile " << profileName);
+	benchmark_random_tt_svd();
 	while (true) {
 		for (const LeastSquaresProblem &prob : leastSquaresProblems) {
 			std::vector<TTOperator> A;
@@ -51,6 +51,8 @@
     #include "xerus/contractionHeuristic.h"
     #include "xerus/ttNetwork.h"
     #include "xerus/ttStack.h"
+    #include "xerus/ttSumAccumulator.h"
+    #include "xerus/mappedFile.h"
 	#include "xerus/performanceData.h"
 	#include "xerus/measurments.h"
     #include "xerus/algorithms/als.h"
@@ -61,6 +63,7 @@
     #include "xerus/algorithms/uqAdf.h"
     #include "xerus/algorithms/iht.h"
     #include "xerus/algorithms/largestEntry.h"
+    #include "xerus/algorithms/randomSVD.h"
     
 	#include "xerus/examples/specificLowRankTensors.h"
 
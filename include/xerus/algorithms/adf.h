@@ -35,6 +35,10 @@ namespace xerus {
 	 * @brief Wrapper class for all ADF variants.
 	 * @details By creating a new object of this class and modifying the member variables, the behaviour of the solver can be modified.
 	 * This algorithm is a modified implementation of the alternating directional fitting algrothim, first introduced by Grasedyck, Kluge and Kraemer (2015).
+	 * If xerus is compiled with openMP, the measurments are split into contiguous shards that are processed in parallel (at most misc::maxThreads threads). 
+	 * The contributions of the shards are summed up in a fixed order.
+	 * If components of x are stored in single precision, the stacks are stored and updated in single precision as well, while
+	 * the residual and the projected gradient are accumulated in double precision.
 	 */
     class ADFVariant {
 		protected:
@@ -94,58 +98,94 @@ namespace xerus {
 			///@brief The current projected Gradient component. That is E(A^T(Ax-b))
 			Tensor projectedGradientComponent;
 			
-			///@brief Ownership holder for a (degree+2)*numMeasurments array of Tensor pointers. (Not used directly)
-			std::unique_ptr<Tensor*[]> forwardStackMem;
+			///@brief Value of all stack entries at the positions -1 and degree, i.e. a single one. Must not be modified.
+			value_t stackBoundary;
+			
+			///@brief Ownership holder for a (degree+2)*numMeasurments array of pointers into the forwardStackArena. (Not used directly)
+			std::unique_ptr<value_t*[]> forwardStackMem;
 			
 			/** @brief Array [numMeasurments][degree]. For positions smaller than the current corePosition and for each measurment, this array contains the pre-computed
-			* contraction of the first _ component tensors and the first _ components of the measurment operator. These tensors are deduplicated in the sense that for each unqiue
-			* part of the position only one tensor is actually stored, which is why the is an array of pointers. The Tensors at the current corePosition are used as 
-			* scatch space. For convinience the underlying array (forwardStackMem) is larger, wherefore also the positions -1 and degree are allow, all poining to a {1} tensor
-			* containing 1 as only entry. Note that position degree-1 must not be used.
+			* contraction of the first _ component tensors and the first _ components of the measurment operator. These vectors are deduplicated in the sense that for each unqiue
+			* part of the position only one vector is actually stored, which is why the is an array of pointers. The entries at the current corePosition are used as 
+			* scatch space. For convinience the underlying array (forwardStackMem) is larger, wherefore also the positions -1 and degree are allow, all poining to 
+			* stackBoundary. Note that position degree-1 must not be used.
 			**/
-			Tensor* const * const forwardStack;
+			value_t* const * const forwardStack;
+			
+			/// @brief Contiguous memory of all unique forwardStack entries. The entries of each corePosition are stored consecutively, each with the length of the rank at this position.
+			std::vector<value_t> forwardStackArena;
 			
-			/// @brief Ownership holder for the unqiue Tensors referenced in forwardStack.
-			std::unique_ptr<Tensor[]> forwardStackSaveSlots;
+			/// @brief Array [degree][numMeasurments] containing for each forwardStack entry the number of the unique entry it refers to, i.e. its position in forwardUpdates.
+			std::vector<size_t> forwardStackSlots;
 			
 			/// @brief Vector containing for each corePosition a vector of the smallest ids of each group of unique forwardStack entries.
 			std::vector<std::vector<size_t>> forwardUpdates;
 			
 			
-			///@brief Ownership holder for a (degree+2)*numMeasurments array of Tensor pointers. (Not used directly)
-			std::unique_ptr<Tensor*[]> backwardStackMem;
+			///@brief Ownership holder for a (degree+2)*numMeasurments array of pointers into the backwardStackArena. (Not used directly)
+			std::unique_ptr<value_t*[]> backwardStackMem;
 			
 			/** @brief Array [numMeasurments][degree]. For positions larger than the current corePosition and for each measurment, this array contains the pre-computed
-			* contraction of the last _ component tensors and the last _ components of the measurment operator. These tensors are deduplicated in the sense that for each unqiue
-			* part of the position only one tensor is actually stored, which is why the is an array of pointers. The Tensors at the current corePosition are used as 
-			* scratch space. For convinience the underlying array (forwardStackMem) is larger, wherefore also the positions -1 and degree are allow, all poining to a {1} tensor
-			* containing 1 as only entry. Note that position zero must not be used.
+			* contraction of the last _ component tensors and the last _ components of the measurment operator. These vectors are deduplicated in the sense that for each unqiue
+			* part of the position only one vector is actually stored, which is why the is an array of pointers. The entries at the current corePosition are used as 
+			* scratch space. For convinience the underlying array (backwardStackMem) is larger, wherefore also the positions -1 and degree are allow, all poining to 
+			* stackBoundary. Note that position zero must not be used.
 			**/
-			Tensor* const * const backwardStack;
-
-			/// @brief Ownership holder for the unqiue Tensors referenced in backwardStack.
-			std::unique_ptr<Tensor[]> backwardStackSaveSlots;
+			value_t* const * const backwardStack;
+			
+			/// @brief Contiguous memory of all unique backwardStack entries. The entries of each corePosition are stored consecutively, each with the length of the rank at this position.
+			std::vector<value_t> backwardStackArena;
+			
+			/// @brief Array [degree][numMeasurments] containing for each backwardStack entry the number of the unique entry it refers to, i.e. its position in backwardUpdates.
+			std::vector<size_t> backwardStackSlots;
 			
 			/// @brief Vector containing for each corePosition a vector of the smallest ids of each group of unique backwardStack entries.
 			std::vector<std::vector<size_t>> backwardUpdates;
 			
+			///@brief Whether the stacks are stored in single precision, which is the case if a component of x is (cf. Tensor::use_single_precision()). Set in resize_stack_tensors().
+			bool singlePrecisionStacks;
+			
+			///@brief Single precision counterpart of stackBoundary.
+			float singleStackBoundary;
+			
+			///@brief Single precision counterparts of forwardStackMem, forwardStack and forwardStackArena, used instead of these if singlePrecisionStacks is set. Allocated on first use.
+			std::unique_ptr<float*[]> singleForwardStackMem;
+			float* const * singleForwardStack;
+			std::vector<float> singleForwardStackArena;
+			
+			///@brief Single precision counterparts of backwardStackMem, backwardStack and backwardStackArena, used instead of these if singlePrecisionStacks is set. Allocated on first use.
+			std::unique_ptr<float*[]> singleBackwardStackMem;
+			float* const * singleBackwardStack;
+			std::vector<float> singleBackwardStackArena;
+			
             /// @brief: Norm of each rank one measurment operator
             std::unique_ptr<double[]> measurmentNorms;
 			
+			/// @brief Number of threads (and shards of the measurements) used for the loops over all measurments. Set in resize_stack_tensors(), as it depends on the ranks.
+			size_t numThreads;
+			
 			///@brief: Reference to the performanceData object (external ownership)
 			PerformanceData& perfData;
 			
 			///@brief calculates the two-norm of the measured values.
 			static double calculate_norm_of_measured_values(const MeasurmentSet& _measurments);
 			
-			///@brief Constructes either the forward or backward stack. That is, it determines the groups of partially equale measurments. Therby stetting (forward/backward)- Updates, StackMem and SaveSlot.
-			void construct_stacks(std::unique_ptr< xerus::Tensor[] >& _stackSaveSlot, std::vector< std::vector< size_t > >& _updates, const std::unique_ptr<Tensor*[]>& _stackMem, const bool _forward);
+			///@brief Constructes either the forward or backward stack. That is, it determines the groups of partially equale measurments. Therby stetting (forward/backward)- Updates and StackSlots.
+			void construct_stacks(std::vector<size_t>& _stackSlots, std::vector<std::vector<size_t>>& _updates, const bool _forward);
+			
+			///@brief Reshapes the arena of one stack to the current ranks of x and sets the stack pointers accordingly. The entries at the positions -1 and degree point to @a _boundary.
+			template<class T>
+			void reshape_stack_arena(std::vector<T>& _arena, const std::unique_ptr<T*[]>& _stackMem, T* const _boundary, const std::vector<size_t>& _stackSlots, const std::vector<std::vector<size_t>>& _updates, const bool _forward);
 			
-			///@brief Resizes the unqiue stack tensors to correspond to the current ranks of x.
+			///@brief Reshapes the stack arenas (of the precision of x) to correspond to the current ranks of x and chooses the number of threads accordingly.
 			void resize_stack_tensors();
 			
-			///@brief Returns a vector of tensors containing the slices of @a _component where the second dimension is fixed.
-			std::vector<Tensor> get_fixed_components(const Tensor& _component);
+			///@brief Returns the dense tensor (n, r1, r2) containing the slices of @a _component (r1, n, r2) where the second dimension is fixed, stored contiguously in the precision of the stacks.
+			Tensor get_slices(const Tensor& _component);
+			
+			///@brief Implementation of update_forward_stack() and update_backward_stack() for the stack @a _stack of precision T.
+			template<class T>
+			void update_stack(T* const * const _stack, const size_t _corePosition, const Tensor& _currentComponent, const bool _forward);
 			
 			///@brief For each measurment sets the forwardStack at the given _corePosition to the contraction between the forwardStack at the previous corePosition (i.e. -1)
 			/// and the given component contracted with the component of the measurment operator. For _corePosition == corePosition and _currentComponent == x.components(corePosition)
@@ -157,6 +197,12 @@ namespace xerus {
 			/// this really updates the stack, otherwise it uses the stack as scratch space.
 			void update_backward_stack(const size_t _corePosition, const Tensor& _currentComponent);
 			
+			///@brief Returns the dot product of the forwardStack entry at @a _forwardPosition and the backwardStack entry at @a _backwardPosition of the measurment @a _i, accumulated in double precision.
+			value_t stack_dot_product(const size_t _i, const size_t _forwardPosition, const size_t _backwardPosition, const size_t _rank) const;
+			
+			///@brief Returns the forwardStack (or backwardStack) entry of the measurment @a _i at @a _position in double precision. Entries of single precision stacks are widened into @a _buffer.
+			const value_t* stack_entry(const bool _forward, const size_t _i, const size_t _position, const size_t _size, value_t* const _buffer) const;
+			
 			///@brief (Re-)Calculates the current residual, i.e. Ax-b.
 			void calculate_residual( const size_t _corePosition );
 			
@@ -210,16 +256,27 @@ namespace xerus {
 				
 				residual(numMeasurments),
 				
-				forwardStackMem(new Tensor*[numMeasurments*(degree+2)]),
+				stackBoundary(1.0),
+				
+				forwardStackMem(new value_t*[numMeasurments*(degree+2)]),
 				forwardStack(forwardStackMem.get()+numMeasurments),
+				forwardStackSlots(numMeasurments*degree),
 				forwardUpdates(degree),
 					
-				backwardStackMem(new Tensor*[numMeasurments*(degree+2)]),
+				backwardStackMem(new value_t*[numMeasurments*(degree+2)]),
 				backwardStack(backwardStackMem.get()+numMeasurments),
+				backwardStackSlots(numMeasurments*degree),
 				backwardUpdates(degree),
 				
+				singlePrecisionStacks(false),
+				singleStackBoundary(1.0f),
+				singleForwardStack(nullptr),
+				singleBackwardStack(nullptr),
+				
 				measurmentNorms(new double[numMeasurments]),
 				
+				numThreads(1),
+				
 				perfData(_perfData) 
 				{
 					_x.require_correct_format();
@@ -40,19 +40,87 @@ namespace xerus {
 		
 	protected:
 		double solve(const TTOperator *_Ap, TTTensor &_x, const TTTensor &_b, size_t _numHalfSweeps, value_t _convergenceEpsilon, PerformanceData &_perfData = NoPerfData) const;
+		std::vector<value_t> solve_eigen(const TTOperator &_A, std::vector<TTTensor> &_x, size_t _numHalfSweeps, value_t _convergenceEpsilon, PerformanceData &_perfData = NoPerfData) const;
 	
 		struct ALSAlgorithmicData {
+			/**
+			* @brief stack of contracted slices that keeps the buffers of removed entries for reuse
+			* @details Together with the scratch buffers this allows the stack updates to run without reallocations once the stack had its maximal height.
+			* The price is memory: the buffers of popped entries are kept, so the left and right stacks together hold about twice as many
+			* contracted slices as are in use at any time, i.e. the peak memory of the stacks roughly doubles.
+			*/
+			struct SliceStack {
+				std::vector<Tensor> entries; ///< buffers of the entries, only the first height ones are part of the stack
+				size_t height = 0; ///< current number of entries
+				std::vector<value_t> workspace1, workspace2; ///< scratch buffers for the intermediate results of the stack updates
+				std::vector<float> singleWorkspace1, singleWorkspace2, singleResult; ///< scratch buffers of the stack updates in single precision
+				Tensor denseCopy1, denseCopy2, denseCopy3, denseCopy4; ///< copies of the operands whose representation or precision differs from the one of the stack update
+				
+				size_t size() const { return height; }
+				const Tensor& operator[](const size_t _i) const { return entries[_i]; }
+				const Tensor& back() const { return entries[height-1]; }
+				
+				/// @brief appends an entry and returns it. Its buffer is the one of a previously removed entry (if any).
+				Tensor& push() {
+					if (height == entries.size()) {
+						entries.emplace_back();
+					}
+					return entries[height++];
+				}
+				
+				void pop_back() { height--; }
+				
+				/// @brief pushes back(r1,r2) * _v1(r1,n,c1) * _v2(r2,n,c2)
+				void push_two_layer_left(const Tensor &_v1, const Tensor &_v2);
+				/// @brief pushes _v1(r1,n,c1) * _v2(r2,n,c2) * back(c1,c2)
+				void push_two_layer_right(const Tensor &_v1, const Tensor &_v2);
+				
+				/// @brief pushes back(r1,r2,r3) * _v1(r1,n,c1) * _A(r2,n,m,c2) * _v3(r3,m,c3), where @a _At is the dense transposed of @a _A
+				void push_three_layer_left(const Tensor &_v1, const Tensor &_At, const Tensor &_v3);
+				/// @brief pushes _v1(r1,n,c1) * _A(r2,n,m,c2) * _v3(r3,m,c3) * back(c1,c2,c3), where @a _At is the dense transposed of @a _A
+				void push_three_layer_right(const Tensor &_v1, const Tensor &_At, const Tensor &_v3);
+				
+				/// @brief pushes back(r1,r2,r3,r4) * _x(r1,n1,c1) * _A(r2,n2,n1,c2) * _A(r3,n2,n3,c3) * _x(r4,n3,c4) for dense @a _A and its dense transposed @a _At
+				void push_four_layer_left(const Tensor &_x, const Tensor &_A, const Tensor &_At);
+				/// @brief pushes _x(r1,n1,c1) * _A(r2,n2,n1,c2) * _A(r3,n2,n3,c3) * _x(r4,n3,c4) * back(c1,c2,c3,c4) for dense @a _A and its dense transposed @a _At
+				void push_four_layer_right(const Tensor &_x, const Tensor &_A, const Tensor &_At);
+				
+				/**
+				* @brief implementations of the push functions above with matrix-matrix products in precision T
+				* @details The push functions use single precision if one of the operands is stored in single precision. The entries themselves
+				* are always kept in double precision, so that the errors of the single precision products do not accumulate along the stack.
+				*/
+				template<class T> void push_two_layer_left_impl(const Tensor &_v1, const Tensor &_v2);
+				template<class T> void push_two_layer_right_impl(const Tensor &_v1, const Tensor &_v2);
+				template<class T> void push_three_layer_left_impl(const Tensor &_v1, const Tensor &_At, const Tensor &_v3);
+				template<class T> void push_three_layer_right_impl(const Tensor &_v1, const Tensor &_At, const Tensor &_v3);
+				template<class T> void push_four_layer_left_impl(const Tensor &_x, const Tensor &_A, const Tensor &_At);
+				template<class T> void push_four_layer_right_impl(const Tensor &_x, const Tensor &_A, const Tensor &_At);
+				
+				/// @brief returns the scratch buffer @a _i (1 or 2) of precision T
+				template<class T> std::vector<T>& workspace(const size_t _i);
+				
+				/// @brief resets @a _res to the dense tensor of dimensions @a _dims and returns the buffer the result of precision T has to be written to, cf. store_result()
+				template<class T> T* result_buffer(Tensor &_res, const Tensor::DimensionTuple &_dims);
+				
+				/// @brief writes the result in the buffer returned by result_buffer() into @a _res (in double precision)
+				template<class T> void store_result(Tensor &_res);
+			};
+			
 			struct ContractedTNCache {
-				std::vector<Tensor> left, right;
+				SliceStack left, right;
 			};
 			const ALSVariant &ALS; ///< the algorithm this data belongs to
 			const TTOperator *A; ///< global operator A
 			TTTensor &x; ///< current iterate x
-			const TTTensor &b; ///< global right-hand-side
+			const TTTensor *b; ///< global right-hand-side, nullptr for eigenvalue problems
 			std::vector<size_t> targetRank; ///< rank for the final x
 			ContractedTNCache localOperatorCache; ///< stacks for the local operator (either xAx or xAtAx)
 			ContractedTNCache rhsCache; ///< stacks for the right-hand-side (either xb or xAtb)
+			std::vector<Tensor> operatorComponents; ///< dense copies of the components of A (without factor and in their precision) used for the stack updates
+			std::vector<Tensor> transposedOperatorComponents; ///< dense copies of the components of A with both external modes swapped
 			value_t normB; ///< norm of the (global) right hand side
+			std::vector<value_t> eigenvalues; ///< current approximations of the lowest eigenvalues (eigenvalue problems only)
 			std::pair<size_t, size_t> optimizedRange; ///< range of indices for the nodes of _x that need to be optimized
 			bool canonicalizeAtTheEnd; ///< whether _x should be canonicalized at the end
 			size_t corePosAtTheEnd; ///< core position that should be restored at the end of the algorithm
@@ -75,13 +143,28 @@ namespace xerus {
 			*/
 			void prepare_x_for_als();
 			
-			TensorNetwork localOperatorSlice(size_t _pos);
-			TensorNetwork localRhsSlice(size_t _pos);
+			/**
+			* @brief contracts the slice at @a _pos onto the left (or right) stack of the local operator
+			* @details uses a fixed sequence of matrix-matrix products instead of a TensorNetwork. The result is written into the buffer of a previously removed entry if possible.
+			*/
+			void push_left_operator_slice(size_t _pos);
+			void push_right_operator_slice(size_t _pos);
+			
+			/// @brief contracts the slice at @a _pos onto the left (or right) stack of the right-hand-side, cf. push_left_operator_slice()
+			void push_left_rhs_slice(size_t _pos);
+			void push_right_rhs_slice(size_t _pos);
+			
+			/**
+			* @brief contracts the current window of sites onto the left stacks and returns the full contractions with the right stacks
+			* @details the first entry is the one of the local operator (<x,Ax> or <Ax,Ax>), the second the one of the right-hand-side (<x,b> or <Ax,b>).
+			* Entries of missing stacks are zero. The stacks are restored afterwards.
+			*/
+			std::pair<value_t, value_t> contract_current_window();
 			
 			/**
 			* @brief prepares the initial stacks for the local operator and local right-hand-side
 			* @details requires optimziedRange
-			* sets xAxL, xAxR, bxL, bxR
+			* sets operatorComponents, transposedOperatorComponents, xAxL, xAxR, bxL, bxR
 			*/
 			void prepare_stacks();
 			
@@ -92,7 +175,7 @@ namespace xerus {
 			*/
 			void choose_energy_functional();
 			
-			ALSAlgorithmicData(const ALSVariant &, const TTOperator *, TTTensor &, const TTTensor &);
+			ALSAlgorithmicData(const ALSVariant &, const TTOperator *, TTTensor &, const TTTensor *);
 			
 			/**
 			* @brief performs one step in @a direction, updating all stacks
@@ -102,6 +185,31 @@ namespace xerus {
 			void move_to_next_index();
 		};
 		
+		/**
+		* @brief splits the solution @a _x of a local problem into the components of all simultaneously optimized sites
+		* @details the rank of each split is bounded by the target rank of the corresponding position. Moves the core in the direction of the sweep.
+		*/
+		static void split_local_solution(Tensor &&_x, std::vector<Tensor> &_components, const ALSAlgorithmicData &_data);
+		
+		/**
+		* @brief calculates the diagonal of the local operator directly from the stacks and the components of A
+		* @details the result has the dimensions of the (combined) local solution
+		*/
+		static Tensor local_operator_diagonal(const ALSAlgorithmicData &_data);
+		
+		/**
+		* @brief calculates the lowest eigenpairs of the local operator @a _A with the block Davidson method
+		* @details The last mode of @a _x enumerates the eigenvectors. Its slices are used as starting values and are replaced by the orthonormal
+		* eigenvectors. If localSolverPreconditioning is set, the corrections are preconditioned
+		* with the diagonal of the local operator, otherwise the search space is the Krylov space of the Lanczos method.
+		*/
+		static void davidson_solver(const TensorNetwork &_A, Tensor &_x, std::vector<value_t> &_eigenvalues, const ALSAlgorithmicData &_data);
+		
+		/**
+		* @brief constructs the local operator as the network of left stack, components of A and right stack
+		* @details The network is matrix-free. The lapack_solver contracts it, but the iterative local solvers (cg_solver, davidson_solver) only 
+		* ever apply it to vectors, so for them the local operator is never assembled.
+		*/
 		TensorNetwork construct_local_operator(ALSAlgorithmicData &_data) const;
 		TensorNetwork construct_local_RHS(ALSAlgorithmicData &_data) const;
 		bool check_for_end_of_sweep(ALSAlgorithmicData& _data, size_t _numHalfSweeps, value_t _convergenceEpsilon, PerformanceData &_perfData) const;
@@ -116,6 +224,9 @@ namespace xerus {
 		bool useResidualForEndCriterion; ///< calculates the residual to decide if the ALS converged. recommended if _perfdata is given. implied if assumeSPD = false
 		bool preserveCorePosition; ///< if true the core will be moved to its original position at the end
 		bool assumeSPD; ///< if true the operator A will be assumed to be symmetric positive definite
+		size_t localSolverMaxIterations; ///< maximal number of iterations of the iterative local solvers. set to 0 to use the size of the local problem
+		value_t localSolverEpsilon; ///< relative residual of the local problem at which the iterative local solvers stop
+		bool localSolverPreconditioning; ///< if true the iterative local solvers are preconditioned with the diagonal of the local operator
 		
 		// TODO std::function endCriterion
 		
@@ -127,7 +238,12 @@ namespace xerus {
 		static void lapack_solver(const TensorNetwork &_A, std::vector<Tensor> &_x, const TensorNetwork &_b, const ALSAlgorithmicData &_data);
 		static void ASD_solver(const TensorNetwork &_A, std::vector<Tensor> &_x, const TensorNetwork &_b, const ALSAlgorithmicData &_data);
 		
-		//TODO add local CG solver
+		/**
+		* @brief local solver that uses the (diagonally preconditioned) CG method, starting at the current components
+		* @details The local operator is symmetric in all variants (for non-SPD operators the local problem is the normal equation), so CG applies to all of them.
+		*/
+		static void cg_solver(const TensorNetwork &_A, std::vector<Tensor> &_x, const TensorNetwork &_b, const ALSAlgorithmicData &_data);
+		
 		//TODO add AMEn solver
 		
 		/// fully defining constructor. alternatively ALSVariants can be created by copying a predefined variant and modifying it
@@ -135,7 +251,8 @@ namespace xerus {
 			bool _useResidual=false
 		) 
 				: sites(_sites), numHalfSweeps(_numHalfSweeps), convergenceEpsilon(1e-6), 
-				useResidualForEndCriterion(_useResidual), preserveCorePosition(true), assumeSPD(_assumeSPD), localSolver(_localSolver)
+				useResidualForEndCriterion(_useResidual), preserveCorePosition(true), assumeSPD(_assumeSPD), 
+				localSolverMaxIterations(0), localSolverEpsilon(1e-10), localSolverPreconditioning(true), localSolver(_localSolver)
 		{
 			XERUS_REQUIRE(_sites>0, "");
 		}
@@ -205,6 +322,33 @@ namespace xerus {
 		double operator()(TTTensor &_x, const TTTensor &_b, PerformanceData &_perfData = NoPerfData) const {
 			return solve(nullptr, _x, _b, numHalfSweeps, convergenceEpsilon, _perfData);
 		}
+		
+		/**
+		* call to find the lowest eigenvalue of the symmetric operator @a _A and a corresponding eigenvector
+		* @param _A symmetric operator
+		* @param[in,out] _x in: initial guess, out: eigenvector as found by the algorithm
+		* @param _perfData vector of performance data (eigenvalue after every microiteration)
+		* @returns the lowest eigenvalue
+		*/
+		value_t eigen(const TTOperator &_A, TTTensor &_x, PerformanceData &_perfData = NoPerfData) const {
+			std::vector<TTTensor> x(1, _x);
+			const value_t lambda = solve_eigen(_A, x, numHalfSweeps, convergenceEpsilon, _perfData).front();
+			_x = std::move(x.front());
+			return lambda;
+		}
+		
+		/**
+		* call to find the _x.size() lowest eigenvalues of the symmetric operator @a _A and corresponding eigenvectors (block mode)
+		* @details All eigenvectors share the components outside of the currently optimized sites and thereby all stacks. Only the optimized sites
+		* carry an additional mode that enumerates the eigenvectors. The ranks of the first initial guess are used for all eigenvectors.
+		* @param _A symmetric operator
+		* @param[in,out] _x in: initial guesses, out: eigenvectors as found by the algorithm
+		* @param _perfData vector of performance data (sum of the eigenvalues after every microiteration)
+		* @returns the eigenvalues in ascending order
+		*/
+		std::vector<value_t> eigen(const TTOperator &_A, std::vector<TTTensor> &_x, PerformanceData &_perfData = NoPerfData) const {
+			return solve_eigen(_A, _x, numHalfSweeps, convergenceEpsilon, _perfData);
+		}
 	};
 	
 	/// default variant of the single-site ALS algorithm for non-symmetric operators using the lapack solver
@@ -46,6 +46,7 @@ namespace xerus {
 		size_t numSteps; ///< maximum number of steps to perform. set to 0 for infinite
 		value_t convergenceEpsilon; ///< default value for the change in the residual at which the algorithm assumes it is converged
 		bool assumeSymmetricPositiveDefiniteOperator; ///< calculates the gradient as b-Ax instead of A^T(b-Ax)
+		size_t productMaxRank; ///< if nonzero, the products of the operator with TTTensors are truncated to this rank by apply_and_round() instead of being calculated exactly
 		
 		TTRetractionI retraction; ///< the retraction type I to project from point + tangent vector to a new point on the manifold
 		TTVectorTransport vectorTransport; ///< the vector transport from old tangent space to new one
@@ -57,13 +58,13 @@ namespace xerus {
 						   TTRetractionI _retraction,
 						   TTVectorTransport _vectorTransport
   						)
-				: numSteps(_numSteps), convergenceEpsilon(_convergenceEpsilon), assumeSymmetricPositiveDefiniteOperator(_symPosOp), 
+				: numSteps(_numSteps), convergenceEpsilon(_convergenceEpsilon), assumeSymmetricPositiveDefiniteOperator(_symPosOp), productMaxRank(0), 
 				  retraction(_retraction), vectorTransport(_vectorTransport)
 		{ }
 		
 		/// definition using only the retraction. In the following an operator() including either convergenceEpsilon or numSteps must be called or the algorithm will never terminate
 		GeometricCGVariant(TTRetractionI _retraction, TTVectorTransport _vectorTransport)
-				: numSteps(0), convergenceEpsilon(0.0), assumeSymmetricPositiveDefiniteOperator(false), 
+				: numSteps(0), convergenceEpsilon(0.0), assumeSymmetricPositiveDefiniteOperator(false), productMaxRank(0), 
 				  retraction(_retraction), vectorTransport(_vectorTransport)
 		{ }
 		
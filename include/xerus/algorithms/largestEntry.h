@@ -26,6 +26,9 @@
 #include "../ttNetwork.h"
 
 namespace xerus {
+	/// @brief The entrywise squares in find_largest_entry() are truncated to this multiple of the current ranks instead of being formed with the squared ranks.
+	extern size_t largestEntryRankFactor; // NOTE not const so that users can modify this value!
+	
 	/** 
 	 * @brief Finds the position of the approximately largest entry.
 	 * @details Finds an entry that is at least of size @a _accuracy * X_max in absolute value,
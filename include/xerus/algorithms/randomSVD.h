@@ -19,7 +19,7 @@
 
 /**
  * @file
- * @brief Header file for the IHT algorithm and its variants.
+ * @brief Header file for the randomized TT-SVD.
  */
 
 #pragma once
@@ -27,75 +27,24 @@
 #include "../ttNetwork.h"
 
 namespace xerus {
-    
-// TTTensor randomTTSVD(const Tensor& _x, const std::vector<size_t>& _ranks, const std::vector<size_t>& _oversampling) {
-//     std::normal_distribution<double> dist(0, 1);
-//     
-//     const size_t d = _x.degree();
-//     TTTensor u(d);
-//     Tensor b = _x;
-//     
-//     for(size_t j = d; j >= 2; --j) {
-//         const size_t s = _ranks[j-2] + _oversampling[j-2];
-//         
-//         const std::vector<size_t> mixDims(b.dimensions.cbegin(), b.dimensions.cbegin()+(j-1));
-//         
-//         std::vector<size_t> outDims({s});
-//         outDims.insert(outDims.end(), b.dimensions.cbegin()+(j-1), b.dimensions.cend());
-//         
-//         Tensor a(outDims, Tensor::Representation::Sparse, Tensor::Initialisation::Zero);
-//         
-//         if(b.is_sparse()) {
-//             const size_t staySize = misc::product(b.dimensions, j-1, b.dimensions.size());
-//             
-//             std::map<size_t, std::vector<value_t>> usedG;
-//             
-//             const auto& data = b.get_sparse_data();
-//             for(const auto& entry : data) {
-//                 const size_t pos = entry.first/staySize;
-//                 const size_t outPos = entry.first%staySize;
-//                 
-//                 auto& gEntry = usedG[pos];
-//                 if(gEntry.empty()) {
-//                     gEntry.reserve(s);
-//                     for(size_t k = 0; k < s; ++k) {
-//                         gEntry.push_back(dist(xerus::misc::randomEngine));
-//                     }
-//                 }
-//                 
-//                 for(size_t k = 0; k < s; ++k) {
-//                     a[outPos+k*staySize] += gEntry[k]*entry.second;
-//                 }
-//             }
-//             
-//         } else {
-//             std::vector<size_t> gDims({s});
-//             gDims.insert(gDims.end(), mixDims.cbegin(), mixDims.cend());
-//             const Tensor g = Tensor::random(gDims, dist, xerus::misc::randomEngine);
-//             contract(a, g, false, b, false, j-1);
-//         }
-//         
-//         
-//         Tensor R, Q;
-//         calculate_rq(R, Q, a, 1);
-//         
-//         
-//         if(j == d) {
-//             contract(b, b, false, Q, true, 1);
-//             Q.reinterpret_dimensions(Q.dimensions | std::vector<size_t>({1}));
-//             u.set_component(j-1, Q);
-//         } else {
-//             contract(b, b, false, Q, true, 2);
-//             u.set_component(j-1, Q); 
-//         }
-//     }
-//     
-//     b.reinterpret_dimensions(std::vector<size_t>({1}) | b.dimensions);
-//     u.set_component(0, b);
-//     
-//     u.round(_ranks);
-//     
-//     return u;
+	/**
+	 * @brief Calculates a TT decomposition of @a _x using randomized SVDs.
+	 * @details Instead of exact SVDs of the matricizations the range of each matricization is approximated by multiplying it with a 
+	 * gaussian random matrix with @a _ranks[i] + @a _oversampling[i] rows, followed by @a _powerIterations steps of subspace iteration. 
+	 * The components are calculated from right to left, finally the result is rounded to @a _ranks. For sparse @a _x only the columns of
+	 * the random matrix that are actually needed are created. The result is canonicalized with core position zero.
+	 * @param _x the tensor to decompose, either dense or sparse.
+	 * @param _ranks the target ranks, must contain degree-1 entries.
+	 * @param _oversampling the additional number of random samples used for each rank.
+	 * @param _powerIterations the number of power (subspace) iterations, improves the accuracy for slowly decaying singular values.
+	 * @returns the TTTensor approximating @a _x.
+	 */
+	TTTensor randomTTSVD(const Tensor& _x, const std::vector<size_t>& _ranks, const std::vector<size_t>& _oversampling, const size_t _powerIterations = 0);
+	
+	
+	/**
+	 * @brief Calculates a TT decomposition of @a _x using randomized SVDs with the same oversampling for all ranks.
+	 * @details See randomTTSVD(const Tensor&, const std::vector<size_t>&, const std::vector<size_t>&, const size_t).
+	 */
+	TTTensor randomTTSVD(const Tensor& _x, const std::vector<size_t>& _ranks, const size_t _oversampling = 10, const size_t _powerIterations = 0);
 }
-
-
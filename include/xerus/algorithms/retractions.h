@@ -41,6 +41,8 @@ namespace xerus {
 		TTTangentVector() {};
 		///@brief creates a tangent vector by projecting @a _direction onto the tangent plane located at @a _base
 		TTTangentVector(const TTTensor &_base, const TTTensor &_direction);
+		///@brief projects the tangent vector @a _direction onto the tangent plane located at @a _base without forming its rank 2r TT representation
+		TTTangentVector(const TTTensor &_base, const TTTangentVector &_direction);
 		TTTangentVector &operator+=(const TTTangentVector &_rhs);
 		TTTangentVector &operator-=(const TTTangentVector &_rhs);
 		TTTangentVector &operator*=(value_t _alpha);
@@ -50,6 +50,7 @@ namespace xerus {
 		size_t numSteps; ///< maximum number of steps to perform. set to 0 for infinite
 		value_t convergenceEpsilon; ///< default value for the change in the residual at which the algorithm assumes it is converged
 		bool assumeSymmetricPositiveDefiniteOperator; ///< calculates the gradient as b-Ax instead of A^T(b-Ax)
+		size_t productMaxRank; ///< if nonzero, the products of the operator with TTTensors are truncated to this rank by apply_and_round() instead of being calculated exactly
 		TTOperator *preconditioner;
 		
 		TTRetractionII retraction; ///< the retraction to project from point + tangent vector to a new point on the manifold
@@ -59,12 +60,12 @@ namespace xerus {
 		/// fully defining constructor. alternatively SteepestDescentVariant can be created by copying a predefined variant and modifying it
 		SteepestDescentVariant(size_t _numSteps, value_t _convergenceEpsilon, bool _symPosOp, TTRetractionII _retraction)
 				: numSteps(_numSteps), convergenceEpsilon(_convergenceEpsilon),
-				  assumeSymmetricPositiveDefiniteOperator(_symPosOp), preconditioner(nullptr), retraction(_retraction)
+				  assumeSymmetricPositiveDefiniteOperator(_symPosOp), productMaxRank(0), preconditioner(nullptr), retraction(_retraction)
 		{ }
 		
 		/// definition using only the retraction. In the following an operator() including either convergenceEpsilon or numSteps must be called or the algorithm will never terminate
 		SteepestDescentVariant(TTRetractionII _retraction)
-				: numSteps(0), convergenceEpsilon(0.0), assumeSymmetricPositiveDefiniteOperator(false), preconditioner(nullptr), retraction(_retraction)
+				: numSteps(0), convergenceEpsilon(0.0), assumeSymmetricPositiveDefiniteOperator(false), productMaxRank(0), preconditioner(nullptr), retraction(_retraction)
 		{ }
 		
 		/**
@@ -61,5 +61,8 @@ namespace xerus {
 		
 		/// @brief Internal deleter function, needed because std::shared_ptr misses an array overload.
 		void array_deleter_st(size_t* const _toDelete);
+		
+		/// @brief Internal deleter function, needed because std::shared_ptr misses an array overload.
+		void array_deleter_ft(float* const _toDelete);
 	}
 }
@@ -47,6 +47,15 @@ namespace xerus {
 		///@brief: Computes the dot product = x^T*y
 		double dot_product(const double* const _x, const size_t _n, const double* const _y);
 		
+		///@brief: Computes the one norm =||x||_1 of a single precision vector
+		float one_norm(const float* const _x, const size_t _n);
+		
+		///@brief: Computes the two norm =||x||_2 of a single precision vector, accumulating in double precision
+		double two_norm(const float* const _x, const size_t _n);
+		
+		///@brief: Computes the dot product = x^T*y of single precision vectors, accumulating in double precision
+		double dot_product(const float* const _x, const size_t _n, const float* const _y);
+		
 		
 		//----------------------------------------------- LEVEL II BLAS ---------------------------------------------------------
 		
@@ -56,6 +65,12 @@ namespace xerus {
 		///@brief: Performs A = alpha*x*y^T
 		void dyadic_vector_product(double* _A, const size_t _m, const size_t _n, const double _alpha, const double*const _x, const double*const _y);
 		
+		///@brief: Perfroms x = alpha*OP(A)*y in single precision
+		void matrix_vector_product(float* const _x, const size_t _m, const float _alpha, const float* const _A, const size_t _n, const bool _transposed, const float* const _y);
+		
+		///@brief: Performs A = alpha*x*y^T in single precision
+		void dyadic_vector_product(float* _A, const size_t _m, const size_t _n, const float _alpha, const float*const _x, const float*const _y);
+		
 		//----------------------------------------------- LEVEL III BLAS --------------------------------------------------------
 		///@brief: Performs the Matrix-Matrix product C = alpha*OP(A) * OP(B)
 		void matrix_matrix_product( double* const _C,
@@ -84,6 +99,33 @@ namespace xerus {
 			matrix_matrix_product( _C, _leftDim, _rightDim, _alpha, _A, _transposeA ? _leftDim : _middleDim, _transposeA, _middleDim, _B, _transposeB ? _middleDim : _rightDim, _transposeB);
 		}
 		
+		///@brief: Performs the Matrix-Matrix product C = alpha*OP(A) * OP(B) in single precision
+		void matrix_matrix_product( float* const _C,
+									const size_t _leftDim,
+									const size_t _rightDim,
+									const float _alpha,
+									const float* const _A,
+									const size_t _lda,
+									const bool _transposeA,
+									const size_t _middleDim,
+									const float* const _B,
+									const size_t _ldb,
+									const bool _transposeB);
+		
+		///@brief: Performs the Matrix-Matrix product C = alpha*OP(A) * OP(B) in single precision
+		static XERUS_force_inline void matrix_matrix_product( float* const _C,
+									const size_t _leftDim,
+									const size_t _rightDim,
+									const float _alpha,
+									const float* const _A,
+									const bool _transposeA,
+									const size_t _middleDim,
+									const float* const _B,
+									const bool _transposeB) {
+			
+			matrix_matrix_product( _C, _leftDim, _rightDim, _alpha, _A, _transposeA ? _leftDim : _middleDim, _transposeA, _middleDim, _B, _transposeB ? _middleDim : _rightDim, _transposeB);
+		}
+		
 		//----------------------------------------------- LAPACK ----------------------------------------------------------------
 		
 		///@brief: Performs (U,S,V) = SVD(A)
@@ -92,6 +134,19 @@ namespace xerus {
 		///@brief: Performs (U,S,V) = SVD(A). Destroys A.
 		void svd_destructive( double* const _U, double* const _S, double* const _Vt, double* const _A, const size_t _m, const size_t _n);
 		
+		///@brief: Performs (U,S,V) = SVD(A) in single precision
+		void svd( float* const _U, float* const _S, float* const _Vt, const float* const _A, const size_t _m, const size_t _n);
+		
+		///@brief: Performs (U,S,V) = SVD(A) in single precision. Destroys A.
+		void svd_destructive( float* const _U, float* const _S, float* const _Vt, float* const _A, const size_t _m, const size_t _n);
+		
+		
+		///@brief: Performs A = V*diag(lambda)*V^T for the symmetric nxn matrix A. The eigenvalues are in ascending order, the columns of V are the corresponding eigenvectors.
+		void symmetric_eigen_decomposition( double* const _V, double* const _lambda, const double* const _A, const size_t _n);
+		
+		///@brief: Single precision variant of symmetric_eigen_decomposition().
+		void symmetric_eigen_decomposition( float* const _V, float* const _lambda, const float* const _A, const size_t _n);
+		
 		
 		///@brief: splits A = Q*C, with @a _C an rxn matrix (where r is the rank of @a _A) and @a _Q orthogonal.
 		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> qc(const double* const _A, const size_t _m, const size_t _n);
@@ -99,6 +154,12 @@ namespace xerus {
 		///@brief: splits A = Q*C, with @a _C an rxn matrix (where r is the rank of @a _A) and @a _Q orthogonal. Destroys A.
 		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> qc_destructive(double* const _A, const size_t _m, const size_t _n);
 		
+		///@brief: Single precision variant of qc().
+		std::tuple<std::unique_ptr<float[]>, std::unique_ptr<float[]>, size_t> qc(const float* const _A, const size_t _m, const size_t _n);
+		
+		///@brief: Single precision variant of qc_destructive().
+		std::tuple<std::unique_ptr<float[]>, std::unique_ptr<float[]>, size_t> qc_destructive(float* const _A, const size_t _m, const size_t _n);
+		
 		
 		///@brief: splits A = C*Q, with @a _C an rxm matrix (where r is the rank of @a _A) and @a _Q orthogonal.
 		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> cq(const double* const _A, const size_t _m, const size_t _n);
@@ -106,6 +167,12 @@ namespace xerus {
 		///@brief: splits A = C*Q, with @a _C an rxm matrix (where r is the rank of @a _A) and @a _Q orthogonal. Destroys A.
 		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> cq_destructive(double* const _A, const size_t _m, const size_t _n);
 		
+		///@brief: Single precision variant of cq().
+		std::tuple<std::unique_ptr<float[]>, std::unique_ptr<float[]>, size_t> cq(const float* const _A, const size_t _m, const size_t _n);
+		
+		///@brief: Single precision variant of cq_destructive().
+		std::tuple<std::unique_ptr<float[]>, std::unique_ptr<float[]>, size_t> cq_destructive(float* const _A, const size_t _m, const size_t _n);
+		
 		
 		///@brief: Performs (Q,R) = QR(A)
 		void qr( double* const _Q, double* const _R, const double* const _A, const size_t _m, const size_t _n);
@@ -116,6 +183,15 @@ namespace xerus {
 		///@brief: Performs (Q,R) = QR(A), destroys A in the process
 		void qr_destructive( double* const _Q, double* const _R, double* const _A, const size_t _m, const size_t _n);
 		
+		///@brief: Performs (Q,R) = QR(A) in single precision
+		void qr( float* const _Q, float* const _R, const float* const _A, const size_t _m, const size_t _n);
+		
+		///@brief: Performs (AtoQ,R) = QR(AtoQ) in single precision
+		void inplace_qr(float* const _AtoQ, float* const _R, const size_t _m, const size_t _n);
+		
+		///@brief: Performs (Q,R) = QR(A) in single precision, destroys A in the process
+		void qr_destructive( float* const _Q, float* const _R, float* const _A, const size_t _m, const size_t _n);
+		
 		
 		
 		///@brief: Performs (R,Q) = RQ(A)
@@ -126,6 +202,15 @@ namespace xerus {
 		
 		///@brief: Performs (R,Q) = RQ(A), destroys A in the process
 		void rq_destructive( double* const _R, double* const _Q, double* const _A, const size_t _m, const size_t _n);
+		
+		///@brief: Performs (R,Q) = RQ(A) in single precision
+		void rq( float* const _R, float* const _Q, const float* const _A, const size_t _m, const size_t _n);
+		
+		///@brief: Performs (R,AtoQ) = RQ(AtoQ) in single precision
+		void inplace_rq( float* const _R, float* const _AtoQ, const size_t _m, const size_t _n);
+		
+		///@brief: Performs (R,Q) = RQ(A) in single precision, destroys A in the process
+		void rq_destructive( float* const _R, float* const _Q, float* const _A, const size_t _m, const size_t _n);
 
 		
 		///@brief: Solves Ax = b for x
@@ -25,10 +25,11 @@
 #pragma once
 
 #include <memory>
-#include <map>
 #include <mutex>
 #include <functional>
 
+#include "misc/flatMap.h"
+
 #include <suitesparse/cholmod.h>
 #include <suitesparse/SuiteSparseQR.hpp>
 
@@ -71,10 +72,10 @@ namespace xerus {
 			
 			///@brief Converts the given tensor to the cholmod sparse format using the given matrification.
 			///@note _input is supposed to be a _m by _n matrix _before_ transposition.
-			CholmodSparse(const std::map<size_t, double>& _input, const size_t _m, const size_t _n, const bool _transpose);
+			CholmodSparse(const misc::FlatMap<size_t, double>& _input, const size_t _m, const size_t _n, const bool _transpose);
 			
 			///@brief Transforms a cholmod sparse matrix to sparse Tensor format.
-			std::map<size_t, double> to_map(double _alpha=1.0) const;
+			misc::FlatMap<size_t, double> to_map(double _alpha=1.0) const;
 			
 			///@brief Calculates the Matrix Matrix product with another sparse matrix.
 			CholmodSparse operator*(const CholmodSparse &_rhs) const;
@@ -83,29 +84,29 @@ namespace xerus {
 			void transpose();
 			
 			///@brief Calculates the Matrix Matrix product between two sparse matrices.
-			static void matrix_matrix_product(std::map<size_t, double>& _C,
+			static void matrix_matrix_product(misc::FlatMap<size_t, double>& _C,
 										const size_t _leftDim,
 										const size_t _rightDim,
 										const double _alpha,
-										const std::map<size_t, double>& _A,
+										const misc::FlatMap<size_t, double>& _A,
 										const bool _transposeA,
 										const size_t _midDim,
-										const std::map<size_t, double>& _B,
+										const misc::FlatMap<size_t, double>& _B,
 										const bool _transposeB);
 			
 			///@brief solve operator / for sparse right hand sites
-			static void solve_sparse_rhs(std::map<size_t, double>& _x,
+			static void solve_sparse_rhs(misc::FlatMap<size_t, double>& _x,
 								size_t _xDim,
-								const std::map<size_t, double>& _A,
+								const misc::FlatMap<size_t, double>& _A,
 								const bool _transposeA,
-								const std::map<size_t, double>& _b,
+								const misc::FlatMap<size_t, double>& _b,
 								size_t _bDim
 			);
 			
 			///@brief solve operator / for dense right hand sites
 			static void solve_dense_rhs(double * _x,
 								size_t _xDim,
-								const std::map<size_t, double>& _A,
+								const misc::FlatMap<size_t, double>& _A,
 								const bool _transposeA,
 								const double* _b,
 								size_t _bDim
@@ -116,8 +117,8 @@ namespace xerus {
 			 * @note A is assumed to be a _m by _n matrix _before_ transposition. Outputs are given in sparse format but usually not very sparse anymore...
 			 * @returns (q, c, rank), rank = min(m,n) if fullrank was set to true
 			 */
-			static std::tuple<std::map<size_t, double>, std::map<size_t, double>, size_t> qc(
-				const std::map<size_t, double> &_A,
+			static std::tuple<misc::FlatMap<size_t, double>, misc::FlatMap<size_t, double>, size_t> qc(
+				const misc::FlatMap<size_t, double> &_A,
 				const bool _transposeA,
 				size_t _m,
 				size_t _n,
@@ -129,8 +130,8 @@ namespace xerus {
 			 * @note A is assumed to be a _m by _n matrix _before_ transposition. Outputs are given in sparse format but usually not very sparse anymore...
 			 * @returns (c, q, rank), rank = min(m,n) if fullrank was set to true
 			 */
-			static std::tuple<std::map<size_t, double>, std::map<size_t, double>, size_t> cq(
-				const std::map<size_t, double> &_A,
+			static std::tuple<misc::FlatMap<size_t, double>, misc::FlatMap<size_t, double>, size_t> cq(
+				const misc::FlatMap<size_t, double> &_A,
 				const bool _transposeA,
 				size_t _m,
 				size_t _n,
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <vector>
+#include <utility>
 
 #include "basic.h"
 
@@ -32,13 +33,28 @@ namespace xerus {
 	class TensorNetwork;
 	
 	namespace internal {
-		typedef void (*ContractionHeuristic)(double &, std::vector<std::pair<size_t,size_t>> &, TensorNetwork);
+		/**
+		 * @brief Signature of all contraction heuristics. 
+		 * @details The heuristics are given the best cost found so far, the corresponding contractions, a stripped copy of the network and the (expected)
+		 * number of non-zero entries of every node. If they find a cheaper order they update the first two arguments.
+		 */
+		typedef void (*ContractionHeuristic)(double &, std::vector<std::pair<size_t,size_t>> &, TensorNetwork, std::vector<double>);
 		
 		template<double (*scoreFct)(double, double, double, double, double)>
-		void greedy_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network);
+		void greedy_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network, std::vector<double> _sparsities);
 		
+		/**
+		 * @brief Estimates the cost of contracting an m x r with an r x n matrix.
+		 * @details @a _sparsity1 and @a _sparsity2 are the (expected) numbers of non-zero entries of the two operands, i.e. m*r and r*n if they are dense.
+		 */
 		double contraction_cost(double _m, double _n, double _r, double _sparsity1, double _sparsity2);
 		
+		/// @brief Estimates the number of non-zero entries of the result of such a contraction, using the same model as xerus::contract().
+		double contraction_sparsity(double _m, double _n, double _r, double _sparsity1, double _sparsity2);
+		
+		/// @brief Coarse classification of a node by its number of non-zero entries: 0 for dense nodes, otherwise one plus the binary logarithm of the number of entries.
+		size_t sparsity_class(size_t _size, size_t _sparsity);
+		
 		double score_size(double _m, double _n, double _r, double _sparsity1, double _sparsity2);
 		double score_mn(double _m, double _n, double _r, double _sparsity1, double _sparsity2);
 		double score_speed(double _m, double _n, double _r, double _sparsity1, double _sparsity2);
@@ -47,9 +63,55 @@ namespace xerus {
 		double score_littlestep(double _m, double _n, double _r, double _sparsity1, double _sparsity2);
 		
 		
-		void greedy_best_of_three_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network);
-		void exchange_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network);
+		void greedy_best_of_three_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network, std::vector<double> _sparsities);
+		void exchange_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network, std::vector<double> _sparsities);
+		
+		
+		/// @brief Networks with at most this many nodes are additionally searched for an optimal contraction order by optimal_heuristic().
+		extern size_t optimalSearchMaxNodes; // NOTE not const so that users can modify this value!
+		
+		/// @brief Time budget (in milliseconds) of optimal_heuristic(). If it is exceeded, the best solution of the greedy heuristics is used.
+		extern size_t optimalSearchTimeBudget; // NOTE not const so that users can modify this value!
+		
+		/**
+		 * @brief Finds the cheapest contraction order by dynamic programming over all subsets of nodes.
+		 * @details The search is pruned with the cost of the best order found so far (i.e. by the greedy heuristics). It is skipped
+		 * for networks with more than optimalSearchMaxNodes nodes and aborted if it takes longer than optimalSearchTimeBudget.
+		 */
+		void optimal_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network, std::vector<double> _sparsities);
 		
 		extern const std::vector<ContractionHeuristic> contractionHeuristics;
+		
+		
+		/// @brief Maximal number of contraction orders kept by the cache of TensorNetwork::contract(). Zero disables the cache.
+		extern size_t contractionCacheCapacity; // NOTE not const so that users can modify this value!
+		
+		/**
+		 * @brief Looks up the contraction order stored for the network structure described by @a _key.
+		 * @details The key lists the degrees, link dimensions, link structure and sparsity classes of all nodes. The nodes in the returned 
+		 * contractions are identified by their position in this description. Every call counts as either a hit or a miss.
+		 * @return true if an order was found, false otherwise.
+		 */
+		bool find_cached_contractions(const std::vector<size_t> &_key, std::vector<std::pair<size_t,size_t>> &_contractions);
+		
+		/// @brief Stores the contraction order for the network structure described by @a _key, cf. find_cached_contractions().
+		void cache_contractions(std::vector<size_t> _key, std::vector<std::pair<size_t,size_t>> _contractions);
+		
+		/// @brief Returns the number of lookups in the contraction cache that found a stored order.
+		size_t contraction_cache_hits();
+		
+		/// @brief Returns the number of lookups in the contraction cache that did not find a stored order.
+		size_t contraction_cache_misses();
+		
+		/// @brief Removes all stored contraction orders and resets the hit and miss counters.
+		void clear_contraction_cache();
+		
+		
+		/**
+		 * @brief Bound for the (estimated) number of entries of all intermediate results that may exist at the same time while independent 
+		 * branches of a contraction order are executed in parallel by TensorNetwork::contract().
+		 * @details Steps that would exceed the bound are postponed until other intermediate results are consumed.
+		 */
+		extern size_t parallelContractionMemory; // NOTE not const so that users can modify this value!
 	}
 }
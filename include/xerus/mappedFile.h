@@ -0,0 +1,74 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+/**
+ * @file
+ * @brief Header file for the memory mapped binary storage of Tensors and TTNetworks.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "tensor.h"
+#include "ttNetwork.h"
+
+namespace xerus { namespace misc {
+	
+	/**
+	 * @brief Stores @a _tensor in the memory mapped binary container format.
+	 * @details The container consists of a 64 byte header, a table with the degree, dimensions, representation, factor and data offset
+	 * of every stored tensor and the raw data blocks, each aligned to 64 bytes. Dense data is written as is, sparse data as the array of
+	 * (position, value) pairs. All values are stored in the native byte order. The file is written under a temporary name and then
+	 * renamed, such that objects still using a previous version of the file are not affected.
+	 */
+	void save_to_mapped_file(const Tensor& _tensor, const std::string& _filename);
+	
+	/**
+	 * @brief Stores @a _network in the memory mapped binary container format.
+	 * @details The components are stored as individual entries of the container, see save_to_mapped_file(const Tensor&, const std::string&).
+	 */
+	template<bool isOperator>
+	void save_to_mapped_file(const TTNetwork<isOperator>& _network, const std::string& _filename);
+	
+	
+	/**
+	 * @brief Restores a Tensor from a file written by save_to_mapped_file().
+	 * @details The file is mapped copy-on-write into memory and dense data is not copied, i.e. the Tensor directly uses the mapped region
+	 * which is unmapped once no Tensor uses it anymore. Loading is thus instant and the data is paged in lazily on first access. Changes to
+	 * the Tensor are never written back to the file. Sparse data has to be copied.
+	 */
+	void load_from_mapped_file(Tensor& _tensor, const std::string& _filename);
+	
+	/**
+	 * @brief Restores a TTNetwork from a file written by save_to_mapped_file().
+	 * @details As for Tensors, the dense components use the mapped region directly.
+	 */
+	template<bool isOperator>
+	void load_from_mapped_file(TTNetwork<isOperator>& _network, const std::string& _filename);
+	
+	
+	template<class T>
+	T load_from_mapped_file(const std::string& _filename) {
+		T result;
+		load_from_mapped_file(result, _filename);
+		return result;
+	}
+}}
@@ -74,6 +74,7 @@ namespace xerus {
 		
 		void measure(const Tensor& _solution);
 		
+		/// @brief Evaluates @a _solution at all positions. Chunks of consecutive positions are evaluated in parallel, within a chunk partial contractions of common prefixes are reused.
 		void measure(const TensorNetwork& _solution);
 		
 		void measure(std::function<value_t(const std::vector<size_t>&)> _callback);
@@ -81,6 +82,7 @@ namespace xerus {
 		
 		double test(const Tensor& _solution) const;
 		
+		/// @brief Returns the relative error of @a _solution at the measured positions. Evaluated in parallel as measure(), the result does not depend on the number of threads.
 		double test(const TensorNetwork& _solution) const;
 		
 		double test(std::function<value_t(const std::vector<size_t>&)> _callback) const;
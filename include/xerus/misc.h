@@ -38,6 +38,7 @@
 #include "misc/performanceAnalysis.h"
 #include "misc/exceptions.h"
 #include "misc/allocator.h"
+#include "misc/memoryAccounting.h"
 #include "misc/histogram.h"
 #include "misc/sort.h"
 #include "misc/math.h"
@@ -45,3 +46,5 @@
 #include "misc/fileIO.h"
 #include "misc/stringFromTo.h"
 #include "misc/random.h"
+#include "misc/flatMap.h"
+#include "misc/parallel.h"
@@ -32,6 +32,7 @@
 	#include <vector>
 	#include <array>
 	#include <set>
+	#include <cstdint>
 	#include <ext/malloc_allocator.h>
 
 	namespace xerus { namespace misc {
@@ -39,7 +40,8 @@
 	extern void* (*r_malloc)(size_t);
 	extern void (*r_free)(void*);
 		
-	using Mallocator = __gnu_cxx::malloc_allocator<void*>;
+	template<class T>
+	using Mallocator = __gnu_cxx::malloc_allocator<T>;
 
 	struct AllocatorStorage {
 		static constexpr const size_t POOL_SIZE = 4*1024*1024;
@@ -47,14 +49,15 @@
 		static constexpr const size_t ALIGNMENT = 64;
 		static constexpr const size_t NUM_BUCKETS = 64;
 		static constexpr const size_t SMALLEST_NOT_CACHED_SIZE = BUCKET_SIZE * NUM_BUCKETS - 1;
+		static constexpr const size_t LARGE_HEADER_SIZE = sizeof(size_t) + 2; ///< size, alignment offset and marker in front of non-bucket allocations
 		
 		static_assert(BUCKET_SIZE > 1, "Buckets need to be at least 2 bytes large.");
 		static_assert(BUCKET_SIZE % ALIGNMENT == 0, "Bucket size needs to be aligned");
 		static_assert(ALIGNMENT <= 256, "Only alignment up to 256 bytes is supported as only a single byte is used to indicate the offset.");
-		static_assert(NUM_BUCKETS < 255, "atm only a single byte is used to store bucket size");
+		static_assert(NUM_BUCKETS < 254, "atm only a single byte is used to store bucket size (0xFE and 0xFF mark large allocations)");
 		
-		std::array<std::vector<uint8_t*, Mallocator>, NUM_BUCKETS> buckets;
-		std::vector<std::pair<uint8_t*, uint8_t*>, Mallocator> pools;
+		std::array<std::vector<uint8_t*, Mallocator<uint8_t*>>, NUM_BUCKETS> buckets;
+		std::vector<std::pair<uint8_t*, uint8_t*>, Mallocator<std::pair<uint8_t*, uint8_t*>>> pools;
 		
 		AllocatorStorage();
 		~AllocatorStorage();
@@ -67,6 +70,46 @@
 	};
 
 	extern thread_local AllocatorStorage astore;
+	
+	
+	/**
+	 * @brief Pool for the large buffers (e.g. the data of dense Tensors), recycled by size class.
+	 * @details Requests of at least SMALLEST_POOLED_SIZE bytes are rounded up to one of four size classes per power of two (i.e. by at most 25%)
+	 * and are directly mapped from the operating system. Freed buffers are kept in a free list per size class, shared by all threads, 
+	 * as long as the total cached size does not exceed largeBufferPoolCapacity. A recycled buffer is thus already paged in.
+	 * The size class of a buffer is stored in the page in front of it, so the buffer itself is page aligned.
+	 */
+	struct LargeBufferPool {
+		static constexpr const size_t SMALLEST_POOLED_SIZE = 1024*1024;
+		static constexpr const size_t CLASSES_PER_OCTAVE = 4;
+		static constexpr const size_t NUM_CLASSES = 112; // up to 2^48 bytes
+		static constexpr const size_t HUGE_PAGE_SIZE = 2*1024*1024;
+		
+		static_assert(NUM_CLASSES < 254, "atm only a single byte is used to store the size class");
+	};
+	
+	///@brief Maximal number of bytes kept in the LargeBufferPool for reuse. Setting it to zero disables the caching.
+	extern size_t largeBufferPoolCapacity; // NOTE not const so that users can modify this value!
+	
+	///@brief Whether newly mapped large buffers are aligned to HUGE_PAGE_SIZE and advised to be backed by transparent huge pages.
+	extern bool largeBufferPoolUseHugePages; // NOTE not const so that users can modify this value!
+	
+	///@brief Statistics of the LargeBufferPool.
+	struct LargeBufferPoolStatistics {
+		size_t hits;        ///< number of requests served from the pool
+		size_t misses;      ///< number of requests that had to map new memory
+		size_t liveBytes;   ///< bytes of pooled size classes currently in use
+		size_t cachedBytes; ///< bytes currently kept for reuse
+		size_t peakBytes;   ///< maximum of liveBytes + cachedBytes so far
+		
+		double hit_rate() const { return hits+misses > 0 ? double(hits)/double(hits+misses) : 0.0; }
+	};
+	
+	///@brief Returns the current statistics of the LargeBufferPool.
+	LargeBufferPoolStatistics large_buffer_pool_statistics();
+	
+	///@brief Returns all cached buffers of the LargeBufferPool to the operating system.
+	void release_large_buffer_pool();
 	}}
 
 #endif
@@ -0,0 +1,205 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+* @file
+* @brief Header file for the FlatMap class, a map stored as a sorted contiguous array.
+*/
+
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "check.h"
+
+namespace xerus { namespace misc {
+	
+	/**
+	 * @brief Associative container that stores its (key, value) pairs in a single contiguous array sorted by key.
+	 * @details The interface mimics the parts of std::map that are used for sparse Tensor data. Lookups are binary searches,
+	 * insertions at the end (the common case when entries are created in ascending order) are amortized constant, all other insertions
+	 * and removals are linear. In contrast to std::map there is no per entry allocation and iteration is a linear sweep through memory.
+	 * Filling a FlatMap in random order via operator[] or emplace() therefore costs O(n^2) in total, so for unordered bulk construction
+	 * use emplace_back_unsorted() followed by a single call to sort_and_sum_duplicates() (or sort_and_combine_duplicates()) instead.
+	 * @note As for std::vector, any insertion or removal may invalidate all iterators and references.
+	 */
+	template<class key_t, class mapped_t>
+	class FlatMap final {
+	public:
+		typedef key_t key_type;
+		typedef mapped_t mapped_type;
+		typedef std::pair<key_t, mapped_t> value_type;
+		typedef typename std::vector<value_type>::iterator iterator;
+		typedef typename std::vector<value_type>::const_iterator const_iterator;
+	
+	private:
+		std::vector<value_type> entries;
+		
+		static bool key_less(const value_type& _entry, const key_t& _key) { return _entry.first < _key; }
+	
+	public:
+		FlatMap() = default;
+		FlatMap(const FlatMap&) = default;
+		FlatMap(FlatMap&&) noexcept = default;
+		FlatMap& operator=(const FlatMap&) = default;
+		FlatMap& operator=(FlatMap&&) noexcept = default;
+		
+		/// @brief Takes ownership of a vector of entries that must already be sorted by (unique) key.
+		explicit FlatMap(std::vector<value_type>&& _sortedEntries) : entries(std::move(_sortedEntries)) {
+			XERUS_INTERNAL_CHECK(std::adjacent_find(entries.begin(), entries.end(), [](const value_type& _a, const value_type& _b){ return !(_a.first < _b.first); }) == entries.end(), "FlatMap entries must be sorted and unique.");
+		}
+		
+		
+		iterator begin() noexcept { return entries.begin(); }
+		const_iterator begin() const noexcept { return entries.begin(); }
+		const_iterator cbegin() const noexcept { return entries.cbegin(); }
+		iterator end() noexcept { return entries.end(); }
+		const_iterator end() const noexcept { return entries.end(); }
+		const_iterator cend() const noexcept { return entries.cend(); }
+		
+		size_t size() const noexcept { return entries.size(); }
+		bool empty() const noexcept { return entries.empty(); }
+		void clear() noexcept { entries.clear(); }
+		void reserve(const size_t _n) { entries.reserve(_n); }
+		size_t capacity() const noexcept { return entries.capacity(); }
+		void shrink_to_fit() { entries.shrink_to_fit(); }
+		
+		/// @brief Direct access to the underlying sorted array.
+		const value_type* data() const noexcept { return entries.data(); }
+		
+		
+		iterator lower_bound(const key_t& _key) { return std::lower_bound(entries.begin(), entries.end(), _key, &key_less); }
+		const_iterator lower_bound(const key_t& _key) const { return std::lower_bound(entries.begin(), entries.end(), _key, &key_less); }
+		
+		iterator find(const key_t& _key) {
+			const iterator pos = lower_bound(_key);
+			return (pos != entries.end() && !(_key < pos->first)) ? pos : entries.end();
+		}
+		
+		const_iterator find(const key_t& _key) const {
+			const const_iterator pos = lower_bound(_key);
+			return (pos != entries.end() && !(_key < pos->first)) ? pos : entries.end();
+		}
+		
+		size_t count(const key_t& _key) const { return find(_key) != entries.end() ? 1 : 0; }
+		
+		
+		/// @brief Returns a reference to the value of @a _key, inserting a value-initialized one if it does not exist. Linear unless @a _key is the largest key.
+		mapped_t& operator[](const key_t& _key) {
+			if(entries.empty() || entries.back().first < _key) {
+				entries.emplace_back(_key, mapped_t());
+				return entries.back().second;
+			}
+			const iterator pos = lower_bound(_key);
+			if(_key < pos->first) {
+				return entries.emplace(pos, _key, mapped_t())->second;
+			}
+			return pos->second;
+		}
+		
+		
+		/// @brief Inserts (_key, _value) if @a _key is not yet present. Same semantics as std::map::emplace.
+		template<class V>
+		std::pair<iterator, bool> emplace(const key_t& _key, V&& _value) {
+			if(entries.empty() || entries.back().first < _key) {
+				entries.emplace_back(_key, std::forward<V>(_value));
+				return std::make_pair(entries.end()-1, true);
+			}
+			const iterator pos = lower_bound(_key);
+			if(_key < pos->first) {
+				return std::make_pair(entries.emplace(pos, _key, std::forward<V>(_value)), true);
+			}
+			return std::make_pair(pos, false);
+		}
+		
+		std::pair<iterator, bool> insert(const value_type& _entry) { return emplace(_entry.first, _entry.second); }
+		
+		
+		/// @brief Appends an entry whose key is larger than all present keys.
+		template<class V>
+		void emplace_back(const key_t& _key, V&& _value) {
+			XERUS_INTERNAL_CHECK(entries.empty() || entries.back().first < _key, "FlatMap::emplace_back requires ascending keys.");
+			entries.emplace_back(_key, std::forward<V>(_value));
+		}
+		
+		
+		/**
+		 * @brief Appends an entry without regard to the ordering.
+		 * @details Leaves the map in an invalid state until sort_and_sum_duplicates() is called. No other member may be used in between.
+		 */
+		template<class V>
+		void emplace_back_unsorted(const key_t& _key, V&& _value) {
+			entries.emplace_back(_key, std::forward<V>(_value));
+		}
+		
+		
+		/**
+		 * @brief Restores the ordering after calls to emplace_back_unsorted().
+		 * @details Entries with equal keys are merged by calling @a _combine(first, other) for every later duplicate, in insertion order.
+		 */
+		template<class combine_t>
+		void sort_and_combine_duplicates(const combine_t& _combine) {
+			const auto keyOrder = [](const value_type& _a, const value_type& _b){ return _a.first < _b.first; };
+			if(!std::is_sorted(entries.begin(), entries.end(), keyOrder)) {
+				std::stable_sort(entries.begin(), entries.end(), keyOrder);
+			}
+			if(entries.empty()) { return; }
+			
+			auto out = entries.begin();
+			for(auto in = entries.begin()+1; in != entries.end(); ++in) {
+				if(out->first < in->first) {
+					++out;
+					if(out != in) { *out = std::move(*in); }
+				} else {
+					_combine(out->second, in->second);
+				}
+			}
+			entries.erase(out+1, entries.end());
+		}
+		
+		
+		/// @brief Restores the ordering after calls to emplace_back_unsorted(). The values of duplicate keys are summed up.
+		void sort_and_sum_duplicates() {
+			sort_and_combine_duplicates([](mapped_t& _a, const mapped_t& _b){ _a += _b; });
+		}
+		
+		
+		size_t erase(const key_t& _key) {
+			const iterator pos = find(_key);
+			if(pos == entries.end()) { return 0; }
+			entries.erase(pos);
+			return 1;
+		}
+		
+		iterator erase(const_iterator _pos) { return entries.erase(_pos); }
+		
+		/// @brief Removes all entries for which @a _rule returns true in a single linear pass.
+		template<class rule_t>
+		void erase_if(const rule_t& _rule) {
+			entries.erase(std::remove_if(entries.begin(), entries.end(), _rule), entries.end());
+		}
+		
+		
+		bool operator==(const FlatMap& _other) const { return entries == _other.entries; }
+		bool operator!=(const FlatMap& _other) const { return entries != _other.entries; }
+	};
+
+} } // namespaces xerus::misc
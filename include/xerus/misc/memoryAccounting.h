@@ -0,0 +1,110 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+ * @file
+ * @brief Header file for the runtime memory accounting of the xerus allocator.
+ */
+
+#pragma once
+
+#include "standard.h"
+#include <string>
+#include <vector>
+
+namespace xerus {
+	namespace misc {
+		/**
+		 * @brief This namespace contains the runtime memory accounting of the custom new and delete operators.
+		 * @details All allocations of all threads are counted with the size of the block that is actually reserved for them. The accounting
+		 * is only available if xerus is compiled with XERUS_REPLACE_ALLOCATOR, otherwise all statistics are zero.
+		 * Every thread counts its allocations in its own counters, which are merged by get_statistics(). Changes of the allocated bytes
+		 * are collected per thread up to 64 KiB, so the peaks may be underestimated by up to 64 KiB per thread.
+		 */
+		namespace memoryAccounting {
+			/// @brief Snapshot of the memory used by all threads.
+			struct MemoryStatistics {
+				size_t currentBytes;    ///< bytes currently allocated
+				size_t peakBytes;       ///< maximal number of bytes allocated at the same time (since the last reset_peak())
+				size_t allocations;     ///< total number of allocations
+				size_t deallocations;   ///< total number of deallocations
+			};
+
+			/// @brief Memory statistics of a completed phase.
+			struct PhaseStatistics {
+				std::string name;       ///< name of the phase, prefixed by the names of all enclosing phases
+				size_t depth;           ///< number of enclosing phases
+				size_t startBytes;      ///< bytes allocated when the phase began
+				size_t endBytes;        ///< bytes allocated when the phase ended
+				size_t peakBytes;       ///< maximal number of bytes allocated at the same time during the phase
+				size_t allocatedBytes;  ///< total number of bytes allocated during the phase
+				size_t allocations;     ///< number of allocations during the phase
+			};
+
+			/// @brief Returns whether the allocations are actually accounted, i.e. whether xerus is compiled with XERUS_REPLACE_ALLOCATOR.
+			bool is_available();
+
+			/// @brief Returns the current statistics of all threads.
+			MemoryStatistics get_statistics();
+
+			/// @brief Resets the global peak to the current number of allocated bytes.
+			void reset_peak();
+
+			/**
+			 * @brief Begins a new phase named @a _name, nested in the currently open phase (if any).
+			 * @details Phases are global to the process, i.e. allocations of all threads are attributed to the innermost open phase.
+			 */
+			void begin_phase(const std::string& _name);
+
+			/// @brief Ends the innermost open phase and records its statistics.
+			void end_phase();
+			
+			/// @brief Ends the innermost open phase like end_phase(), but only logs a warning if there is none. Used by ~ScopedPhase().
+			void end_scoped_phase() noexcept;
+
+			/// @brief Returns the statistics of all completed phases in the order in which they ended.
+			std::vector<PhaseStatistics> get_phases();
+
+			/// @brief Removes the statistics of all completed phases.
+			void clear_phases();
+
+			/// @brief Returns a human readable summary of the current statistics and all completed phases.
+			std::string get_report();
+
+
+			/// @brief Opens a phase for the lifetime of the object, e.g. @code ScopedPhase phase("ALS sweep "+std::to_string(i)); @endcode
+			class ScopedPhase final {
+			public:
+				explicit ScopedPhase(const std::string& _name) { begin_phase(_name); }
+				ScopedPhase(const ScopedPhase&) = delete;
+				ScopedPhase& operator=(const ScopedPhase&) = delete;
+				~ScopedPhase() { end_scoped_phase(); }
+			};
+
+
+			#ifdef XERUS_REPLACE_ALLOCATOR
+				/// @brief Accounts an allocation of @a _bytes. Used by the custom new operator only.
+				void account_allocation(const size_t _bytes) noexcept;
+
+				/// @brief Accounts a deallocation of @a _bytes. Used by the custom delete operator only.
+				void account_deallocation(const size_t _bytes) noexcept;
+			#endif
+		}
+	}
+}
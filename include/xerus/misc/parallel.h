@@ -0,0 +1,47 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+ * @file
+ * @brief Header file for the settings of the multithreaded kernels of xerus.
+ */
+
+#pragma once
+
+#include "standard.h"
+
+namespace xerus {
+	namespace misc {
+		/**
+		 * @brief Upper bound for the number of threads used by the multithreaded kernels of xerus.
+		 * @details Zero means that the openMP default is used. If xerus is compiled without openMP (-fopenmp) all kernels run 
+		 * sequentially and this value has no effect.
+		 */
+		extern size_t maxThreads; // NOTE not const so that users can modify this value!
+		
+		/// @brief Minimal number of elementary operations per thread, below which additional threads do not pay off.
+		extern size_t minWorkPerThread; // NOTE not const so that users can modify this value!
+		
+		/**
+		 * @brief Returns the number of threads that shall be used for a task consisting of @a _work elementary operations.
+		 * @details Returns one if openMP is not available, the task is too small or the calling thread is already part of a parallel region.
+		 */
+		size_t get_num_threads(const size_t _work);
+	}
+}
@@ -24,7 +24,7 @@
 
 #pragma once
 
-#include <map>
+#include "misc/flatMap.h"
 
 namespace xerus {
     
@@ -33,7 +33,7 @@ namespace xerus {
                                 const size_t _leftDim,
                                 const size_t _rightDim,
                                 const double _alpha,
-                                const std::map<size_t, double>& _A,
+                                const misc::FlatMap<size_t, double>& _A,
                                 const bool _transposeA,
                                 const size_t _midDim,
                                 const double* const _B,
@@ -46,28 +46,50 @@ namespace xerus {
                                 const double* const _A,
                                 const bool _transposeA,
                                 const size_t _midDim,
-                                const std::map<size_t, double>& _B,
+                                const misc::FlatMap<size_t, double>& _B,
+                                const bool _transposeB);
+    
+    ///@brief: Single precision variant, the sparse factor and @a _alpha remain double, the products are rounded to single precision.
+    void matrix_matrix_product( float* const _C,
+                                const size_t _leftDim,
+                                const size_t _rightDim,
+                                const double _alpha,
+                                const misc::FlatMap<size_t, double>& _A,
+                                const bool _transposeA,
+                                const size_t _midDim,
+                                const float* const _B,
+                                const bool _transposeB);
+    
+    ///@brief: Single precision variant, the sparse factor and @a _alpha remain double, the products are rounded to single precision.
+    void matrix_matrix_product( float* const _C,
+                                const size_t _leftDim,
+                                const size_t _rightDim,
+                                const double _alpha,
+                                const float* const _A,
+                                const bool _transposeA,
+                                const size_t _midDim,
+                                const misc::FlatMap<size_t, double>& _B,
                                 const bool _transposeB);
     
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - Mix to Sparse - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    void matrix_matrix_product( std::map<size_t, double>& _C,
+    void matrix_matrix_product( misc::FlatMap<size_t, double>& _C,
                                 const size_t _leftDim,
                                 const size_t _rightDim,
                                 const double _alpha,
-                                const std::map<size_t, double>& _A,
+                                const misc::FlatMap<size_t, double>& _A,
                                 const bool _transposeA,
                                 const size_t _midDim,
                                 const double* const _B,
                                 const bool _transposeB);
     
-    void matrix_matrix_product( std::map<size_t, double>& _C,
+    void matrix_matrix_product( misc::FlatMap<size_t, double>& _C,
                                 const size_t _leftDim,
                                 const size_t _rightDim,
                                 const double _alpha,
                                 const double* const _A,
                                 const bool _transposeA,
                                 const size_t _midDim,
-                                const std::map<size_t, double>& _B,
+                                const misc::FlatMap<size_t, double>& _B,
                                 const bool _transposeB);
 }
@@ -32,6 +32,7 @@
 
 #include "basic.h"
 #include "misc/containerSupport.h"
+#include "misc/flatMap.h"
 #include "misc/fileIO.h"
 #include "misc/random.h"
 
@@ -88,6 +89,15 @@ namespace xerus {
 		 */
 		enum class Representation : bool { Dense, Sparse };
 		
+		/** 
+		 * @brief Flags indicating the floating point precision of the entries of Tensor objects. 
+		 * @details Double means that the entries are stored as value_t. Single means that a dense float array is used instead, 
+		 * which halves memory and bandwidth of contractions, reshuffles and factorizations. Single precision is only available for 
+		 * dense tensors and the factor always remains a value_t. Operations that are not single precision aware (e.g. writing 
+		 * access to single entries) convert the tensor back to double precision.
+		 */
+		enum class Precision { Double, Single };
+		
 		///@brief: Represention of the dimensions of a Tensor.
 		typedef std::vector<size_t> DimensionTuple; // NOTE must not be declared as "using.." (internal segfault in gcc4.8.1)
 		
@@ -107,6 +117,9 @@ namespace xerus {
 		/// @brief The current representation of the Tensor (i.e Dense or Sparse)
 		Representation representation = Representation::Sparse;
 		
+		/// @brief The current precision of the Tensor (i.e Double or Single), Single implies a dense representation.
+		Precision precision = Precision::Double;
+		
 	private:
 		/** 
 		 * @brief Shared pointer to the dense data array, if representation is dense. 
@@ -117,10 +130,16 @@ namespace xerus {
 		
 		/** 
 		 * @brief Shared pointer to the a map containing the non-zero entries, if representation is Sparse. 
-		 * @details The entries are stored in a map which uses the position of each entry assuming row-major ordering as key value.
-		 * If the tensor is modified and not sole owner a deep copy is performed.
+		 * @details The entries are stored in a FlatMap, i.e. a contiguous array of (position, value) pairs sorted by the position 
+		 * of each entry assuming row-major ordering. If the tensor is modified and not sole owner a deep copy is performed.
 		 */
-		std::shared_ptr<std::map<size_t, value_t>> sparseData;
+		std::shared_ptr<misc::FlatMap<size_t, value_t>> sparseData;
+		
+		/** 
+		 * @brief Shared pointer to the single precision dense data array, if representation is dense and precision is single. 
+		 * @details Stored in the same order as denseData, which is not allocated in this case.
+		 */
+		std::shared_ptr<float> singleData;
 		
 	public:
 		/*- - - - - - - - - - - - - - - - - - - - - - - - - - Constructors - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
@@ -296,8 +315,13 @@ namespace xerus {
 			XERUS_REQUIRE(_N <= result.size, " Cannot create " << _N << " non zero entries in a tensor with only " << result.size << " total entries!");
 			
 			std::uniform_int_distribution<size_t> entryDist(0, result.size-1);
+			result.sparseData->reserve(_N);
 			while(result.sparseData->size() < _N) {
-				result.sparseData->emplace(entryDist(_rnd), _dist(_rnd));
+				for(size_t i = result.sparseData->size(); i < _N; ++i) {
+					const size_t position = entryDist(_rnd);
+					result.sparseData->emplace_back_unsorted(position, _dist(_rnd));
+				}
+				result.sparseData->sort_and_combine_duplicates([](value_t&, const value_t&){});
 			}
 			return result;
 		}
@@ -405,6 +429,9 @@ namespace xerus {
 		/// @brief Returns whether the current representation is sparse.
 		bool is_sparse() const;
 		
+		/// @brief Returns whether the entries are stored in single precision (which implies a dense representation).
+		bool is_single_precision() const;
+		
 		/** 
 		 * @brief Returns the number currently saved entries. 
 		 * @details Note that this is not nessecarily the number of non-zero entries as the saved entries may contain
@@ -447,7 +474,8 @@ namespace xerus {
 		/*- - - - - - - - - - - - - - - - - - - - - - - - - - Basic arithmetics - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
 		/** 
 		 * @brief Adds the @a _other Tensor entrywise to this one.
-		 * @details To be well-defined it is required that the dimensions of this and @a _other coincide.
+		 * @details To be well-defined it is required that the dimensions of this and @a _other coincide. This Tensor keeps its precision, 
+		 * i.e. @a _other is rounded to single precision or widened to double precision if necessary.
 		 * @param _other the Tensor to be added to this one.
 		 * @return a reference to this Tensor.
 		 */
@@ -455,7 +483,7 @@ namespace xerus {
 		
 		/** 
 		 * @brief Subtracts the @a _other Tensor entrywise from this one.
-		 * @details To be well-defined it is required that the dimensions of this and @a _other coincide.
+		 * @details To be well-defined it is required that the dimensions of this and @a _other coincide. This Tensor keeps its precision, cf. operator+=().
 		 * @param _other the Tensor to be subtracted to this one.
 		 * @return a reference to this Tensor.
 		 */
@@ -482,6 +510,8 @@ namespace xerus {
 		
 		/** 
 		 * @brief Read/Write access a single entry.
+		 * @details For sparse Tensors creating a new entry is only cheap if its position is larger than all existing ones, otherwise it 
+		 * is linear in the number of entries. To fill a sparse Tensor in random order use get_sparse_data() with misc::FlatMap::emplace_back_unsorted() instead.
 		 * @param _position the position of the desired entry, assuming row-major ordering.
 		 * @return a reference to the selected entry.
 		 */
@@ -562,12 +592,36 @@ namespace xerus {
 		 */
 		const std::shared_ptr<value_t>& get_internal_dense_data();
 		
+		/** 
+		 * @brief Gives access to the internal single precision data pointer, without any checks.
+		 * @details The tensor must use single precision. The data may be shared with other tensors and has to be interpreted considering 
+		 * the global factor. The tensor data itself is stored in row-major ordering.
+		 * @return pointer to the internal single precision data array.
+		 */
+		float* get_unsanitized_single_data();
+		
+		/** 
+		 * @brief Gives access to the internal single precision data pointer, without any checks.
+		 * @details The tensor must use single precision. The data may be shared with other tensors and has to be interpreted considering 
+		 * the global factor. The tensor data itself is stored in row-major ordering.
+		 * @return pointer to the internal single precision data array.
+		 */
+		const float* get_unsanitized_single_data() const;
+		
+		/** 
+		 * @brief Returns a pointer to the internal single precision data array for complete rewrite purpose ONLY.
+		 * @details This is equivalent to calling reset() with the current dimensions and a new uninitialized float array and then
+		 * calling get_unsanitized_single_data().
+		 * @return pointer to the internal single precision data array.
+		 */
+		float* override_single_data();
+		
 		/** 
 		 * @brief Returns a reference for direct access to the sparse data map. 
 		 * @details Also takes care that this direct access is safe, i.e. that this tensor is using a dense representation, is the sole owner of the data and that no non trivial factor exists.
 		 * @return reference to the sparse data map.
 		 */
-		std::map<size_t, value_t>& get_sparse_data();
+		misc::FlatMap<size_t, value_t>& get_sparse_data();
 		
 		/** 
 		 * @brief Gives access to the internal sparse map, without any checks.
@@ -575,7 +629,7 @@ namespace xerus {
 		 * may shared with other tensors or has to be interpreted considering a gloal factor. Both can be avoid if using get_sparse_data().
 		 * @return reference to the internal sparse data map.
 		 */
-		std::map<size_t, value_t>& get_unsanitized_sparse_data();
+		misc::FlatMap<size_t, value_t>& get_unsanitized_sparse_data();
 		
 		/** 
 		 * @brief Gives access to the internal sparse map, without any checks.
@@ -583,15 +637,16 @@ namespace xerus {
 		 * may shared with other tensors or has to be interpreted considering a gloal factor. Both can be avoid if using get_sparse_data().
 		 * @return reference to the internal sparse data map.
 		 */
-		const std::map<size_t, value_t>& get_unsanitized_sparse_data() const;
+		const misc::FlatMap<size_t, value_t>& get_unsanitized_sparse_data() const;
 		
 		/** 
 		 * @brief Returns a pointer to the internal sparse data map for complete rewrite purpose ONLY.
 		 * @details This is equivalent to calling reset() with the current dimensions, sparse representation and no initialisation and then
-		 * calling get_unsanitized_sparse_data().
+		 * calling get_unsanitized_sparse_data(). The data is best filled using FlatMap::emplace_back() in ascending order of the positions, 
+		 * or using FlatMap::emplace_back_unsorted() followed by FlatMap::sort_and_sum_duplicates().
 		 * @return reference to the internal sparse data map.
 		 */
-		std::map<size_t, value_t>& override_sparse_data();
+		misc::FlatMap<size_t, value_t>& override_sparse_data();
 		
 		/** 
 		 * @brief Gives access to the internal shared sparse data pointer, without any checks.
@@ -599,7 +654,7 @@ namespace xerus {
 		 * may shared with other tensors or has to be interpreted considering a gloal factor. Both can be avoid if using get_sparse_data().
 		 * @return The internal shared pointer to the sparse data map.
 		 */
-		const std::shared_ptr<std::map<size_t, value_t>>& get_internal_sparse_data();
+		const std::shared_ptr<misc::FlatMap<size_t, value_t>>& get_internal_sparse_data();
 		
 		
 		/*- - - - - - - - - - - - - - - - - - - - - - - - - - Indexing - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
@@ -673,6 +728,7 @@ namespace xerus {
 		
 		/** 
 		 * @brief Resets the tensor to the given dimensions, preserving the current representation.
+		 * @details Single precision tensors are reset to double precision.
 		 * @param _newDim the dimensions of the new tensor.
 		 * @param _init (optional) data treatment, i.e. whether the tensor shall be zero initialized.
 		 */
@@ -700,10 +756,18 @@ namespace xerus {
 		void reset(DimensionTuple _newDim, std::unique_ptr<value_t[]>&& _newData);
 		
 		
+		/** 
+		 * @brief Resets the tensor to the given dimensions with single precision data @a _newData.
+		 * @param _newDim the dimensions of the new tensor.
+		 * @param _newData new dense data in row-major order.
+		 */
+		void reset(DimensionTuple _newDim, std::unique_ptr<float[]>&& _newData);
+		
+		
 		/**
 		 * @brief Resets the tensor to a given dimensionstuple with sparse data @a _newData
 		 */
-		void reset(DimensionTuple _newDim, std::map<size_t, value_t>&& _newData);
+		void reset(DimensionTuple _newDim, misc::FlatMap<size_t, value_t>&& _newData);
 		
 		
 		/** 
@@ -814,6 +878,19 @@ namespace xerus {
 		 */
 		void use_sparse_representation(const value_t _eps = std::numeric_limits<value_t>::epsilon());
 		
+		
+		/** 
+		 * @brief Converts the Tensor to a dense representation in single precision.
+		 * @details The entries are rounded to float, the factor is kept as is.
+		 */
+		void use_single_precision();
+		
+		
+		/** 
+		 * @brief Converts the Tensor back to double precision, the representation stays dense.
+		 */
+		void use_double_precision();
+		
 		/*- - - - - - - - - - - - - - - - - - - - - - - - - - Miscellaneous - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
 		
 		/** 
@@ -837,10 +914,10 @@ namespace xerus {
 		static void plus_minus_equal(Tensor& _me, const Tensor& _other);
 		
 		/// @brief Adds the given sparse data to the given full data
-		static void add_sparse_to_full(const std::shared_ptr<value_t>& _denseData, const value_t _factor, const std::shared_ptr<const std::map<size_t, value_t>>& _sparseData);
+		static void add_sparse_to_full(const std::shared_ptr<value_t>& _denseData, const value_t _factor, const std::shared_ptr<const misc::FlatMap<size_t, value_t>>& _sparseData);
 		
 		/// @brief Adds the given sparse data to the given sparse data
-		static void add_sparse_to_sparse(const std::shared_ptr<std::map<size_t, value_t>>& _sum, const value_t _factor, const std::shared_ptr<const std::map<size_t, value_t>>& _summand);
+		static void add_sparse_to_sparse(const std::shared_ptr<misc::FlatMap<size_t, value_t>>& _sum, const value_t _factor, const std::shared_ptr<const misc::FlatMap<size_t, value_t>>& _summand);
 		
 	public:
 		
@@ -1061,6 +1138,8 @@ namespace xerus {
 	namespace misc {
 		/**
 		* @brief pipes all information necessary to restore the current tensor into @a _stream.
+		* @details In the binary format sparse data is written in blocks of separate index and value arrays, where the indices are 
+		* stored as varint encoded differences to their predecessors.
 		* @note that this excludes header information
 		*/
 		void stream_writer(std::ostream &_stream, const Tensor &_obj, const FileFormat _format);
@@ -496,6 +496,14 @@ namespace xerus {
 		double contraction_cost(const size_t _nodeId1, const size_t _nodeId2) const;
 		
 		
+		/** 
+		* @brief Returns the number of (stored) non-zero entries of a node, i.e. its size if it is dense or has no Tensor object.
+		* @param _nodeId id of the node.
+		* @return The number of non-zero entries, as used by the contraction heuristics.
+		*/
+		double node_sparsity(const size_t _nodeId) const;
+		
+		
 		/**
 		 * @brief Contracts the nodes with with indices included in the given set @a _ids.
 		 * @details Erases all nodes but one, which id is returned.
@@ -37,6 +37,12 @@
 #include "indexedTensorList.h"
 
 namespace xerus {
+	/// @brief Algorithms available to TTNetwork::round().
+	enum class RoundingMode {
+		Sweep, ///< Canonicalize and truncate the bonds one after another by SVDs, i.e. the TT-SVD. This is the default.
+		Gram ///< Truncate all bonds independently, using the eigendecompositions of the Gram matrices of the left and right interfaces.
+	};
+	
 	/**
 	* @brief Specialized TensorNetwork class used to represent TTTensor and TToperators.
 	* @details TTTensors correspond to isOperator=FALSE and TTOperators correspond to isOperator=FALSE.
@@ -335,6 +341,18 @@ namespace xerus {
 		void set_component(const size_t _idx, Tensor _T);
 		
 		
+		/**
+		* @brief Evaluates the TTNetwork at a batch of positions.
+		* @details Equivalent to calling operator[] for every position, but instead of contracting a network per entry the 
+		* components are applied from left to right to the whole batch at once. In each step the partial products of all positions that 
+		* share the same slice of the component are stored contiguously and multiplied with this slice by a single matrix-matrix product.
+		* Large batches are split over several threads.
+		* @param _positions the multi-indices to evaluate. For TTOperators the row indices come first, followed by the column indices.
+		* @returns the entries at the given positions, in the same order.
+		*/
+		std::vector<value_t> evaluate_batch(const std::vector<Tensor::MultiIndex>& _positions) const;
+		
+		
 		/** 
 		* @brief Splits the TTNetwork into two parts by removing the node.
 		* @param _position index of the component to be removed, thereby also defining the position 
@@ -352,6 +370,19 @@ namespace xerus {
 		void round(const std::vector<size_t>& _maxRanks, const double _eps = EPSILON);
 		
 		
+		/** 
+		* @brief Reduce all ranks up to a given accuracy and maximal number, using the given algorithm.
+		* @details RoundingMode::Gram computes the Gram matrices of all left and right interfaces (one sweep in each direction, run 
+		* concurrently) and then truncates every bond independently from the eigendecompositions of its two (small) Gram matrices. 
+		* The result is not canonicalized unless the TTNetwork was before. It is quasi-optimal like the TT-SVD, but as the Gram matrices 
+		* square the singular values, singular values below roughly sqrt(EPSILON) times the largest one cannot be resolved.
+		* @param _maxRanks maximal allowed ranks. All current ranks that are larger than the given ones are reduced by truncation.
+		* @param _eps the accuracy to use for truncation in the individual SVDs.
+		* @param _mode the algorithm to use.
+		*/
+		void round(const std::vector<size_t>& _maxRanks, const double _eps, const RoundingMode _mode);
+		
+		
 		/** 
 		* @brief Reduce all ranks to the given number.
 		* @param _maxRank maximal allowed rank. All current ranks that are larger than this are reduced by truncation.
@@ -582,6 +613,21 @@ namespace xerus {
 	template<bool isOperator>
 	TTNetwork<isOperator> entrywise_product(const TTNetwork<isOperator>& _A, const TTNetwork<isOperator>& _B);
 	
+	
+	/**
+	* @brief Calculates the componentwise product of two tensors given in the TT format, truncated to the given ranks and accuracy.
+	* @details The cores of rank rank(A)*rank(B) are never formed. Instead the product is assembled from left to right with the 
+	* truncated remainder of the previous positions (zip-up), such that at each position only the slices of the two cores are multiplied 
+	* with the carried matrix and the result is directly truncated by an SVD. The result is rounded once more in the end and has its core 
+	* at the last component.
+	* @param _A, _B the factors.
+	* @param _maxRanks the maximal ranks of the result.
+	* @param _eps the accuracy of the truncations.
+	* @return the truncated entrywise product.
+	*/
+	template<bool isOperator>
+	TTNetwork<isOperator> entrywise_product(const TTNetwork<isOperator>& _A, const TTNetwork<isOperator>& _B, const std::vector<size_t>& _maxRanks, const double _eps = EPSILON);
+	
 	/** 
 	 * @brief Computes the dyadic product of @a _lhs and @a _rhs. 
 	 * @details This function is currently needed to keep the resulting network in the TTNetwork class.
@@ -601,6 +647,32 @@ namespace xerus {
 	TTNetwork<isOperator> dyadic_product(const std::vector<TTNetwork<isOperator>> &_tensors);
 	
 	
+	/**
+	 * @brief Calculates the product of the TTOperator @a _A with @a _x, truncated to the given ranks and accuracy.
+	 * @details Instead of forming the product with ranks rank(A)*rank(x) and rounding it afterwards, the components of the product are 
+	 * formed from left to right and truncated by an SVD right away (zip-up): the left singular vectors become the component, the remainder 
+	 * is carried to the next position. The untruncated product is thus only formed for a single position at a time. The truncations use 
+	 * a tenth of @a _eps, the final result is rounded once more (which is cheap as its ranks are already bounded) and has its core at the last component.
+	 * @note As the truncations do not see an orthogonalized right part of the product, the result may be slightly less accurate than the 
+	 * rounded exact product.
+	 * @param _A the operator to apply.
+	 * @param _x the TTTensor or TTOperator it is applied to, i.e. the result is A(i/2, j/2)*x(j&0).
+	 * @param _maxRanks the maximal ranks of the result.
+	 * @param _eps the accuracy of the truncations.
+	 * @return the truncated product.
+	 */
+	template<bool isOperator>
+	TTNetwork<isOperator> apply_and_round(const TTOperator& _A, const TTNetwork<isOperator>& _x, const std::vector<size_t>& _maxRanks, const double _eps = EPSILON);
+	
+	
+	/**
+	 * @brief Calculates the product of the TTOperator @a _A with @a _x, truncated to the given maximal rank.
+	 * @details See apply_and_round(const TTOperator&, const TTNetwork<isOperator>&, const std::vector<size_t>&, const double).
+	 */
+	template<bool isOperator>
+	TTNetwork<isOperator> apply_and_round(const TTOperator& _A, const TTNetwork<isOperator>& _x, const size_t _maxRank, const double _eps = EPSILON);
+	
+	
 	namespace misc {
 		
 		/**
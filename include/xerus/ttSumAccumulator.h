@@ -0,0 +1,99 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+/**
+* @file
+* @brief Header file for the TTSumAccumulator class.
+*/
+
+#pragma once
+
+#include "ttNetwork.h"
+
+namespace xerus {
+	/**
+	* @brief Accumulates (weighted) sums of many TTTensors while keeping the ranks bounded.
+	* @details The sum is reduced pairwise: the accumulator stores at most one partial sum of 2^l added tensors for every level l, each rounded 
+	* to the given maximal ranks and accuracy. A new tensor is merged with the occupied levels from the lowest one upwards, i.e. like the carry 
+	* in a binary counter, so that after k additions at most log2(k)+1 partial sums of bounded rank are stored. Every tensor takes part in at 
+	* most log2(k) roundings, and every rounding only involves the sum of two tensors of bounded rank.
+	*/
+	class TTSumAccumulator final {
+	private:
+		///@brief The dimensions of the summed tensors.
+		std::vector<size_t> dimensions;
+		
+		///@brief The maximal ranks used for all roundings.
+		std::vector<size_t> maxRanks;
+		
+		///@brief The accuracy used for all roundings.
+		double eps;
+		
+		///@brief The algorithm used for all roundings.
+		RoundingMode roundingMode;
+		
+		///@brief The number of added tensors, its binary digits indicate which partialSums are in use.
+		size_t numAdded;
+		
+		///@brief partialSums[l] contains the rounded sum of 2^l added tensors, if the l-th binary digit of numAdded is set.
+		std::vector<TTTensor> partialSums;
+		
+	public:
+		/**
+		* @brief Creates an empty accumulator for TTTensors with the given dimensions.
+		* @param _dimensions the dimensions of the tensors to be summed.
+		* @param _maxRanks the maximal ranks of all partial sums, must contain degree-1 entries.
+		* @param _eps the accuracy used in the roundings of the partial sums.
+		* @param _mode the algorithm used to round the partial sums.
+		*/
+		TTSumAccumulator(std::vector<size_t> _dimensions, std::vector<size_t> _maxRanks, const double _eps = EPSILON, const RoundingMode _mode = RoundingMode::Sweep);
+		
+		
+		/**
+		* @brief Creates an empty accumulator for TTTensors with the given dimensions, using the same maximal rank for all partial sums.
+		* @details See TTSumAccumulator(std::vector<size_t>, std::vector<size_t>, const double, const RoundingMode).
+		*/
+		TTSumAccumulator(std::vector<size_t> _dimensions, const size_t _maxRank, const double _eps = EPSILON, const RoundingMode _mode = RoundingMode::Sweep);
+		
+		
+		/**
+		* @brief Adds @a _weight * @a _x to the sum.
+		* @param _x the tensor to add, must have the dimensions of the accumulator.
+		* @param _weight the scalar factor of @a _x.
+		*/
+		void add(const TTTensor& _x, const value_t _weight = 1.0);
+		
+		
+		/**
+		* @brief Returns the rounded sum of all added tensors.
+		* @details The partial sums are combined from the lowest level upwards and rounded after each step. The accumulator is not modified, 
+		* i.e. further tensors may be added afterwards.
+		*/
+		TTTensor sum() const;
+		
+		
+		///@brief Returns the number of tensors added so far.
+		size_t count() const;
+		
+		
+		///@brief Removes all added tensors.
+		void clear();
+	};
+}
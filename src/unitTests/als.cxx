@@ -102,6 +102,164 @@ static misc::UnitTest als_proj("ALS", "projectionALS", [](){
 	TEST(misc::approx_equal(frob_norm(B), normB, 0.));
 });
 
+static misc::UnitTest als_cg("ALS", "cg_local_solver", []() {
+	Index k,l,m;
+	
+	TTOperator A = TTOperator::random({6, 6, 6, 6, 6, 6, 6, 6}, {3,3,3});
+	TTOperator ASym;
+	ASym(k/2,l/2) = A(k/2,m/2) * A(l/2,m/2);
+	TTTensor realX = TTTensor::random({6, 6, 6, 6}, {2,2,2});
+	TTTensor b;
+	b(k&0) = ASym(k/2,l/2)*realX(l&0);
+	
+	for (const ALSVariant &variant : {ALS_SPD, DMRG_SPD, ALS}) {
+		ALSVariant cgVariant(variant);
+		cgVariant.localSolver = ALSVariant::cg_solver;
+		cgVariant.useResidualForEndCriterion = true;
+		
+		TTTensor lapackX = TTTensor::random(realX.dimensions, realX.ranks());
+		TTTensor cgX = lapackX;
+		
+		const value_t lapackResidual = variant(ASym, lapackX, b, 1e-9);
+		const value_t cgResidual = cgVariant(ASym, cgX, b, 1e-9);
+		MTEST(cgResidual < 1e-6, variant.sites << " " << variant.assumeSPD << ": " << cgResidual << " vs lapack " << lapackResidual);
+		MTEST(frob_norm(cgX - realX)/frob_norm(realX) < 1e-4, variant.sites << " " << variant.assumeSPD << ": " << frob_norm(cgX - realX)/frob_norm(realX));
+	}
+});
+
+
+static misc::UnitTest als_single("ALS", "single_precision", []() {
+	Index k,l,m;
+	
+	TTOperator A = TTOperator::random({6, 6, 6, 6, 6, 6, 6, 6}, {3,3,3});
+	TTOperator ASym;
+	ASym(k/2,l/2) = A(k/2,m/2) * A(l/2,m/2);
+	TTTensor realX = TTTensor::random({6, 6, 6, 6}, {2,2,2});
+	TTTensor b;
+	b(k&0) = ASym(k/2,l/2)*realX(l&0);
+	
+	// the components of x stay in single precision, the stacks are updated with single precision products
+	for (const ALSVariant &variant : {ALS_SPD, DMRG_SPD, ALS}) {
+		ALSVariant ourALS(variant);
+		ourALS.useResidualForEndCriterion = true;
+		
+		TTTensor x = TTTensor::random(realX.dimensions, realX.ranks());
+		for (size_t i = 0; i < x.degree(); ++i) {
+			x.component(i).use_single_precision();
+		}
+		
+		const value_t residual = ourALS(ASym, x, b, 1e-6);
+		for (size_t i = 0; i < x.degree(); ++i) {
+			MTEST(x.get_component(i).is_single_precision(), variant.sites << " " << variant.assumeSPD << ": " << i);
+		}
+		MTEST(residual < 1e-3, variant.sites << " " << variant.assumeSPD << ": " << residual);
+		MTEST(frob_norm(x - realX)/frob_norm(realX) < 1e-3, variant.sites << " " << variant.assumeSPD << ": " << frob_norm(x - realX)/frob_norm(realX));
+	}
+	
+	// an operator in single precision, its rounding error is amplified by the condition of ASym
+	TTOperator singleASym(ASym);
+	for (size_t i = 0; i < singleASym.degree()/2; ++i) {
+		singleASym.component(i).use_single_precision();
+	}
+	TTTensor x = TTTensor::random(realX.dimensions, realX.ranks());
+	ALS_SPD(singleASym, x, b, size_t(20));
+	MTEST(frob_norm(x - realX)/frob_norm(realX) < 1e-3, frob_norm(x - realX)/frob_norm(realX));
+});
+
+
+static misc::UnitTest als_threads("ALS", "parallel_stacks", []() {
+	Index k,l,m;
+	
+	// the first and last components are of full rank, so the left stacks are not empty initially
+	TTOperator A = TTOperator::random({2, 6, 6, 6, 6, 2, 2, 6, 6, 6, 6, 2}, {3,3,3,3,3});
+	TTOperator ASym;
+	ASym(k/2,l/2) = A(k/2,m/2) * A(l/2,m/2);
+	const TTTensor b = TTTensor::random({2, 6, 6, 6, 6, 2}, {2,3,3,3,2});
+	const TTTensor initialX = TTTensor::random(b.dimensions, b.ranks());
+	
+	const size_t oldMaxThreads = misc::maxThreads;
+	const size_t oldMinWork = misc::minWorkPerThread;
+	for (const ALSVariant &variant : {ALS_SPD, ALS}) {
+		const TTOperator &op = variant.assumeSPD ? ASym : A;
+	
+		misc::maxThreads = 1;
+		TTTensor sequentialX = initialX;
+		const value_t sequentialResidual = variant(op, sequentialX, b, size_t(4));
+	
+		misc::maxThreads = 4;
+		misc::minWorkPerThread = 1;
+		TTTensor parallelX = initialX;
+		const value_t parallelResidual = variant(op, parallelX, b, size_t(4));
+		misc::minWorkPerThread = oldMinWork;
+	
+		MTEST(misc::approx_equal(sequentialResidual, parallelResidual, 1e-10), variant.assumeSPD << ": " << sequentialResidual << " vs " << parallelResidual);
+		MTEST(frob_norm(sequentialX - parallelX)/frob_norm(sequentialX) < 1e-10, variant.assumeSPD << ": " << frob_norm(sequentialX - parallelX)/frob_norm(sequentialX));
+	}
+	misc::maxThreads = oldMaxThreads;
+});
+
+
+static misc::UnitTest als_eigen("ALS", "eigen", []() {
+	Index k,l;
+	const size_t d = 4, n = 4;
+	
+	// A = sum_s I x ... x L_s x ... x I has rank one eigenvectors, its eigenvalues are the sums of eigenvalues of the L_s
+	std::vector<Tensor> L(d);
+	for (size_t s = 0; s < d; ++s) {
+		const Tensor R = Tensor::random({n, n});
+		L[s](k,l) = R(k,l) + R(l,k);
+	}
+	Tensor fullA(Tensor::DimensionTuple(2*d, n), [&](const std::vector<size_t> &_idx) {
+		value_t result = 0.0;
+		for (size_t s = 0; s < d; ++s) {
+			bool identity = true;
+			for (size_t t = 0; t < d; ++t) {
+				if (t != s && _idx[t] != _idx[t+d]) {
+					identity = false;
+				}
+			}
+			if (identity) {
+				result += L[s][{_idx[s], _idx[s+d]}];
+			}
+		}
+		return result;
+	});
+	const size_t N = misc::pow(n, d);
+	std::vector<value_t> realEigenvalues(N), realEigenvectors(N*N);
+	blasWrapper::symmetric_eigen_decomposition(realEigenvectors.data(), realEigenvalues.data(), fullA.get_dense_data(), N);
+	const TTOperator A(fullA);
+	
+	for (const ALSVariant &variant : {ALS_SPD, DMRG_SPD}) {
+		ALSVariant eigenVariant(variant);
+		eigenVariant.convergenceEpsilon = 1e-12;
+		eigenVariant.numHalfSweeps = 100;
+		
+		TTTensor x = TTTensor::random(std::vector<size_t>(d, n), std::vector<size_t>(d-1, 2));
+		const value_t lambda = eigenVariant.eigen(A, x);
+		TTTensor residual;
+		residual(k&0) = A(k/2,l/2)*x(l&0) - lambda*x(k&0);
+		MTEST(std::abs(lambda - realEigenvalues[0]) < 1e-8*std::abs(realEigenvalues[0]), variant.sites << ": " << lambda << " vs " << realEigenvalues[0]);
+		MTEST(frob_norm(residual) < 1e-6*std::abs(lambda), variant.sites << ": " << frob_norm(residual));
+		MTEST(misc::approx_equal(frob_norm(x), 1.0, 1e-10), variant.sites << ": " << frob_norm(x));
+		
+		std::vector<TTTensor> xs;
+		for (size_t c = 0; c < 3; ++c) {
+			xs.push_back(TTTensor::random(std::vector<size_t>(d, n), std::vector<size_t>(d-1, 4)));
+		}
+		const std::vector<value_t> lambdas = eigenVariant.eigen(A, xs);
+		TEST(lambdas.size() == 3);
+		for (size_t c = 0; c < 3; ++c) {
+			residual(k&0) = A(k/2,l/2)*xs[c](l&0) - lambdas[c]*xs[c](k&0);
+			MTEST(std::abs(lambdas[c] - realEigenvalues[c]) < 1e-8*std::abs(realEigenvalues[c]), variant.sites << " " << c << ": " << lambdas[c] << " vs " << realEigenvalues[c]);
+			MTEST(frob_norm(residual) < 1e-6*std::abs(lambdas[c]), variant.sites << " " << c << ": " << frob_norm(residual));
+			for (size_t c2 = 0; c2 < c; ++c2) {
+				MTEST(std::abs(value_t(xs[c](k&0)*xs[c2](k&0))) < 1e-8, variant.sites << " " << c << " " << c2);
+			}
+		}
+	}
+});
+
+
 #include <iomanip>
 #include <fstream>
 /*
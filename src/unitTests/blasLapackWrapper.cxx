@@ -0,0 +1,109 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+#include<xerus.h>
+
+#include "../../include/xerus/test/test.h"
+#include "../../include/xerus/misc/internal.h"
+
+using namespace xerus;
+
+static misc::UnitTest blas_single("BlasWrapper", "single_precision_blas", [](){
+	const size_t m = 37, n = 53, k = 41;
+	Tensor A = Tensor::random({m, k});
+	Tensor B = Tensor::random({k, n});
+	Tensor C({m, n}, Tensor::Representation::Dense);
+	Index i, j, l;
+	C(i,j) = A(i,l) * B(l,j);
+	
+	std::vector<float> Af(A.get_dense_data(), A.get_dense_data()+m*k);
+	std::vector<float> Bf(B.get_dense_data(), B.get_dense_data()+k*n);
+	std::vector<float> Cf(m*n);
+	blasWrapper::matrix_matrix_product(Cf.data(), m, n, 1.0f, Af.data(), false, k, Bf.data(), false);
+	double error = 0.0;
+	for (size_t x = 0; x < m*n; ++x) {
+		error += misc::sqr(double(Cf[x]) - C[x]);
+	}
+	MTEST(std::sqrt(error) < 1e-5*frob_norm(C), std::sqrt(error)/frob_norm(C));
+	MTEST(std::abs(blasWrapper::two_norm(Cf.data(), m*n) - frob_norm(C)) < 1e-5*frob_norm(C), blasWrapper::two_norm(Cf.data(), m*n) << " vs " << frob_norm(C));
+	
+	// Mixed precision: the accumulation is done in double, so small summands are not lost
+	std::vector<float> x(1001, 1.0f), y(1001, 1.0f);
+	x[0] = 1e8f;
+	MTEST(std::abs(blasWrapper::dot_product(x.data(), 1001, y.data()) - 100001000.0) < 0.5, blasWrapper::dot_product(x.data(), 1001, y.data()));
+	
+	// Single precision eigendecomposition of a symmetric matrix
+	std::vector<float> S(k*k), V(k*k), lambda(k);
+	for (size_t a = 0; a < k; ++a) {
+		for (size_t b = 0; b < k; ++b) {
+			S[a*k+b] = float(A[a]*A[b]) + (a == b ? 1.0f : 0.0f);
+		}
+	}
+	blasWrapper::symmetric_eigen_decomposition(V.data(), lambda.data(), S.data(), k);
+	double residual = 0.0;
+	for (size_t a = 0; a < k; ++a) {
+		for (size_t b = 0; b < k; ++b) {
+			double entry = 0.0;
+			for (size_t c = 0; c < k; ++c) {
+				entry += double(V[a*k+c])*double(lambda[c])*double(V[b*k+c]);
+			}
+			residual += misc::sqr(entry - double(S[a*k+b]));
+		}
+	}
+	MTEST(std::sqrt(residual) < 1e-4*blasWrapper::two_norm(S.data(), k*k), std::sqrt(residual));
+});
+
+static misc::UnitTest blas_single_lapack("BlasWrapper", "single_precision_lapack", [](){
+	const size_t m = 29, n = 17;
+	Tensor A = Tensor::random({m, n});
+	const std::vector<float> Af(A.get_dense_data(), A.get_dense_data()+m*n);
+	
+	// Calculates the relative error of the product of the given float matrices w.r.t. A.
+	const auto product_error = [&](const std::vector<float>& _lhs, const std::vector<float>& _rhs, const size_t _rank) {
+		double error = 0.0;
+		for (size_t a = 0; a < m; ++a) {
+			for (size_t b = 0; b < n; ++b) {
+				double entry = 0.0;
+				for (size_t c = 0; c < _rank; ++c) {
+					entry += double(_lhs[a*_rank+c])*double(_rhs[c*n+b]);
+				}
+				error += misc::sqr(entry - A[a*n+b]);
+			}
+		}
+		return std::sqrt(error)/frob_norm(A);
+	};
+	
+	std::vector<float> U(m*n), S(n), Vt(n*n);
+	blasWrapper::svd(U.data(), S.data(), Vt.data(), Af.data(), m, n);
+	for (size_t a = 0; a < n; ++a) {
+		misc::scale(Vt.data()+a*n, S[a], n);
+	}
+	MTEST(product_error(U, Vt, n) < 1e-5, product_error(U, Vt, n));
+	
+	std::vector<float> Q(m*n), R(n*n);
+	blasWrapper::qr(Q.data(), R.data(), Af.data(), m, n);
+	MTEST(product_error(Q, R, n) < 1e-5, product_error(Q, R, n));
+	
+	std::unique_ptr<float[]> Qc, C;
+	size_t rank;
+	std::tie(Qc, C, rank) = blasWrapper::qc(Af.data(), m, n);
+	TEST(rank == n);
+	MTEST(product_error(std::vector<float>(Qc.get(), Qc.get()+m*rank), std::vector<float>(C.get(), C.get()+rank*n), rank) < 1e-5, rank);
+});
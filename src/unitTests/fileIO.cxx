@@ -50,6 +50,46 @@ static misc::UnitTest tensor_rw("Tensor", "read_write_file", [](){
 	MTEST(frob_norm(S - Ab) < 1e-16, "sparse tsv " << frob_norm(S-Ab));
 });
 
+static misc::UnitTest tensor_rw_sparse_blocks("Tensor", "read_write_sparse_blocks", [](){
+	// Enough entries for several blocks, with small and large gaps between the positions
+	std::mt19937_64 &rnd = misc::randomEngine;
+	std::uniform_int_distribution<size_t> gapDist(1, 300);
+	Tensor S({1000,1000,1000}, Tensor::Representation::Sparse);
+	size_t position = 7;
+	for (size_t i = 0; i < 200000; ++i) {
+		S[position] = double(i%17) - 8.5;
+		position += (i%1000 == 0) ? 1000000 : gapDist(rnd);
+	}
+	S[S.size-1] = 1.0;
+	S *= 3.0;
+	
+	misc::save_to_file(S, "test.dat", misc::FileFormat::BINARY);
+	Tensor Sb = misc::load_from_file<Tensor>("test.dat");
+	TEST(Sb.is_sparse());
+	TEST(Sb.get_unsanitized_sparse_data().size() == S.get_unsanitized_sparse_data().size());
+	MTEST(frob_norm(S - Sb) < 1e-16, "sparse bin " << frob_norm(S-Sb));
+	
+	Tensor E({3,4}, Tensor::Representation::Sparse);
+	misc::save_to_file(E, "test.dat", misc::FileFormat::BINARY);
+	Tensor Eb = misc::load_from_file<Tensor>("test.dat");
+	TEST(Eb.is_sparse() && Eb.dimensions == E.dimensions && Eb.get_unsanitized_sparse_data().empty());
+	
+	// Streams with the entry by entry encoding can still be read
+	std::stringstream legacy;
+	misc::write_to_stream<size_t>(legacy, 1, misc::FileFormat::BINARY);
+	misc::write_to_stream(legacy, std::vector<size_t>({3,4}), misc::FileFormat::BINARY);
+	misc::write_to_stream<size_t>(legacy, 2, misc::FileFormat::BINARY);
+	misc::write_to_stream<size_t>(legacy, 2, misc::FileFormat::BINARY);
+	misc::write_to_stream<size_t>(legacy, 5, misc::FileFormat::BINARY);
+	misc::write_to_stream<value_t>(legacy, 2.0, misc::FileFormat::BINARY);
+	misc::write_to_stream<size_t>(legacy, 1, misc::FileFormat::BINARY);
+	misc::write_to_stream<value_t>(legacy, -1.0, misc::FileFormat::BINARY);
+	Tensor L;
+	misc::read_from_stream(legacy, L, misc::FileFormat::BINARY);
+	TEST(L.is_sparse() && L.dimensions == std::vector<size_t>({3,4}));
+	TEST(misc::approx_equal(L[1], -1.0) && misc::approx_equal(L[5], 2.0) && L.count_non_zero_entries() == 2);
+});
+
 static misc::UnitTest tn_rw("TensorNetwork", "read_write_file", [](){
 	Tensor A = Tensor::random({12,13,14});
 	Tensor B = Tensor({12,13,14}, Tensor::Representation::Sparse);
@@ -85,3 +125,89 @@ static misc::UnitTest tt_rw("TT", "read_write_file", [](){
 	MTEST(A.dimensions == Ab.dimensions, A.dimensions << " vs " << Ab.dimensions);
 	MTEST(frob_norm(A(i&0)-Ab(i&0))/frob_norm(A) < 6e-16, frob_norm(A(i&0)-Ab(i&0))/frob_norm(A));
 });
+
+
+static misc::UnitTest tensor_mapped("Tensor", "mapped_file", [](){
+	Tensor A = Tensor::random({12,13,14});
+	A *= 3.0;
+	
+	misc::save_to_mapped_file(A, "test.dat");
+	Tensor Ab = misc::load_from_mapped_file<Tensor>("test.dat");
+	TEST(Ab.is_dense());
+	MTEST(A.dimensions == Ab.dimensions, A.dimensions << " vs " << Ab.dimensions);
+	MTEST(frob_norm(A - Ab) < 1e-16, "dense mapped " << frob_norm(A-Ab));
+	
+	// The data is used in place and 64 byte aligned
+	TEST(reinterpret_cast<uintptr_t>(Ab.get_unsanitized_dense_data()) % 64 == 0);
+	
+	// Modifications neither affect the file nor other loaded instances
+	Ab[{1,2,3}] = 17.0;
+	Tensor Ac = misc::load_from_mapped_file<Tensor>("test.dat");
+	MTEST(frob_norm(A - Ac) < 1e-16, "dense mapped " << frob_norm(A-Ac));
+	
+	Tensor S({100,234,567}, Tensor::Representation::Sparse);
+	S[{5,7,99}] = 1; S[{80,123,5}] = 6; S[{1,2,3}] = 4; S[{99,233,566}] = 5;
+	S[{12,12,12}] = 8; S[{15,15,15}] = 7; S[{99,99,99}] = 3; S[{65,65,65}] = 2;
+	
+	misc::save_to_mapped_file(S, "test.dat");
+	Ab = misc::load_from_mapped_file<Tensor>("test.dat");
+	TEST(Ab.is_sparse());
+	MTEST(frob_norm(S - Ab) < 1e-16, "sparse mapped " << frob_norm(S-Ab));
+	
+	FAILTEST(misc::load_from_mapped_file<TTTensor>("test.dat"));
+	
+	// Corrupted positions are rejected
+	const auto corrupt_position = [&](const size_t _position, const size_t _newPosition) {
+		misc::save_to_mapped_file(S, "test.dat");
+		std::fstream file("test.dat", std::ios::in | std::ios::out | std::ios::binary);
+		const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		const uint64_t oldValue = _position, newValue = _newPosition;
+		const size_t offset = content.find(std::string(reinterpret_cast<const char*>(&oldValue), sizeof(uint64_t)), 64);
+		REQUIRE(offset != std::string::npos, "Position not found in the container.");
+		file.seekp(std::streamoff(offset));
+		file.write(reinterpret_cast<const char*>(&newValue), sizeof(uint64_t));
+	};
+	corrupt_position(99*234*567 + 233*567 + 566, S.size);
+	FAILTEST(misc::load_from_mapped_file<Tensor>("test.dat"));
+	corrupt_position(1*234*567 + 2*567 + 3, 99*234*567);
+	FAILTEST(misc::load_from_mapped_file<Tensor>("test.dat"));
+	
+	misc::save_to_file(S, "test.dat");
+	FAILTEST(misc::load_from_mapped_file<Tensor>("test.dat"));
+});
+
+
+static misc::UnitTest tt_mapped("TT", "mapped_file", [](){
+	Index i;
+	TTTensor A = TTTensor::random({7,8,9,10}, {2,3,2});
+	A.move_core(2);
+	
+	misc::save_to_mapped_file(A, "test.dat");
+	TTTensor Ab = misc::load_from_mapped_file<TTTensor>("test.dat");
+	Ab.require_correct_format();
+	MTEST(Ab.canonicalized && Ab.corePosition == 2, Ab.canonicalized << " " << Ab.corePosition);
+	MTEST(A.dimensions == Ab.dimensions, A.dimensions << " vs " << Ab.dimensions);
+	TEST(A.ranks() == Ab.ranks());
+	MTEST(frob_norm(A(i&0)-Ab(i&0))/frob_norm(A) < 6e-16, frob_norm(A(i&0)-Ab(i&0))/frob_norm(A));
+	
+	TTOperator B = TTOperator::random({2,3,4,2,3,4}, {3,2});
+	B.canonicalized = false;
+	
+	misc::save_to_mapped_file(B, "test.dat");
+	TTOperator Bb = misc::load_from_mapped_file<TTOperator>("test.dat");
+	Bb.require_correct_format();
+	TEST(!Bb.canonicalized);
+	MTEST(frob_norm(B(i&0)-Bb(i&0))/frob_norm(B) < 6e-16, frob_norm(B(i&0)-Bb(i&0))/frob_norm(B));
+	
+	// The loaded networks stay valid after the file is overwritten
+	TTTensor C = TTTensor::ones({2,2});
+	misc::save_to_mapped_file(C, "test.dat");
+	Ab.move_core(0);
+	MTEST(frob_norm(A(i&0)-Ab(i&0))/frob_norm(A) < 1e-14, frob_norm(A(i&0)-Ab(i&0))/frob_norm(A));
+	
+	TTTensor D(Tensor::ones({}));
+	D *= 2.0;
+	misc::save_to_mapped_file(D, "test.dat");
+	TTTensor Db = misc::load_from_mapped_file<TTTensor>("test.dat");
+	MTEST(Db.degree() == 0 && std::abs(Db[0] - 2.0) < 1e-16, Db.degree());
+});
@@ -360,3 +360,77 @@ static misc::UnitTest sparse_svd("Tensor", "SparseSVD", [](){
 	}
 });
 
+
+static misc::UnitTest tensor_single_precision("Tensor", "Single_Precision", [](){
+	Tensor A = Tensor::random({4,5,6,7});
+	Tensor As(A);
+	As.use_single_precision();
+	TEST(As.is_single_precision());
+	MTEST(approx_equal(As, A, 1e-6), frob_norm(As-A));
+	
+	Index i, j, k, l, m, n;
+	
+	// Dense and sparse products with a single precision factor are single precision
+	Tensor B = Tensor::random({6,7,3});
+	Tensor Bsparse = Tensor::random({6,7,3}, 20);
+	Tensor C, Cs;
+	C(i,j,k) = A(i,j,l,m)*B(l,m,k);
+	Cs(i,j,k) = As(i,j,l,m)*B(l,m,k);
+	TEST(Cs.is_single_precision());
+	MTEST(approx_equal(Cs, C, 1e-5), frob_norm(Cs-C)/frob_norm(C));
+	C(i,j,k) = A(i,j,l,m)*Bsparse(l,m,k);
+	Cs(i,j,k) = As(i,j,l,m)*Bsparse(l,m,k);
+	TEST(Cs.is_single_precision());
+	MTEST(approx_equal(Cs, C, 1e-5), frob_norm(Cs-C)/frob_norm(C));
+	C(k,i,j) = Bsparse(l,m,k)*A(i,j,l,m);
+	Cs(k,i,j) = Bsparse(l,m,k)*As(i,j,l,m);
+	TEST(Cs.is_single_precision());
+	MTEST(approx_equal(Cs, C, 1e-5), frob_norm(Cs-C)/frob_norm(C));
+	
+	// Reshuffles and factorisations keep the precision, only the singular values are double
+	Tensor U, S, Vt, Q, R, X;
+	(U(i,j,n), S(n,m), Vt(m,k,l)) = SVD(As(i,k,j,l));
+	TEST(U.is_single_precision() && Vt.is_single_precision() && !S.is_single_precision());
+	X(i,k,j,l) = U(i,j,n)*S(n,m)*Vt(m,k,l);
+	TEST(X.is_single_precision());
+	MTEST(approx_equal(X, A, 1e-5), frob_norm(X-A)/frob_norm(A));
+	
+	(Q(i,j,n), R(n,k,l)) = QR(As(i,j,k,l));
+	TEST(Q.is_single_precision() && R.is_single_precision());
+	X(i,j,k,l) = Q(i,j,n)*R(n,k,l);
+	MTEST(approx_equal(X, A, 1e-5), frob_norm(X-A)/frob_norm(A));
+	
+	(R(i,j,n), Q(n,k,l)) = RQ(As(i,j,k,l));
+	TEST(Q.is_single_precision() && R.is_single_precision());
+	X(i,j,k,l) = R(i,j,n)*Q(n,k,l);
+	MTEST(approx_equal(X, A, 1e-5), frob_norm(X-A)/frob_norm(A));
+	
+	(Q(i,j,n), R(n,k,l)) = QC(As(i,j,k,l));
+	TEST(Q.is_single_precision() && R.is_single_precision());
+	X(i,j,k,l) = Q(i,j,n)*R(n,k,l);
+	MTEST(approx_equal(X, A, 1e-5), frob_norm(X-A)/frob_norm(A));
+	
+	// Sums keep the precision of the tensor that is added to, single summands are widened exactly
+	Tensor AsDouble(As);
+	AsDouble.use_double_precision();
+	Tensor D(A);
+	D += As;
+	TEST(!D.is_single_precision());
+	MTEST(approx_equal(D, A + AsDouble, 1e-15), frob_norm(D - A - AsDouble));
+	Tensor Dsparse = Tensor::random({4,5,6,7}, 20);
+	Tensor E = Dsparse + AsDouble;
+	Dsparse += As;
+	TEST(!Dsparse.is_single_precision());
+	MTEST(approx_equal(Dsparse, E, 1e-15), frob_norm(Dsparse - E));
+	Tensor Ds(As);
+	Ds -= A;
+	TEST(Ds.is_single_precision());
+	MTEST(frob_norm(Ds) < 1e-6*frob_norm(A), frob_norm(Ds));
+	
+	// Writing access converts back to double precision
+	X[0] = A[0];
+	TEST(!X.is_single_precision());
+	As.use_double_precision();
+	TEST(!As.is_single_precision());
+	MTEST(approx_equal(As, A, 1e-6), frob_norm(As-A));
+});
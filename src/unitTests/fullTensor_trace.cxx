@@ -119,3 +119,44 @@ static misc::UnitTest tensor_traces("Tensor", "Traces", [](){
     res1() = C(i,j,j,i);
     MTEST(approx_entrywise_equal(res1, {1+64+512+32768}), res1.to_string());
 });
+
+
+static misc::UnitTest tensor_parallel_reshuffle("Tensor", "Parallel_reshuffle", [](){
+	const size_t oldMaxThreads = misc::maxThreads;
+	const size_t oldMinWork = misc::minWorkPerThread;
+	misc::maxThreads = 4;
+	misc::minWorkPerThread = 64;
+	
+	Index i, j, k, l;
+	Tensor A = Tensor::random({37,3,45});
+	Tensor B = Tensor::random({37,4,45,4});
+	Tensor sparseA = A.sparse_copy();
+	Tensor sparseB = B.sparse_copy();
+	Tensor res, sparseRes;
+	
+	// Tiled transposition
+	res(k,j,i) = A(i,j,k);
+	sparseRes(k,j,i) = sparseA(i,j,k);
+	TEST(approx_entrywise_equal(res, sparseRes, 1e-15));
+	
+	// Tiled transposition with traces
+	res(k,i) = B(i,j,k,j);
+	sparseRes(k,i) = sparseB(i,j,k,j);
+	TEST(approx_entrywise_equal(res, sparseRes, 1e-13));
+	
+	// Block copies with traces
+	res(j,i,k) = B(i,l,j,l) * Tensor::ones({1})(k);
+	sparseRes(j,i,k) = sparseB(i,l,j,l) * Tensor::ones({1})(k);
+	TEST(approx_entrywise_equal(res, sparseRes, 1e-13));
+	
+	// Simple reshuffle
+	res = reshuffle(A, {2,0,1});
+	sparseRes = reshuffle(sparseA, {2,0,1});
+	TEST(approx_entrywise_equal(res, sparseRes, 1e-15));
+	res = reshuffle(B, {1,0,2,3});
+	sparseRes = reshuffle(sparseB, {1,0,2,3});
+	TEST(approx_entrywise_equal(res, sparseRes, 1e-15));
+	
+	misc::maxThreads = oldMaxThreads;
+	misc::minWorkPerThread = oldMinWork;
+});
@@ -20,6 +20,8 @@
 
 #include<xerus.h> // NOTE xerus.h header file is necessary for below check of internal header export
 
+#include <atomic>
+
 #include "../../include/xerus/test/test.h"
 using namespace xerus;
 
@@ -118,3 +120,90 @@ static misc::UnitTest misc_exc("Misc", "exceptions", [](){
 		MTEST(false, "4");
 	}
 });
+
+
+#ifdef XERUS_REPLACE_ALLOCATOR
+	static misc::UnitTest misc_large_pool("Misc", "large_buffer_pool", [](){
+		const misc::LargeBufferPoolStatistics before = misc::large_buffer_pool_statistics();
+		
+		// A freed large buffer is reused for the next request of the same size class
+		Tensor A = Tensor::random({512, 513});
+		const value_t* const data = A.get_unsanitized_dense_data();
+		A.reset();
+		Tensor B = Tensor::random({513, 512});
+		TEST(B.get_unsanitized_dense_data() == data);
+		
+		const misc::LargeBufferPoolStatistics after = misc::large_buffer_pool_statistics();
+		TEST(after.hits > before.hits);
+		TEST(after.liveBytes >= 512*513*sizeof(value_t));
+		
+		misc::release_large_buffer_pool();
+		TEST(misc::large_buffer_pool_statistics().cachedBytes == 0);
+		
+		// With huge pages, new buffers are aligned to them
+		misc::largeBufferPoolUseHugePages = true;
+		Tensor C = Tensor::random({1024, 1024});
+		TEST(reinterpret_cast<uintptr_t>(C.get_unsanitized_dense_data()) % misc::LargeBufferPool::HUGE_PAGE_SIZE == 0);
+		misc::largeBufferPoolUseHugePages = false;
+		C.reset();
+		misc::release_large_buffer_pool();
+	});
+#endif
+
+
+static misc::UnitTest misc_memory_phases("Misc", "memory_accounting", [](){
+	namespace ma = misc::memoryAccounting;
+	ma::clear_phases();
+	{
+		ma::ScopedPhase outer("outer");
+		{
+			ma::ScopedPhase inner("inner");
+			Tensor A = Tensor::random({64, 64, 64});
+			MTEST(!ma::is_available() || ma::get_statistics().currentBytes >= A.size*sizeof(value_t), ma::get_statistics().currentBytes);
+		}
+		Tensor B = Tensor::random({10, 10});
+	}
+	
+	const std::vector<ma::PhaseStatistics> phases = ma::get_phases();
+	TEST(phases.size() == 2);
+	TEST(phases[0].name == "outer / inner" && phases[0].depth == 1);
+	TEST(phases[1].name == "outer" && phases[1].depth == 0);
+	if (ma::is_available()) {
+		// The per thread counters of other threads may lag behind by up to 64 KiB each
+		TEST(phases[0].peakBytes + 1024*1024 >= phases[0].startBytes + 64*64*64*sizeof(value_t));
+		TEST(phases[1].peakBytes >= phases[0].peakBytes);
+		TEST(phases[1].allocations > phases[0].allocations);
+		TEST(ma::get_statistics().peakBytes >= phases[1].peakBytes);
+	} else {
+		TEST(phases[0].peakBytes == 0 && phases[0].allocations == 0);
+	}
+	
+	FAILTEST(ma::end_phase());
+	ma::clear_phases();
+	TEST(ma::get_phases().empty());
+	
+	// A ScopedPhase whose phase was already ended does not throw from its destructor
+	{
+		ma::ScopedPhase phase("ended early");
+		ma::end_phase();
+	}
+	TEST(ma::get_phases().size() == 1);
+	ma::clear_phases();
+	
+	// Allocations of all threads are counted
+	if (ma::is_available()) {
+		// The buffers escape through an atomic pointer, otherwise the new/delete pairs may be elided
+		static std::atomic<value_t*> sink(nullptr);
+		const ma::MemoryStatistics before = ma::get_statistics();
+		#pragma omp parallel for num_threads(4)
+		for (size_t t = 0; t < 4; ++t) {
+			for (size_t k = 0; k < 1000; ++k) {
+				std::unique_ptr<value_t[]> buffer(new value_t[k%50+1]);
+				sink.store(buffer.get(), std::memory_order_relaxed);
+			}
+		}
+		const ma::MemoryStatistics after = ma::get_statistics();
+		MTEST(after.allocations >= before.allocations + 4000, after.allocations - before.allocations);
+		MTEST(after.deallocations >= before.deallocations + 4000, after.deallocations - before.deallocations);
+	}
+});
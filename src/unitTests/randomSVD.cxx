@@ -0,0 +1,76 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+#include<xerus.h>
+
+#include "../../include/xerus/test/test.h"
+using namespace xerus;
+using xerus::misc::operator<<;
+
+
+static misc::UnitTest rsvd_exact("RandomSVD", "exact_low_rank", [](){
+	const std::vector<size_t> dims({4, 5, 6, 5, 4});
+	const std::vector<size_t> ranks({3, 4, 4, 3});
+	const Tensor X(TTTensor::random(dims, ranks));
+	
+	const TTTensor tt = randomTTSVD(X, ranks);
+	MTEST(tt.dimensions == dims, tt.dimensions);
+	MTEST(tt.ranks() == ranks, tt.ranks());
+	MTEST(frob_norm(Tensor(tt) - X) < 1e-10*frob_norm(X), frob_norm(Tensor(tt) - X)/frob_norm(X));
+	
+	// Degree one
+	const Tensor v = Tensor::random({7});
+	MTEST(frob_norm(Tensor(randomTTSVD(v, {})) - v) < 1e-12*frob_norm(v), frob_norm(Tensor(randomTTSVD(v, {})) - v));
+});
+
+
+static misc::UnitTest rsvd_sparse("RandomSVD", "sparse_input", [](){
+	const std::vector<size_t> dims({10, 10, 10, 10});
+	const Tensor X = Tensor::random(dims, 20);
+	MTEST(X.is_sparse(), "The test requires sparse input.");
+	
+	// With 20 entries no matricization has a rank above 20
+	const TTTensor tt = randomTTSVD(X, {10, 20, 10}, 5);
+	MTEST(frob_norm(Tensor(tt) - X) < 1e-10*frob_norm(X), frob_norm(Tensor(tt) - X)/frob_norm(X));
+	
+	// Must be the same as for the dense representation of the same tensor
+	Tensor denseX = X;
+	denseX.use_dense_representation();
+	const TTTensor denseTT = randomTTSVD(denseX, {10, 20, 10}, 5);
+	MTEST(frob_norm(Tensor(denseTT) - X) < 1e-10*frob_norm(X), frob_norm(Tensor(denseTT) - X)/frob_norm(X));
+});
+
+
+static misc::UnitTest rsvd_power("RandomSVD", "power_iterations", [](){
+	const std::vector<size_t> dims({6, 6, 6, 6, 6});
+	const std::vector<size_t> ranks({2, 3, 3, 2});
+	Tensor X(TTTensor::random(dims, ranks));
+	X /= frob_norm(X);
+	X += 1e-3*Tensor::random(dims)/std::sqrt(double(misc::product(dims)));
+	
+	const TTTensor exact(X, 0.0, ranks);
+	const value_t exactError = frob_norm(Tensor(exact) - X);
+	
+	const TTTensor randomized = randomTTSVD(X, ranks, 5, 2);
+	const value_t randomError = frob_norm(Tensor(randomized) - X);
+	
+	MTEST(randomized.ranks() == ranks, randomized.ranks());
+	MTEST(randomError < 2*exactError, randomError << " vs " << exactError);
+});
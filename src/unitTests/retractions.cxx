@@ -221,6 +221,19 @@ static misc::UnitTest tttv_creation("TTTangentVector", "creation", [](){
 	MTEST((tangentChange2.frob_norm() - tangentChange1.frob_norm())/tangentChange1.frob_norm() < 1e-14, "PP " << tangentChange2.frob_norm() - tangentChange1.frob_norm()/tangentChange1.frob_norm());
 	MTEST((frob_norm(TTTensor(tangentChange1) - TTTensor(tangentChange2)))/tangentChange1.frob_norm() < 1e-14, "PP2 " << (frob_norm(TTTensor(tangentChange1) - TTTensor(tangentChange2)))/tangentChange1.frob_norm());
 	
+	// projecting the tangent vector itself does not change it either
+	tangentChange2 = TTTangentVector(X, tangentChange1);
+	MTEST((frob_norm(TTTensor(tangentChange1) - TTTensor(tangentChange2)))/tangentChange1.frob_norm() < 1e-14, "PT " << (frob_norm(TTTensor(tangentChange1) - TTTensor(tangentChange2)))/tangentChange1.frob_norm());
+	for (size_t i=0; i<stateDims.size(); ++i) {
+		MTEST(frob_norm(tangentChange2.components[i] - tangentChange1.components[i])/tangentChange1.frob_norm() < 1e-14, i << " " << frob_norm(tangentChange2.components[i] - tangentChange1.components[i])/tangentChange1.frob_norm());
+	}
+	
+	// tangent vectors of other tangent planes are projected like their full representation
+	TTTensor Y = TTTensor::random(stateDims, stateRank);
+	tangentChange2 = TTTangentVector(Y, tangentChange1);
+	TTTangentVector tangentChange3(Y, TTTensor(tangentChange1));
+	MTEST(frob_norm(TTTensor(tangentChange2) - TTTensor(tangentChange3))/tangentChange3.frob_norm() < 1e-14, "PY " << frob_norm(TTTensor(tangentChange2) - TTTensor(tangentChange3))/tangentChange3.frob_norm());
+	
 	// tangent space of 10*X should be equal to tangent space of X
 	tangentChange2 = TTTangentVector(10 * X, change);
 	MTEST((frob_norm(TTTensor(tangentChange1) - TTTensor(tangentChange2)))/tangentChange1.frob_norm() < 1e-14, "10X " << (frob_norm(TTTensor(tangentChange1) - TTTensor(tangentChange2)))/tangentChange1.frob_norm());
@@ -148,3 +148,56 @@ static misc::UnitTest sparse_creation("SparseTensor", "Creation", [](){
     TEST(approx_entrywise_equal(fullA, sparseA, 1e-13));
     TEST(approx_entrywise_equal(fullB, sparseB, 1e-13));
 });
+
+
+static misc::UnitTest sparse_flat_storage("SparseTensor", "Flat_storage", [](){
+	Tensor fullA({10,7,13});
+	Tensor sparseA({10,7,13}, Tensor::Representation::Sparse);
+	
+	// Write the entries in random order
+	std::vector<size_t> positions(fullA.size);
+	std::iota(positions.begin(), positions.end(), 0);
+	std::shuffle(positions.begin(), positions.end(), misc::randomEngine);
+	positions.resize(50);
+	for(const size_t pos : positions) {
+		fullA[pos] = double(pos);
+		sparseA[pos] = double(pos);
+	}
+	MTEST(sparseA.is_sparse(), "A should still be sparse.");
+	MTEST(sparseA.sparsity() == 50, sparseA.sparsity());
+	TEST(approx_entrywise_equal(fullA, sparseA, 1e-16));
+	
+	const auto& data = sparseA.get_unsanitized_sparse_data();
+	MTEST(std::is_sorted(data.begin(), data.end()), "Sparse entries must be sorted by position.");
+	
+	// The same entries constructed in bulk
+	Tensor sparseC({10,7,13}, Tensor::Representation::Sparse);
+	for(const size_t pos : positions) {
+		sparseC.get_sparse_data().emplace_back_unsorted(pos, double(pos));
+	}
+	sparseC.get_sparse_data().sort_and_sum_duplicates();
+	MTEST(sparseC.sparsity() == 50, sparseC.sparsity());
+	MTEST(data == sparseC.get_unsanitized_sparse_data(), "Bulk and random order construction must yield the same entries.");
+	
+	Tensor sparseB = Tensor::random({10,7,13}, 60);
+	MTEST(sparseB.sparsity() == 60, sparseB.sparsity());
+	const auto& dataB = sparseB.get_unsanitized_sparse_data();
+	MTEST(std::is_sorted(dataB.begin(), dataB.end()), "Sparse entries must be sorted by position.");
+	
+	Tensor fullB = sparseB.dense_copy();
+	Tensor fullX, sparseX;
+	Index i,j,k;
+	
+	sparseX = sparseA + 2*sparseB;
+	fullX = fullA + 2*fullB;
+	TEST(approx_entrywise_equal(fullX, sparseX, 1e-13));
+	
+	sparseX(k,i,j) = sparseA(i,j,k) - sparseB(i,j,k);
+	fullX(k,i,j) = fullA(i,j,k) - fullB(i,j,k);
+	TEST(approx_entrywise_equal(fullX, sparseX, 1e-13));
+	MTEST(std::is_sorted(sparseX.get_unsanitized_sparse_data().begin(), sparseX.get_unsanitized_sparse_data().end()), "Sparse entries must be sorted by position.");
+	
+	sparseX.modify_entries([](value_t& _val, const size_t _pos){ if(_pos%3 == 0) { _val = 1.0; } });
+	fullX.modify_entries([](value_t& _val, const size_t _pos){ if(_pos%3 == 0) { _val = 1.0; } });
+	TEST(approx_entrywise_equal(fullX, sparseX, 1e-13));
+});
@@ -322,3 +322,166 @@ static misc::UnitTest tn_save_ntwork("TensorNetwork", "Save_Network", [](){
     res3(i,o) = res1A(i,l,m,n,j,k) * res2A(l,o,m,n,j,k);
     TEST(approx_entrywise_equal(res3, {20596523, 21531582, 46728183, 48849590}));
 });
+
+
+static misc::UnitTest tn_optimal_order("TensorNetwork", "optimal_contraction_order", [](){
+	Tensor A = Tensor::random({2,50});
+	Tensor B = Tensor::random({50,3,7});
+	Tensor C = Tensor::random({3,60});
+	Tensor D = Tensor::random({60,4,7});
+	Tensor E = Tensor::random({4,70});
+	Tensor F = Tensor::random({70,2});
+	Index i1,i2,i3,i4,i5,i6,i7,i8;
+	
+	TensorNetwork net;
+	net(i1,i8) = A(i1,i2) * B(i2,i3,i7) * C(i3,i4) * D(i4,i5,i7) * E(i5,i6) * F(i6,i8);
+	MTEST(net.nodes.size() == 6, net.nodes.size());
+	
+	std::vector<double> sparsities;
+	for (size_t id = 0; id < net.nodes.size(); ++id) { sparsities.emplace_back(net.node_sparsity(id)); }
+	
+	// The optimal order must not be more expensive than any of the greedy orders
+	double optimalCost = std::numeric_limits<double>::max();
+	std::vector<std::pair<size_t, size_t>> optimalOrder;
+	internal::optimal_heuristic(optimalCost, optimalOrder, net, sparsities);
+	MTEST(optimalOrder.size() == 5, optimalOrder.size());
+	for (size_t h = 0; h < 5; ++h) {
+		double greedyCost = std::numeric_limits<double>::max();
+		std::vector<std::pair<size_t, size_t>> greedyOrder;
+		internal::contractionHeuristics[h](greedyCost, greedyOrder, net, sparsities);
+		MTEST(optimalCost <= greedyCost*(1+1e-12), h << ": " << optimalCost << " vs " << greedyCost);
+	}
+	
+	// The order must be valid and reproduce the result
+	double replayedCost = 0;
+	for (const std::pair<size_t, size_t> &c : optimalOrder) {
+		replayedCost += net.contraction_cost(c.first, c.second);
+		net.contract(c.first, c.second);
+	}
+	MTEST(misc::approx_equal(replayedCost, optimalCost, 1e-12), replayedCost << " vs " << optimalCost);
+	net.sanitize();
+	
+	Tensor result, expected;
+	result(i1,i8) = net(i1,i8);
+	expected(i1,i8) = A(i1,i2) * B(i2,i3,i7) * C(i3,i4) * D(i4,i5,i7) * E(i5,i6) * F(i6,i8);
+	MTEST(approx_equal(result, expected, 1e-12), frob_norm(result - expected));
+});
+
+
+static misc::UnitTest tn_sparse_cost("TensorNetwork", "sparse_contraction_cost", [](){
+	// Dense operands
+	TEST(misc::approx_equal(internal::contraction_cost(10, 20, 30, 300, 600), 6000.0));
+	TEST(misc::approx_equal(internal::contraction_sparsity(10, 20, 30, 300, 600), 200.0));
+	
+	// Sparse times dense only touches the non-zero entries of the sparse operand
+	TEST(misc::approx_equal(internal::contraction_cost(10, 20, 30, 10, 600), 200.0));
+	TEST(misc::approx_equal(internal::contraction_cost(10, 20, 30, 300, 20), 200.0));
+	TEST(internal::contraction_cost(10, 20, 30, 10, 20) < 200.0);
+	
+	// A diagonal times a sparse vector has (in expectation) few non-zero entries
+	TEST(internal::contraction_sparsity(100, 1, 100, 100, 1) < 2.0);
+	
+	Tensor A = Tensor::random({100,100});
+	Tensor I = Tensor::identity({100,100});
+	Tensor v = Tensor::dirac({100}, 7);
+	Index i,j,k;
+	
+	TensorNetwork net;
+	net(i) = A(i,j) * I(j,k) * v(k);
+	INTERNAL_CHECK(net.nodes.size() == 3, "IE");
+	MTEST(net.node_sparsity(1) < 101 && net.node_sparsity(2) < 2, net.node_sparsity(1) << " " << net.node_sparsity(2));
+	MTEST(net.contraction_cost(1, 2) < net.contraction_cost(0, 1), net.contraction_cost(1, 2) << " vs " << net.contraction_cost(0, 1));
+	
+	// The exchange heuristic uses the same cost model as the optimal search
+	std::vector<double> sparsities;
+	for (size_t id = 0; id < net.nodes.size(); ++id) { sparsities.emplace_back(net.node_sparsity(id)); }
+	double exchangeCost = std::numeric_limits<double>::max();
+	std::vector<std::pair<size_t, size_t>> exchangeOrder({{0, 1}, {0, 2}});
+	internal::exchange_heuristic(exchangeCost, exchangeOrder, net, sparsities);
+	double optimalCost = std::numeric_limits<double>::max();
+	std::vector<std::pair<size_t, size_t>> optimalOrder;
+	internal::optimal_heuristic(optimalCost, optimalOrder, net, sparsities);
+	MTEST(misc::approx_equal(exchangeCost, optimalCost) && exchangeCost < 1000, exchangeCost << " vs " << optimalCost);
+	
+	Tensor result, expected;
+	result(i) = net(i);
+	expected(i) = A(i,j) * I(j,k) * v(k);
+	TEST(approx_equal(result, expected, 1e-14));
+});
+
+
+static misc::UnitTest tn_contraction_cache("TensorNetwork", "contraction_cache", [](){
+	Index i1,i2,i3,i4,i5,i6,i7,i8;
+	internal::clear_contraction_cache();
+	TEST(internal::contraction_cache_hits() == 0 && internal::contraction_cache_misses() == 0);
+	
+	const auto contract_chain = [&](const size_t _n) {
+		Tensor A = Tensor::random({2,_n});
+		Tensor B = Tensor::random({_n,3,7});
+		Tensor C = Tensor::random({3,60});
+		Tensor D = Tensor::random({60,4,7});
+		Tensor E = Tensor::random({4,70});
+		Tensor F = Tensor::random({70,2});
+		TensorNetwork net;
+		net(i1,i8) = A(i1,i2) * B(i2,i3,i7) * C(i3,i4) * D(i4,i5,i7) * E(i5,i6) * F(i6,i8);
+		Tensor result, expected;
+		result(i1,i8) = net(i1,i8);
+		expected(i1,i8) = A(i1,i2) * B(i2,i3,i7) * C(i3,i4) * D(i4,i5,i7) * E(i5,i6) * F(i6,i8);
+		MTEST(approx_equal(result, expected, 1e-12), frob_norm(result - expected));
+	};
+	
+	contract_chain(50);
+	const size_t misses = internal::contraction_cache_misses();
+	const size_t hits = internal::contraction_cache_hits();
+	MTEST(misses > 0, misses);
+	
+	// Same structure, different values: the stored order is replayed
+	contract_chain(50);
+	MTEST(internal::contraction_cache_misses() == misses, internal::contraction_cache_misses() << " vs " << misses);
+	MTEST(internal::contraction_cache_hits() > hits, internal::contraction_cache_hits() << " vs " << hits);
+	
+	// Different dimensions require a new order
+	contract_chain(51);
+	MTEST(internal::contraction_cache_misses() > misses, internal::contraction_cache_misses() << " vs " << misses);
+	
+	internal::clear_contraction_cache();
+	TEST(internal::contraction_cache_hits() == 0 && internal::contraction_cache_misses() == 0);
+});
+
+static misc::UnitTest tn_parallel_contraction("TensorNetwork", "parallel_contraction", [](){
+	// A star with six arms: the arms are independent branches of the contraction order
+	const size_t numArms = 6;
+	std::vector<Tensor> arms, legs;
+	for (size_t k = 0; k < numArms; ++k) {
+		arms.push_back(Tensor::random({2, 40}));
+		legs.push_back(Tensor::random({40, 3}));
+	}
+	const Tensor center = Tensor::random(std::vector<size_t>(numArms, 3));
+	
+	const auto contract_star = [&](){
+		Index x0, x1, x2, x3, x4, x5, a0, a1, a2, a3, a4, a5, b0, b1, b2, b3, b4, b5;
+		TensorNetwork net;
+		net(x0, x1, x2, x3, x4, x5) = center(b0, b1, b2, b3, b4, b5)
+			* arms[0](x0, a0) * legs[0](a0, b0) * arms[1](x1, a1) * legs[1](a1, b1) * arms[2](x2, a2) * legs[2](a2, b2)
+			* arms[3](x3, a3) * legs[3](a3, b3) * arms[4](x4, a4) * legs[4](a4, b4) * arms[5](x5, a5) * legs[5](a5, b5);
+		return Tensor(net);
+	};
+	
+	const size_t oldMaxThreads = misc::maxThreads, oldMinWork = misc::minWorkPerThread, oldMemory = internal::parallelContractionMemory;
+	misc::maxThreads = 1;
+	const Tensor sequential = contract_star();
+	
+	misc::maxThreads = 4;
+	misc::minWorkPerThread = 1;
+	const Tensor parallel = contract_star();
+	MTEST(approx_equal(parallel, sequential, 1e-12), frob_norm(parallel - sequential));
+	
+	// A memory bound that is too small to run two steps at once must not prevent progress
+	internal::parallelContractionMemory = 1;
+	const Tensor bounded = contract_star();
+	MTEST(approx_equal(bounded, sequential, 1e-12), frob_norm(bounded - sequential));
+	
+	misc::maxThreads = oldMaxThreads;
+	misc::minWorkPerThread = oldMinWork;
+	internal::parallelContractionMemory = oldMemory;
+});
@@ -102,3 +102,32 @@ static misc::UnitTest tn_many_access("TensorNetwork", "many_element_access", [](
 		TEST(misc::approx_equal(measurments.measuredValues[m], res[measurments.positions[m]]));
     }
 });
+
+
+static misc::UnitTest tn_parallel_measure("TensorNetwork", "parallel_measurement", [](){
+	TTTensor tt = TTTensor::random(std::vector<size_t>(7, 4), std::vector<size_t>(6, 3));
+	const Tensor full(tt);
+	
+	// More positions than fit into a single chunk
+	SinglePointMeasurementSet measurements = SinglePointMeasurementSet::random(9000, full.dimensions);
+	measurements.measure(tt);
+	size_t wrongValues = 0;
+	for(size_t m = 0; m < measurements.size(); ++m) {
+		if(!misc::approx_equal(measurements.measuredValues[m], full[measurements.positions[m]], 1e-10)) { wrongValues++; }
+	}
+	MTEST(wrongValues == 0, wrongValues);
+	MTEST(measurements.test(tt) < 1e-12, measurements.test(tt));
+	
+	// The results must not depend on the number of threads
+	const TTTensor perturbed = tt + 1e-3*TTTensor::random(tt.dimensions, tt.ranks());
+	const double parallelError = measurements.test(perturbed);
+	const size_t oldMaxThreads = misc::maxThreads;
+	misc::maxThreads = 1;
+	SinglePointMeasurementSet sequential(measurements);
+	sequential.measure(tt);
+	const double sequentialError = measurements.test(perturbed);
+	misc::maxThreads = oldMaxThreads;
+	
+	TEST(sequential.measuredValues == measurements.measuredValues);
+	MTEST(sequentialError > 0 && misc::approx_equal(sequentialError, parallelError, 1e-14), sequentialError << " vs " << parallelError);
+});
@@ -462,3 +462,45 @@ static misc::UnitTest tt_disjoint("TT", "disjoint_product", [](){
 		dimsB.push_back(dimDist(rnd));
 	}
 });
+
+
+static misc::UnitTest tt_apply_and_round("TT", "apply_and_round", [](){
+	Index i,j,k;
+	const std::vector<size_t> dims({3,4,5,4,3});
+	const std::vector<size_t> opDims({3,4,5,4,3,3,4,5,4,3});
+	
+	// Without truncation the result is the exact product
+	const TTOperator A = TTOperator::random(opDims, {2,3,3,2});
+	const TTTensor x = TTTensor::random(dims, {3,4,4,3});
+	TTTensor exact;
+	exact(i&0) = A(i/2, j/2) * x(j&0);
+	const TTTensor full = apply_and_round(A, x, 1000);
+	MTEST(frob_norm(full - exact) < 1e-10*frob_norm(exact), frob_norm(full - exact)/frob_norm(exact));
+	TEST(full.canonicalized && full.corePosition == 4);
+	
+	// The product of (I + 2I) with x has the ranks of x, although the ranks of the operator are two
+	const TTOperator id = TTOperator::identity(opDims);
+	TTOperator threeId(id);
+	threeId.canonicalized = false; // otherwise the sum would be rounded to rank one
+	threeId += 2*id;
+	MTEST(threeId.ranks() == std::vector<size_t>({2,2,2,2}), threeId.ranks());
+	const TTTensor tripled = apply_and_round(threeId, x, x.ranks());
+	MTEST(tripled.ranks() == x.ranks(), tripled.ranks() << " vs " << x.ranks());
+	MTEST(frob_norm(tripled - 3*x) < 1e-10*frob_norm(x), frob_norm(tripled - 3*x)/frob_norm(x));
+	
+	// Truncation stays close to rounding the exact product
+	const std::vector<size_t> targetRanks({2,3,3,2});
+	TTTensor rounded(exact);
+	rounded.round(targetRanks);
+	const TTTensor truncated = apply_and_round(A, x, targetRanks);
+	MTEST(truncated.ranks() == targetRanks, truncated.ranks());
+	const value_t roundedError = frob_norm(rounded - exact), truncatedError = frob_norm(truncated - exact);
+	MTEST(truncatedError < 2*roundedError, truncatedError << " vs " << roundedError);
+	
+	// Application to operators
+	const TTOperator B = TTOperator::random(opDims, {2,2,2,2});
+	TTOperator exactOp;
+	exactOp(i/2, k/2) = A(i/2, j/2) * B(j/2, k/2);
+	const TTOperator productOp = apply_and_round(A, B, 1000);
+	MTEST(frob_norm(productOp - exactOp) < 1e-10*frob_norm(exactOp), frob_norm(productOp - exactOp)/frob_norm(exactOp));
+});
@@ -139,3 +139,72 @@ static misc::UnitTest alg_adf_rnd("Algorithm", "adf_random_low_rank", [](){
 	
 	MTEST(frob_norm(X - trueSolution)/frob_norm(trueSolution) < 1e-3, frob_norm(X - trueSolution)/frob_norm(trueSolution));
 });
+
+
+static misc::UnitTest alg_adf_parallel("Algorithm", "adf_parallel_shards", [](){
+	const size_t D = 5;
+	const size_t N = 4;
+	const size_t R = 2;
+	
+	const TTTensor trueSolution = TTTensor::random(std::vector<size_t>(D, N), std::vector<size_t>(D-1, R));
+	SinglePointMeasurementSet measurements = SinglePointMeasurementSet::random(D*N*10*R*R, std::vector<size_t>(D, N));
+	measurements.measure(trueSolution);
+	
+	ADFVariant ourADF(20, 1e-10, 0.0);
+	const TTTensor initial = TTTensor::random(std::vector<size_t>(D, N), std::vector<size_t>(D-1, R));
+	
+	// The result must not depend (up to rounding) on the number of shards the measurements are split into
+	const size_t oldMaxThreads = misc::maxThreads;
+	const size_t oldMinWork = misc::minWorkPerThread;
+	misc::minWorkPerThread = 1;
+	
+	std::vector<TTTensor> results;
+	for (const size_t threads : std::vector<size_t>({1, 3})) {
+		misc::maxThreads = threads;
+		TTTensor X = initial;
+		ourADF(X, measurements, std::vector<size_t>(D-1, R), NoPerfData);
+		results.push_back(X);
+		
+		X = initial;
+		ourADF(X, RankOneMeasurementSet(measurements, X.dimensions), std::vector<size_t>(D-1, R), NoPerfData);
+		results.push_back(X);
+	}
+	
+	misc::maxThreads = oldMaxThreads;
+	misc::minWorkPerThread = oldMinWork;
+	
+	MTEST(frob_norm(results[0] - results[2]) < 1e-8*frob_norm(results[0]), frob_norm(results[0] - results[2])/frob_norm(results[0]));
+	MTEST(frob_norm(results[1] - results[3]) < 1e-8*frob_norm(results[1]), frob_norm(results[1] - results[3])/frob_norm(results[1]));
+});
+
+
+static misc::UnitTest alg_adf_single("Algorithm", "adf_single_precision", [](){
+	const size_t D = 5;
+	const size_t N = 4;
+	const size_t R = 2;
+	
+	const TTTensor trueSolution = TTTensor::random(std::vector<size_t>(D, N), std::vector<size_t>(D-1, R));
+	SinglePointMeasurementSet measurements = SinglePointMeasurementSet::random(D*N*10*R*R, std::vector<size_t>(D, N));
+	measurements.measure(trueSolution);
+	
+	// The stacks are stored in single precision if the components of x are. The components stay single, also when the ranks are increased.
+	ADFVariant ourADF(500, 1e-6, 0.999);
+	TTTensor initial = TTTensor::ones(std::vector<size_t>(D, N));
+	for (size_t i = 0; i < D; ++i) {
+		initial.component(i).use_single_precision();
+	}
+	
+	TTTensor X = initial;
+	ourADF(X, measurements, std::vector<size_t>(D-1, R), NoPerfData);
+	for (size_t i = 0; i < D; ++i) {
+		MTEST(X.get_component(i).is_single_precision(), i);
+	}
+	MTEST(frob_norm(X - trueSolution)/frob_norm(trueSolution) < 1e-3, frob_norm(X - trueSolution)/frob_norm(trueSolution));
+	
+	X = initial;
+	ourADF(X, RankOneMeasurementSet(measurements, X.dimensions), std::vector<size_t>(D-1, R), NoPerfData);
+	for (size_t i = 0; i < D; ++i) {
+		MTEST(X.get_component(i).is_single_precision(), i);
+	}
+	MTEST(frob_norm(X - trueSolution)/frob_norm(trueSolution) < 1e-3, frob_norm(X - trueSolution)/frob_norm(trueSolution));
+});
@@ -33,6 +33,32 @@ static misc::UnitTest tt_entryprod("TT", "entrywise_product", [](){
 	MTEST(approx_equal(Df, Tensor(Do1), 1e-13), frob_norm(Df- Tensor(Do1)));
 });
 
+static misc::UnitTest tt_entryprod_truncated("TT", "entrywise_product_truncated", [](){
+	TTTensor A = TTTensor::random({2,3,4,3,2}, {2,3,3,2});
+	TTTensor B = TTTensor::random({2,3,4,3,2}, {3,2,4,2});
+	TTOperator Ao = TTOperator::random({2,3,2,2,3,2}, {2,3});
+	TTOperator Bo = TTOperator::random({2,3,2,2,3,2}, {3,2});
+	
+	// Without truncation the results are exact
+	const TTTensor C = entrywise_product(A, B);
+	const TTTensor Ct = entrywise_product(A, B, std::vector<size_t>(4, 100));
+	MTEST(frob_norm(C - Ct)/frob_norm(C) < 1e-12, frob_norm(C - Ct)/frob_norm(C));
+	TEST(Ct.canonicalized && Ct.corePosition == 4);
+	
+	const TTOperator Co = entrywise_product(Ao, Bo);
+	const TTOperator Cot = entrywise_product(Ao, Bo, std::vector<size_t>(2, 100));
+	MTEST(frob_norm(Co - Cot)/frob_norm(Co) < 1e-12, frob_norm(Co - Cot)/frob_norm(Co));
+	
+	// With truncation the ranks are bounded and the error is of the order of that of rounding the exact product
+	const std::vector<size_t> targetRanks({2,3,3,2});
+	TTTensor rounded(C);
+	rounded.round(targetRanks);
+	const TTTensor truncated = entrywise_product(A, B, targetRanks);
+	TEST(truncated.ranks() == targetRanks);
+	const value_t roundedError = frob_norm(rounded - C), truncatedError = frob_norm(truncated - C);
+	MTEST(truncatedError < 5*roundedError, truncatedError << " vs " << roundedError);
+});
+
 static misc::UnitTest tt_soft("TT", "soft_thresholding", [](){
 	Index i,j,k;
 
@@ -82,3 +108,60 @@ static misc::UnitTest tt_pseudo_inv("TT", "Non-operator Pseudo Inverse", [](){
 	error = frob_norm(op(i^d,r1^d)*pInv(r1^d,r2^d)*op(r2^d,j^d) - op(i^d,j^d));
 	MTEST(error < 1e-10, "A A^+ A != A ? " << error);
 });
+
+
+static misc::UnitTest tt_evaluate_batch("TT", "evaluate_batch", [](){
+	const std::vector<size_t> dims({3, 4, 5, 2, 3});
+	TTTensor tt = 2.5*TTTensor::random(dims, {2, 3, 4, 2});
+	const Tensor full(tt);
+	
+	std::vector<Tensor::MultiIndex> positions(2000, Tensor::MultiIndex(dims.size()));
+	for (Tensor::MultiIndex& position : positions) {
+		for (size_t i = 0; i < dims.size(); ++i) {
+			position[i] = std::uniform_int_distribution<size_t>(0, dims[i]-1)(misc::randomEngine);
+		}
+	}
+	
+	std::vector<value_t> values = tt.evaluate_batch(positions);
+	MTEST(values.size() == positions.size(), values.size());
+	size_t wrongValues = 0;
+	for (size_t k = 0; k < positions.size(); ++k) {
+		if (!misc::approx_equal(values[k], full[positions[k]], 1e-12)) { wrongValues++; }
+	}
+	MTEST(wrongValues == 0, wrongValues);
+	
+	// Sparse components
+	const TTTensor dirac = TTTensor::dirac(dims, {1, 2, 3, 0, 2});
+	std::vector<value_t> diracValues;
+	for (const Tensor::MultiIndex& position : positions) {
+		diracValues.push_back(position == Tensor::MultiIndex({1, 2, 3, 0, 2}) ? 1.0 : 0.0);
+	}
+	TEST(dirac.evaluate_batch(positions) == diracValues);
+	
+	// Operators
+	TTOperator op = TTOperator::random({3, 4, 2, 5}, {3});
+	const Tensor fullOp(op);
+	std::vector<Tensor::MultiIndex> opPositions;
+	for (size_t a = 0; a < 3; ++a) { for (size_t b = 0; b < 4; ++b) { for (size_t c = 0; c < 2; ++c) { for (size_t e = 0; e < 5; ++e) {
+		opPositions.push_back({a, b, c, e});
+	} } } }
+	values = op.evaluate_batch(opPositions);
+	wrongValues = 0;
+	for (size_t k = 0; k < opPositions.size(); ++k) {
+		if (!misc::approx_equal(values[k], fullOp[opPositions[k]], 1e-12)) { wrongValues++; }
+	}
+	MTEST(wrongValues == 0, wrongValues);
+	
+	// Single precision components are widened to double
+	TTTensor singleTT(tt);
+	singleTT.component(2).use_single_precision();
+	values = singleTT.evaluate_batch(positions);
+	value_t error = 0.0, norm = 0.0;
+	for (size_t k = 0; k < positions.size(); ++k) {
+		error += misc::sqr(values[k] - full[positions[k]]);
+		norm += misc::sqr(full[positions[k]]);
+	}
+	MTEST(std::sqrt(error) < 1e-6*std::sqrt(norm), std::sqrt(error/norm));
+	
+	TEST(tt.evaluate_batch({}).empty());
+});
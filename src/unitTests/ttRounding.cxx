@@ -115,3 +115,70 @@ static misc::UnitTest tt_noround("TT", "no_rounding", [](){
 	a.round(2);
 	TEST(approx_equal(Tensor(a), Tensor(b), 1e-14));
 });
+
+
+static misc::UnitTest tt_gram_round("TT", "gram_rounding", [](){
+	Index i;
+	const std::vector<size_t> dimensions({4,5,3,4,5,3,4});
+	
+	// Adding a TTTensor to itself doubles the ranks without changing the rank of the represented tensor
+	const TTTensor a = TTTensor::random(dimensions, {2,3,4,4,3,2});
+	TTTensor sum = a + a;
+	sum.round(a.ranks(), EPSILON, RoundingMode::Gram);
+	MTEST(sum.ranks() == a.ranks(), sum.ranks() << " vs " << a.ranks());
+	MTEST(frob_norm(sum - 2*a) < 1e-10*frob_norm(a), frob_norm(sum - 2*a)/frob_norm(a));
+	
+	// Truncation is quasi-optimal, i.e. at most sqrt(d-1) times worse than the TT-SVD
+	TTTensor b = TTTensor::random(dimensions, {3,6,8,8,6,3});
+	b.move_core(2);
+	const std::vector<size_t> targetRanks({2,3,3,3,3,2});
+	TTTensor sweep(b), gram(b);
+	sweep.round(targetRanks, EPSILON, RoundingMode::Sweep);
+	gram.round(targetRanks, EPSILON, RoundingMode::Gram);
+	MTEST(gram.ranks() == targetRanks, gram.ranks());
+	TEST(gram.canonicalized && gram.corePosition == 2);
+	const value_t sweepError = frob_norm(sweep - b), gramError = frob_norm(gram - b);
+	MTEST(gramError <= std::sqrt(6.0)*sweepError*(1+1e-10), gramError << " vs " << sweepError);
+	
+	// A relative accuracy only removes the negligible singular values
+	TTTensor noisy = a + 1e-12*TTTensor::random(dimensions, {2,2,2,2,2,2});
+	noisy.round(std::vector<size_t>(6, std::numeric_limits<size_t>::max()), 1e-6, RoundingMode::Gram);
+	MTEST(noisy.ranks() == a.ranks(), noisy.ranks() << " vs " << a.ranks());
+	MTEST(frob_norm(noisy - a) < 1e-10*frob_norm(a), frob_norm(noisy - a)/frob_norm(a));
+	
+	// Operators
+	TTOperator op = TTOperator::random({2,3,4,2,3,4}, {3,3});
+	TTOperator opSum = op + op;
+	opSum.round(op.ranks(), EPSILON, RoundingMode::Gram);
+	MTEST(opSum.ranks() == op.ranks(), opSum.ranks() << " vs " << op.ranks());
+	MTEST(frob_norm(opSum - 2*op) < 1e-10*frob_norm(op), frob_norm(opSum - 2*op)/frob_norm(op));
+});
+
+
+static misc::UnitTest tt_single_round("TT", "single_precision_rounding", [](){
+	const std::vector<size_t> dimensions({4,5,3,4,5,3,4});
+	
+	// Rounding keeps single precision components in single precision
+	const TTTensor a = TTTensor::random(dimensions, {2,3,4,4,3,2});
+	TTTensor sum = a + a;
+	for (size_t n = 0; n < dimensions.size(); ++n) {
+		sum.component(n).use_single_precision();
+	}
+	sum.round(a.ranks());
+	MTEST(sum.ranks() == a.ranks(), sum.ranks() << " vs " << a.ranks());
+	for (size_t n = 0; n < dimensions.size(); ++n) {
+		MTEST(sum.get_component(n).is_single_precision(), n);
+	}
+	const Tensor fullSum(sum), fullA(a);
+	MTEST(approx_equal(fullSum, 2*fullA, 1e-5), frob_norm(fullSum - 2*fullA)/frob_norm(2*fullA));
+	
+	// TT-SVD of a single precision tensor
+	Tensor singleA(fullA);
+	singleA.use_single_precision();
+	const TTTensor b(singleA, 1e-4);
+	MTEST(b.ranks() == a.ranks(), b.ranks() << " vs " << a.ranks());
+	for (size_t n = 0; n < dimensions.size(); ++n) {
+		MTEST(b.get_component(n).is_single_precision(), n);
+	}
+	MTEST(approx_equal(Tensor(b), fullA, 1e-5), frob_norm(Tensor(b) - fullA)/frob_norm(fullA));
+});
@@ -0,0 +1,89 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+
+#include<xerus.h>
+
+#include "../../include/xerus/test/test.h"
+using namespace xerus;
+using xerus::misc::operator<<;
+
+
+static misc::UnitTest tt_sum_low_rank("TT", "sum_accumulator_low_rank", [](){
+	const std::vector<size_t> dims({3, 4, 3, 4, 3});
+	const TTTensor base1 = TTTensor::random(dims, {2, 2, 2, 2});
+	const TTTensor base2 = TTTensor::random(dims, {2, 2, 2, 2});
+	
+	// All summands lie in a space of rank 4, so the bounded partial sums are exact
+	TTSumAccumulator accumulator(dims, 4, EPSILON, RoundingMode::Sweep);
+	Tensor expected(dims);
+	for (size_t k = 0; k < 37; ++k) {
+		const value_t alpha = misc::defaultNormalDistribution(misc::randomEngine), beta = misc::defaultNormalDistribution(misc::randomEngine);
+		const value_t weight = 1.0/static_cast<value_t>(k+1);
+		const TTTensor x = alpha*base1 + beta*base2;
+		accumulator.add(x, weight);
+		expected += weight*Tensor(x);
+		
+		MTEST(accumulator.count() == k+1, accumulator.count());
+	}
+	
+	const TTTensor result = accumulator.sum();
+	for (const size_t r : result.ranks()) {
+		MTEST(r <= 4, result.ranks());
+	}
+	MTEST(frob_norm(Tensor(result) - expected) < 1e-10*frob_norm(expected), frob_norm(Tensor(result) - expected)/frob_norm(expected));
+	
+	// The Gram rounding gives the same result
+	TTSumAccumulator gramAccumulator(dims, 4, EPSILON, RoundingMode::Gram);
+	gramAccumulator.add(base1, 2.0);
+	gramAccumulator.add(base2, -1.0);
+	gramAccumulator.add(base1 + base2, 0.5);
+	const Tensor gramExpected = 2.5*Tensor(base1) - 0.5*Tensor(base2);
+	MTEST(frob_norm(Tensor(gramAccumulator.sum()) - gramExpected) < 1e-8*frob_norm(gramExpected), frob_norm(Tensor(gramAccumulator.sum()) - gramExpected)/frob_norm(gramExpected));
+});
+
+
+static misc::UnitTest tt_sum_full_rank("TT", "sum_accumulator_full_rank", [](){
+	const std::vector<size_t> dims({3, 4, 3, 4});
+	
+	// The maximal ranks are larger than the full ranks, i.e. nothing is truncated
+	TTSumAccumulator accumulator(dims, {100, 100, 100});
+	TEST(accumulator.count() == 0);
+	TEST(frob_norm(accumulator.sum()) < 1e-14);
+	
+	Tensor expected(dims);
+	for (size_t k = 0; k < 13; ++k) {
+		const TTTensor x = TTTensor::random(dims, {2, 2, 2});
+		accumulator.add(x);
+		expected += Tensor(x);
+	}
+	
+	// sum() does not change the accumulator
+	const TTTensor result = accumulator.sum();
+	const TTTensor secondResult = accumulator.sum();
+	MTEST(frob_norm(Tensor(result) - expected) < 1e-12*frob_norm(expected), frob_norm(Tensor(result) - expected)/frob_norm(expected));
+	MTEST(frob_norm(result - secondResult) < 1e-14*frob_norm(result), frob_norm(result - secondResult));
+	MTEST(result.ranks() == std::vector<size_t>({3, 12, 4}), result.ranks());
+	
+	accumulator.clear();
+	TEST(accumulator.count() == 0);
+	accumulator.add(TTTensor::random(dims, {2, 2, 2}), 0.0);
+	TEST(frob_norm(accumulator.sum()) < 1e-14);
+});
@@ -40,6 +40,8 @@ using namespace xerus;
 				LOG(allocator, (i+1) * xma::BUCKET_SIZE-1 << " \tx\t " << xm::astore.allocCount[i] << "\tmax: " << xm::astore.maxAlloc[i] << '\t' << xm::astore.currAlloc[i] << '\t' << totalStorage);
 			}
 			LOG(storageNeeded, totalStorage << " storage used: " << misc::astore.pools.size()*xma::POOL_SIZE);
+			const misc::LargeBufferPoolStatistics poolStats = misc::large_buffer_pool_statistics();
+			LOG(largeBufferPool, "hits: " << poolStats.hits << " misses: " << poolStats.misses << " (hit rate " << poolStats.hit_rate() << ") live: " << poolStats.liveBytes << " cached: " << poolStats.cachedBytes << " peak: " << poolStats.peakBytes);
 			LOG(index, sizeof(Index));
 			LOG(node, sizeof(TensorNetwork::TensorNode));
 			LOG(link, sizeof(TensorNetwork::Link));
@@ -27,6 +27,8 @@
 #include <xerus/indexedTensorMoveable.h>
 #include <xerus/misc/basicArraySupport.h>
 #include <xerus/misc/internal.h>
+#include <xerus/misc/parallel.h>
+#include <xerus/blasLapackWrapper.h>
 
 #ifdef _OPENMP
 	#include <omp.h>
@@ -100,12 +102,9 @@ namespace xerus {
 	
 	
 	template<class MeasurmentSet>
-	void ADFVariant::InternalSolver<MeasurmentSet>::construct_stacks(std::unique_ptr<Tensor[]>& _stackSaveSlot, std::vector<std::vector<size_t>>& _updates, const std::unique_ptr<Tensor*[]>& _stackMem, const bool _forward) {
+	void ADFVariant::InternalSolver<MeasurmentSet>::construct_stacks(std::vector<size_t>& _stackSlots, std::vector<std::vector<size_t>>& _updates, const bool _forward) {
 		using misc::approx_equal;
 		
-		// Direct reference to the stack (withou Mem)
-		Tensor** const stack(_stackMem.get()+numMeasurments);
-		
 		// Temporary map. For each stack entry (i.e. measurement number + corePosition) gives a measurement number of a stack entry (at same corePosition) that shall have an equal value (or its own number otherwise). 
 		std::vector<size_t> calculationMap(degree*numMeasurments);
 		
@@ -160,153 +159,244 @@ namespace xerus {
 			}
 		}
 		
-		// Create the stack
-		numUniqueStackEntries++; // +1 for the special positions -1 and degree.
-		_stackSaveSlot.reset(new Tensor[numUniqueStackEntries]); 
-		size_t usedSlots = 0; 
-		_stackSaveSlot[usedSlots++] = Tensor::ones({1}); // Special slot reserved for the the position -1 and degree stacks
-		
-		// NOTE that _stackMem contains (degree+2)*numMeasurments entries and has an offset of numMeasurments (to have space for corePosition -1).
-		
-		// Set links for the special entries -1 and degree
-		for(size_t i = 0; i < numMeasurments; ++i) {
-			stack[i - 1*numMeasurments] = &_stackSaveSlot[0];
-			stack[i + degree*numMeasurments] = &_stackSaveSlot[0];
-		}
-		
+		// Number the unique entries of each corePosition, all other entries refer to the unique entry with equal value.
 		for(size_t corePosition = 0; corePosition < degree; ++corePosition) {
 			for(size_t i = 0; i < numMeasurments; ++i) {
 				if(calculationMap[i + corePosition*numMeasurments] == i) {
+					_stackSlots[i + corePosition*numMeasurments] = _updates[corePosition].size();
 					_updates[corePosition].emplace_back(i);
-					stack[i + corePosition*numMeasurments] = &_stackSaveSlot[usedSlots];
-					usedSlots++;
 				} else {
-					stack[i + corePosition*numMeasurments] = stack[calculationMap[i + corePosition*numMeasurments] + corePosition*numMeasurments];
+					INTERNAL_CHECK(calculationMap[i + corePosition*numMeasurments] < i, "Internal Error.");
+					_stackSlots[i + corePosition*numMeasurments] = _stackSlots[calculationMap[i + corePosition*numMeasurments] + corePosition*numMeasurments];
 				}
 			}
 		}
 		
-		INTERNAL_CHECK(usedSlots == numUniqueStackEntries, "Internal Error.");
 		perfData << "We have " << numUniqueStackEntries << " unique stack entries. There are " << numMeasurments*degree+1 << " virtual stack entries.";
 	}
 	
-	template<class MeasurmentSet>
-	void ADFVariant::InternalSolver<MeasurmentSet>::resize_stack_tensors() {
-		#pragma omp parallel for schedule(static)
+	
+	template<class MeasurmentSet> template<class T>
+	void ADFVariant::InternalSolver<MeasurmentSet>::reshape_stack_arena(std::vector<T>& _arena, const std::unique_ptr<T*[]>& _stackMem, T* const _boundary, const std::vector<size_t>& _stackSlots, const std::vector<std::vector<size_t>>& _updates, const bool _forward) {
+		// Direct reference to the stack (withou Mem)
+		T** const stack(_stackMem.get()+numMeasurments);
+		
+		// The unique entries of each corePosition are stored consecutively
+		std::vector<size_t> entrySizes(degree), offsets(degree+1, 0);
 		for(size_t corePosition = 0; corePosition < degree; ++corePosition) {
-			for(const size_t i : forwardUpdates[corePosition]) {
-				forwardStack[i + corePosition*numMeasurments]->reset({corePosition+1 == degree ? 1 : x.rank(corePosition)}, Tensor::Representation::Dense, Tensor::Initialisation::None);
+			if(_forward) {
+				entrySizes[corePosition] = corePosition+1 == degree ? 1 : x.rank(corePosition);
+			} else {
+				entrySizes[corePosition] = corePosition == 0 ? 1 : x.rank(corePosition-1);
 			}
-			for(const size_t i : backwardUpdates[corePosition]) {
-				backwardStack[i + corePosition*numMeasurments]->reset({corePosition == 0 ? 1 :x.rank(corePosition - 1)}, Tensor::Representation::Dense, Tensor::Initialisation::None);
+			offsets[corePosition+1] = offsets[corePosition] + _updates[corePosition].size()*entrySizes[corePosition];
+		}
+		
+		// NOTE that resize keeps the allocated memory if the ranks are not increased.
+		_arena.resize(offsets[degree]);
+		
+		// NOTE that _stackMem contains (degree+2)*numMeasurments entries and has an offset of numMeasurments (to have space for corePosition -1).
+		
+		// Set links for the special entries -1 and degree
+		for(size_t i = 0; i < numMeasurments; ++i) {
+			stack[i - 1*numMeasurments] = _boundary;
+			stack[i + degree*numMeasurments] = _boundary;
+		}
+		
+		#pragma omp parallel for num_threads(numThreads) schedule(static)
+		for(size_t corePosition = 0; corePosition < degree; ++corePosition) {
+			T* const positionArena = _arena.data() + offsets[corePosition];
+			for(size_t i = 0; i < numMeasurments; ++i) {
+				stack[i + corePosition*numMeasurments] = positionArena + _stackSlots[i + corePosition*numMeasurments]*entrySizes[corePosition];
 			}
 		}
 	}
 	
+	
 	template<class MeasurmentSet>
-	std::vector<Tensor> ADFVariant::InternalSolver<MeasurmentSet>::get_fixed_components(const Tensor& _component) {
-		std::vector<Tensor> fixedComponents(_component.dimensions[1]);
+	void ADFVariant::InternalSolver<MeasurmentSet>::resize_stack_tensors() {
+		// The work per measurment is roughly quadratic in the ranks
+		const std::vector<size_t> ranks = x.ranks();
+		const size_t maxRank = ranks.empty() ? 1 : *std::max_element(ranks.begin(), ranks.end());
+		numThreads = misc::get_num_threads(numMeasurments*maxRank*maxRank);
 		
-		for(size_t i = 0; i < _component.dimensions[1]; ++i) {
-			fixedComponents[i](r1, r2) = _component(r1, i, r2);
+		// The stacks use single precision if any component does, only the arenas of the used precision are kept.
+		singlePrecisionStacks = false;
+		for(size_t corePosition = 0; corePosition < degree; ++corePosition) {
+			singlePrecisionStacks = singlePrecisionStacks || x.get_component(corePosition).is_single_precision();
 		}
 		
-		return fixedComponents;
+		if(singlePrecisionStacks) {
+			if(!singleForwardStackMem) {
+				singleForwardStackMem.reset(new float*[numMeasurments*(degree+2)]);
+				singleBackwardStackMem.reset(new float*[numMeasurments*(degree+2)]);
+				singleForwardStack = singleForwardStackMem.get()+numMeasurments;
+				singleBackwardStack = singleBackwardStackMem.get()+numMeasurments;
+			}
+			std::vector<value_t>().swap(forwardStackArena);
+			std::vector<value_t>().swap(backwardStackArena);
+			reshape_stack_arena(singleForwardStackArena, singleForwardStackMem, &singleStackBoundary, forwardStackSlots, forwardUpdates, true);
+			reshape_stack_arena(singleBackwardStackArena, singleBackwardStackMem, &singleStackBoundary, backwardStackSlots, backwardUpdates, false);
+		} else {
+			std::vector<float>().swap(singleForwardStackArena);
+			std::vector<float>().swap(singleBackwardStackArena);
+			reshape_stack_arena(forwardStackArena, forwardStackMem, &stackBoundary, forwardStackSlots, forwardUpdates, true);
+			reshape_stack_arena(backwardStackArena, backwardStackMem, &stackBoundary, backwardStackSlots, backwardUpdates, false);
+		}
 	}
 	
-	template<>
-	void ADFVariant::InternalSolver<SinglePointMeasurementSet>::update_backward_stack(const size_t _corePosition, const Tensor& _currentComponent) {
-		INTERNAL_CHECK(_currentComponent.dimensions[1] == x.dimensions[_corePosition], "IE");
-		
-		const size_t numUpdates = backwardUpdates[_corePosition].size();
-		
-		std::vector<Tensor> fixedComponents = get_fixed_components(_currentComponent);
-		
-		// Update the stack
-		#pragma omp parallel for schedule(static)
-		for(size_t u = 0; u < numUpdates; ++u) {
-			const size_t i = backwardUpdates[_corePosition][u];
-			contract(*backwardStack[i + _corePosition*numMeasurments], fixedComponents[measurments.positions[i][_corePosition]], false, *backwardStack[i + (_corePosition+1)*numMeasurments], false, 1);
+	
+	template<class MeasurmentSet>
+	Tensor ADFVariant::InternalSolver<MeasurmentSet>::get_slices(const Tensor& _component) {
+		Tensor slices;
+		slices(i1, r1, r2) = _component(r1, i1, r2);
+		slices.use_dense_representation();
+		slices.apply_factor();
+		if(singlePrecisionStacks) {
+			slices.use_single_precision();
+		} else {
+			slices.use_double_precision();
 		}
+		return slices;
 	}
 	
+	
+	/// @brief Returns the dense data of @a _tensor, which must be stored in precision T.
+	template<class T>
+	static const T* unsanitized_data(const Tensor& _tensor);
+	
 	template<>
-	void ADFVariant::InternalSolver<RankOneMeasurementSet>::update_backward_stack(const size_t _corePosition, const Tensor& _currentComponent) {
-		INTERNAL_CHECK(_currentComponent.dimensions[1] == x.dimensions[_corePosition], "IE");
-		
-		const size_t numUpdates = backwardUpdates[_corePosition].size();
-		
-		Tensor reshuffledComponent;
-		reshuffledComponent(i1, r1, r2) =  _currentComponent(r1, i1, r2);
-
-		Tensor mixedComponent({reshuffledComponent.dimensions[1], reshuffledComponent.dimensions[2]});
-		
-		// Update the stack
-		#pragma omp parallel for firstprivate(mixedComponent) schedule(static)
-		for(size_t u = 0; u < numUpdates; ++u) {
-			const size_t i = backwardUpdates[_corePosition][u];
-			contract(mixedComponent, measurments.positions[i][_corePosition], false, reshuffledComponent, false, 1);
-			contract(*backwardStack[i + _corePosition*numMeasurments], mixedComponent, false, *backwardStack[i + (_corePosition+1)*numMeasurments], false, 1);
+	const value_t* unsanitized_data<value_t>(const Tensor& _tensor) {
+		return _tensor.get_unsanitized_dense_data();
+	}
+	
+	template<>
+	const float* unsanitized_data<float>(const Tensor& _tensor) {
+		return _tensor.get_unsanitized_single_data();
+	}
+	
+	
+	/// @brief Sets @a _mixed to the sum of the @a _sliceSize sized slices, weighted with the entries of @a _position.
+	template<class T>
+	static void mix_slices(T* const _mixed, const Tensor& _position, const T* const _slices, const size_t _sliceSize) {
+		misc::set_zero(_mixed, _sliceSize);
+		if(_position.is_dense()) {
+			const value_t* const positionData = _position.get_unsanitized_dense_data();
+			for(size_t n = 0; n < _position.size; ++n) {
+				misc::add_scaled(_mixed, T(_position.factor*positionData[n]), _slices + n*_sliceSize, _sliceSize);
+			}
+		} else {
+			for(const auto& entry : _position.get_unsanitized_sparse_data()) {
+				misc::add_scaled(_mixed, T(_position.factor*entry.second), _slices + entry.first*_sliceSize, _sliceSize);
+			}
 		}
 	}
 	
 	
-	template<>
-	void ADFVariant::InternalSolver<SinglePointMeasurementSet>::update_forward_stack( const size_t _corePosition, const Tensor& _currentComponent ) {
+	/// @brief Returns the slice of the component that belongs to a single point measurment at @a _position.
+	template<class T>
+	static const T* measured_slice(T* const /*_mixed*/, const size_t _position, const T* const _slices, const size_t _sliceSize) {
+		return _slices + _position*_sliceSize;
+	}
+	
+	/// @brief Returns the slices of the component weighted with the rank one measurment @a _position, using @a _mixed as storage.
+	template<class T>
+	static const T* measured_slice(T* const _mixed, const Tensor& _position, const T* const _slices, const size_t _sliceSize) {
+		mix_slices(_mixed, _position, _slices, _sliceSize);
+		return _mixed;
+	}
+	
+	
+	template<class MeasurmentSet> template<class T>
+	void ADFVariant::InternalSolver<MeasurmentSet>::update_stack(T* const * const _stack, const size_t _corePosition, const Tensor& _currentComponent, const bool _forward) {
 		INTERNAL_CHECK(_currentComponent.dimensions[1] == x.dimensions[_corePosition], "IE");
 		
-		const size_t numUpdates = forwardUpdates[_corePosition].size();
+		const std::vector<size_t>& updates = _forward ? forwardUpdates[_corePosition] : backwardUpdates[_corePosition];
+		const size_t leftRank = _currentComponent.dimensions[0];
+		const size_t rightRank = _currentComponent.dimensions[2];
 		
-		const std::vector<Tensor> fixedComponents = get_fixed_components(_currentComponent);		
+		const Tensor slices = get_slices(_currentComponent);
+		const T* const slicesData = unsanitized_data<T>(slices);
 		
 		// Update the stack
-		#pragma omp parallel for schedule(static)
-		for(size_t u = 0; u < numUpdates; ++u) {
-			const size_t i = forwardUpdates[_corePosition][u];
-			contract(*forwardStack[i + _corePosition*numMeasurments] , *forwardStack[i + (_corePosition-1)*numMeasurments], false, fixedComponents[measurments.positions[i][_corePosition]], false, 1);
+		#pragma omp parallel num_threads(numThreads)
+		{
+			std::unique_ptr<T[]> mixedComponent(std::is_same<MeasurmentSet, RankOneMeasurementSet>::value ? new T[leftRank*rightRank] : nullptr);
+			
+			#pragma omp for schedule(static)
+			for(size_t u = 0; u < updates.size(); ++u) {
+				const size_t i = updates[u];
+				const T* const slice = measured_slice(mixedComponent.get(), measurments.positions[i][_corePosition], slicesData, leftRank*rightRank);
+				if(_forward) {
+					blasWrapper::matrix_vector_product(_stack[i + _corePosition*numMeasurments], rightRank, T(1), slice, leftRank, true, _stack[i + (_corePosition-1)*numMeasurments]);
+				} else {
+					blasWrapper::matrix_vector_product(_stack[i + _corePosition*numMeasurments], leftRank, T(1), slice, rightRank, false, _stack[i + (_corePosition+1)*numMeasurments]);
+				}
+			}
 		}
 	}
 	
-	template<>
-	void ADFVariant::InternalSolver<RankOneMeasurementSet>::update_forward_stack( const size_t _corePosition, const Tensor& _currentComponent ) {
-		INTERNAL_CHECK(_currentComponent.dimensions[1] == x.dimensions[_corePosition], "IE");
-		
-		const size_t numUpdates = forwardUpdates[_corePosition].size();
-		
-		Tensor reshuffledComponent;
-		reshuffledComponent(i1, r1, r2) =  _currentComponent(r1, i1, r2);
-
-		Tensor mixedComponent({reshuffledComponent.dimensions[1], reshuffledComponent.dimensions[2]});
-
-		// Update the stack
-		#pragma omp parallel for firstprivate(mixedComponent) schedule(static)
-		for(size_t u = 0; u < numUpdates; ++u) {
-			const size_t i = forwardUpdates[_corePosition][u];
-			contract(mixedComponent, measurments.positions[i][_corePosition], false, reshuffledComponent, false, 1);
-			contract(*forwardStack[i + _corePosition*numMeasurments] , *forwardStack[i + (_corePosition-1)*numMeasurments], false, mixedComponent, false, 1);
+	
+	template<class MeasurmentSet>
+	void ADFVariant::InternalSolver<MeasurmentSet>::update_backward_stack(const size_t _corePosition, const Tensor& _currentComponent) {
+		if(singlePrecisionStacks) {
+			update_stack<float>(singleBackwardStack, _corePosition, _currentComponent, false);
+		} else {
+			update_stack<value_t>(backwardStack, _corePosition, _currentComponent, false);
 		}
 	}
 	
+	
+	template<class MeasurmentSet>
+	void ADFVariant::InternalSolver<MeasurmentSet>::update_forward_stack(const size_t _corePosition, const Tensor& _currentComponent) {
+		if(singlePrecisionStacks) {
+			update_stack<float>(singleForwardStack, _corePosition, _currentComponent, true);
+		} else {
+			update_stack<value_t>(forwardStack, _corePosition, _currentComponent, true);
+		}
+	}
+	
+	
+	template<class MeasurmentSet>
+	value_t ADFVariant::InternalSolver<MeasurmentSet>::stack_dot_product(const size_t _i, const size_t _forwardPosition, const size_t _backwardPosition, const size_t _rank) const {
+		if(singlePrecisionStacks) {
+			return blasWrapper::dot_product(singleForwardStack[_i + _forwardPosition*numMeasurments], _rank, singleBackwardStack[_i + _backwardPosition*numMeasurments]);
+		}
+		return blasWrapper::dot_product(forwardStack[_i + _forwardPosition*numMeasurments], _rank, backwardStack[_i + _backwardPosition*numMeasurments]);
+	}
+	
+	
+	template<class MeasurmentSet>
+	const value_t* ADFVariant::InternalSolver<MeasurmentSet>::stack_entry(const bool _forward, const size_t _i, const size_t _position, const size_t _size, value_t* const _buffer) const {
+		if(singlePrecisionStacks) {
+			const float* const entry = (_forward ? singleForwardStack : singleBackwardStack)[_i + _position*numMeasurments];
+			for(size_t k = 0; k < _size; ++k) {
+				_buffer[k] = value_t(entry[k]);
+			}
+			return _buffer;
+		}
+		return (_forward ? forwardStack : backwardStack)[_i + _position*numMeasurments];
+	}
+	
+	
 	template<class MeasurmentSet>
 	void ADFVariant::InternalSolver<MeasurmentSet>::calculate_residual( const size_t _corePosition ) {
-		Tensor currentValue({});
-		
 		// Look which side of the stack needs less calculations
 		if(forwardUpdates[_corePosition].size() < backwardUpdates[_corePosition].size()) {
 			update_forward_stack(_corePosition, x.get_component(_corePosition));
+			const size_t rank = x.get_component(_corePosition).dimensions[2];
 			
-			#pragma omp parallel for firstprivate(currentValue) schedule(static)
+			#pragma omp parallel for num_threads(numThreads) schedule(static)
 			for(size_t i = 0; i < numMeasurments; ++i) {
-				contract(currentValue, *forwardStack[i + _corePosition*numMeasurments], false, *backwardStack[i + (_corePosition+1)*numMeasurments], false, 1);
-				residual[i] = (measurments.measuredValues[i]-currentValue[0]);
+				residual[i] = measurments.measuredValues[i]-stack_dot_product(i, _corePosition, _corePosition+1, rank);
 			}
 		} else {
 			update_backward_stack(_corePosition, x.get_component(_corePosition));
+			const size_t rank = x.get_component(_corePosition).dimensions[0];
 			
-			#pragma omp parallel for firstprivate(currentValue) schedule(static)
+			#pragma omp parallel for num_threads(numThreads) schedule(static)
 			for(size_t i = 0; i < numMeasurments; ++i) {
-				contract(currentValue, *forwardStack[i + (_corePosition-1)*numMeasurments], false, *backwardStack[i + _corePosition*numMeasurments], false, 1);
-				residual[i] = (measurments.measuredValues[i]-currentValue[0]);
+				residual[i] = measurments.measuredValues[i]-stack_dot_product(i, _corePosition-1, _corePosition, rank);
 			}
 		}
 	}
@@ -361,35 +451,40 @@ namespace xerus {
 		const size_t localLeftRank = x.get_component(_corePosition).dimensions[0];
 		const size_t localRightRank = x.get_component(_corePosition).dimensions[2];
 		
-		projectedGradientComponent.reset({x.dimensions[_corePosition], localLeftRank, localRightRank});
-			
-		#pragma omp parallel
-		{
-			Tensor partialProjGradComp({x.dimensions[_corePosition], localLeftRank, localRightRank}, Tensor::Representation::Dense);
-			
+		// Each shard of measurments is accumulated in its own partial component. NOTE these must not share their data.
+		std::vector<Tensor> partialProjGradComps;
+		partialProjGradComps.reserve(numThreads);
+		for(size_t shard = 0; shard < numThreads; ++shard) {
+			partialProjGradComps.emplace_back(Tensor::DimensionTuple({x.dimensions[_corePosition], localLeftRank, localRightRank}), Tensor::Representation::Dense);
+		}
+		
+		#pragma omp parallel for num_threads(numThreads) schedule(static, 1)
+		for(size_t shard = 0; shard < numThreads; ++shard) {
+			value_t* const partialPtr = partialProjGradComps[shard].get_unsanitized_dense_data();
 			std::unique_ptr<value_t[]> dyadicComponent(std::is_same<MeasurmentSet, RankOneMeasurementSet>::value ? new value_t[localLeftRank*localRightRank] : nullptr);
 			
-			#pragma omp for schedule(static)
-			for(size_t i = 0; i < numMeasurments; ++i) {
-				INTERNAL_CHECK(!forwardStack[i + (_corePosition-1)*numMeasurments]->has_factor() && !backwardStack[i + (_corePosition+1)*numMeasurments]->has_factor(), "IE");
-				
+			// Entries of single precision stacks are widened, so that the gradient is accumulated in double precision.
+			std::unique_ptr<value_t[]> leftEntry(singlePrecisionStacks ? new value_t[localLeftRank] : nullptr);
+			std::unique_ptr<value_t[]> rightEntry(singlePrecisionStacks ? new value_t[localRightRank] : nullptr);
+			
+			for(size_t i = shard*numMeasurments/numThreads; i < (shard+1)*numMeasurments/numThreads; ++i) {
 				// Interestingly writing a dyadic product on our own turns out to be faster than blas...
 				perform_dyadic_product(	localLeftRank, 
 										localRightRank, 
-										forwardStack[i + (_corePosition-1)*numMeasurments]->get_dense_data(),
-										backwardStack[i + (_corePosition+1)*numMeasurments]->get_dense_data(),
-										partialProjGradComp.get_unsanitized_dense_data(),
+										stack_entry(true, i, _corePosition-1, localLeftRank, leftEntry.get()),
+										stack_entry(false, i, _corePosition+1, localRightRank, rightEntry.get()),
+										partialPtr,
 										residual[i],
 										measurments.positions[i][_corePosition],
 										dyadicComponent.get()
   									);
 			}
+		}
 		
-			// Accumulate the partical components
-			#pragma omp critical
-			{
-				projectedGradientComponent += partialProjGradComp;
-			}
+		// Accumulate the partial components in a fixed order
+		projectedGradientComponent = std::move(partialProjGradComps[0]);
+		for(size_t shard = 1; shard < numThreads; ++shard) {
+			projectedGradientComponent += partialProjGradComps[shard];
 		}
 		
 		projectedGradientComponent(r1, i1, r2) = projectedGradientComponent(i1, r1, r2);
@@ -414,59 +509,48 @@ namespace xerus {
 	std::vector<value_t> ADFVariant::InternalSolver<MeasurmentSet>::calculate_slicewise_norm_A_projGrad( const size_t _corePosition) {
 		std::vector<value_t> normAProjGrad(x.dimensions[_corePosition], 0.0);
 		
-		Tensor currentValue({});
+		// Each shard of measurments is accumulated separately
+		std::vector<std::vector<value_t>> partialNormAProjGrads(numThreads, std::vector<value_t>(x.dimensions[_corePosition], 0.0));
 		
 		// Look which side of the stack needs less calculations
 		if(forwardUpdates[_corePosition].size() < backwardUpdates[_corePosition].size()) {
 			update_forward_stack(_corePosition, projectedGradientComponent);
+			const size_t rank = projectedGradientComponent.dimensions[2];
 			
-			#pragma omp parallel firstprivate(currentValue)
-			{
-				std::vector<value_t> partialNormAProjGrad(x.dimensions[_corePosition], 0.0);
-				
-				#pragma omp for schedule(static)
-				for(size_t i = 0; i < numMeasurments; ++i) {
-					contract(currentValue, *forwardStack[i + _corePosition*numMeasurments], false, *backwardStack[i + (_corePosition+1)*numMeasurments], false, 1);
-                    partialNormAProjGrad[position_or_zero(measurments, i, _corePosition)] += misc::sqr(currentValue[0]/**measurmentNorms[i]*/); // TODO measurmentNorms
-				}
-				
-				// Accumulate the partical components
-				#pragma omp critical
-				{
-					for(size_t i = 0; i < normAProjGrad.size(); ++i) {
-						normAProjGrad[i] += partialNormAProjGrad[i];
-					}
+			#pragma omp parallel for num_threads(numThreads) schedule(static, 1)
+			for(size_t shard = 0; shard < numThreads; ++shard) {
+				for(size_t i = shard*numMeasurments/numThreads; i < (shard+1)*numMeasurments/numThreads; ++i) {
+					const value_t currentValue = stack_dot_product(i, _corePosition, _corePosition+1, rank);
+					partialNormAProjGrads[shard][position_or_zero(measurments, i, _corePosition)] += misc::sqr(currentValue/**measurmentNorms[i]*/); // TODO measurmentNorms
 				}
 			}
 		} else {
 			update_backward_stack(_corePosition, projectedGradientComponent);
+			const size_t rank = projectedGradientComponent.dimensions[0];
 			
-			#pragma omp parallel firstprivate(currentValue)
-			{
-				std::vector<value_t> partialNormAProjGrad(x.dimensions[_corePosition], 0.0);
-				
-				#pragma omp for schedule(static)
-				for(size_t i = 0; i < numMeasurments; ++i) {
-					contract(currentValue, *forwardStack[i + (_corePosition-1)*numMeasurments], false, *backwardStack[i + _corePosition*numMeasurments], false, 1);
-                    partialNormAProjGrad[position_or_zero(measurments, i, _corePosition)] += misc::sqr(currentValue[0]/**measurmentNorms[i]*/); // TODO measurmentNorms
-				}
-			
-				// Accumulate the partical components
-				#pragma omp critical
-				{
-					for(size_t i = 0; i < normAProjGrad.size(); ++i) {
-						normAProjGrad[i] += partialNormAProjGrad[i];
-					}
+			#pragma omp parallel for num_threads(numThreads) schedule(static, 1)
+			for(size_t shard = 0; shard < numThreads; ++shard) {
+				for(size_t i = shard*numMeasurments/numThreads; i < (shard+1)*numMeasurments/numThreads; ++i) {
+					const value_t currentValue = stack_dot_product(i, _corePosition-1, _corePosition, rank);
+					partialNormAProjGrads[shard][position_or_zero(measurments, i, _corePosition)] += misc::sqr(currentValue/**measurmentNorms[i]*/); // TODO measurmentNorms
 				}
 			}
 		}
 		
+		// Accumulate the partial norms in a fixed order
+		for(size_t shard = 0; shard < numThreads; ++shard) {
+			for(size_t i = 0; i < normAProjGrad.size(); ++i) {
+				normAProjGrad[i] += partialNormAProjGrads[shard][i];
+			}
+		}
+		
 		return normAProjGrad;
 	}
 	
 	
 	template<>
 	void ADFVariant::InternalSolver<SinglePointMeasurementSet>::update_x(const std::vector<value_t>& _normAProjGrad, const size_t _corePosition) {
+		const bool singlePrecision = x.get_component(_corePosition).is_single_precision();
 		for(size_t j = 0; j < x.dimensions[_corePosition]; ++j) {
 			Tensor localDelta;
 			localDelta(r1, r2) = projectedGradientComponent(r1, j, r2);
@@ -475,15 +559,26 @@ namespace xerus {
 			// Update
 			x.component(_corePosition)(r1, i1, r2) = x.component(_corePosition)(r1, i1, r2) + (PyR/_normAProjGrad[j])*Tensor::dirac({x.dimensions[_corePosition]}, j)(i1)*localDelta(r1, r2);
 		}
+		
+		// The update is calculated in double precision, components stored in single precision stay single
+		if(singlePrecision) {
+			x.component(_corePosition).use_single_precision();
+		}
 	}
 	
 	
 	template<>
 	void ADFVariant::InternalSolver<RankOneMeasurementSet>::update_x(const std::vector<value_t>& _normAProjGrad, const size_t _corePosition) {
 		const value_t PyR = misc::sqr(frob_norm(projectedGradientComponent));
+		const bool singlePrecision = x.get_component(_corePosition).is_single_precision();
 		
 		// Update
 		x.component(_corePosition)(r1, i1, r2) = x.component(_corePosition)(r1, i1, r2) + (PyR/misc::sum(_normAProjGrad))*projectedGradientComponent(r1, i1, r2);
+		
+		// The update is calculated in double precision, components stored in single precision stay single
+		if(singlePrecision) {
+			x.component(_corePosition).use_single_precision();
+		}
 	}
 	
 	template<class MeasurmentSet>
@@ -505,7 +600,6 @@ namespace xerus {
 			lastResidualNorm = residualNorm;
 			double residualNormSqr = 0;
 			
-			#pragma omp parallel for schedule(static) reduction(+:residualNormSqr)
 			for(size_t i = 0; i < numMeasurments; ++i) {
 				residualNormSqr += misc::sqr(residual[i]);
 			}
@@ -570,10 +664,10 @@ namespace xerus {
 		#pragma omp parallel sections
 		{
 			#pragma omp section
-				construct_stacks(forwardStackSaveSlots, forwardUpdates, forwardStackMem, true);
+				construct_stacks(forwardStackSlots, forwardUpdates, true);
 			
 			#pragma omp section
-				construct_stacks(backwardStackSaveSlots, backwardUpdates, backwardStackMem, false);
+				construct_stacks(backwardStackSlots, backwardUpdates, false);
 		}
 		
 		calc_measurment_norm(measurmentNorms.get(), measurments);
@@ -588,7 +682,12 @@ namespace xerus {
 		
 		// If we follow a rank increasing strategie, increase the ransk until we reach the targetResidual, the maxRanks or the maxIterations.
 		while(residualNorm > targetResidualNorm && x.ranks() != maxRanks && (maxIterations == 0 || iteration < maxIterations)) {
-			// Increase the ranks
+			// Increase the ranks, components stored in single precision stay single
+			std::vector<bool> singlePrecision(degree);
+			for(size_t corePosition = 0; corePosition < degree; ++corePosition) {
+				singlePrecision[corePosition] = x.get_component(corePosition).is_single_precision();
+			}
+			
 			x.move_core(0, true);
 			const auto rndTensor = TTTensor::random(x.dimensions, std::vector<size_t>(x.degree()-1, 1));
             const auto diff = (1e-6*frob_norm(x))*rndTensor/frob_norm(rndTensor);
@@ -596,6 +695,12 @@ namespace xerus {
 			
 			x.round(maxRanks);
 			
+			for(size_t corePosition = 0; corePosition < degree; ++corePosition) {
+				if(singlePrecision[corePosition]) {
+					x.component(corePosition).use_single_precision();
+				}
+			}
+			
 			resize_stack_tensors();
 			
 			solve_with_current_ranks();
@@ -22,14 +22,18 @@
 * @brief Implementation of the ALS variants.
 */
 
+#include <numeric>
+#include <exception>
 #include <xerus/misc/math.h>
 
 #include <xerus/algorithms/als.h>
+#include <xerus/blasLapackWrapper.h>
 #include <xerus/basic.h>
 #include <xerus/index.h>
 #include <xerus/indexedTensorList.h>
 #include <xerus/tensorNetwork.h>
 #include <xerus/misc/internal.h>
+#include <xerus/misc/parallel.h>
 
 #include <xerus/indexedTensorMoveable.h>
 #include <xerus/indexedTensor_tensor_factorisations.h>
@@ -40,34 +44,217 @@ namespace xerus {
 	//                                       local solvers
 	// -------------------------------------------------------------------------------------------------------------------------
 	
-	void ALSVariant::lapack_solver(const TensorNetwork& _A, std::vector<Tensor>& _x, const TensorNetwork& _b, const ALSAlgorithmicData& _data) {
-		Tensor A(_A);
-		Tensor b(_b);
-		Tensor x;
-		
-		xerus::solve(x, A, b);
-		
+	void ALSVariant::split_local_solution(Tensor &&_x, std::vector<Tensor> &_components, const ALSAlgorithmicData &_data) {
+		Tensor x(std::move(_x));
 		Index i,j,k,l;
 		if (_data.direction == Increasing) {
 			for (size_t p = 0; p+1 < _data.ALS.sites; ++p) {
 				Tensor U, S;
 // 				calculate_svd(U, S, x, x, 2, _data.targetRank[_data.currIndex+p], EPSILON); TODO
 				(U(i^2,j), S(j,k), x(k,l&1)) = SVD(x(i^2,l&2), _data.targetRank[_data.currIndex+p]);
-				_x[p] = std::move(U);
+				_components[p] = std::move(U);
 				x(j,l&1) = S(j,k) * x(k,l&1);
 			}
-			_x.back() = std::move(x);
+			_components.back() = std::move(x);
 		} else {
 			// direction: decreasing index
 			for (size_t p = _data.ALS.sites-1; p>0; --p) {
 				Tensor S, Vt;
 // 				calculate_svd(x, S, Vt, x, x.degree()-1, _data.targetRank[_data.currIndex+p-1], EPSILON); TODO
 				(x(i&1,j), S(j,k), Vt(k,l&1)) = SVD(x(i&2,l^2), _data.targetRank[_data.currIndex+p-1]);
-				_x[p] = std::move(Vt);
+				_components[p] = std::move(Vt);
 				x(i&1,k) = x(i&1,j) * S(j,k);
 			}
-			_x[0] = std::move(x);
+			_components[0] = std::move(x);
+		}
+	}
+	
+	void ALSVariant::lapack_solver(const TensorNetwork& _A, std::vector<Tensor>& _x, const TensorNetwork& _b, const ALSAlgorithmicData& _data) {
+		Tensor A(_A);
+		Tensor b(_b);
+		Tensor x;
+		
+		xerus::solve(x, A, b);
+		
+		split_local_solution(std::move(x), _x, _data);
+	}
+	
+	void ALSVariant::cg_solver(const TensorNetwork &_A, std::vector<Tensor> &_x, const TensorNetwork &_b, const ALSAlgorithmicData &_data) {
+		Index i,j,k,l;
+		
+		// warm start at the current components
+		Tensor x = _x[0];
+		for (size_t p = 1; p < _data.ALS.sites; ++p) {
+			x(i^(p+1), j, k) = x(i^(p+1), l) * _x[p](l, j, k);
+		}
+		
+		const Tensor b(_b);
+		const value_t tolerance = _data.ALS.localSolverEpsilon * frob_norm(b);
+		const size_t maxIterations = _data.ALS.localSolverMaxIterations > 0 ? _data.ALS.localSolverMaxIterations : x.size;
+		
+		Tensor inverseDiagonal;
+		if (_data.ALS.localSolverPreconditioning) {
+			inverseDiagonal = local_operator_diagonal(_data);
+			value_t* const diagonal = inverseDiagonal.get_dense_data();
+			for (size_t n = 0; n < inverseDiagonal.size; ++n) {
+				diagonal[n] = diagonal[n] > 0.0 ? 1.0/diagonal[n] : 1.0;
+			}
+		}
+		const auto precondition = [&](const Tensor &_residual) {
+			return _data.ALS.localSolverPreconditioning ? entrywise_product(_residual, inverseDiagonal) : _residual;
+		};
+		
+		Tensor residual, Ap;
+		residual(i&0) = b(i&0) - _A(i/2, j/2) * x(j&0);
+		Tensor z = precondition(residual);
+		Tensor p = z;
+		value_t rz = value_t(residual(i&0) * z(i&0));
+		
+		for (size_t iteration = 0; iteration < maxIterations && frob_norm(residual) > tolerance; ++iteration) {
+			Ap(i&0) = _A(i/2, j/2) * p(j&0);
+			const value_t pAp = value_t(p(i&0) * Ap(i&0));
+			if (pAp <= 0.0) {
+				break; // the local operator is only semi-definite and p lies in its kernel
+			}
+			const value_t alpha = rz/pAp;
+			x += alpha*p;
+			residual -= alpha*Ap;
+			
+			z = precondition(residual);
+			const value_t rzNew = value_t(residual(i&0) * z(i&0));
+			p = z + (rzNew/rz)*p;
+			rz = rzNew;
+		}
+		
+		split_local_solution(std::move(x), _x, _data);
+	}
+	
+	void ALSVariant::davidson_solver(const TensorNetwork &_A, Tensor &_x, std::vector<value_t> &_eigenvalues, const ALSAlgorithmicData &_data) {
+		Index i,j;
+		const size_t numEigenpairs = _x.dimensions.back();
+		const Tensor::DimensionTuple localDimensions(_x.dimensions.begin(), _x.dimensions.end()-1);
+		const size_t localSize = misc::product(localDimensions);
+		REQUIRE(numEigenpairs <= localSize, "Cannot calculate " << numEigenpairs << " eigenpairs of a local problem of size " << localSize);
+		const size_t maxBasisSize = std::min(localSize, std::max(4*numEigenpairs, size_t(20)));
+		const size_t maxIterations = _data.ALS.localSolverMaxIterations > 0 ? _data.ALS.localSolverMaxIterations : localSize;
+		
+		// orthonormal basis of the search space, the local operator applied to it and the (lower half of the) projected operator
+		std::vector<Tensor> basis, operatorBasis;
+		std::vector<std::vector<value_t>> projection;
+		const auto extend_basis = [&](Tensor _v) -> bool {
+			value_t norm = frob_norm(_v);
+			if (norm <= 0.0) {
+				return false;
+			}
+			_v /= norm;
+			// classical Gram-Schmidt, repeated once for numerical stability
+			for (size_t pass = 0; pass < 2; ++pass) {
+				for (const Tensor &u : basis) {
+					_v -= value_t(u(i&0) * _v(i&0)) * u;
+				}
+			}
+			norm = frob_norm(_v);
+			if (norm < 1e-8) {
+				return false; // _v is (numerically) contained in the search space
+			}
+			_v /= norm;
+			
+			Tensor Av;
+			Av(i&0) = _A(i/2, j/2) * _v(j&0);
+			projection.emplace_back();
+			for (const Tensor &u : basis) {
+				projection.back().push_back(value_t(u(i&0) * Av(i&0)));
+			}
+			projection.back().push_back(value_t(_v(i&0) * Av(i&0)));
+			basis.push_back(std::move(_v));
+			operatorBasis.push_back(std::move(Av));
+			return true;
+		};
+		
+		// start at the current eigenvectors, completed randomly if they are linearly dependent
+		const Tensor &start = _x;
+		for (size_t c = 0; c < numEigenpairs; ++c) {
+			extend_basis(Tensor(localDimensions, [&](const size_t _pos){ return start[_pos*numEigenpairs + c]; }));
+		}
+		while (basis.size() < numEigenpairs) {
+			extend_basis(Tensor::random(localDimensions));
+		}
+		
+		Tensor diagonal;
+		if (_data.ALS.localSolverPreconditioning) {
+			diagonal = local_operator_diagonal(_data);
+		}
+		
+		std::vector<Tensor> ritz(numEigenpairs), operatorRitz(numEigenpairs);
+		for (size_t iteration = 0; ; ++iteration) {
+			// Rayleigh-Ritz: the eigenpairs of the projected operator are the best approximations within the search space
+			const size_t m = basis.size();
+			std::unique_ptr<value_t[]> H(new value_t[m*m]), V(new value_t[m*m]), lambda(new value_t[m]);
+			for (size_t a = 0; a < m; ++a) {
+				for (size_t b = 0; b <= a; ++b) {
+					H[a*m+b] = H[b*m+a] = projection[a][b];
+				}
+			}
+			blasWrapper::symmetric_eigen_decomposition(V.get(), lambda.get(), H.get(), m);
+			
+			for (size_t c = 0; c < numEigenpairs; ++c) {
+				ritz[c] = Tensor(localDimensions, Tensor::Representation::Dense);
+				operatorRitz[c] = Tensor(localDimensions, Tensor::Representation::Dense);
+				for (size_t a = 0; a < m; ++a) {
+					ritz[c] += V[a*m+c] * basis[a];
+					operatorRitz[c] += V[a*m+c] * operatorBasis[a];
+				}
+			}
+			_eigenvalues.assign(lambda.get(), lambda.get()+numEigenpairs);
+			
+			const value_t tolerance = _data.ALS.localSolverEpsilon * std::max(std::abs(lambda[0]), std::abs(lambda[m-1]));
+			std::vector<std::pair<size_t, Tensor>> residuals;
+			for (size_t c = 0; c < numEigenpairs; ++c) {
+				Tensor residual = operatorRitz[c] - lambda[c]*ritz[c];
+				if (frob_norm(residual) > tolerance) {
+					residuals.emplace_back(c, std::move(residual));
+				}
+			}
+			if (residuals.empty() || iteration >= maxIterations) {
+				break;
+			}
+			
+			// restart at the current approximations if the search space would grow too large
+			if (m + residuals.size() > maxBasisSize) {
+				basis = ritz;
+				operatorBasis = operatorRitz;
+				projection.clear();
+				for (size_t c = 0; c < numEigenpairs; ++c) {
+					projection.emplace_back(c, 0.0);
+					projection.back().push_back(lambda[c]);
+				}
+			}
+			
+			size_t numAdded = 0;
+			for (std::pair<size_t, Tensor> &residual : residuals) {
+				if (_data.ALS.localSolverPreconditioning) {
+					// Davidson correction (D - lambda)^-1 r, without preconditioning the search space is the Krylov space of Lanczos
+					value_t* const r = residual.second.get_dense_data();
+					const value_t* const D = diagonal.get_dense_data();
+					for (size_t n = 0; n < localSize; ++n) {
+						const value_t shift = D[n] - lambda[residual.first];
+						if (std::abs(shift) > tolerance) {
+							r[n] /= shift;
+						}
+					}
+				}
+				if (extend_basis(std::move(residual.second))) {
+					numAdded += 1;
+				}
+			}
+			if (numAdded == 0) {
+				break; // the search space cannot be extended any further
+			}
 		}
+		
+		// the eigenvectors are stored along the last mode
+		const std::vector<Tensor> &eigenvectors = ritz;
+		_x = Tensor(_x.dimensions, [&](const size_t _pos){ return eigenvectors[_pos%numEigenpairs][_pos/numEigenpairs]; });
 	}
 	
 	void ALSVariant::ASD_solver(const TensorNetwork &_A, std::vector<Tensor> &_x, const TensorNetwork &_b, const ALSAlgorithmicData &_data) {
@@ -181,148 +368,516 @@ namespace xerus {
 		optimizedRange = std::pair<size_t, size_t>(firstOptimizedIndex, firstNotOptimizedIndex);
 	}
 
-	TensorNetwork ALSVariant::ALSAlgorithmicData::localOperatorSlice(size_t _pos) {
-		//TODO optimization: create these networks without indices
-		Index cr1, cr2, cr3, cr4, r1, r2, r3, r4, n1, n2, n3;
-		TensorNetwork res;
+	/// @brief returns the dense data of @a _comp in precision T and multiplies its factor into @a _factor. Sparse tensors and tensors of the other precision are copied into @a _copy first.
+	template<class T> static const T* dense_data(const Tensor &_comp, Tensor &_copy, value_t &_factor);
+	
+	template<> const value_t* dense_data<value_t>(const Tensor &_comp, Tensor &_copy, value_t &_factor) {
+		if (_comp.is_sparse() || _comp.is_single_precision()) {
+			_copy = _comp;
+			_copy.use_dense_representation();
+			_copy.use_double_precision();
+			_factor *= _copy.factor;
+			return _copy.get_unsanitized_dense_data();
+		}
+		_factor *= _comp.factor;
+		return _comp.get_unsanitized_dense_data();
+	}
+	
+	template<> const float* dense_data<float>(const Tensor &_comp, Tensor &_copy, value_t &_factor) {
+		if (!_comp.is_single_precision()) {
+			_copy = _comp;
+			_copy.use_single_precision();
+			_factor *= _copy.factor;
+			return _copy.get_unsanitized_single_data();
+		}
+		_factor *= _comp.factor;
+		return _comp.get_unsanitized_single_data();
+	}
+	
+	template<> std::vector<value_t>& ALSVariant::ALSAlgorithmicData::SliceStack::workspace<value_t>(const size_t _i) {
+		return _i == 1 ? workspace1 : workspace2;
+	}
+	
+	template<> std::vector<float>& ALSVariant::ALSAlgorithmicData::SliceStack::workspace<float>(const size_t _i) {
+		return _i == 1 ? singleWorkspace1 : singleWorkspace2;
+	}
+	
+	template<> value_t* ALSVariant::ALSAlgorithmicData::SliceStack::result_buffer<value_t>(Tensor &_res, const Tensor::DimensionTuple &_dims) {
+		_res.reset(_dims, Tensor::Representation::Dense, Tensor::Initialisation::None);
+		return _res.override_dense_data();
+	}
+	
+	template<> float* ALSVariant::ALSAlgorithmicData::SliceStack::result_buffer<float>(Tensor &_res, const Tensor::DimensionTuple &_dims) {
+		_res.reset(_dims, Tensor::Representation::Dense, Tensor::Initialisation::None);
+		singleResult.resize(_res.size);
+		return singleResult.data();
+	}
+	
+	template<> void ALSVariant::ALSAlgorithmicData::SliceStack::store_result<value_t>(Tensor &/*_res*/) { }
+	
+	template<> void ALSVariant::ALSAlgorithmicData::SliceStack::store_result<float>(Tensor &_res) {
+		value_t* const data = _res.override_dense_data();
+		for (size_t i = 0; i < _res.size; ++i) {
+			data[i] = value_t(singleResult[i]);
+		}
+	}
+	
+	template<class T>
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_two_layer_left_impl(const Tensor &_v1, const Tensor &_v2) {
+		Tensor &res = push();
+		const Tensor &prev = entries[height-2];
+		const size_t R1 = _v1.dimensions[0], N = _v1.dimensions[1], C1 = _v1.dimensions[2];
+		const size_t R2 = _v2.dimensions[0], C2 = _v2.dimensions[2];
+		INTERNAL_CHECK(prev.is_dense(), "ie");
+		value_t factor = 1.0;
+		const T* const L = dense_data<T>(prev, denseCopy3, factor);
+		const T* const V1 = dense_data<T>(_v1, denseCopy1, factor);
+		const T* const V2 = dense_data<T>(_v2, denseCopy2, factor);
+		std::vector<T> &work1 = workspace<T>(1);
+		
+		// T1(r1,n,c2) = L(r1,r2) * V2(r2,n,c2)
+		work1.resize(R1*N*C2);
+		blasWrapper::matrix_matrix_product(work1.data(), R1, N*C2, T(1), L, false, R2, V2, false);
+		
+		// res(c1,c2) = V1(r1,n,c1) * T1(r1,n,c2)
+		blasWrapper::matrix_matrix_product(result_buffer<T>(res, {C1, C2}), C1, C2, T(factor), V1, true, R1*N, work1.data(), false);
+		store_result<T>(res);
+	}
+	
+	template<class T>
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_two_layer_right_impl(const Tensor &_v1, const Tensor &_v2) {
+		Tensor &res = push();
+		const Tensor &prev = entries[height-2];
+		const size_t R1 = _v1.dimensions[0], N = _v1.dimensions[1], C1 = _v1.dimensions[2];
+		const size_t R2 = _v2.dimensions[0], C2 = _v2.dimensions[2];
+		INTERNAL_CHECK(prev.is_dense(), "ie");
+		value_t factor = 1.0;
+		const T* const R = dense_data<T>(prev, denseCopy3, factor);
+		const T* const V1 = dense_data<T>(_v1, denseCopy1, factor);
+		const T* const V2 = dense_data<T>(_v2, denseCopy2, factor);
+		std::vector<T> &work1 = workspace<T>(1);
+		
+		// T1(r1,n,c2) = V1(r1,n,c1) * R(c1,c2)
+		work1.resize(R1*N*C2);
+		blasWrapper::matrix_matrix_product(work1.data(), R1*N, C2, T(1), V1, false, C1, R, false);
+		
+		// res(r1,r2) = T1(r1,n,c2) * V2(r2,n,c2)
+		blasWrapper::matrix_matrix_product(result_buffer<T>(res, {R1, R2}), R1, R2, T(factor), work1.data(), false, N*C2, V2, true);
+		store_result<T>(res);
+	}
+	
+	template<class T>
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_three_layer_left_impl(const Tensor &_v1, const Tensor &_At, const Tensor &_v3) {
+		Tensor &res = push();
+		const Tensor &prev = entries[height-2];
+		const size_t R1 = _v1.dimensions[0], N = _v1.dimensions[1], C1 = _v1.dimensions[2];
+		const size_t R2 = _At.dimensions[0], M = _At.dimensions[1], C2 = _At.dimensions[3];
+		const size_t R3 = _v3.dimensions[0], C3 = _v3.dimensions[2];
+		INTERNAL_CHECK(prev.is_dense(), "ie");
+		value_t factor = 1.0;
+		const T* const L = dense_data<T>(prev, denseCopy3, factor);
+		const T* const V1 = dense_data<T>(_v1, denseCopy1, factor);
+		const T* const V3 = dense_data<T>(_v3, denseCopy2, factor);
+		const T* const At = dense_data<T>(_At, denseCopy4, factor);
+		std::vector<T> &work1 = workspace<T>(1), &work2 = workspace<T>(2);
+		
+		// T1(r1,r2,m,c3) = L(r1,r2,r3) * V3(r3,m,c3)
+		work1.resize(R1*R2*M*C3);
+		blasWrapper::matrix_matrix_product(work1.data(), R1*R2, M*C3, T(1), L, false, R3, V3, false);
+		
+		// T2(r1,n,c2,c3) = At(r2,m,n,c2) * T1(r1,r2,m,c3) for every r1
+		work2.resize(R1*N*C2*C3);
+		for (size_t r1 = 0; r1 < R1; ++r1) {
+			blasWrapper::matrix_matrix_product(work2.data()+r1*N*C2*C3, N*C2, C3, T(1), At, true, R2*M, work1.data()+r1*R2*M*C3, false);
+		}
+		
+		// res(c1,c2,c3) = V1(r1,n,c1) * T2(r1,n,c2,c3)
+		blasWrapper::matrix_matrix_product(result_buffer<T>(res, {C1, C2, C3}), C1, C2*C3, T(factor), V1, true, R1*N, work2.data(), false);
+		store_result<T>(res);
+	}
+	
+	template<class T>
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_three_layer_right_impl(const Tensor &_v1, const Tensor &_At, const Tensor &_v3) {
+		Tensor &res = push();
+		const Tensor &prev = entries[height-2];
+		const size_t R1 = _v1.dimensions[0], N = _v1.dimensions[1], C1 = _v1.dimensions[2];
+		const size_t R2 = _At.dimensions[0], M = _At.dimensions[1], C2 = _At.dimensions[3];
+		const size_t R3 = _v3.dimensions[0], C3 = _v3.dimensions[2];
+		INTERNAL_CHECK(prev.is_dense(), "ie");
+		value_t factor = 1.0;
+		const T* const R = dense_data<T>(prev, denseCopy3, factor);
+		const T* const V1 = dense_data<T>(_v1, denseCopy1, factor);
+		const T* const V3 = dense_data<T>(_v3, denseCopy2, factor);
+		const T* const At = dense_data<T>(_At, denseCopy4, factor);
+		std::vector<T> &work1 = workspace<T>(1), &work2 = workspace<T>(2);
+		
+		// T1(r1,n,c2,c3) = V1(r1,n,c1) * R(c1,c2,c3)
+		work1.resize(R1*N*C2*C3);
+		blasWrapper::matrix_matrix_product(work1.data(), R1*N, C2*C3, T(1), V1, false, C1, R, false);
+		
+		// T2(r1,r2,m,c3) = At(r2,m,n,c2) * T1(r1,n,c2,c3) for every r1
+		work2.resize(R1*R2*M*C3);
+		for (size_t r1 = 0; r1 < R1; ++r1) {
+			blasWrapper::matrix_matrix_product(work2.data()+r1*R2*M*C3, R2*M, C3, T(1), At, false, N*C2, work1.data()+r1*N*C2*C3, false);
+		}
+		
+		// res(r1,r2,r3) = T2(r1,r2,m,c3) * V3(r3,m,c3)
+		blasWrapper::matrix_matrix_product(result_buffer<T>(res, {R1, R2, R3}), R1*R2, R3, T(factor), work2.data(), false, M*C3, V3, true);
+		store_result<T>(res);
+	}
+	
+	template<class T>
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_four_layer_left_impl(const Tensor &_x, const Tensor &_A, const Tensor &_At) {
+		Tensor &res = push();
+		const Tensor &prev = entries[height-2];
+		const size_t R1 = _x.dimensions[0], N = _x.dimensions[1], C1 = _x.dimensions[2];
+		const size_t R2 = _A.dimensions[0], M = _A.dimensions[1], C2 = _A.dimensions[3];
+		INTERNAL_CHECK(prev.is_dense(), "ie");
+		value_t factor = 1.0;
+		const T* const L = dense_data<T>(prev, denseCopy3, factor);
+		const T* const X = dense_data<T>(_x, denseCopy2, factor);
+		const T* const A = dense_data<T>(_A, denseCopy1, factor);
+		const T* const At = dense_data<T>(_At, denseCopy4, factor);
+		std::vector<T> &work1 = workspace<T>(1), &work2 = workspace<T>(2);
+		
+		// T1(r1,r2,r3,n3,c4) = L(r1,r2,r3,r4) * X(r4,n3,c4)
+		work1.resize(R1*R2*R2*N*C1);
+		blasWrapper::matrix_matrix_product(work1.data(), R1*R2*R2, N*C1, T(1), L, false, R1, X, false);
+		
+		// T2(r1,r2,n2,c3,c4) = At(r3,n3,n2,c3) * T1(r1,r2,r3,n3,c4) for every r1,r2
+		work2.resize(R1*R2*M*C2*C1);
+		for (size_t r12 = 0; r12 < R1*R2; ++r12) {
+			blasWrapper::matrix_matrix_product(work2.data()+r12*M*C2*C1, M*C2, C1, T(1), At, true, R2*N, work1.data()+r12*R2*N*C1, false);
+		}
+		
+		// T3(r1,n1,c2,c3,c4) = A(r2,n2,n1,c2) * T2(r1,r2,n2,c3,c4) for every r1
+		work1.resize(R1*N*C2*C2*C1);
+		for (size_t r1 = 0; r1 < R1; ++r1) {
+			blasWrapper::matrix_matrix_product(work1.data()+r1*N*C2*C2*C1, N*C2, C2*C1, T(1), A, true, R2*M, work2.data()+r1*R2*M*C2*C1, false);
+		}
+		
+		// res(c1,c2,c3,c4) = X(r1,n1,c1) * T3(r1,n1,c2,c3,c4)
+		blasWrapper::matrix_matrix_product(result_buffer<T>(res, {C1, C2, C2, C1}), C1, C2*C2*C1, T(factor), X, true, R1*N, work1.data(), false);
+		store_result<T>(res);
+	}
+	
+	template<class T>
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_four_layer_right_impl(const Tensor &_x, const Tensor &_A, const Tensor &_At) {
+		Tensor &res = push();
+		const Tensor &prev = entries[height-2];
+		const size_t R1 = _x.dimensions[0], N = _x.dimensions[1], C1 = _x.dimensions[2];
+		const size_t R2 = _A.dimensions[0], M = _A.dimensions[1], C2 = _A.dimensions[3];
+		INTERNAL_CHECK(prev.is_dense(), "ie");
+		value_t factor = 1.0;
+		const T* const R = dense_data<T>(prev, denseCopy3, factor);
+		const T* const X = dense_data<T>(_x, denseCopy2, factor);
+		const T* const A = dense_data<T>(_A, denseCopy1, factor);
+		const T* const At = dense_data<T>(_At, denseCopy4, factor);
+		std::vector<T> &work1 = workspace<T>(1), &work2 = workspace<T>(2);
+		
+		// T1(r1,n1,c2,c3,c4) = X(r1,n1,c1) * R(c1,c2,c3,c4)
+		work1.resize(R1*N*C2*C2*C1);
+		blasWrapper::matrix_matrix_product(work1.data(), R1*N, C2*C2*C1, T(1), X, false, C1, R, false);
+		
+		// T2(r1,r2,n2,c3,c4) = A(r2,n2,n1,c2) * T1(r1,n1,c2,c3,c4) for every r1
+		work2.resize(R1*R2*M*C2*C1);
+		for (size_t r1 = 0; r1 < R1; ++r1) {
+			blasWrapper::matrix_matrix_product(work2.data()+r1*R2*M*C2*C1, R2*M, C2*C1, T(1), A, false, N*C2, work1.data()+r1*N*C2*C2*C1, false);
+		}
+		
+		// T3(r1,r2,r3,n3,c4) = At(r3,n3,n2,c3) * T2(r1,r2,n2,c3,c4) for every r1,r2
+		work1.resize(R1*R2*R2*N*C1);
+		for (size_t r12 = 0; r12 < R1*R2; ++r12) {
+			blasWrapper::matrix_matrix_product(work1.data()+r12*R2*N*C1, R2*N, C1, T(1), At, false, M*C2, work2.data()+r12*M*C2*C1, false);
+		}
+		
+		// res(r1,r2,r3,r4) = T3(r1,r2,r3,n3,c4) * X(r4,n3,c4)
+		blasWrapper::matrix_matrix_product(result_buffer<T>(res, {R1, R2, R2, R1}), R1*R2*R2, R1, T(factor), work1.data(), false, N*C1, X, true);
+		store_result<T>(res);
+	}
+	
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_two_layer_left(const Tensor &_v1, const Tensor &_v2) {
+		if (_v1.is_single_precision() || _v2.is_single_precision()) {
+			push_two_layer_left_impl<float>(_v1, _v2);
+		} else {
+			push_two_layer_left_impl<value_t>(_v1, _v2);
+		}
+	}
+	
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_two_layer_right(const Tensor &_v1, const Tensor &_v2) {
+		if (_v1.is_single_precision() || _v2.is_single_precision()) {
+			push_two_layer_right_impl<float>(_v1, _v2);
+		} else {
+			push_two_layer_right_impl<value_t>(_v1, _v2);
+		}
+	}
+	
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_three_layer_left(const Tensor &_v1, const Tensor &_At, const Tensor &_v3) {
+		if (_v1.is_single_precision() || _At.is_single_precision() || _v3.is_single_precision()) {
+			push_three_layer_left_impl<float>(_v1, _At, _v3);
+		} else {
+			push_three_layer_left_impl<value_t>(_v1, _At, _v3);
+		}
+	}
+	
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_three_layer_right(const Tensor &_v1, const Tensor &_At, const Tensor &_v3) {
+		if (_v1.is_single_precision() || _At.is_single_precision() || _v3.is_single_precision()) {
+			push_three_layer_right_impl<float>(_v1, _At, _v3);
+		} else {
+			push_three_layer_right_impl<value_t>(_v1, _At, _v3);
+		}
+	}
+	
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_four_layer_left(const Tensor &_x, const Tensor &_A, const Tensor &_At) {
+		if (_x.is_single_precision() || _A.is_single_precision()) {
+			push_four_layer_left_impl<float>(_x, _A, _At);
+		} else {
+			push_four_layer_left_impl<value_t>(_x, _A, _At);
+		}
+	}
+	
+	void ALSVariant::ALSAlgorithmicData::SliceStack::push_four_layer_right(const Tensor &_x, const Tensor &_A, const Tensor &_At) {
+		if (_x.is_single_precision() || _A.is_single_precision()) {
+			push_four_layer_right_impl<float>(_x, _A, _At);
+		} else {
+			push_four_layer_right_impl<value_t>(_x, _A, _At);
+		}
+	}
+	
+	void ALSVariant::ALSAlgorithmicData::push_left_operator_slice(size_t _pos) {
 		INTERNAL_CHECK(A, "ie");
 		if (ALS.assumeSPD) {
-			res(r1,r2,r3, cr1,cr2,cr3) = x.get_component(_pos)(r1, n1, cr1) 
-										* A->get_component(_pos)(r2, n1, n2, cr2) 
-										* x.get_component(_pos)(r3, n2, cr3);
+			localOperatorCache.left.push_three_layer_left(x.get_component(_pos), transposedOperatorComponents[_pos], x.get_component(_pos));
 		} else {
-			res(r1,r2,r3,r4, cr1,cr2,cr3, cr4) = x.get_component(_pos)(r1, n1, cr1) 
-										* A->get_component(_pos)(r2, n2, n1, cr2) 
-										* A->get_component(_pos)(r3, n2, n3, cr3) 
-										* x.get_component(_pos)(r4, n3, cr4);
+			localOperatorCache.left.push_four_layer_left(x.get_component(_pos), operatorComponents[_pos], transposedOperatorComponents[_pos]);
 		}
-		return res;
 	}
 	
-	TensorNetwork ALSVariant::ALSAlgorithmicData::localRhsSlice(size_t _pos) {
-		//TODO optimization: create these networks without indices
-		Index cr1, cr2, cr3, r1, r2, r3, n1, n2;
-		TensorNetwork res;
+	void ALSVariant::ALSAlgorithmicData::push_right_operator_slice(size_t _pos) {
+		INTERNAL_CHECK(A, "ie");
+		if (ALS.assumeSPD) {
+			localOperatorCache.right.push_three_layer_right(x.get_component(_pos), transposedOperatorComponents[_pos], x.get_component(_pos));
+		} else {
+			localOperatorCache.right.push_four_layer_right(x.get_component(_pos), operatorComponents[_pos], transposedOperatorComponents[_pos]);
+		}
+	}
+	
+	void ALSVariant::ALSAlgorithmicData::push_left_rhs_slice(size_t _pos) {
+		INTERNAL_CHECK(b, "ie");
+		if (ALS.assumeSPD || (A == nullptr)) {
+			rhsCache.left.push_two_layer_left(b->get_component(_pos), x.get_component(_pos));
+		} else {
+			rhsCache.left.push_three_layer_left(b->get_component(_pos), transposedOperatorComponents[_pos], x.get_component(_pos));
+		}
+	}
+	
+	void ALSVariant::ALSAlgorithmicData::push_right_rhs_slice(size_t _pos) {
+		INTERNAL_CHECK(b, "ie");
 		if (ALS.assumeSPD || (A == nullptr)) {
-			res(r1,r2, cr1,cr2) = b.get_component(_pos)(r1, n1, cr1) 
-									* x.get_component(_pos)(r2, n1, cr2);
+			rhsCache.right.push_two_layer_right(b->get_component(_pos), x.get_component(_pos));
 		} else {
-			res(r1,r2,r3, cr1,cr2,cr3) = b.get_component(_pos)(r1, n1, cr1) 
-												* A->get_component(_pos)(r2, n1, n2, cr2) 
-												* x.get_component(_pos)(r3, n2, cr3);
+			rhsCache.right.push_three_layer_right(b->get_component(_pos), transposedOperatorComponents[_pos], x.get_component(_pos));
 		}
-		return res;
 	}
+
 	
 	void ALSVariant::ALSAlgorithmicData::prepare_stacks() {
 		const size_t d = x.degree();
-		Index r1,r2;
 		
-		Tensor tmpA;
-		Tensor tmpB;
+		// number of flops of the matrix-matrix products that contract the slices onto the stacks, cf. SliceStack
+		size_t work = 0;
+		for (size_t i = 0; i < d; ++i) {
+			const Tensor& comp = x.get_component(i);
+			const size_t r = std::max(comp.dimensions.front(), comp.dimensions.back());
+			const size_t n = comp.dimensions[1];
+			size_t a = 0;
+			if (A != nullptr) {
+				const Tensor& AComp = A->get_component(i);
+				a = std::max(AComp.dimensions.front(), AComp.dimensions.back());
+				work += ALS.assumeSPD ? comp.size*a*(2*r + a*n) : 2*comp.size*a*a*(r + a*n);
+			}
+			if (b != nullptr) {
+				const Tensor& bComp = b->get_component(i);
+				const size_t rb = std::max(bComp.dimensions.front(), bComp.dimensions.back());
+				work += (ALS.assumeSPD || A == nullptr) ? 2*comp.size*rb : comp.size*a*(2*rb + a*n);
+			}
+		}
+		const size_t numThreads = misc::get_num_threads(work);
+		
+		if (A != nullptr) {
+			operatorComponents.resize(d);
+			transposedOperatorComponents.resize(d);
+			#pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+			for (size_t i = 0; i < d; ++i) {
+				Index r1, r2, n1, n2;
+				operatorComponents[i] = A->get_component(i);
+				operatorComponents[i].use_dense_representation();
+				operatorComponents[i].ensure_own_data_and_apply_factor();
+				transposedOperatorComponents[i](r1, n1, n2, r2) = operatorComponents[i](r1, n2, n1, r2);
+				transposedOperatorComponents[i].use_dense_representation();
+				transposedOperatorComponents[i].ensure_own_data_and_apply_factor();
+			}
+		}
+		
+		// reserve all entries up front, so that pushing onto a stack never moves the existing entries
+		localOperatorCache.left.entries.reserve(d+1);
+		localOperatorCache.right.entries.reserve(d+1);
+		rhsCache.left.entries.reserve(d+1);
+		rhsCache.right.entries.reserve(d+1);
+		
 		if (ALS.assumeSPD || (A == nullptr)) {
-			tmpA = Tensor::ones({1,1,1});
-			tmpB = Tensor::ones({1,1});
+			localOperatorCache.left.push() = Tensor::ones({1,1,1});
+			localOperatorCache.right.push() = Tensor::ones({1,1,1});
 		} else {
-			tmpA = Tensor::ones({1,1,1,1});
-			tmpB = Tensor::ones({1,1,1});
+			localOperatorCache.left.push() = Tensor::ones({1,1,1,1});
+			localOperatorCache.right.push() = Tensor::ones({1,1,1,1});
+		}
+		if (b != nullptr) {
+			const Tensor ones = (ALS.assumeSPD || (A == nullptr)) ? Tensor::ones({1,1}) : Tensor::ones({1,1,1});
+			rhsCache.left.push() = ones;
+			rhsCache.right.push() = ones;
 		}
 		
+		// the four stacks are independent of each other and each of them has its own scratch buffers.
+		// Exceptions must not leave the parallel region, so the first one is stored and rethrown afterwards.
+		std::exception_ptr error;
+		const auto run_section = [&error](const std::function<void()>& _section) {
+			try {
+				_section();
+			} catch (...) {
+				#pragma omp critical(xerus_als_prepare_stacks)
+				if (!error) { error = std::current_exception(); }
+			}
+		};
 		
-		localOperatorCache.left.emplace_back(tmpA);
-		localOperatorCache.right.emplace_back(tmpA);
-		rhsCache.left.emplace_back(tmpB);
-		rhsCache.right.emplace_back(tmpB);
+		#pragma omp parallel sections num_threads(std::min(numThreads, size_t(4)))
+		{
+			#pragma omp section
+			if (A != nullptr) {
+				run_section([&](){
+					for (size_t i = d-1; i > optimizedRange.first + ALS.sites - 1; --i) {
+						push_right_operator_slice(i);
+					}
+				});
+			}
+			
+			#pragma omp section
+			if (b != nullptr) {
+				run_section([&](){
+					for (size_t i = d-1; i > optimizedRange.first + ALS.sites - 1; --i) {
+						push_right_rhs_slice(i);
+					}
+				});
+			}
+			
+			#pragma omp section
+			if (A != nullptr) {
+				run_section([&](){
+					for (size_t i = 0; i < optimizedRange.first; ++i) {
+						push_left_operator_slice(i);
+					}
+				});
+			}
+			
+			#pragma omp section
+			if (b != nullptr) {
+				run_section([&](){
+					for (size_t i = 0; i < optimizedRange.first; ++i) {
+						push_left_rhs_slice(i);
+					}
+				});
+			}
+		}
 		
-		for (size_t i = d-1; i > optimizedRange.first + ALS.sites - 1; --i) {
+		if (error) { std::rethrow_exception(error); }
+	}
+	
+	/// @brief returns the full contraction of the dense tensors @a _a and @a _b of equal dimensions
+	static value_t full_contraction(const Tensor &_a, const Tensor &_b) {
+		INTERNAL_CHECK(_a.is_dense() && _b.is_dense() && _a.dimensions == _b.dimensions, "ie");
+		return _a.factor*_b.factor*blasWrapper::dot_product(_a.get_unsanitized_dense_data(), _a.size, _b.get_unsanitized_dense_data());
+	}
+	
+	std::pair<value_t, value_t> ALSVariant::ALSAlgorithmicData::contract_current_window() {
+		for (size_t i = 0; i < ALS.sites; ++i) {
 			if (A != nullptr) {
-				tmpA(r1&0) = localOperatorCache.right.back()(r2&0) * localOperatorSlice(i)(r1/2, r2/2);
-				localOperatorCache.right.emplace_back(tmpA);
+				push_left_operator_slice(currIndex+i);
+			}
+			if (b != nullptr) {
+				push_left_rhs_slice(currIndex+i);
 			}
-			tmpB(r1&0) = rhsCache.right.back()(r2&0) * localRhsSlice(i)(r1/2, r2/2);
-			rhsCache.right.emplace_back(tmpB);
 		}
-		for (size_t i = 0; i < optimizedRange.first; ++i) {
+		
+		std::pair<value_t, value_t> result(0.0, 0.0);
+		if (A != nullptr) {
+			result.first = full_contraction(localOperatorCache.left.back(), localOperatorCache.right.back());
+		}
+		if (b != nullptr) {
+			result.second = full_contraction(rhsCache.left.back(), rhsCache.right.back());
+		}
+		
+		for (size_t i = 0; i < ALS.sites; ++i) {
 			if (A != nullptr) {
-				tmpA(r2&0) = localOperatorCache.left.back()(r1&0) * localOperatorSlice(i)(r1/2, r2/2);
-				localOperatorCache.left.emplace_back((tmpA));
+				localOperatorCache.left.pop_back();
+			}
+			if (b != nullptr) {
+				rhsCache.left.pop_back();
 			}
-			tmpB(r2&0) = rhsCache.left.back()(r1&0) * localRhsSlice(i)(r1/2, r2/2);
-			rhsCache.left.emplace_back(tmpB);
 		}
+		return result;
 	}
 	
 	void ALSVariant::ALSAlgorithmicData::choose_energy_functional() {
-		if (A != nullptr) {
+		if (b == nullptr) {
+			// eigenvalue problem: the energy is the sum of the current approximations of the eigenvalues
+			energy_f = [&](){
+				return std::accumulate(eigenvalues.begin(), eigenvalues.end(), 0.0);
+			};
+			residual_f = energy_f;
+		} else if (A != nullptr) {
 			if (ALS.assumeSPD) {
 				residual_f = [&](){
 					Index n1, n2;
-					return frob_norm((*A)(n1/2,n2/2)*x(n2&0) - b(n1&0))/normB;
+					return frob_norm((*A)(n1/2,n2/2)*x(n2&0) - (*b)(n1&0))/normB;
 				};
 				if (ALS.useResidualForEndCriterion) {
 					energy_f = residual_f;
 				} else {
 					energy_f = [&](){
-						Index r1,r2;
-						Tensor res;
 						// 0.5*<x,Ax> - <x,b>
-						TensorNetwork xAx = localOperatorCache.left.back();
-						TensorNetwork bx = rhsCache.left.back();
-						for (size_t i=0; i<ALS.sites; ++i) {
-							xAx(r2&0) = xAx(r1&0) * localOperatorSlice(currIndex+i)(r1/2, r2/2);
-							bx(r2&0) = bx(r1&0) * localRhsSlice(currIndex+i)(r1/2, r2/2);
-						}
-						res() = 0.5*xAx(r1&0) * localOperatorCache.right.back()(r1&0)
-								- bx(r1&0) * rhsCache.right.back()(r1&0);
-						return res.frob_norm();
+						const std::pair<value_t, value_t> xAx_bx = contract_current_window();
+						return std::abs(0.5*xAx_bx.first - xAx_bx.second);
 					};
 				}
 			} else {
 				// not Symmetric pos def
 				residual_f = [&](){
-					Index r1,r2;
-					Tensor res;
 					// <Ax,Ax> - 2 * <Ax,b> + <b,b>
-					TensorNetwork xAtAx = localOperatorCache.left.back();
-					TensorNetwork bAx = rhsCache.left.back();
-					for (size_t i=0; i<ALS.sites; ++i) {
-						xAtAx(r2&0) = xAtAx(r1&0) * localOperatorSlice(currIndex+i)(r1/2, r2/2);
-						bAx(r2&0) = bAx(r1&0) * localRhsSlice(currIndex+i)(r1/2, r2/2);
-					}
-					res() = xAtAx(r1&0) * localOperatorCache.right.back()(r1&0)
-							- 2 * bAx(r1&0) * rhsCache.right.back()(r1&0);
-					return std::sqrt(res[0] + misc::sqr(normB))/normB;
+					const std::pair<value_t, value_t> xAtAx_bAx = contract_current_window();
+					return std::sqrt(xAtAx_bAx.first - 2*xAtAx_bAx.second + misc::sqr(normB))/normB;
 				};
 				energy_f = residual_f;
 			}
 		} else {
 			// no operator A given
 			residual_f = [&](){
-				return frob_norm(x - b);
+				return frob_norm(x - *b);
 			};
 			if (ALS.useResidualForEndCriterion) {
 				energy_f = residual_f;
 			} else {
 				energy_f = [&](){
-					Index r1,r2;
-					Tensor res;
 					// 0.5*<x,Ax> - <x,b> = 0.5*|x_i|^2 - <x,b>
-					TensorNetwork bx = rhsCache.left.back();
-					for (size_t i=0; i<ALS.sites; ++i) {
-						bx(r2&0) = bx(r1&0) * localRhsSlice(currIndex+i)(r1/2, r2/2);
-					}
-					res() = 0.5*x.get_component(currIndex)(r1&0) * x.get_component(currIndex)(r1&0) 
-							- bx(r1&0) * rhsCache.right.back()(r1&0);
-					return res[0];
+					return 0.5*misc::sqr(x.get_component(currIndex).frob_norm()) - contract_current_window().second;
 				};
 			}
 		}
 	}
 	
-	ALSVariant::ALSAlgorithmicData::ALSAlgorithmicData(const ALSVariant &_ALS, const TTOperator *_A, TTTensor &_x, const TTTensor &_b) 
+	ALSVariant::ALSAlgorithmicData::ALSAlgorithmicData(const ALSVariant &_ALS, const TTOperator *_A, TTTensor &_x, const TTTensor *_b) 
 		: ALS(_ALS), A(_A), x(_x), b(_b)
 		, targetRank(_x.ranks())
-		, normB(frob_norm(_b))
+		, normB(_b != nullptr ? frob_norm(*_b) : 0.0)
 		, canonicalizeAtTheEnd(_x.canonicalized)
 		, corePosAtTheEnd(_x.corePosition)
 		, lastEnergy2(1e102)
@@ -338,8 +893,6 @@ namespace xerus {
 	}
 
 	void ALSVariant::ALSAlgorithmicData::move_to_next_index() {
-		Index r1,r2;
-		Tensor tmpA, tmpB;
 		if (direction == Increasing) {
 			INTERNAL_CHECK(currIndex+ALS.sites < optimizedRange.second, "ie " << currIndex << " " << ALS.sites << " " << optimizedRange.first << " " << optimizedRange.second);
 			// Move core to next position (assumed to be done by the solver if sites > 1)
@@ -350,13 +903,13 @@ namespace xerus {
 			// Move one site to the right
 			if (A != nullptr) {
 				localOperatorCache.right.pop_back();
-				tmpA(r2&0) = localOperatorCache.left.back()(r1&0) * localOperatorSlice(currIndex)(r1/2, r2/2);
-				localOperatorCache.left.emplace_back(std::move(tmpA));
+				push_left_operator_slice(currIndex);
 			}
 			
-			rhsCache.right.pop_back();
-			tmpB(r2&0) = rhsCache.left.back()(r1&0) * localRhsSlice(currIndex)(r1/2, r2/2);
-			rhsCache.left.emplace_back(std::move(tmpB));
+			if (b != nullptr) {
+				rhsCache.right.pop_back();
+				push_left_rhs_slice(currIndex);
+			}
 			currIndex++;
 		} else {
 			INTERNAL_CHECK(currIndex > optimizedRange.first, "ie");
@@ -365,21 +918,68 @@ namespace xerus {
 				x.move_core(currIndex-1, true);
 			}
 			
-			// move one site to the left
+			// move one site to the left, i.e. the last site of the current window leaves it
 			if (A != nullptr) {
 				localOperatorCache.left.pop_back();
-				tmpA(r1&0) = localOperatorCache.right.back()(r2&0) * localOperatorSlice(currIndex)(r1/2, r2/2);
-				localOperatorCache.right.emplace_back(std::move(tmpA));
+				push_right_operator_slice(currIndex+ALS.sites-1);
 			}
 			
-			rhsCache.left.pop_back();
-			tmpB(r1&0) = rhsCache.right.back()(r2&0) * localRhsSlice(currIndex)(r1/2, r2/2);
-			rhsCache.right.emplace_back(std::move(tmpB));
+			if (b != nullptr) {
+				rhsCache.left.pop_back();
+				push_right_rhs_slice(currIndex+ALS.sites-1);
+			}
 			currIndex--;
 		}
 	}
 	
 	
+	Tensor ALSVariant::local_operator_diagonal(const ALSAlgorithmicData &_data) {
+		INTERNAL_CHECK(_data.A, "IE");
+		Index r1, r2, r3, r4, n1, n2;
+		const Tensor &left = _data.localOperatorCache.left.back();
+		const Tensor &right = _data.localOperatorCache.right.back();
+		Tensor diagonal;
+		if (_data.ALS.assumeSPD) {
+			// the local operator is left(l,a,l') * A(a,n,n',b) * ... * right(r,b,r'), so its diagonal is the chain of the respective diagonals
+			diagonal = Tensor({left.dimensions[0], left.dimensions[1]}, [&](const std::vector<size_t> &_idx){
+				return left[{_idx[0], _idx[1], _idx[0]}];
+			});
+			for (size_t p=0; p<_data.ALS.sites; ++p) {
+				const Tensor &comp = _data.A->get_component(_data.currIndex+p);
+				const Tensor compDiagonal({comp.dimensions[0], comp.dimensions[1], comp.dimensions[3]}, [&](const std::vector<size_t> &_idx){
+					return comp[{_idx[0], _idx[1], _idx[1], _idx[2]}];
+				});
+				diagonal(n1^(p+1), n2, r2) = diagonal(n1^(p+1), r1) * compDiagonal(r1, n2, r2);
+			}
+			const Tensor rightDiagonal({right.dimensions[0], right.dimensions[1]}, [&](const std::vector<size_t> &_idx){
+				return right[{_idx[0], _idx[1], _idx[0]}];
+			});
+			diagonal(n1^(_data.ALS.sites+1), n2) = diagonal(n1^(_data.ALS.sites+1), r1) * rightDiagonal(n2, r1);
+		} else {
+			// the local operator is left(l,a,a',l') * A(a,x,n,b) * A(a',x,n',b') * ... * right(r,b,b',r')
+			diagonal = Tensor({left.dimensions[0], left.dimensions[1], left.dimensions[2]}, [&](const std::vector<size_t> &_idx){
+				return left[{_idx[0], _idx[1], _idx[2], _idx[0]}];
+			});
+			for (size_t p=0; p<_data.ALS.sites; ++p) {
+				const Tensor &comp = _data.A->get_component(_data.currIndex+p);
+				const Tensor compDiagonal({comp.dimensions[0], comp.dimensions[0], comp.dimensions[2], comp.dimensions[3], comp.dimensions[3]}, [&](const std::vector<size_t> &_idx){
+					value_t sum = 0.0;
+					for (size_t x = 0; x < comp.dimensions[1]; ++x) {
+						sum += comp[{_idx[0], x, _idx[2], _idx[3]}] * comp[{_idx[1], x, _idx[2], _idx[4]}];
+					}
+					return sum;
+				});
+				diagonal(n1^(p+1), n2, r3, r4) = diagonal(n1^(p+1), r1, r2) * compDiagonal(r1, r2, n2, r3, r4);
+			}
+			const Tensor rightDiagonal({right.dimensions[0], right.dimensions[1], right.dimensions[2]}, [&](const std::vector<size_t> &_idx){
+				return right[{_idx[0], _idx[1], _idx[2], _idx[0]}];
+			});
+			diagonal(n1^(_data.ALS.sites+1), n2) = diagonal(n1^(_data.ALS.sites+1), r1^2) * rightDiagonal(n2, r1^2);
+		}
+		return diagonal;
+	}
+	
+	
 	TensorNetwork ALSVariant::construct_local_operator(ALSVariant::ALSAlgorithmicData& _data) const {
 		INTERNAL_CHECK(_data.A, "IE");
 		Index cr1, cr2, cr3, cr4, r1, r2, r3, r4, n1, n2, n3, n4, x;
@@ -407,14 +1007,14 @@ namespace xerus {
 		if (assumeSPD || (_data.A == nullptr)) {
 			BTilde(n1,r1) = _data.rhsCache.left.back()(r1,n1);
 			for (size_t p=0; p<sites; ++p) {
-				BTilde(n1^(p+1), n2, cr1) = BTilde(n1^(p+1), r1) * _data.b.get_component(_data.currIndex+p)(r1, n2, cr1);
+				BTilde(n1^(p+1), n2, cr1) = BTilde(n1^(p+1), r1) * _data.b->get_component(_data.currIndex+p)(r1, n2, cr1);
 			}
 			BTilde(n1^(sites+1),n2) = BTilde(n1^(sites+1), r1) * _data.rhsCache.right.back()(r1,n2);
 		} else {
 			BTilde(n1,r1^2) = _data.rhsCache.left.back()(r1^2,n1);
 			for (size_t p=0; p<sites; ++p) {
 				BTilde(n1^(p+1), n3, cr1, cr2) = BTilde(n1^(p+1), r1, r2) 
-					* _data.b.get_component(_data.currIndex+p)(r1, n2, cr1)
+					* _data.b->get_component(_data.currIndex+p)(r1, n2, cr1)
 					* _data.A->get_component(_data.currIndex+p)(r2, n2, n3, cr2);
 			}
 			BTilde(n1^(sites+1),n2) = BTilde(n1^(sites+1), r1^2) * _data.rhsCache.right.back()(r1^2,n2);
@@ -514,7 +1114,7 @@ namespace xerus {
 		}
 		_perfData.start();
 		
-		ALSAlgorithmicData data(*this, _Ap, _x, _b);
+		ALSAlgorithmicData data(*this, _Ap, _x, &_b);
 		
 		data.energy = data.energy_f();
 		
@@ -536,12 +1136,22 @@ namespace xerus {
 				}
 				localSolver(construct_local_operator(data), tmpX, construct_local_RHS(data), data);
 				for (size_t p=0; p<sites; ++p) {
+					// the local solvers work in double precision, components stored in single precision stay single
+					if (_x.get_component(data.currIndex+p).is_single_precision()) {
+						tmpX[p].use_single_precision();
+					}
 					_x.set_component(data.currIndex+p, std::move(tmpX[p]));
 				}
 			} else {
 				//TODO?
 				REQUIRE(sites==1, "approximation dmrg not implemented yet");
-				_x.component(data.currIndex) = Tensor(construct_local_RHS(data));
+				Tensor newComponent(construct_local_RHS(data));
+				if (_x.get_component(data.currIndex).is_single_precision()) {
+					newComponent.use_single_precision();
+				} else {
+					newComponent.use_double_precision();
+				}
+				_x.component(data.currIndex) = std::move(newComponent);
 			}
 			
 			if(check_for_end_of_sweep(data, _numHalfSweeps, _convergenceEpsilon, _perfData)) {
@@ -553,6 +1163,146 @@ namespace xerus {
 	}
 	
 	
+	std::vector<value_t> ALSVariant::solve_eigen(const TTOperator &_A, std::vector<TTTensor> &_x, size_t _numHalfSweeps, value_t _convergenceEpsilon, PerformanceData &_perfData) const {
+		LOG(ALS, "ALS("<< sites <<") called for " << _x.size() << " eigenpairs");
+		REQUIRE(!_x.empty(), "At least one initial guess is required.");
+		#ifndef XERUS_DISABLE_RUNTIME_CHECKS
+			_A.require_correct_format();
+			REQUIRE(_x.front().degree() > 0, "");
+			REQUIRE(_A.dimensions.size() == _x.front().dimensions.size()*2, "");
+			for (const TTTensor &guess : _x) {
+				guess.require_correct_format();
+				REQUIRE(guess.dimensions == _x.front().dimensions, "All initial guesses must have the same dimensions.");
+			}
+			for (size_t i=0; i<_x.front().dimensions.size(); ++i) {
+				REQUIRE(_A.dimensions[i] == _x.front().dimensions[i], "");
+				REQUIRE(_A.dimensions[i+_A.degree()/2] == _x.front().dimensions[i], "");
+			}
+		#endif
+		const size_t numEigenpairs = _x.size();
+		
+		_perfData << "ALS for the " << numEigenpairs << " lowest eigenpairs of A, x.dimensions: " << _x.front().dimensions << '\n'
+				<< "A.ranks: " << _A.ranks() << '\n'
+				<< "x.ranks: " << _x.front().ranks() << '\n'
+				<< "maximum number of half sweeps: " << _numHalfSweeps << '\n'
+				<< "convergence epsilon: " << _convergenceEpsilon << '\n';
+		_perfData.start();
+		
+		// the local operator of a symmetric eigenvalue problem is the one of the xAx stacks, regardless of the definiteness of A.
+		// The core position is restored for each eigenvector at the end, not for the shared frame.
+		ALSVariant variant(*this);
+		variant.assumeSPD = true;
+		variant.preserveCorePosition = false;
+		
+		// all eigenvectors share the components of the frame outside of the optimized sites
+		TTTensor frame(_x.front());
+		ALSAlgorithmicData data(variant, &_A, frame, nullptr);
+		const size_t d = frame.degree();
+		Index i, j, k, l, n1, n2, r1, r2, cr1, cr2, e;
+		
+		// replaces the optimized sites starting at _first by the split _core, the core of the frame is then at the last of them
+		const auto set_window = [&](Tensor _core, const size_t _first) {
+			for (size_t p = 0; p+1 < sites; ++p) {
+				Tensor U, S;
+				(U(i^2,j), S(j,k), _core(k,l&1)) = SVD(_core(i^2,l&2), data.targetRank[_first+p]);
+				frame.set_component(_first+p, std::move(U));
+				_core(j,l&1) = S(j,k) * _core(k,l&1);
+			}
+			frame.set_component(_first+sites-1, std::move(_core));
+			frame.assume_core_position(_first+sites-1);
+		};
+		
+		// the last mode of the block core enumerates the eigenvectors
+		const auto stack_cores = [&](const std::vector<Tensor> &_cores) -> Tensor {
+			Tensor::DimensionTuple blockDimensions(_cores.front().dimensions);
+			blockDimensions.push_back(numEigenpairs);
+			return Tensor(std::move(blockDimensions), [&](const size_t _pos){ return _cores[_pos%numEigenpairs][_pos/numEigenpairs]; });
+		};
+		const auto unstack_core = [&](const Tensor &_block, const size_t _c) -> Tensor {
+			const Tensor::DimensionTuple dimensions(_block.dimensions.begin(), _block.dimensions.end()-1);
+			return Tensor(dimensions, [&](const size_t _pos){ return _block[_pos*numEigenpairs + _c]; });
+		};
+		
+		// projects an initial guess onto the frame, i.e. calculates the components of the optimized sites closest to it
+		const auto project_onto_frame = [&](const TTTensor &_y) -> Tensor {
+			Tensor left = Tensor::ones({1,1});
+			for (size_t pos = 0; pos < data.currIndex; ++pos) {
+				left(r2, cr2) = left(r1, cr1) * _y.get_component(pos)(r1, n1, r2) * frame.get_component(pos)(cr1, n1, cr2);
+			}
+			Tensor right = Tensor::ones({1,1});
+			for (size_t pos = d; pos > data.currIndex+sites; --pos) {
+				right(r1, cr1) = _y.get_component(pos-1)(r1, n1, r2) * frame.get_component(pos-1)(cr1, n1, cr2) * right(r2, cr2);
+			}
+			Tensor core;
+			core(n1, r1) = left(r1, n1);
+			for (size_t p = 0; p < sites; ++p) {
+				core(n1^(p+1), n2, r2) = core(n1^(p+1), r1) * _y.get_component(data.currIndex+p)(r1, n2, r2);
+			}
+			core(n1^(sites+1), n2) = core(n1^(sites+1), r1) * right(r1, n2);
+			return core;
+		};
+		
+		std::vector<Tensor> initialCores;
+		for (const TTTensor &guess : _x) {
+			initialCores.push_back(project_onto_frame(guess));
+		}
+		Tensor blockCore = stack_cores(initialCores);
+		
+		while (true) {
+			LOG(ALS, "Starting to optimize index " << data.currIndex);
+			
+			davidson_solver(variant.construct_local_operator(data), blockCore, data.eigenvalues, data);
+			set_window(unstack_core(blockCore, 0), data.currIndex);
+			
+			if (variant.check_for_end_of_sweep(data, _numHalfSweeps, _convergenceEpsilon, _perfData)) {
+				break;
+			}
+			
+			// split off the site that leaves the window and contract the remainder with the site that enters it
+			const Tensor::DimensionTuple dimensions(blockCore.dimensions);
+			Tensor U, S, Vt;
+			if (data.direction == Increasing) {
+				const Tensor &next = frame.get_component(data.currIndex+sites);
+				blockCore.reinterpret_dimensions({dimensions[0], dimensions[1], misc::product(dimensions, 2, sites+1), dimensions[sites+1], numEigenpairs});
+				(U(r1,n1,j), S(j,k), blockCore(k,n2,r2,e)) = SVD(blockCore(r1,n1,n2,r2,e), data.targetRank[data.currIndex]);
+				blockCore(j,n2,n1,r2,e) = S(j,k) * blockCore(k,n2,r1,e) * next(r1,n1,r2);
+				
+				Tensor::DimensionTuple newDimensions(1, blockCore.dimensions[0]);
+				newDimensions.insert(newDimensions.end(), dimensions.begin()+2, dimensions.begin()+sites+1);
+				newDimensions.insert(newDimensions.end(), {next.dimensions[1], next.dimensions[2], numEigenpairs});
+				blockCore.reinterpret_dimensions(std::move(newDimensions));
+				
+				frame.set_component(data.currIndex, std::move(U));
+				set_window(unstack_core(blockCore, 0), data.currIndex+1);
+			} else {
+				const Tensor &previous = frame.get_component(data.currIndex-1);
+				blockCore.reinterpret_dimensions({dimensions[0], misc::product(dimensions, 1, sites), dimensions[sites], dimensions[sites+1], numEigenpairs});
+				(blockCore(r1,n1,e,j), S(j,k), Vt(k,n2,r2)) = SVD(blockCore(r1,n1,n2,r2,e), data.targetRank[data.currIndex+sites-2]);
+				blockCore(r1,n2,n1,k,e) = previous(r1,n2,r2) * blockCore(r2,n1,e,j) * S(j,k);
+				
+				Tensor::DimensionTuple newDimensions {previous.dimensions[0], previous.dimensions[1]};
+				newDimensions.insert(newDimensions.end(), dimensions.begin()+1, dimensions.begin()+sites);
+				newDimensions.insert(newDimensions.end(), {blockCore.dimensions[3], numEigenpairs});
+				blockCore.reinterpret_dimensions(std::move(newDimensions));
+				
+				frame.set_component(data.currIndex+sites-1, std::move(Vt));
+				set_window(unstack_core(blockCore, 0), data.currIndex-1);
+			}
+			
+			data.move_to_next_index();
+		}
+		
+		for (size_t c = 0; c < numEigenpairs; ++c) {
+			set_window(unstack_core(blockCore, c), data.currIndex);
+			_x[c] = frame;
+			if (data.canonicalizeAtTheEnd && preserveCorePosition) {
+				_x[c].move_core(data.corePosAtTheEnd, true);
+			}
+		}
+		return data.eigenvalues;
+	}
+	
+	
 	const ALSVariant ALS(1, 0, ALSVariant::lapack_solver, false);
 	const ALSVariant ALS_SPD(1, 0, ALSVariant::lapack_solver, true);
 	
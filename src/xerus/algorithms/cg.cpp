@@ -61,9 +61,19 @@ namespace xerus {
 					<< "convergence epsilon: " << _convergenceEpsilon << '\n';
 		_perfData.start();
 		
+		TTOperator transposedA;
+		if (_Ap != nullptr && productMaxRank > 0 && !assumeSymmetricPositiveDefiniteOperator) {
+			transposedA = _A;
+			transposedA.transpose();
+		}
+		
 		auto calculateResidual = [&]()->value_t {
 			if (_Ap != nullptr) {
-				residual(i&0) = _b(i&0) - _A(i/2,j/2)*_x(j&0);
+				if (productMaxRank > 0) {
+					residual = _b - apply_and_round(_A, _x, productMaxRank);
+				} else {
+					residual(i&0) = _b(i&0) - _A(i/2,j/2)*_x(j&0);
+				}
 			} else {
 				residual = _b - _x;
 			}
@@ -74,7 +84,11 @@ namespace xerus {
 				gradient = TTTangentVector(_x, residual);
 			} else {
 				TTTensor grad;
-				grad(i&0) = (*_Ap)(j/2,i/2) * residual(j&0); // grad = A^T * (b - Ax)
+				if (productMaxRank > 0) {
+					grad = apply_and_round(transposedA, residual, productMaxRank);
+				} else {
+					grad(i&0) = (*_Ap)(j/2,i/2) * residual(j&0); // grad = A^T * (b - Ax)
+				}
 				gradient = TTTangentVector(_x, grad);
 			}
 			gradientNorm = gradient.frob_norm();
@@ -73,14 +73,19 @@ namespace xerus {
 			for (value_t beta = 1/ALPHA_CHG; beta < ALPHA_CHG*1.5; beta *= ALPHA_CHG) {
 				// Build the largeX
 				for(size_t d = 0; d < degree; ++d) {
-					Tensor& currComp = _x.component(d);
+					const Tensor& currComp = _x.get_component(d);
 					Tensor newComp({d == 0 ? 1 : (currComp.dimensions[0]+USER_MEASUREMENTS_PER_ITR), currComp.dimensions[1], d == degree-1 ? 1 : (currComp.dimensions[2]+USER_MEASUREMENTS_PER_ITR)});
+					const size_t N = newComp.dimensions[1];
+					const size_t R2 = newComp.dimensions[2];
+					
+					// The sparse part is created in the order of the measurements, so all entries are collected unsorted and sorted once.
+					misc::FlatMap<size_t, value_t>& newData = newComp.get_sparse_data();
 					
 					// Copy dense part
 					for(size_t r1 = 0; r1 < currComp.dimensions[0]; ++r1) {
 						for(size_t n = 0; n < currComp.dimensions[1]; ++n) {
 							for(size_t r2 = 0; r2 < currComp.dimensions[2]; ++r2) {
-								newComp[{r1, n, r2}] = currComp[{r1, n, r2}];
+								newData.emplace_back_unsorted((r1*N + n)*R2 + r2, currComp[{r1, n, r2}]);
 							}
 						}
 					}
@@ -88,18 +93,20 @@ namespace xerus {
 					// Copy sparse part
 					if (d==0) {
 						for(size_t i = 0; i < USER_MEASUREMENTS_PER_ITR; ++i) {
-							newComp[{0, _measurments.positions[measurementOrder[i]][d], i+currComp.dimensions[2]}] = beta*alpha*(_measurments.measuredValues[measurementOrder[i]] - currentValues[measurementOrder[i]]);
+							newData.emplace_back_unsorted(_measurments.positions[measurementOrder[i]][d]*R2 + i+currComp.dimensions[2], beta*alpha*(_measurments.measuredValues[measurementOrder[i]] - currentValues[measurementOrder[i]]));
 						}
 					} else if (d!=degree-1) {
 						for(size_t i = 0; i < USER_MEASUREMENTS_PER_ITR; ++i) {
-							newComp[{i + currComp.dimensions[0], _measurments.positions[measurementOrder[i]][d], i+currComp.dimensions[2]}] = 1.0;
+							newData.emplace_back_unsorted(((i + currComp.dimensions[0])*N + _measurments.positions[measurementOrder[i]][d])*R2 + i+currComp.dimensions[2], 1.0);
 						}
 					} else {
 						// d == degree-1
 						for(size_t i = 0; i < USER_MEASUREMENTS_PER_ITR; ++i) {
-							newComp[{i + currComp.dimensions[0], _measurments.positions[measurementOrder[i]][d], 0}] = 1.0;
+							newData.emplace_back_unsorted((i + currComp.dimensions[0])*N + _measurments.positions[measurementOrder[i]][d], 1.0);
 						}
 					}
+					newData.sort_and_sum_duplicates();
+					newComp.use_dense_representation_if_desirable();
 					
 					
 					largeX.set_component(d, newComp);
@@ -2,6 +2,8 @@
 #include <xerus/algorithms/largestEntry.h>
 
 namespace xerus {
+	size_t largestEntryRankFactor = 2;
+	
 	template<bool isOperator>
 	size_t find_largest_entry(const TTNetwork<isOperator> &_T, const double _accuracy, const value_t _lowerBound) {
 		_T.require_correct_format();
@@ -17,7 +19,10 @@ namespace xerus {
 			
 			X = _T;
 			while(misc::sum(X.ranks()) >= _T.degree()) {
-				X = entrywise_product(X, X);
+				// The squared ranks of the exact product are mostly removed by the thresholding anyway, so they are never formed
+				std::vector<size_t> maxRanks = X.ranks();
+				for(size_t& rank : maxRanks) { rank *= largestEntryRankFactor; }
+				X = entrywise_product(X, X, maxRanks);
 				
 				X.soft_threshold(tau, true);
 				
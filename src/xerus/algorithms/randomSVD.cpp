@@ -0,0 +1,134 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+ * @file
+ * @brief Implementation of the randomized TT-SVD.
+ */
+
+#include <xerus/algorithms/randomSVD.h>
+#include <xerus/misc/basicArraySupport.h>
+#include <xerus/misc/internal.h>
+
+namespace xerus {
+	
+	/**
+	 * @brief Calculates G*B, where G is a (_numSamples x m) gaussian random matrix and B the matricization of @a _b with m rows, i.e. the first @a _numMixModes modes.
+	 * @details For sparse @a _b only the columns of G that are multiplied with a non-zero entry are created.
+	 */
+	static Tensor random_sketch(const Tensor& _b, const size_t _numSamples, const size_t _numMixModes) {
+		std::vector<size_t> outDims({_numSamples});
+		outDims.insert(outDims.end(), _b.dimensions.cbegin()+long(_numMixModes), _b.dimensions.cend());
+		
+		if(_b.is_dense()) {
+			std::vector<size_t> gDims({_numSamples});
+			gDims.insert(gDims.end(), _b.dimensions.cbegin(), _b.dimensions.cbegin()+long(_numMixModes));
+			const Tensor g = Tensor::random(gDims);
+			
+			Tensor a;
+			contract(a, g, false, _b, false, _numMixModes);
+			return a;
+		}
+		
+		const size_t staySize = misc::product(_b.dimensions, _numMixModes, _b.degree());
+		Tensor a(outDims, Tensor::Representation::Dense);
+		value_t* const aData = a.get_unsanitized_dense_data();
+		
+		// The entries are sorted, so all entries of one row of the matricization are consecutive and share one column of G.
+		std::vector<value_t> usedG(_numSamples);
+		size_t currentRow = ~0ul;
+		for(const auto& entry : _b.get_unsanitized_sparse_data()) {
+			const size_t row = entry.first/staySize;
+			const size_t col = entry.first%staySize;
+			
+			if(row != currentRow) {
+				currentRow = row;
+				for(size_t k = 0; k < _numSamples; ++k) {
+					usedG[k] = misc::defaultNormalDistribution(misc::randomEngine);
+				}
+			}
+			
+			const value_t value = _b.factor*entry.second;
+			for(size_t k = 0; k < _numSamples; ++k) {
+				aData[k*staySize + col] += usedG[k]*value;
+			}
+		}
+		
+		return a;
+	}
+	
+	
+	TTTensor randomTTSVD(const Tensor& _x, const std::vector<size_t>& _ranks, const std::vector<size_t>& _oversampling, const size_t _powerIterations) {
+		const size_t d = _x.degree();
+		REQUIRE(d > 0, "The randomized TT-SVD requires a tensor of positive degree.");
+		REQUIRE(_ranks.size()+1 == d, "There must be exactly degree-1 ranks. Here: " << _ranks.size() << " vs " << d-1);
+		REQUIRE(_oversampling.size()+1 == d, "There must be exactly degree-1 oversampling values. Here: " << _oversampling.size() << " vs " << d-1);
+		
+		TTTensor u(d);
+		Tensor b = _x;
+		
+		for(size_t j = d; j >= 2; --j) {
+			const size_t numMixModes = j-1;
+			const size_t numStayModes = b.degree()-numMixModes;
+			const size_t mixSize = misc::product(b.dimensions, 0, numMixModes);
+			const size_t staySize = misc::product(b.dimensions, numMixModes, b.degree());
+			const size_t s = std::min(_ranks[j-2] + _oversampling[j-2], std::min(mixSize, staySize));
+			
+			// Approximate the row space of the matricization
+			Tensor a = random_sketch(b, s, numMixModes);
+			
+			Tensor R, Q, Z, QZ;
+			for(size_t p = 0; p < _powerIterations; ++p) {
+				calculate_rq(R, Q, a, 1);
+				contract(Z, b, false, Q, true, numStayModes);
+				calculate_qr(QZ, R, Z, numMixModes);
+				contract(a, QZ, true, b, false, numMixModes);
+			}
+			
+			calculate_rq(R, Q, a, 1);
+			
+			// Project onto the row space, the remainder is decomposed in the next step
+			contract(Z, b, false, Q, true, numStayModes);
+			b = std::move(Z);
+			
+			if(j == d) {
+				Q.reinterpret_dimensions(Q.dimensions | std::vector<size_t>({1}));
+			}
+			u.set_component(j-1, std::move(Q));
+		}
+		
+		if(d == 1) {
+			b.reinterpret_dimensions({1, b.dimensions[0], 1});
+		} else {
+			b.reinterpret_dimensions(std::vector<size_t>({1}) | b.dimensions);
+		}
+		u.set_component(0, std::move(b));
+		
+		// All components but the first one have orthogonal rows
+		u.assume_core_position(0);
+		u.round(_ranks);
+		
+		return u;
+	}
+	
+	
+	TTTensor randomTTSVD(const Tensor& _x, const std::vector<size_t>& _ranks, const size_t _oversampling, const size_t _powerIterations) {
+		return randomTTSVD(_x, _ranks, std::vector<size_t>(_ranks.size(), _oversampling), _powerIterations);
+	}
+}
@@ -24,6 +24,7 @@
 
 #include <xerus.h>
 #include <xerus/misc/internal.h>
+#include <xerus/misc/parallel.h>
 
 namespace xerus {
 
@@ -79,53 +80,139 @@ namespace xerus {
 		baseL.move_core(0, true);
 	}
 		
+	/// @brief gauge condition: all but the first component of a tangent vector are orthogonal to the corresponding component @a _UComp of the base
+	static void apply_gauge_condition(Tensor &_V, const Tensor &_UComp) {
+		Index i1,i2,r,j1,s;
+		Tensor UTV;
+		UTV(i1,i2) = _V(i1,r,j1) * _UComp(i2,r,j1);
+		_V(i1,r,j1) = _V(i1,r,j1) - UTV(i1,s) * _UComp(s,r,j1);
+	}
+	
 	TTTangentVector::TTTangentVector(const TTTensor& _base, const TTTensor& _direction) {
 		REQUIRE(_base.canonicalized && _base.corePosition == 0, "projection onto tangent plane is only implemented for core position 0 at the moment");
 		REQUIRE(_base.dimensions == _direction.dimensions, "");
 		
 		baseL = _base;
 		baseL.move_core(0, true);
+		const size_t d = baseL.degree();
 		
-		Index i1,i2,j1,j2,r,s, s2;
-		std::vector<Tensor> leftStackUV;
-		std::vector<Tensor> leftStackUU;
-		Tensor tmp({1,1}, [](){return 1.0;});
-		leftStackUV.push_back(tmp);
-		leftStackUU.push_back(tmp);
-		for (size_t i=0; i<baseL.degree()-1; ++i) {
-			Tensor newLeft;
-			newLeft(j1,j2) = leftStackUV.back()(i1,i2) * baseL.get_component(i)(i1,r,j1) * _direction.get_component(i)(i2,r,j2);
-			leftStackUV.emplace_back(std::move(newLeft));
-			newLeft(j1,j2) = leftStackUU.back()(i1,i2) * baseL.get_component(i)(i1,r,j1) * baseL.get_component(i)(i2,r,j2);
-			leftStackUU.emplace_back(std::move(newLeft));
+		size_t work = 0;
+		for (size_t i = 0; i < d; ++i) {
+			const Tensor &dirComp = _direction.get_component(i);
+			work += baseL.get_component(i).size*std::max(dirComp.dimensions.front(), dirComp.dimensions.back());
 		}
-		Tensor right(tmp);
-		Tensor UTV;
-		std::vector<Tensor> tmpComponents;
-		for (size_t i=baseL.degree(); i>0; --i) {
-			const size_t currIdx = i-1;
-			std::unique_ptr<Tensor> newComponent(new Tensor);
-			const Tensor &UComp = baseL.get_component(currIdx);
-			Tensor V;
-			Tensor uuInv = pseudo_inverse(leftStackUU.back(), 1);
-			V(i1,r,j1) =  uuInv(i1,s)* leftStackUV.back()(s,i2) * _direction.get_component(currIdx)(i2,r,j2) * right(j1,j2);
-// 			if (i!=baseL.degree()) {
-// 				V(i1,r,j1) = V(i1,r,j1) + UComp(i1,r,s)*UTV(s,j1);
-// 			}
-			if (currIdx!=0) {
-				UTV(i1,i2) = V(i1,r,j1) * UComp(i2,r,j1);
-				V(i1,r,j1) = V(i1,r,j1) - UTV(i1,s) * UComp(s,r,j1);
+		const size_t numThreads = misc::get_num_threads(work);
+		
+		// the left stacks at position i contain the components 0,...,i-1 and the right stack those of i+1,...,d-1
+		std::vector<Tensor> leftStackUV(d), leftStackUU(d), rightStackUV(d);
+		#pragma omp parallel sections num_threads(std::min(numThreads, size_t(2)))
+		{
+			#pragma omp section
+			{
+				Index i1,i2,j1,j2,r;
+				leftStackUV[0] = Tensor::ones({1,1});
+				leftStackUU[0] = Tensor::ones({1,1});
+				for (size_t i = 1; i < d; ++i) {
+					leftStackUV[i](j1,j2) = leftStackUV[i-1](i1,i2) * baseL.get_component(i-1)(i1,r,j1) * _direction.get_component(i-1)(i2,r,j2);
+					leftStackUU[i](j1,j2) = leftStackUU[i-1](i1,i2) * baseL.get_component(i-1)(i1,r,j1) * baseL.get_component(i-1)(i2,r,j2);
+				}
 			}
-			tmpComponents.emplace_back(std::move(V));
-			if (currIdx != 0) {
-				right(j1,j2) = UComp(j1,r,i1) * _direction.get_component(currIdx)(j2,r,i2) * right(i1,i2);
+			
+			#pragma omp section
+			{
+				Index i1,i2,j1,j2,r;
+				rightStackUV[d-1] = Tensor::ones({1,1});
+				for (size_t i = d-1; i > 0; --i) {
+					rightStackUV[i-1](j1,j2) = baseL.get_component(i)(j1,r,i1) * _direction.get_component(i)(j2,r,i2) * rightStackUV[i](i1,i2);
+				}
 			}
-			leftStackUV.pop_back();
-			leftStackUU.pop_back();
 		}
-		while (!tmpComponents.empty()) {
-			components.emplace_back(std::move(tmpComponents.back()));
-			tmpComponents.pop_back();
+		
+		// with all stacks in place the components are independent of each other
+		components.resize(d);
+		#pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+		for (size_t i = 0; i < d; ++i) {
+			Index i1,i2,j1,j2,r,s;
+			Tensor &V = components[i];
+			const Tensor uuInv = pseudo_inverse(leftStackUU[i], 1);
+			V(i1,r,j1) = uuInv(i1,s) * leftStackUV[i](s,i2) * _direction.get_component(i)(i2,r,j2) * rightStackUV[i](j1,j2);
+			if (i != 0) {
+				apply_gauge_condition(V, baseL.get_component(i));
+			}
+		}
+	}
+	
+	TTTangentVector::TTTangentVector(const TTTensor& _base, const TTTangentVector& _direction) {
+		REQUIRE(_base.canonicalized && _base.corePosition == 0, "projection onto tangent plane is only implemented for core position 0 at the moment");
+		REQUIRE(_base.dimensions == _direction.baseL.dimensions, "");
+		REQUIRE(_direction.components.size() == _direction.baseL.degree(), "");
+		
+		baseL = _base;
+		baseL.move_core(0, true);
+		const size_t d = baseL.degree();
+		const TTTensor &oldBase = _direction.baseL;
+		
+		size_t work = 0;
+		for (size_t i = 0; i < d; ++i) {
+			const Tensor &oldComp = oldBase.get_component(i);
+			work += 3*baseL.get_component(i).size*std::max(oldComp.dimensions.front(), oldComp.dimensions.back());
+		}
+		const size_t numThreads = misc::get_num_threads(work);
+		
+		// _direction is the TT tensor with the components [U V; 0 U] built from the components U of its base and V of itself, cf. operator TTTensor().
+		// Instead of forming this rank 2r tensor its stacks are built blockwise: the left stacks of the old base (A) and of the partial sums
+		// that already contain a V (B), and the right stacks of the partial sums that contain a V (C) and of the old base (D).
+		std::vector<Tensor> leftStackA(d), leftStackB(d), leftStackUU(d), rightStackC(d), rightStackD(d);
+		#pragma omp parallel sections num_threads(std::min(numThreads, size_t(2)))
+		{
+			#pragma omp section
+			{
+				Index i1,i2,j1,j2,r;
+				leftStackA[0] = Tensor::ones({1,1});
+				leftStackB[0] = Tensor({1,1});
+				leftStackUU[0] = Tensor::ones({1,1});
+				for (size_t i = 1; i < d; ++i) {
+					const Tensor &newComp = baseL.get_component(i-1);
+					const Tensor &oldComp = oldBase.get_component(i-1);
+					Tensor AU;
+					AU(i2,r,j1) = leftStackA[i-1](i1,i2) * newComp(i1,r,j1);
+					leftStackB[i](j1,j2) = AU(i2,r,j1) * _direction.components[i-1](i2,r,j2) + leftStackB[i-1](i1,i2) * newComp(i1,r,j1) * oldComp(i2,r,j2);
+					leftStackA[i](j1,j2) = AU(i2,r,j1) * oldComp(i2,r,j2);
+					leftStackUU[i](j1,j2) = leftStackUU[i-1](i1,i2) * newComp(i1,r,j1) * newComp(i2,r,j2);
+				}
+			}
+			
+			#pragma omp section
+			{
+				Index i1,i2,j1,j2,r;
+				rightStackC[d-1] = Tensor({1,1});
+				rightStackD[d-1] = Tensor::ones({1,1});
+				for (size_t i = d-1; i > 0; --i) {
+					const Tensor &newComp = baseL.get_component(i);
+					const Tensor &oldComp = oldBase.get_component(i);
+					Tensor UD;
+					UD(j1,r,i2) = newComp(j1,r,i1) * rightStackD[i](i1,i2);
+					rightStackC[i-1](j1,j2) = UD(j1,r,i2) * _direction.components[i](j2,r,i2) + newComp(j1,r,i1) * oldComp(j2,r,i2) * rightStackC[i](i1,i2);
+					rightStackD[i-1](j1,j2) = UD(j1,r,i2) * oldComp(j2,r,i2);
+				}
+			}
+		}
+		
+		components.resize(d);
+		#pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+		for (size_t i = 0; i < d; ++i) {
+			Index i1,i2,j1,j2,r,s;
+			const Tensor &oldComp = oldBase.get_component(i);
+			const Tensor uuInv = pseudo_inverse(leftStackUU[i], 1);
+			// the blocks U*C + V*D of the first block row and U*D of the second one, contracted with the left stacks
+			Tensor right, T;
+			right(i2,r,j1) = oldComp(i2,r,j2) * rightStackC[i](j1,j2) + _direction.components[i](i2,r,j2) * rightStackD[i](j1,j2);
+			T(s,r,j1) = leftStackA[i](s,i2) * right(i2,r,j1) + leftStackB[i](s,i2) * oldComp(i2,r,j2) * rightStackD[i](j1,j2);
+			Tensor &V = components[i];
+			V(i1,r,j1) = uuInv(i1,s) * T(s,r,j1);
+			if (i != 0) {
+				apply_gauge_condition(V, baseL.get_component(i));
+			}
 		}
 	}
 	
@@ -283,6 +370,6 @@ namespace xerus {
 	void ProjectiveVectorTransport(const TTTensor &_newBase, TTTangentVector &_tangentVector) {
 		REQUIRE(_newBase.canonicalized && _newBase.corePosition == 0, "Tangent vectors only implemented for core position 0 atm");
 		
-		_tangentVector = TTTangentVector(_newBase, TTTensor(_tangentVector));
+		_tangentVector = TTTangentVector(_newBase, _tangentVector);
 	}
 } // namespace xerus
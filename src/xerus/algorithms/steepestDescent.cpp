@@ -105,9 +105,19 @@ namespace xerus {
 					<< "convergence epsilon: " << _convergenceEpsilon << '\n';
 		_perfData.start();
 		
+		TTOperator transposedA;
+		if (_Ap != nullptr && productMaxRank > 0 && !assumeSymmetricPositiveDefiniteOperator) {
+			transposedA = _A;
+			transposedA.transpose();
+		}
+		
 		auto updateResidual = [&]() {
 			if (_Ap != nullptr) {
-				residual(i&0) = _b(i&0) - _A(i/2,j/2)*_x(j&0);
+				if (productMaxRank > 0) {
+					residual = _b - apply_and_round(_A, _x, productMaxRank);
+				} else {
+					residual(i&0) = _b(i&0) - _A(i/2,j/2)*_x(j&0);
+				}
 			} else {
 				residual = _b - _x;
 			}
@@ -142,7 +152,11 @@ namespace xerus {
 // 					alpha = misc::sqr(frob_norm(y)) / value_t(y(i&0)*Ay(i&0));
 				} else { XERUS_REQUIRE_TEST;
 					// search direction: y = A^T(b-Ax)
-					y(i&0) = _A(j/2,i/2) * residual(j&0);
+					if (productMaxRank > 0) {
+						y = apply_and_round(transposedA, residual, productMaxRank);
+					} else {
+						y(i&0) = _A(j/2,i/2) * residual(j&0);
+					}
 					if (preconditioner != nullptr) {
 						y(j&0) = (*preconditioner)(j/2,i/2) * y(i&0);
 					}
@@ -30,5 +30,6 @@ namespace xerus {
     namespace internal {
         void array_deleter_vt(value_t* const _toDelete) { delete[] _toDelete; }
         void array_deleter_st( size_t* const _toDelete) { delete[] _toDelete; }
+        void array_deleter_ft(  float* const _toDelete) { delete[] _toDelete; }
     } // namespace internal
 } // namespace xerus
@@ -49,6 +49,8 @@ extern "C"
 
 
 #include <memory>
+#include <algorithm>
+#include <cmath>
 #include <xerus/misc/standard.h>
 #include <xerus/misc/performanceAnalysis.h>
 #include <xerus/misc/check.h>
@@ -110,6 +112,38 @@ namespace xerus {
 		}
 		
 		
+		float one_norm(const float* const _x, const size_t _n) {
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			XERUS_PA_START;
+			
+			const float result = cblas_sasum(static_cast<int>(_n), _x, 1);
+			
+			XERUS_PA_END("Dense BLAS", "One Norm (single)", misc::to_string(_n));
+			
+			return result;
+		}
+		
+		double two_norm(const float* const _x, const size_t _n) {
+			// Squaring in single precision would lose half of the exponent range, so the (double accumulating) dot product is used.
+			return std::sqrt(dot_product(_x, _n, _x));
+		}
+		
+		double dot_product(const float* const _x, const size_t _n, const float* const _y) {
+			XERUS_PA_START;
+			
+			// NOTE cblas_dsdot is not used, as some implementations (e.g. OpenBLAS) accumulate partial sums in single precision.
+			double result = 0.0;
+			for(size_t i = 0; i < _n; ++i) {
+				result += double(_x[i])*double(_y[i]);
+			}
+			
+			XERUS_PA_END("Dense BLAS", "Dot Product (single)", misc::to_string(_n)+"*"+misc::to_string(_n));
+			
+			return result;
+		}
+		
+		
 		//----------------------------------------------- LEVEL II BLAS ---------------------------------------------------------
 		
 		void matrix_vector_product(double* const _x, const size_t _m, const double _alpha, const double* const _A, const size_t _n, const bool _transposed, const double* const _y) {
@@ -144,6 +178,35 @@ namespace xerus {
 		}
 		
 		
+		void matrix_vector_product(float* const _x, const size_t _m, const float _alpha, const float* const _A, const size_t _n, const bool _transposed, const float* const _y) {
+			REQUIRE(_m <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			XERUS_PA_START;
+			if(!_transposed) {
+				cblas_sgemv(CblasRowMajor, CblasNoTrans, static_cast<int>(_m), static_cast<int>(_n), _alpha, _A, static_cast<int>(_n), _y, 1, 0.0f, _x, 1);
+			} else {
+				cblas_sgemv(CblasRowMajor, CblasTrans, static_cast<int>(_n), static_cast<int>(_m), _alpha, _A, static_cast<int>(_m) , _y, 1, 0.0f, _x, 1);
+			}
+			
+			XERUS_PA_END("Dense BLAS", "Matrix Vector Product (single)", misc::to_string(_m)+"x"+misc::to_string(_n)+" * "+misc::to_string(_n));
+		}
+		
+		void dyadic_vector_product(float* _A, const size_t _m, const size_t _n, const float _alpha, const float*const  _x, const float* const _y) {
+			REQUIRE(_m <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			XERUS_PA_START;
+			
+			//Blas wants to add the product to A, but we don't.
+			std::fill(_A, _A+_m*_n, 0.0f);
+			
+			cblas_sger(CblasRowMajor, static_cast<int>(_m), static_cast<int>(_n), _alpha, _x, 1, _y, 1, _A, static_cast<int>(_n));
+			
+			XERUS_PA_END("Dense BLAS", "Dyadic Vector Product (single)", misc::to_string(_m)+" o "+misc::to_string(_n));
+		}
+		
+		
 		//----------------------------------------------- LEVEL III BLAS --------------------------------------------------------
 		/// Performs the Matrix-Matrix product c = a * b
 		void matrix_matrix_product( double* const _C,
@@ -196,28 +259,113 @@ namespace xerus {
 		
 		
 		
+		void matrix_matrix_product( float* const _C,
+									const size_t _leftDim,
+									const size_t _rightDim,
+									const float _alpha,
+									const float* const _A,
+									const size_t _lda,
+									const bool _transposeA,
+									const size_t _middleDim,
+									const float* const _B,
+									const size_t _ldb,
+									const bool _transposeB) {
+			//Delegate call if appropriate
+			if(_leftDim == 1) {
+				matrix_vector_product(_C, _rightDim, _alpha, _B, _middleDim, !_transposeB, _A);
+			} else if(_rightDim == 1) {
+				matrix_vector_product(_C, _leftDim, _alpha, _A, _middleDim, _transposeA, _B);
+			} else if(_middleDim == 1) { 
+				dyadic_vector_product(_C, _leftDim, _rightDim, _alpha, _A, _B);
+			} else {
+				REQUIRE(_leftDim <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+				REQUIRE(_middleDim <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+				REQUIRE(_rightDim <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+				REQUIRE(_lda <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+				REQUIRE(_ldb <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+				
+				XERUS_PA_START;
+				
+				cblas_sgemm(CblasRowMajor, _transposeA ? CblasTrans : CblasNoTrans, _transposeB ? CblasTrans : CblasNoTrans, 
+						static_cast<int>(_leftDim), static_cast<int>(_rightDim), static_cast<int>(_middleDim), 
+						_alpha, _A, static_cast<int>(_lda), _B, static_cast<int>(_ldb), 0.0f, _C, static_cast<int>(_rightDim));
+				
+				XERUS_PA_END("Dense BLAS", "Matrix-Matrix-Multiplication (single)", misc::to_string(_leftDim)+"x"+misc::to_string(_middleDim)+" * "+misc::to_string(_middleDim)+"x"+misc::to_string(_rightDim));
+			}
+		}
+		
+		
+		
 		//----------------------------------------------- LAPACK ----------------------------------------------------------------
 		
-		void svd( double* const _U, double* const _S, double* const _Vt, const double* const _A, const size_t _m, const size_t _n) {
-			//Create copy of A
-			const std::unique_ptr<double[]> tmpA(new double[_m*_n]);
-			misc::copy(tmpA.get(), _A, _m*_n);
-			
-			svd_destructive(_U, _S, _Vt, tmpA.get(), _m, _n);
+		// Overloads dispatching to the double (d*) and single (s*) precision LAPACK routines, so that the factorisations are only written once.
+		static inline int lapacke_gesdd(int _layout, char _jobz, int _m, int _n, double* _A, int _lda, double* _S, double* _U, int _ldu, double* _Vt, int _ldvt) {
+			return LAPACKE_dgesdd(_layout, _jobz, _m, _n, _A, _lda, _S, _U, _ldu, _Vt, _ldvt);
 		}
 		
+		static inline int lapacke_gesdd(int _layout, char _jobz, int _m, int _n, float* _A, int _lda, float* _S, float* _U, int _ldu, float* _Vt, int _ldvt) {
+			return LAPACKE_sgesdd(_layout, _jobz, _m, _n, _A, _lda, _S, _U, _ldu, _Vt, _ldvt);
+		}
 		
-		void svd_destructive( double* const _U, double* const _S, double* const _Vt, double* const _A, const size_t _m, const size_t _n) {
+		static inline int lapacke_geqp3(int _layout, int _m, int _n, double* _A, int _lda, int* _permutation, double* _tau) {
+			return LAPACKE_dgeqp3(_layout, _m, _n, _A, _lda, _permutation, _tau);
+		}
+		
+		static inline int lapacke_geqp3(int _layout, int _m, int _n, float* _A, int _lda, int* _permutation, float* _tau) {
+			return LAPACKE_sgeqp3(_layout, _m, _n, _A, _lda, _permutation, _tau);
+		}
+		
+		static inline int lapacke_geqrf(int _layout, int _m, int _n, double* _A, int _lda, double* _tau) {
+			return LAPACKE_dgeqrf(_layout, _m, _n, _A, _lda, _tau);
+		}
+		
+		static inline int lapacke_geqrf(int _layout, int _m, int _n, float* _A, int _lda, float* _tau) {
+			return LAPACKE_sgeqrf(_layout, _m, _n, _A, _lda, _tau);
+		}
+		
+		static inline int lapacke_orgqr(int _layout, int _m, int _n, int _k, double* _A, int _lda, const double* _tau) {
+			return LAPACKE_dorgqr(_layout, _m, _n, _k, _A, _lda, _tau);
+		}
+		
+		static inline int lapacke_orgqr(int _layout, int _m, int _n, int _k, float* _A, int _lda, const float* _tau) {
+			return LAPACKE_sorgqr(_layout, _m, _n, _k, _A, _lda, _tau);
+		}
+		
+		static inline int lapacke_gerqf(int _layout, int _m, int _n, double* _A, int _lda, double* _tau) {
+			return LAPACKE_dgerqf(_layout, _m, _n, _A, _lda, _tau);
+		}
+		
+		static inline int lapacke_gerqf(int _layout, int _m, int _n, float* _A, int _lda, float* _tau) {
+			return LAPACKE_sgerqf(_layout, _m, _n, _A, _lda, _tau);
+		}
+		
+		static inline int lapacke_orgrq(int _layout, int _m, int _n, int _k, double* _A, int _lda, const double* _tau) {
+			return LAPACKE_dorgrq(_layout, _m, _n, _k, _A, _lda, _tau);
+		}
+		
+		static inline int lapacke_orgrq(int _layout, int _m, int _n, int _k, float* _A, int _lda, const float* _tau) {
+			return LAPACKE_sorgrq(_layout, _m, _n, _k, _A, _lda, _tau);
+		}
+		
+		/// @brief Name of a LAPACK call in the performance analysis, single precision calls are marked as such.
+		template<class T>
+		static std::string lapack_call_name(const std::string& _name) {
+			return std::is_same<T, float>::value ? _name + " (single)" : _name;
+		}
+		
+		
+		template<class T>
+		static void svd_destructive_impl( T* const _U, T* const _S, T* const _Vt, T* const _A, const size_t _m, const size_t _n) {
 			REQUIRE(_m <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			
 			XERUS_PA_START;
-			std::unique_ptr<double[]> tmpA(new double[_m*_n]);
+			std::unique_ptr<T[]> tmpA(new T[_m*_n]);
 			misc::copy(tmpA.get(), _A, _m*_n);
 			
-			int lapackAnswer = LAPACKE_dgesdd(LAPACK_ROW_MAJOR, 'S', static_cast<int>(_m), static_cast<int>(_n), _A, static_cast<int>(_n), _S, _U, static_cast<int>(std::min(_m, _n)), _Vt, static_cast<int>(_n));
+			int lapackAnswer = lapacke_gesdd(LAPACK_ROW_MAJOR, 'S', static_cast<int>(_m), static_cast<int>(_n), _A, static_cast<int>(_n), _S, _U, static_cast<int>(std::min(_m, _n)), _Vt, static_cast<int>(_n));
 			CHECK(lapackAnswer == 0, warning, "Lapack failed to compute SVD. Answer is: " << lapackAnswer);
-			CHECK(lapackAnswer == 0, warning, "Call was: LAPACKE_dgesdd(LAPACK_ROW_MAJOR, 'S', " << static_cast<int>(_m) << ", " << static_cast<int>(_n) << ", " << _A << ", " << static_cast<int>(_n) <<", " 
+			CHECK(lapackAnswer == 0, warning, "Call was: LAPACKE_" << (std::is_same<T, float>::value ? 's' : 'd') << "gesdd(LAPACK_ROW_MAJOR, 'S', " << static_cast<int>(_m) << ", " << static_cast<int>(_n) << ", " << _A << ", " << static_cast<int>(_n) <<", "
 			<< _S <<", " << _U << ", " << static_cast<int>(std::min(_m, _n)) << ", " << _Vt << ", " << static_cast<int>(_n) << ");");
 			if(lapackAnswer != 0) {
 				LOG(warning, "SVD failed ");
@@ -228,19 +376,68 @@ namespace xerus {
 // 				}
 			}
 			
-			XERUS_PA_END("Dense LAPACK", "Singular Value Decomposition", misc::to_string(_m)+"x"+misc::to_string(_n));
+			XERUS_PA_END("Dense LAPACK", lapack_call_name<T>("Singular Value Decomposition"), misc::to_string(_m)+"x"+misc::to_string(_n));
 		}
 		
 		
-		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> qc(const double* const _A, const size_t _m, const size_t _n) {
-			const std::unique_ptr<double[]> tmpA(new double[_m*_n]);
+		template<class T>
+		static void svd_impl( T* const _U, T* const _S, T* const _Vt, const T* const _A, const size_t _m, const size_t _n) {
+			//Create copy of A
+			const std::unique_ptr<T[]> tmpA(new T[_m*_n]);
 			misc::copy(tmpA.get(), _A, _m*_n);
 			
-			return qc_destructive(tmpA.get(), _m, _n);
+			svd_destructive_impl(_U, _S, _Vt, tmpA.get(), _m, _n);
 		}
 		
 		
-		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> qc_destructive(double* const _A, const size_t _m, const size_t _n) {
+		void svd( double* const _U, double* const _S, double* const _Vt, const double* const _A, const size_t _m, const size_t _n) {
+			svd_impl(_U, _S, _Vt, _A, _m, _n);
+		}
+		
+		
+		void svd_destructive( double* const _U, double* const _S, double* const _Vt, double* const _A, const size_t _m, const size_t _n) {
+			svd_destructive_impl(_U, _S, _Vt, _A, _m, _n);
+		}
+		
+		
+		void svd( float* const _U, float* const _S, float* const _Vt, const float* const _A, const size_t _m, const size_t _n) {
+			svd_impl(_U, _S, _Vt, _A, _m, _n);
+		}
+		
+		
+		void svd_destructive( float* const _U, float* const _S, float* const _Vt, float* const _A, const size_t _m, const size_t _n) {
+			svd_destructive_impl(_U, _S, _Vt, _A, _m, _n);
+		}
+		
+		
+		void symmetric_eigen_decomposition( double* const _V, double* const _lambda, const double* const _A, const size_t _n) {
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			XERUS_PA_START;
+			misc::copy(_V, _A, _n*_n);
+			
+			IF_CHECK( int lapackAnswer = ) LAPACKE_dsyev(LAPACK_ROW_MAJOR, 'V', 'U', static_cast<int>(_n), _V, static_cast<int>(_n), _lambda);
+			CHECK(lapackAnswer == 0, error, "Unable to compute the eigendecomposition. Lapacke says: " << lapackAnswer);
+			
+			XERUS_PA_END("Dense LAPACK", "Symmetric Eigendecomposition", misc::to_string(_n)+"x"+misc::to_string(_n));
+		}
+		
+		
+		void symmetric_eigen_decomposition( float* const _V, float* const _lambda, const float* const _A, const size_t _n) {
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			XERUS_PA_START;
+			std::copy(_A, _A+_n*_n, _V);
+			
+			IF_CHECK( int lapackAnswer = ) LAPACKE_ssyev(LAPACK_ROW_MAJOR, 'V', 'U', static_cast<int>(_n), _V, static_cast<int>(_n), _lambda);
+			CHECK(lapackAnswer == 0, error, "Unable to compute the eigendecomposition. Lapacke says: " << lapackAnswer);
+			
+			XERUS_PA_END("Dense LAPACK", "Symmetric Eigendecomposition (single)", misc::to_string(_n)+"x"+misc::to_string(_n));
+		}
+		
+		
+		template<class T>
+		static std::tuple<std::unique_ptr<T[]>, std::unique_ptr<T[]>, size_t> qc_destructive_impl(T* const _A, const size_t _m, const size_t _n) {
 			REQUIRE(_m <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			
@@ -253,28 +450,28 @@ namespace xerus {
 			const size_t maxRank = std::min(_m, _n);
 			
 			// Tmp Array for Lapacke
-			const std::unique_ptr<double[]> tau(new double[maxRank]);
+			const std::unique_ptr<T[]> tau(new T[maxRank]);
 			
 			const std::unique_ptr<int[]> permutation(new int[_n]());
 			misc::set_zero(permutation.get(), _n); // Lapack requires the entries to be zero.
 			
 			// Calculate QR factorisations with column pivoting
-			IF_CHECK(int lapackAnswer = ) LAPACKE_dgeqp3(LAPACK_ROW_MAJOR, static_cast<int>(_m), static_cast<int>(_n), _A, static_cast<int>(_n), permutation.get(), tau.get());
-			REQUIRE(lapackAnswer == 0, "Unable to perform QC factorisaton (dgeqp3). Lapacke says: " << lapackAnswer );
+			IF_CHECK(int lapackAnswer = ) lapacke_geqp3(LAPACK_ROW_MAJOR, static_cast<int>(_m), static_cast<int>(_n), _A, static_cast<int>(_n), permutation.get(), tau.get());
+			REQUIRE(lapackAnswer == 0, "Unable to perform QC factorisaton (geqp3). Lapacke says: " << lapackAnswer );
 			
 			
 			// Determine the actual rank
 			size_t rank;
 			for (rank = 1; rank <= maxRank; ++rank) {
-				if (rank == maxRank || std::abs(_A[rank+rank*_n]) < 16*std::numeric_limits<double>::epsilon()*_A[0]) {
+				if (rank == maxRank || std::abs(_A[rank+rank*_n]) < 16*std::numeric_limits<T>::epsilon()*_A[0]) {
 					break;
 				}
 			}
 			
 			
 			// Create the matrix C
-			std::unique_ptr<double[]> C(new double[rank*_n]);
-			misc::set_zero(C.get(), rank*_n); 
+			std::unique_ptr<T[]> C(new T[rank*_n]);
+			misc::set_zero(C.get(), rank*_n);
 			
 			// Copy the upper triangular Matrix C (rank x _n) into position
 			for (size_t col = 0; col < _n; ++col) {
@@ -286,11 +483,11 @@ namespace xerus {
 			
 			
 			// Create orthogonal matrix Q
-			IF_CHECK(lapackAnswer = ) LAPACKE_dorgqr(LAPACK_ROW_MAJOR, static_cast<int>(_m), static_cast<int>(maxRank), static_cast<int>(maxRank), _A, static_cast<int>(_n), tau.get());
+			IF_CHECK(lapackAnswer = ) lapacke_orgqr(LAPACK_ROW_MAJOR, static_cast<int>(_m), static_cast<int>(maxRank), static_cast<int>(maxRank), _A, static_cast<int>(_n), tau.get());
 			CHECK(lapackAnswer == 0, error, "Unable to reconstruct Q from the QC factorisation. Lapacke says: " << lapackAnswer);
 			
 			// Copy the newly created Q into position
-			std::unique_ptr<double[]> Q(new double[_m*rank]);
+			std::unique_ptr<T[]> Q(new T[_m*rank]);
 			if(rank == _n) {
 				misc::copy(Q.get(), _A, _m*rank);
 			} else {
@@ -299,22 +496,44 @@ namespace xerus {
 				}
 			}
 			
-			XERUS_PA_END("Dense LAPACK", "QRP Factorisation", misc::to_string(_m)+"x"+misc::to_string(rank)+" * "+misc::to_string(rank)+"x"+misc::to_string(_n));
+			XERUS_PA_END("Dense LAPACK", lapack_call_name<T>("QRP Factorisation"), misc::to_string(_m)+"x"+misc::to_string(rank)+" * "+misc::to_string(rank)+"x"+misc::to_string(_n));
 			
 			return std::make_tuple(std::move(Q), std::move(C), rank);
 		}
 		
 		
-		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> cq(const double* const _A, const size_t _m, const size_t _n) {
-			const std::unique_ptr<double[]> tmpA(new double[_m*_n]);
+		template<class T>
+		static std::tuple<std::unique_ptr<T[]>, std::unique_ptr<T[]>, size_t> qc_impl(const T* const _A, const size_t _m, const size_t _n) {
+			const std::unique_ptr<T[]> tmpA(new T[_m*_n]);
 			misc::copy(tmpA.get(), _A, _m*_n);
 			
-			return cq_destructive(tmpA.get(), _m, _n);
+			return qc_destructive_impl(tmpA.get(), _m, _n);
+		}
+		
+		
+		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> qc(const double* const _A, const size_t _m, const size_t _n) {
+			return qc_impl(_A, _m, _n);
+		}
+		
+		
+		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> qc_destructive(double* const _A, const size_t _m, const size_t _n) {
+			return qc_destructive_impl(_A, _m, _n);
+		}
+		
+		
+		std::tuple<std::unique_ptr<float[]>, std::unique_ptr<float[]>, size_t> qc(const float* const _A, const size_t _m, const size_t _n) {
+			return qc_impl(_A, _m, _n);
+		}
+		
+		
+		std::tuple<std::unique_ptr<float[]>, std::unique_ptr<float[]>, size_t> qc_destructive(float* const _A, const size_t _m, const size_t _n) {
+			return qc_destructive_impl(_A, _m, _n);
 		}
 		
 		
 		// We use that in col-major we get At = Qt * Ct => A = C * Q, i.e. doing the calculation in col-major and switching Q and C give the desired result.
-		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> cq_destructive(double* const _A, const size_t _m, const size_t _n) {
+		template<class T>
+		static std::tuple<std::unique_ptr<T[]>, std::unique_ptr<T[]>, size_t> cq_destructive_impl(T* const _A, const size_t _m, const size_t _n) {
 			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			REQUIRE(_m <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			
@@ -327,28 +546,28 @@ namespace xerus {
 			const size_t maxRank = std::min(_n, _m);
 			
 			// Tmp Array for Lapacke
-			const std::unique_ptr<double[]> tau(new double[maxRank]);
+			const std::unique_ptr<T[]> tau(new T[maxRank]);
 			
 			const std::unique_ptr<int[]> permutation(new int[_m]());
 			misc::set_zero(permutation.get(), _m); // Lapack requires the entries to be zero.
 			
 			// Calculate QR factorisations with column pivoting
-			IF_CHECK(int lapackAnswer = ) LAPACKE_dgeqp3(LAPACK_COL_MAJOR, static_cast<int>(_n), static_cast<int>(_m), _A, static_cast<int>(_n), permutation.get(), tau.get());
-			REQUIRE(lapackAnswer == 0, "Unable to perform QC factorisaton (dgeqp3). Lapacke says: " << lapackAnswer );
+			IF_CHECK(int lapackAnswer = ) lapacke_geqp3(LAPACK_COL_MAJOR, static_cast<int>(_n), static_cast<int>(_m), _A, static_cast<int>(_n), permutation.get(), tau.get());
+			REQUIRE(lapackAnswer == 0, "Unable to perform QC factorisaton (geqp3). Lapacke says: " << lapackAnswer );
 			
 			
 			// Determine the actual rank
 			size_t rank;
 			for (rank = 1; rank <= maxRank; ++rank) {
-				if (rank == maxRank || std::abs(_A[rank+rank*_n]) < 16*std::numeric_limits<double>::epsilon()*_A[0]) {
+				if (rank == maxRank || std::abs(_A[rank+rank*_n]) < 16*std::numeric_limits<T>::epsilon()*_A[0]) {
 					break;
 				}
 			}
 			
 			
 			// Create the matrix C
-			std::unique_ptr<double[]> C(new double[rank*_m]);
-			misc::set_zero(C.get(), rank*_m); 
+			std::unique_ptr<T[]> C(new T[rank*_m]);
+			misc::set_zero(C.get(), rank*_m);
 			
 			// Copy the upper triangular Matrix C (rank x _m) into position
 			for (size_t col = 0; col < _m; ++col) {
@@ -358,34 +577,50 @@ namespace xerus {
 			
 			
 			// Create orthogonal matrix Q
-			IF_CHECK(lapackAnswer = ) LAPACKE_dorgqr(LAPACK_COL_MAJOR, static_cast<int>(_n), static_cast<int>(maxRank), static_cast<int>(maxRank), _A, static_cast<int>(_n), tau.get());
+			IF_CHECK(lapackAnswer = ) lapacke_orgqr(LAPACK_COL_MAJOR, static_cast<int>(_n), static_cast<int>(maxRank), static_cast<int>(maxRank), _A, static_cast<int>(_n), tau.get());
 			CHECK(lapackAnswer == 0, error, "Unable to reconstruct Q from the QC factorisation. Lapacke says: " << lapackAnswer);
 			
 			// Copy the newly created Q into position
-			std::unique_ptr<double[]> Q(new double[_n*rank]);
+			std::unique_ptr<T[]> Q(new T[_n*rank]);
 			misc::copy(Q.get(), _A, _n*rank);
 			
-			XERUS_PA_END("Dense LAPACK", "QRP Factorisation", misc::to_string(_n)+"x"+misc::to_string(rank)+" * "+misc::to_string(rank)+"x"+misc::to_string(_m));
+			XERUS_PA_END("Dense LAPACK", lapack_call_name<T>("QRP Factorisation"), misc::to_string(_n)+"x"+misc::to_string(rank)+" * "+misc::to_string(rank)+"x"+misc::to_string(_m));
 			
 			return std::make_tuple(std::move(C), std::move(Q), rank);
 		}
 		
 		
-		void qr(double* const _Q, double* const _R, const double* const _A, const size_t _m, const size_t _n) {
-			// Create tmp copy of A since Lapack wants to destroy it
-			const std::unique_ptr<double[]> tmpA(new double[_m*_n]);
+		template<class T>
+		static std::tuple<std::unique_ptr<T[]>, std::unique_ptr<T[]>, size_t> cq_impl(const T* const _A, const size_t _m, const size_t _n) {
+			const std::unique_ptr<T[]> tmpA(new T[_m*_n]);
 			misc::copy(tmpA.get(), _A, _m*_n);
 			
-			qr_destructive(_Q, _R, tmpA.get(), _m, _n);
+			return cq_destructive_impl(tmpA.get(), _m, _n);
 		}
 		
 		
-		void inplace_qr(double* const _AtoQ, double* const _R, const size_t _m, const size_t _n) {
-			qr_destructive(_AtoQ, _R, _AtoQ, _m, _n);
+		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> cq(const double* const _A, const size_t _m, const size_t _n) {
+			return cq_impl(_A, _m, _n);
 		}
 		
 		
-		void qr_destructive( double* const _Q, double* const _R, double* const _A, const size_t _m, const size_t _n) {
+		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> cq_destructive(double* const _A, const size_t _m, const size_t _n) {
+			return cq_destructive_impl(_A, _m, _n);
+		}
+		
+		
+		std::tuple<std::unique_ptr<float[]>, std::unique_ptr<float[]>, size_t> cq(const float* const _A, const size_t _m, const size_t _n) {
+			return cq_impl(_A, _m, _n);
+		}
+		
+		
+		std::tuple<std::unique_ptr<float[]>, std::unique_ptr<float[]>, size_t> cq_destructive(float* const _A, const size_t _m, const size_t _n) {
+			return cq_destructive_impl(_A, _m, _n);
+		}
+		
+		
+		template<class T>
+		static void qr_destructive_impl( T* const _Q, T* const _R, T* const _A, const size_t _m, const size_t _n) {
 			REQUIRE(_m <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			
@@ -398,14 +633,14 @@ namespace xerus {
 			XERUS_PA_START;
 			
 			// Maximal rank is used by Lapacke
-			const size_t rank = std::min(_m, _n); 
+			const size_t rank = std::min(_m, _n);
 			
 			// Tmp Array for Lapacke
-			const std::unique_ptr<double[]> tau(new double[rank]);
+			const std::unique_ptr<T[]> tau(new T[rank]);
 			
 			// Calculate QR factorisations
 //             LOG(Lapacke, "Call to dorgqr with parameters: " << LAPACK_ROW_MAJOR << ", " << static_cast<int>(_m)  << ", " << static_cast<int>(_n)  << ", " << _A << ", " << static_cast<int>(_n)  << ", " << tau.get());
-			IF_CHECK( int lapackAnswer = ) LAPACKE_dgeqrf(LAPACK_ROW_MAJOR, static_cast<int>(_m), static_cast<int>(_n), _A, static_cast<int>(_n), tau.get());
+			IF_CHECK( int lapackAnswer = ) lapacke_geqrf(LAPACK_ROW_MAJOR, static_cast<int>(_m), static_cast<int>(_n), _A, static_cast<int>(_n), tau.get());
 			CHECK(lapackAnswer == 0, error, "Unable to perform QR factorisaton. Lapacke says: " << lapackAnswer );
 			
 			// Copy the upper triangular Matrix R (rank x _n) into position
@@ -416,7 +651,7 @@ namespace xerus {
 			
 			// Create orthogonal matrix Q (in tmpA)
 	//         LOG(Lapacke, "Call to dorgqr with parameters: " << LAPACK_ROW_MAJOR << ", " << static_cast<int>(_m)  << ", " << static_cast<int>(rank)  << ", " << static_cast<int>(rank) << ", " << _A << ", " << static_cast<int>(_n)  << ", " << tau.get());
-			IF_CHECK( lapackAnswer = ) LAPACKE_dorgqr(LAPACK_ROW_MAJOR, static_cast<int>(_m), static_cast<int>(rank), static_cast<int>(rank), _A, static_cast<int>(_n), tau.get());
+			IF_CHECK( lapackAnswer = ) lapacke_orgqr(LAPACK_ROW_MAJOR, static_cast<int>(_m), static_cast<int>(rank), static_cast<int>(rank), _A, static_cast<int>(_n), tau.get());
 			CHECK(lapackAnswer == 0, error, "Unable to reconstruct Q from the QR factorisation. Lapacke says: " << lapackAnswer);
 			
 			// Copy Q (_m x rank) into position
@@ -434,25 +669,52 @@ namespace xerus {
 				}
 			}
 			
-			XERUS_PA_END("Dense LAPACK", "QR Factorisation", misc::to_string(_m)+"x"+misc::to_string(_n));
+			XERUS_PA_END("Dense LAPACK", lapack_call_name<T>("QR Factorisation"), misc::to_string(_m)+"x"+misc::to_string(_n));
 		}
 		
 		
-		void rq( double* const _R, double* const _Q, const double* const _A, const size_t _m, const size_t _n) {
+		template<class T>
+		static void qr_impl(T* const _Q, T* const _R, const T* const _A, const size_t _m, const size_t _n) {
 			// Create tmp copy of A since Lapack wants to destroy it
-			const std::unique_ptr<double[]> tmpA(new double[_m*_n]);
+			const std::unique_ptr<T[]> tmpA(new T[_m*_n]);
 			misc::copy(tmpA.get(), _A, _m*_n);
 			
-			rq_destructive(_R, _Q, tmpA.get(), _m, _n);
+			qr_destructive_impl(_Q, _R, tmpA.get(), _m, _n);
 		}
 		
 		
-		void inplace_rq( double* const _R, double* const _AtoQ, const size_t _m, const size_t _n) {
-			rq_destructive(_R, _AtoQ, _AtoQ, _m, _n);
+		void qr(double* const _Q, double* const _R, const double* const _A, const size_t _m, const size_t _n) {
+			qr_impl(_Q, _R, _A, _m, _n);
 		}
 		
 		
-		void rq_destructive( double* const _R, double* const _Q, double* const _A, const size_t _m, const size_t _n) {
+		void inplace_qr(double* const _AtoQ, double* const _R, const size_t _m, const size_t _n) {
+			qr_destructive_impl(_AtoQ, _R, _AtoQ, _m, _n);
+		}
+		
+		
+		void qr_destructive( double* const _Q, double* const _R, double* const _A, const size_t _m, const size_t _n) {
+			qr_destructive_impl(_Q, _R, _A, _m, _n);
+		}
+		
+		
+		void qr(float* const _Q, float* const _R, const float* const _A, const size_t _m, const size_t _n) {
+			qr_impl(_Q, _R, _A, _m, _n);
+		}
+		
+		
+		void inplace_qr(float* const _AtoQ, float* const _R, const size_t _m, const size_t _n) {
+			qr_destructive_impl(_AtoQ, _R, _AtoQ, _m, _n);
+		}
+		
+		
+		void qr_destructive( float* const _Q, float* const _R, float* const _A, const size_t _m, const size_t _n) {
+			qr_destructive_impl(_Q, _R, _A, _m, _n);
+		}
+		
+		
+		template<class T>
+		static void rq_destructive_impl( T* const _R, T* const _Q, T* const _A, const size_t _m, const size_t _n) {
 			REQUIRE(_m <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			
@@ -465,13 +727,13 @@ namespace xerus {
 			XERUS_PA_START;
 			
 			// Maximal rank is used by Lapacke
-			const size_t rank = std::min(_m, _n); 
+			const size_t rank = std::min(_m, _n);
 			
 			// Tmp Array for Lapacke
-			const std::unique_ptr<double[]> tau(new double[rank]);
+			const std::unique_ptr<T[]> tau(new T[rank]);
 			
-			IF_CHECK( int lapackAnswer = ) LAPACKE_dgerqf(LAPACK_ROW_MAJOR, static_cast<int>(_m), static_cast<int>(_n), _A, static_cast<int>(_n), tau.get());
-			CHECK(lapackAnswer == 0, error, "Unable to perform QR factorisaton. Lapacke says: " << lapackAnswer << ". Call was: LAPACKE_dgerqf(LAPACK_ROW_MAJOR, "<<static_cast<int>(_m)<<", "<<static_cast<int>(_n)<<", "<<_A<<", "<<static_cast<int>(_n)<<", "<<tau.get()<<");" );
+			IF_CHECK( int lapackAnswer = ) lapacke_gerqf(LAPACK_ROW_MAJOR, static_cast<int>(_m), static_cast<int>(_n), _A, static_cast<int>(_n), tau.get());
+			CHECK(lapackAnswer == 0, error, "Unable to perform QR factorisaton. Lapacke says: " << lapackAnswer << ". Call was: LAPACKE_?gerqf(LAPACK_ROW_MAJOR, "<<static_cast<int>(_m)<<", "<<static_cast<int>(_n)<<", "<<_A<<", "<<static_cast<int>(_n)<<", "<<tau.get()<<");" );
 			
 			
 			// Copy the upper triangular Matrix R (_m x rank) into position.
@@ -485,16 +747,56 @@ namespace xerus {
 			}
 			
 			// Create orthogonal matrix Q (in _A). Lapacke expects to get the last rank rows of A...
-			IF_CHECK( lapackAnswer = ) LAPACKE_dorgrq(LAPACK_ROW_MAJOR, static_cast<int>(rank), static_cast<int>(_n), static_cast<int>(rank), _A+(_m-rank)*_n, static_cast<int>(_n), tau.get()); 
-			CHECK(lapackAnswer == 0, error, "Unable to reconstruct Q from the RQ factorisation. Lapacke says: " << lapackAnswer << ". Call was: LAPACKE_dorgrq(LAPACK_ROW_MAJOR, "<<static_cast<int>(rank)<<", "<<static_cast<int>(_n)<<", "<<static_cast<int>(rank)<<", "<<_A+(_m-rank)*_n<<", "<<static_cast<int>(_n)<<", "<<tau.get()<<");");
-
+			IF_CHECK( lapackAnswer = ) lapacke_orgrq(LAPACK_ROW_MAJOR, static_cast<int>(rank), static_cast<int>(_n), static_cast<int>(rank), _A+(_m-rank)*_n, static_cast<int>(_n), tau.get());
+			CHECK(lapackAnswer == 0, error, "Unable to reconstruct Q from the RQ factorisation. Lapacke says: " << lapackAnswer << ". Call was: LAPACKE_?orgrq(LAPACK_ROW_MAJOR, "<<static_cast<int>(rank)<<", "<<static_cast<int>(_n)<<", "<<static_cast<int>(rank)<<", "<<_A+(_m-rank)*_n<<", "<<static_cast<int>(_n)<<", "<<tau.get()<<");");
+			
 			
 			//Copy Q (rank x _n) into position
 			if(_A != _Q) {
 				misc::copy(_Q, _A+(_m-rank)*_n, rank*_n);
 			}
 			
-			XERUS_PA_END("Dense LAPACK", "RQ Factorisation", misc::to_string(_m)+"x"+misc::to_string(_n));
+			XERUS_PA_END("Dense LAPACK", lapack_call_name<T>("RQ Factorisation"), misc::to_string(_m)+"x"+misc::to_string(_n));
+		}
+		
+		
+		template<class T>
+		static void rq_impl( T* const _R, T* const _Q, const T* const _A, const size_t _m, const size_t _n) {
+			// Create tmp copy of A since Lapack wants to destroy it
+			const std::unique_ptr<T[]> tmpA(new T[_m*_n]);
+			misc::copy(tmpA.get(), _A, _m*_n);
+			
+			rq_destructive_impl(_R, _Q, tmpA.get(), _m, _n);
+		}
+		
+		
+		void rq( double* const _R, double* const _Q, const double* const _A, const size_t _m, const size_t _n) {
+			rq_impl(_R, _Q, _A, _m, _n);
+		}
+		
+		
+		void inplace_rq( double* const _R, double* const _AtoQ, const size_t _m, const size_t _n) {
+			rq_destructive_impl(_R, _AtoQ, _AtoQ, _m, _n);
+		}
+		
+		
+		void rq_destructive( double* const _R, double* const _Q, double* const _A, const size_t _m, const size_t _n) {
+			rq_destructive_impl(_R, _Q, _A, _m, _n);
+		}
+		
+		
+		void rq( float* const _R, float* const _Q, const float* const _A, const size_t _m, const size_t _n) {
+			rq_impl(_R, _Q, _A, _m, _n);
+		}
+		
+		
+		void inplace_rq( float* const _R, float* const _AtoQ, const size_t _m, const size_t _n) {
+			rq_destructive_impl(_R, _AtoQ, _AtoQ, _m, _n);
+		}
+		
+		
+		void rq_destructive( float* const _R, float* const _Q, float* const _A, const size_t _m, const size_t _n) {
+			rq_destructive_impl(_R, _Q, _A, _m, _n);
 		}
 		
 		
@@ -91,7 +91,7 @@ namespace xerus { namespace internal {
 		REQUIRE(matrix && cholmodObject.c->status == 0, "cholmod_allocate_sparse did not allocate anything... status: " << cholmodObject.c->status << " call: " << _m << " " << _n << " " << _N << " alloc: " << cholmodObject.c->malloc_count);
 	}
 
-	CholmodSparse::CholmodSparse(const std::map<size_t, double>& _input, const size_t _m, const size_t _n, const bool _transpose) 
+	CholmodSparse::CholmodSparse(const misc::FlatMap<size_t, double>& _input, const size_t _m, const size_t _n, const bool _transpose) 
 		: CholmodSparse(_n, _m, _input.size())
 	{
 		size_t entryPos = 0;
@@ -125,18 +125,21 @@ namespace xerus { namespace internal {
 		}
 	}
 
-	std::map<size_t, double> CholmodSparse::to_map(double _alpha) const {
-		std::map<size_t, double> result;
+	misc::FlatMap<size_t, double> CholmodSparse::to_map(double _alpha) const {
+		misc::FlatMap<size_t, double> result;
 		long* mi = reinterpret_cast<long*>(matrix->i);
 		long* p = reinterpret_cast<long*>(matrix->p);
 		double* x = reinterpret_cast<double*>(matrix->x);
 		
 		for(size_t i = 0; i < matrix->ncol; ++i) {
 			for(long j = p[i]; j < p[i+1]; ++j) {
-				IF_CHECK( auto ret = ) result.emplace(size_t(mi[size_t(j)])*matrix->ncol+i, _alpha*x[j]);
-				INTERNAL_CHECK(ret.second, "Internal Error");
+				result.emplace_back_unsorted(size_t(mi[size_t(j)])*matrix->ncol+i, _alpha*x[j]);
 			}
 		}
+		// The entries are stored column wise, so they have to be sorted once.
+		IF_CHECK( const size_t numEntries = result.size(); )
+		result.sort_and_sum_duplicates();
+		INTERNAL_CHECK(result.size() == numEntries, "Internal Error");
 		return result;
 	}
 
@@ -151,14 +154,14 @@ namespace xerus { namespace internal {
 	}
 
 	
-	void CholmodSparse::matrix_matrix_product( std::map<size_t, double>& _C,
+	void CholmodSparse::matrix_matrix_product( misc::FlatMap<size_t, double>& _C,
 								const size_t _leftDim,
 								const size_t _rightDim,
 								const double _alpha,
-								const std::map<size_t, double>& _A,
+								const misc::FlatMap<size_t, double>& _A,
 								const bool _transposeA,
 								const size_t _midDim,
-								const std::map<size_t, double>& _B,
+								const misc::FlatMap<size_t, double>& _B,
 								const bool _transposeB ) 
 	{
 // 		LOG(ssmult, _leftDim << " " << _midDim << " " << _rightDim << " " << _transposeA << " " << _transposeB);
@@ -168,11 +171,11 @@ namespace xerus { namespace internal {
 		_C = resultCs.to_map(_alpha);
 	}
 	
-	void CholmodSparse::solve_sparse_rhs(std::map<size_t, double>& _x,
+	void CholmodSparse::solve_sparse_rhs(misc::FlatMap<size_t, double>& _x,
 						  size_t _xDim,
-					   const std::map<size_t, double>& _A,
+					   const misc::FlatMap<size_t, double>& _A,
 					   const bool _transposeA,
-					   const std::map<size_t, double>& _b,
+					   const misc::FlatMap<size_t, double>& _b,
 					   size_t _bDim)
 	{
 		const CholmodSparse A(_A, _transposeA?_xDim:_bDim, _transposeA?_bDim:_xDim, _transposeA);
@@ -184,7 +187,7 @@ namespace xerus { namespace internal {
 	
 	void CholmodSparse::solve_dense_rhs(double * _x,
 								 size_t _xDim,
-							  const std::map<size_t, double>& _A,
+							  const misc::FlatMap<size_t, double>& _A,
 							  const bool _transposeA,
 							  const double* _b,
 							  size_t _bDim)
@@ -210,8 +213,8 @@ namespace xerus { namespace internal {
 	}
 	
 	
-	std::tuple<std::map<size_t, double>, std::map<size_t, double>, size_t> CholmodSparse::qc(
-				const std::map<size_t, double> &_A,
+	std::tuple<misc::FlatMap<size_t, double>, misc::FlatMap<size_t, double>, size_t> CholmodSparse::qc(
+				const misc::FlatMap<size_t, double> &_A,
 				const bool _transposeA,
 				size_t _m,
 				size_t _n,
@@ -234,8 +237,8 @@ namespace xerus { namespace internal {
 		return std::make_tuple(Qs.to_map(), Rs.to_map(), _fullrank?std::min(_m,_n):size_t(rank));
 	}
 	
-	std::tuple<std::map<size_t, double>, std::map<size_t, double>, size_t> CholmodSparse::cq(
-				const std::map<size_t, double> &_A,
+	std::tuple<misc::FlatMap<size_t, double>, misc::FlatMap<size_t, double>, size_t> CholmodSparse::cq(
+				const misc::FlatMap<size_t, double> &_A,
 				const bool _transposeA,
 				size_t _m,
 				size_t _n,
@@ -25,14 +25,24 @@
 #include <xerus/misc/check.h>
 
 #include <xerus/contractionHeuristic.h>
+#include <xerus/tensor.h>
 #include <xerus/tensorNetwork.h>
 #include <xerus/misc/internal.h>
 
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
 namespace xerus {
     namespace internal {
+		size_t optimalSearchMaxNodes = 15;
+		
+		size_t optimalSearchTimeBudget = 50;
+		
 		
 		template<double (*scoreFct)(double, double, double, double, double)>
-		void greedy_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network) {
+		void greedy_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network, std::vector<double> _sparsities) {
 			// estimated cost to calculate this heuristic is
 			// numNodes * numNodes * 2*avgEdgesPerNode = 2 * numNodes * numEdges
 			double numNodes = 0, numEdges = 0;
@@ -45,7 +55,7 @@ namespace xerus {
 			// if the best solution is only about twice as costly as the calculation of this heuristic, then don't bother
 			if (_bestCost < 2 * 2 * numNodes * numEdges) { return; }
 			
-			double bestScore, ourCost=0;
+			double bestScore, ourCost=0, ourSparsity=0;
 			double ourFinalCost=0;
 			std::vector<std::pair<size_t,size_t>> ourContractions;
 			size_t bestId1, bestId2;
@@ -72,10 +82,11 @@ namespace xerus {
 								n *= static_cast<double>(nj.neighbors[d].dimension);
 							}
 						}
-						double tmpscore = scoreFct(m,n,r,0.0,0.0);
+						double tmpscore = scoreFct(m,n,r,_sparsities[i],_sparsities[j]);
 						if (tmpscore < bestScore) {
 							bestScore = tmpscore;
-							ourCost = contraction_cost(m,n,r,0.0,0.0);
+							ourCost = contraction_cost(m,n,r,_sparsities[i],_sparsities[j]);
+							ourSparsity = contraction_sparsity(m,n,r,_sparsities[i],_sparsities[j]);
 							bestId1 = i;
 							bestId2 = j;
 						}
@@ -88,6 +99,7 @@ namespace xerus {
 					}
 					ourContractions.emplace_back(bestId1,bestId2);
 					_network.contract(bestId1,bestId2);
+					_sparsities[bestId1] = ourSparsity;
 				}
 			} while (bestScore < std::numeric_limits<double>::max());
 			if (ourFinalCost < _bestCost) {
@@ -99,43 +111,106 @@ namespace xerus {
 		
 		
 		
-		double contraction_cost(double _m, double _n, double _r, double  /*_sparsity1*/, double  /*_sparsity2*/) {
-			return _m*_n*_r; // TODO sparse
+		/// @brief Whether an operand with the given number of non-zero entries is (expected to be) stored in sparse representation, cf. Tensor::use_dense_representation_if_desirable().
+		inline bool is_sparse_operand(const double _sparsity, const double _size) {
+			return static_cast<double>(Tensor::sparsityFactor)*_sparsity < _size;
 		}
 		
 		
+		double contraction_cost(double _m, double _n, double _r, double _sparsity1, double _sparsity2) {
+			const bool sparse1 = is_sparse_operand(_sparsity1, _m*_r);
+			const bool sparse2 = is_sparse_operand(_sparsity2, _r*_n);
+			if (sparse1 && sparse2) {
+				// Every pair of non-zero entries that shares the contracted index yields one multiplication
+				return _sparsity1*_sparsity2/_r + _sparsity1 + _sparsity2;
+			}
+			if (sparse1) {
+				return _sparsity1*_n;
+			}
+			if (sparse2) {
+				return _sparsity2*_m;
+			}
+			return _m*_n*_r;
+		}
 		
 		
-		double score_size(double _m, double _n, double _r, double  /*_sparsity1*/, double  /*_sparsity2*/) {
-			return _n*_m-(_n+_m)*_r;
+		double contraction_sparsity(double _m, double _n, double _r, double _sparsity1, double _sparsity2) {
+			// Same estimate and representation choice as in xerus::contract, assuming uniformly distributed non-zero entries
+			const double finalSize = _m*_n;
+			const double density = std::min(1.0, (_sparsity1*_sparsity2)/((_m*_r)*(_r*_n)));
+			const double expectation = -finalSize*std::expm1(_r*std::log1p(-density));
+			if ((is_sparse_operand(_sparsity1, _m*_r) && is_sparse_operand(_sparsity2, _r*_n)) || (finalSize > 64 && static_cast<double>(Tensor::sparsityFactor)*expectation < finalSize*2)) {
+				return expectation;
+			}
+			return finalSize;
 		}
-		double score_mn(double _m, double _n, double  /*_r*/, double  /*_sparsity1*/, double  /*_sparsity2*/) {
-			return _m*_n;
+		
+		
+		size_t sparsity_class(size_t _size, size_t _sparsity) {
+			if (!is_sparse_operand(static_cast<double>(_sparsity), static_cast<double>(_size))) { return 0; }
+			size_t sparsityClass = 1;
+			while (_sparsity > 0) {
+				_sparsity /= 2;
+				sparsityClass++;
+			}
+			return sparsityClass;
 		}
-		double score_speed(double _m, double _n, double _r, double  /*_sparsity1*/, double  /*_sparsity2*/) {
-			return (_n*_m-(_n+_m)*_r)/(_n*_m*_r);
+		
+		
+		
+		
+		double score_size(double _m, double _n, double _r, double _sparsity1, double _sparsity2) {
+			return contraction_sparsity(_m, _n, _r, _sparsity1, _sparsity2) - _sparsity1 - _sparsity2;
+		}
+		double score_mn(double _m, double _n, double _r, double _sparsity1, double _sparsity2) {
+			return contraction_sparsity(_m, _n, _r, _sparsity1, _sparsity2);
+		}
+		double score_speed(double _m, double _n, double _r, double _sparsity1, double _sparsity2) {
+			return score_size(_m, _n, _r, _sparsity1, _sparsity2)/contraction_cost(_m, _n, _r, _sparsity1, _sparsity2);
 		}
 		double score_r(double  /*_m*/, double  /*_n*/, double _r, double  /*_sparsity1*/, double  /*_sparsity2*/) {
 			return -_r;
 		}
-		double score_big_tensor(double _m, double _n, double _r, double  /*_sparsity1*/, double  /*_sparsity2*/) {
-			if (_n*_m<(_n+_m)*_r) {
-				return -1e10 + _n*_m*_r;
+		double score_big_tensor(double _m, double _n, double _r, double _sparsity1, double _sparsity2) {
+			if (contraction_sparsity(_m, _n, _r, _sparsity1, _sparsity2) < _sparsity1 + _sparsity2) {
+				return -1e10 + contraction_cost(_m, _n, _r, _sparsity1, _sparsity2);
 			} 
-				return _n*_m-(_n+_m)*_r;
+				return score_size(_m, _n, _r, _sparsity1, _sparsity2);
 			
 		}
-		double score_littlestep(double _m, double _n, double _r, double  /*_sparsity1*/, double  /*_sparsity2*/) {
-			if (_n*_m<(_n+_m)*_r) {
-				return -std::max(_n,_m)*_r;
+		double score_littlestep(double _m, double _n, double _r, double _sparsity1, double _sparsity2) {
+			if (contraction_sparsity(_m, _n, _r, _sparsity1, _sparsity2) < _sparsity1 + _sparsity2) {
+				return -std::max(_sparsity1, _sparsity2);
 			} 
-				return _n*_m-(_n+_m)*_r;
+				return score_size(_m, _n, _r, _sparsity1, _sparsity2);
 			
 		}
 		
 		
 		
-		std::tuple<size_t, size_t, size_t, double> best_of_three(const TensorNetwork &_network, size_t _id1, size_t _id2, size_t _id3) {
+		/// @brief Contracts the nodes @a _id1 and @a _id2 of the (structure only) network, updates the sparsity of the result and returns the cost of the contraction.
+		double contract_and_update_sparsity(TensorNetwork &_network, std::vector<double> &_sparsities, const size_t _id1, const size_t _id2) {
+			double m=1, n=1, r=1;
+			for (const TensorNetwork::Link &l : _network.nodes[_id1].neighbors) {
+				if (l.links(_id2)) {
+					r *= static_cast<double>(l.dimension);
+				} else {
+					m *= static_cast<double>(l.dimension);
+				}
+			}
+			for (const TensorNetwork::Link &l : _network.nodes[_id2].neighbors) {
+				if (!l.links(_id1)) {
+					n *= static_cast<double>(l.dimension);
+				}
+			}
+			const double cost = contraction_cost(m, n, r, _sparsities[_id1], _sparsities[_id2]);
+			_sparsities[_id1] = contraction_sparsity(m, n, r, _sparsities[_id1], _sparsities[_id2]);
+			_network.contract(_id1, _id2);
+			return cost;
+		}
+		
+		
+		std::tuple<size_t, size_t, size_t, double> best_of_three(const TensorNetwork &_network, size_t _id1, size_t _id2, size_t _id3, const std::vector<double> &_sparsities) {
 			const TensorNetwork::TensorNode &na = _network.nodes[_id1];
 			const TensorNetwork::TensorNode &nb = _network.nodes[_id2];
 			const TensorNetwork::TensorNode &nc = _network.nodes[_id3];
@@ -163,21 +238,25 @@ namespace xerus {
 					sc *= static_cast<double>(nc.neighbors[d].dimension);
 				}
 			}
-			// cost of contraction a-b first etc.
-			double costAB = sa*sb*sac*sbc*(sab+sc); // (sa*sac)*sab*(sb*sbc) + sa*sb*sac*sbc*sc;
-			double costAC = sa*sc*sab*sbc*(sac+sb); 
-			double costBC = sb*sc*sab*sac*(sbc+sa);
+			// cost of contraction a-b first etc. (for dense nodes e.g. costAB = (sa*sac)*sab*(sb*sbc) + sa*sb*sac*sbc*sc)
+			const double spa = _sparsities[_id1], spb = _sparsities[_id2], spc = _sparsities[_id3];
+			const double firstAB = contraction_cost(sa*sac, sb*sbc, sab, spa, spb);
+			const double firstAC = contraction_cost(sa*sab, sc*sbc, sac, spa, spc);
+			const double firstBC = contraction_cost(sb*sab, sc*sac, sbc, spb, spc);
+			const double costAB = firstAB + contraction_cost(sa*sb, sc, sac*sbc, contraction_sparsity(sa*sac, sb*sbc, sab, spa, spb), spc);
+			const double costAC = firstAC + contraction_cost(sa*sc, sb, sab*sbc, contraction_sparsity(sa*sab, sc*sbc, sac, spa, spc), spb);
+			const double costBC = firstBC + contraction_cost(sb*sc, sa, sab*sac, contraction_sparsity(sb*sab, sc*sac, sbc, spb, spc), spa);
 			if (costAB < costAC && costAB < costBC) {
-				return std::tuple<size_t, size_t, size_t, double>(_id1, _id2, _id3, sa*sb*sac*sbc*sab);
+				return std::tuple<size_t, size_t, size_t, double>(_id1, _id2, _id3, firstAB);
 			} 
 			if (costAC < costBC) {
-				return std::tuple<size_t, size_t, size_t, double>(_id1, _id3, _id2, sa*sc*sab*sbc*sac);
+				return std::tuple<size_t, size_t, size_t, double>(_id1, _id3, _id2, firstAC);
 			}
-			return std::tuple<size_t, size_t, size_t, double>(_id2, _id3, _id1, sb*sc*sab*sac*sbc);
+			return std::tuple<size_t, size_t, size_t, double>(_id2, _id3, _id1, firstBC);
 		}
 		
 		
-		void greedy_best_of_three_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network) {
+		void greedy_best_of_three_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network, std::vector<double> _sparsities) {
 			// estimated cost to calculate this heuristic is
 			// numNodes * numNodes * 3*avgEdgesPerNode = 3 * numNodes * numEdges
 			size_t numNodes=0, numEdges=0;
@@ -244,7 +323,7 @@ namespace xerus {
 				}
 				
 				// find the next best contraction within id1,id2,id3
-				std::tuple<size_t, size_t, size_t, double> contraction = best_of_three(_network, id1, id2, id3);
+				std::tuple<size_t, size_t, size_t, double> contraction = best_of_three(_network, id1, id2, id3, _sparsities);
 				ourFinalCost += std::get<3>(contraction);
 				if (ourFinalCost > _bestCost) {
 					return;
@@ -255,12 +334,12 @@ namespace xerus {
 // 					id2 = id3;
 // 				}
 				ourContractions.emplace_back(std::get<0>(contraction), std::get<1>(contraction));
-				_network.contract(std::get<0>(contraction), std::get<1>(contraction));
+				contract_and_update_sparsity(_network, _sparsities, std::get<0>(contraction), std::get<1>(contraction));
 				numNodes -= 1;
 				LOG(cont, std::get<0>(contraction) << " " << std::get<1>(contraction));
 				
 				if (numNodes == 2) {
-					ourFinalCost += _network.contraction_cost(id1, id2);
+					ourFinalCost += contract_and_update_sparsity(_network, _sparsities, id1, id2);
 					ourContractions.emplace_back(id1, id2);
 					LOG(cont, id1 << " " << id2);
 					numNodes -= 1;
@@ -275,10 +354,11 @@ namespace xerus {
 		}
 		
 		
-		void exchange_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network) {
+		void exchange_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network, std::vector<double> _sparsities) {
 			// estimated cost to calculate this heuristic is
 			// numContractions * 3*avgEdgesPerNode ~= 3 * numEdges
 			TensorNetwork copyNet(_network);
+			const std::vector<double> copySparsities(_sparsities);
 			double numEdges=0;
 			for (const auto &node : _network.nodes) {
 				if (!node.erased) {
@@ -314,14 +394,13 @@ namespace xerus {
 					while (id2 != idMap[id2]) { id2 = idMap[id2]; }
 					if (next.first != id1 && next.first != id2) {
 						if (next.second == id1 || next.second == id2) {
-							auto contr = best_of_three(_network, id1, id2, next.first);
+							auto contr = best_of_three(_network, id1, id2, next.first, _sparsities);
 							size_t a = std::get<0>(contr);
 							size_t b = std::get<1>(contr);
 							size_t c = std::get<2>(contr);
 							idMap[b] = a;
-							ourFinalCost += std::get<3>(contr);
+							ourFinalCost += contract_and_update_sparsity(_network, _sparsities, a, b);
 							ourContractions.emplace_back(a,b);
-							_network.contract(a,b);
 							next.first = a;
 							next.second = c;
 						} else {
@@ -331,14 +410,13 @@ namespace xerus {
 						if (next.second == id1 || next.second == id2) {
 							LOG(fatal, "ie");
 						} else {
-							auto contr = best_of_three(_network, id1, id2, next.second);
+							auto contr = best_of_three(_network, id1, id2, next.second, _sparsities);
 							size_t a = std::get<0>(contr);
 							size_t b = std::get<1>(contr);
 							size_t c = std::get<2>(contr);
 							idMap[b] = a;
-							ourFinalCost += std::get<3>(contr);
+							ourFinalCost += contract_and_update_sparsity(_network, _sparsities, a, b);
 							ourContractions.emplace_back(a,b);
-							_network.contract(a,b);
 							next.first = a;
 							next.second = c;
 						}
@@ -350,7 +428,7 @@ namespace xerus {
 			
 			INTERNAL_CHECK(openPairs.size() == 1, "ie");
 			
-			ourFinalCost += _network.contraction_cost(openPairs.front().first, openPairs.front().second);
+			ourFinalCost += contract_and_update_sparsity(_network, _sparsities, openPairs.front().first, openPairs.front().second);
 			ourContractions.emplace_back(openPairs.front());
 			
 // 			LOG(hohohoEx, ourFinalCost << " vs " << _bestCost);
@@ -363,12 +441,118 @@ namespace xerus {
 				_contractions = std::move(ourContractions);
 				
 				if (repeat) {
-					exchange_heuristic(_bestCost, _contractions, copyNet);
+					exchange_heuristic(_bestCost, _contractions, copyNet, copySparsities);
 				}
 			}
 		}
 		
 		
+		/// @brief Appends the optimal contractions of the given subset of nodes (as found by optimal_heuristic) and returns the id of the resulting node.
+		size_t append_optimal_contractions(std::vector<std::pair<size_t,size_t>> &_contractions, const std::vector<size_t> &_splits, const std::vector<size_t> &_ids, const size_t _subset) {
+			if ((_subset & (_subset-1)) == 0) {
+				size_t pos = 0;
+				while ((size_t(1) << pos) != _subset) { ++pos; }
+				return _ids[pos];
+			}
+			const size_t id1 = append_optimal_contractions(_contractions, _splits, _ids, _splits[_subset]);
+			const size_t id2 = append_optimal_contractions(_contractions, _splits, _ids, _subset ^ _splits[_subset]);
+			_contractions.emplace_back(id1, id2);
+			return id1;
+		}
+		
+		
+		void optimal_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network, std::vector<double> _sparsities) {
+			std::vector<size_t> ids;
+			for (size_t i = 0; i < _network.nodes.size(); ++i) {
+				if (!_network.nodes[i].erased) { ids.emplace_back(i); }
+			}
+			const size_t numNodes = ids.size();
+			if (numNodes < 3 || numNodes > optimalSearchMaxNodes) { return; }
+			
+			// estimated cost to calculate this heuristic is the number of pairs of disjoint subsets, i.e. 3^numNodes
+			// if the best solution is only about twice as costly as the calculation of this heuristic, then don't bother
+			if (_bestCost < 2 * std::pow(3.0, static_cast<double>(numNodes))) { return; }
+			
+			const auto startTime = std::chrono::steady_clock::now();
+			const size_t numSubsets = size_t(1) << numNodes;
+			
+			// Dimensions of the links between any two nodes and of the external links of each node
+			std::vector<size_t> localIds(_network.nodes.size(), numNodes);
+			for (size_t k = 0; k < numNodes; ++k) { localIds[ids[k]] = k; }
+			std::vector<double> linkDims(numNodes*numNodes, 1.0);
+			std::vector<double> externalDims(numNodes, 1.0);
+			for (size_t k = 0; k < numNodes; ++k) {
+				for (const TensorNetwork::Link &l : _network.nodes[ids[k]].neighbors) {
+					if (l.external) {
+						externalDims[k] *= static_cast<double>(l.dimension);
+					} else {
+						linkDims[k*numNodes + localIds[l.other]] *= static_cast<double>(l.dimension);
+					}
+				}
+			}
+			
+			// Size of the tensor resulting from the contraction of each subset of nodes
+			std::vector<double> sizes(numSubsets);
+			sizes[0] = 1.0;
+			for (size_t subset = 1; subset < numSubsets; ++subset) {
+				size_t k = 0;
+				while (((subset >> k) & 1) == 0) { ++k; }
+				const size_t rest = subset & (subset-1);
+				double size = sizes[rest]*externalDims[k];
+				for (size_t other = 0; other < numNodes; ++other) {
+					if (other == k) { continue; }
+					if ((rest >> other) & 1) {
+						size /= linkDims[k*numNodes + other];
+					} else {
+						size *= linkDims[k*numNodes + other];
+					}
+				}
+				sizes[subset] = size;
+			}
+			
+			// Dynamic programming over all subsets (in increasing order, so all proper subsets are handled before).
+			// The results of S1 and S2 have sizes m*r and n*r and the result of S1+S2 has size m*n, so r = sqrt(size(S1)*size(S2)/size(S1+S2)).
+			// Subsets that are already more expensive than the best known solution are pruned.
+			std::vector<double> costs(numSubsets, std::numeric_limits<double>::infinity());
+			std::vector<double> sparsities(numSubsets);
+			std::vector<size_t> splits(numSubsets, 0);
+			for (size_t k = 0; k < numNodes; ++k) { 
+				costs[size_t(1) << k] = 0.0;
+				sparsities[size_t(1) << k] = _sparsities[ids[k]];
+			}
+			for (size_t subset = 3; subset < numSubsets; ++subset) {
+				if ((subset & (subset-1)) == 0) { continue; }
+				
+				if (std::chrono::steady_clock::now() - startTime > std::chrono::milliseconds(optimalSearchTimeBudget)) {
+					LOG(contractionHeuristic, "Optimal contraction search exceeded its time budget, using the best heuristic solution instead.");
+					return;
+				}
+				
+				// Only consider splits where the first part contains the lowest node, so that every split is considered once.
+				const size_t lowestNode = subset & (~subset + 1);
+				for (size_t first = (subset-1) & subset; first > 0; first = (first-1) & subset) {
+					if ((first & lowestNode) == 0) { continue; }
+					const size_t second = subset ^ first;
+					const double subCost = costs[first] + costs[second];
+					if (subCost >= costs[subset]) { continue; }
+					const double r = std::sqrt(sizes[first]*sizes[second]/sizes[subset]);
+					const double cost = subCost + contraction_cost(sizes[first]/r, sizes[second]/r, r, sparsities[first], sparsities[second]);
+					if (cost < costs[subset] && cost < _bestCost) {
+						costs[subset] = cost;
+						sparsities[subset] = contraction_sparsity(sizes[first]/r, sizes[second]/r, r, sparsities[first], sparsities[second]);
+						splits[subset] = first;
+					}
+				}
+			}
+			
+			if (costs[numSubsets-1] < _bestCost) {
+				_bestCost = costs[numSubsets-1];
+				_contractions.clear();
+				append_optimal_contractions(_contractions, splits, ids, numSubsets-1);
+			}
+		}
+		
+		
 		const std::vector<ContractionHeuristic> contractionHeuristics {
 			&greedy_heuristic<&score_size>,
 			&greedy_heuristic<&score_mn>,
@@ -378,7 +562,73 @@ namespace xerus {
 			&greedy_heuristic<&score_littlestep>
 // 			,&greedy_best_of_three_heuristic
 			,&exchange_heuristic
+			,&optimal_heuristic
+		};
+		
+		
+		size_t contractionCacheCapacity = 4096;
+		
+		/// @brief Hash for the structure descriptions used as keys of the contraction cache.
+		struct ContractionKeyHash {
+			size_t operator()(const std::vector<size_t> &_key) const noexcept {
+				size_t hash = _key.size();
+				for (const size_t k : _key) {
+					hash ^= k + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				}
+				return hash;
+			}
 		};
+		
+		static std::mutex contractionCacheMutex;
+		static std::unordered_map<std::vector<size_t>, std::vector<std::pair<size_t,size_t>>, ContractionKeyHash> contractionCache;
+		static size_t contractionCacheHits = 0;
+		static size_t contractionCacheMisses = 0;
+		
+		
+		bool find_cached_contractions(const std::vector<size_t> &_key, std::vector<std::pair<size_t,size_t>> &_contractions) {
+			std::lock_guard<std::mutex> lock(contractionCacheMutex);
+			const auto entry = contractionCache.find(_key);
+			if (entry == contractionCache.end()) {
+				contractionCacheMisses++;
+				return false;
+			}
+			contractionCacheHits++;
+			_contractions = entry->second;
+			return true;
+		}
+		
+		
+		void cache_contractions(std::vector<size_t> _key, std::vector<std::pair<size_t,size_t>> _contractions) {
+			std::lock_guard<std::mutex> lock(contractionCacheMutex);
+			if (contractionCache.size() >= contractionCacheCapacity) {
+				if (contractionCacheCapacity == 0) { return; }
+				contractionCache.clear();
+			}
+			contractionCache.emplace(std::move(_key), std::move(_contractions));
+		}
+		
+		
+		size_t contraction_cache_hits() {
+			std::lock_guard<std::mutex> lock(contractionCacheMutex);
+			return contractionCacheHits;
+		}
+		
+		
+		size_t contraction_cache_misses() {
+			std::lock_guard<std::mutex> lock(contractionCacheMutex);
+			return contractionCacheMisses;
+		}
+		
+		
+		void clear_contraction_cache() {
+			std::lock_guard<std::mutex> lock(contractionCacheMutex);
+			contractionCache.clear();
+			contractionCacheHits = 0;
+			contractionCacheMisses = 0;
+		}
+		
+		
+		size_t parallelContractionMemory = 1ul<<27;
     } // namespace internal
 
 } // namespace xerus
@@ -28,25 +28,185 @@
 #include <xerus/tensor.h>
  
 #include <memory>
+#include <algorithm>
 #include <xerus/misc/basicArraySupport.h>
  
 #include <xerus/misc/containerSupport.h>
 #include <xerus/misc/performanceAnalysis.h>
+#include <xerus/misc/parallel.h>
 #include <xerus/misc/internal.h>
 
 namespace xerus {
 
-	void increase_indices(const size_t _i, value_t*& _outPosition, const std::vector<size_t>& _stepSizes, const std::vector<size_t>& _baseDimensions ) {
-		size_t index = _stepSizes.size()-1;
-		_outPosition += _stepSizes[index];
-		size_t multStep = _baseDimensions[index];
-		while(_i%multStep == 0) {
-			_outPosition -= _baseDimensions[index]*_stepSizes[index]; // "reset" current index to 0
-			--index; // Advance to next index
-			_outPosition += _stepSizes[index]; // increase next index
-			multStep *= _baseDimensions[index]; // next stepSize
+	namespace internal {
+		
+		template<class T>
+		inline void increase_indices(const size_t _i, const T*& _oldPosition, const std::vector<size_t>& _steps, const std::vector<size_t>& _multDimensions) {
+			size_t index = _steps.size()-1;
+			_oldPosition += _steps[index];
+			size_t multStep = _multDimensions[index];
+			while(_i%multStep == 0) {
+				_oldPosition -= _multDimensions[index]*_steps[index]; // "reset" current index to 0
+				--index; // Advance to next index
+				_oldPosition += _steps[index]; // increase next index
+				multStep *= _multDimensions[index]; // next stepSize
+			}
 		}
-	}
+
+		template<class T>
+		inline void sum_traces(	T* const _newPosition,
+								const T* _oldPosition,
+								const std::vector<size_t>& _doubleSteps,
+								const std::vector<size_t>& _doubleMultDimensions,
+								const size_t _numSummations) {
+			*_newPosition = *_oldPosition;
+			for(size_t k = 1; k < _numSummations; ++k) {
+				increase_indices(k, _oldPosition, _doubleSteps, _doubleMultDimensions);
+				*_newPosition += *_oldPosition;
+			}
+		}
+		
+		template<class T>
+		inline void sum_traces(	T* const _newPosition,
+								const T* _oldPosition,
+								const std::vector<size_t>& _doubleSteps,
+								const std::vector<size_t>& _doubleMultDimensions,
+								const size_t _numSummations,
+								const size_t _orderedIndicesMultDim ) {
+			misc::copy(_newPosition, _oldPosition, _orderedIndicesMultDim);
+			for(size_t k = 1; k < _numSummations; ++k) {
+				increase_indices(k, _oldPosition, _doubleSteps, _doubleMultDimensions);
+				misc::add(_newPosition, _oldPosition, _orderedIndicesMultDim);
+			}
+		}
+		
+		
+		
+		/// @brief Edge length of the tiles used by dense_reshuffle() if the fastest index of the old data is not the fastest of the new data.
+		constexpr size_t RESHUFFLE_TILE_SIZE = 32;
+		
+		/// @brief Returns the position of @a _position (w.r.t. @a _dimensions) in a layout with the given step sizes.
+		inline size_t get_shifted_position(size_t _position, const std::vector<size_t>& _dimensions, const std::vector<size_t>& _steps) {
+			size_t shiftedPosition = 0;
+			for(size_t i = _dimensions.size(); i > 0; --i) {
+				shiftedPosition += (_position%_dimensions[i-1])*_steps[i-1];
+				_position /= _dimensions[i-1];
+			}
+			return shiftedPosition;
+		}
+		
+		/// @brief Copies one block of @a _blockSize consecutive entries or, if there are traces, sets it to the sum over all traces.
+		template<class T>
+		XERUS_force_inline void copy_or_sum_traces(	T* const _newPosition,
+													const T* const _oldPosition,
+													const size_t _blockSize,
+													const std::vector<size_t>& _traceSteps,
+													const std::vector<size_t>& _traceDimensions,
+													const size_t _totalTraceDim) {
+			if(_totalTraceDim == 1) {
+				if(_blockSize == 1) {
+					*_newPosition = *_oldPosition;
+				} else {
+					misc::copy(_newPosition, _oldPosition, _blockSize);
+				}
+			} else {
+				if(_blockSize == 1) {
+					sum_traces(_newPosition, _oldPosition, _traceSteps, _traceDimensions, _totalTraceDim);
+				} else {
+					sum_traces(_newPosition, _oldPosition, _traceSteps, _traceDimensions, _totalTraceDim, _blockSize);
+				}
+			}
+		}
+		
+		
+		/**
+		 * @brief Multithreaded kernel shared by all dense reshuffles, i.e. generalized transpositions with optional traces.
+		 * @details Sets the k-th block of @a _blockSize entries of @a _newData to the (sum over all traces of the) block at position 
+		 * sum_i k_i*_oldSteps[i] in @a _oldData, where (k_0, ..., k_{n-1}) is the multi-index of k w.r.t. @a _newDimensions.
+		 * If single entries are moved and the fastest index of the old data is not the fastest index of the new data, both indices
+		 * are processed in tiles of RESHUFFLE_TILE_SIZE^2 entries, such that neither reads nor writes leave the cache. 
+		 * The work is split among misc::get_num_threads() threads. Used for double as well as single precision data.
+		 */
+		template<class T>
+		void dense_reshuffle(	T* const _newData,
+								const T* const _oldData,
+								const std::vector<size_t>& _newDimensions,
+								const std::vector<size_t>& _oldSteps,
+								const size_t _blockSize,
+								const std::vector<size_t>& _traceSteps,
+								const std::vector<size_t>& _traceDimensions) {
+			INTERNAL_CHECK(_newDimensions.size() == _oldSteps.size() && _traceSteps.size() == _traceDimensions.size(), "IE");
+			
+			const size_t numIndices = _newDimensions.size();
+			const size_t numBlocks = misc::product(_newDimensions);
+			const size_t totalTraceDim = misc::product(_traceDimensions);
+			const size_t numThreads = misc::get_num_threads(numBlocks*_blockSize*totalTraceDim);
+			
+			// Find the index which is fastest in the old data, this and the last index are tiled if they differ. 
+			size_t tileIndex = numIndices;
+			if(_blockSize == 1 && numIndices >= 2 && _newDimensions.back() >= RESHUFFLE_TILE_SIZE/2) {
+				tileIndex = 0;
+				for(size_t i = 1; i+1 < numIndices; ++i) {
+					if(_oldSteps[i] < _oldSteps[tileIndex]) { tileIndex = i; }
+				}
+				if(_oldSteps[tileIndex] >= _oldSteps.back() || _newDimensions[tileIndex] < RESHUFFLE_TILE_SIZE/2) { tileIndex = numIndices; }
+			}
+			
+			if(tileIndex == numIndices) {
+				// Each thread handles a consecutive range of blocks in the new data
+				#pragma omp parallel for num_threads(numThreads) schedule(static)
+				for(size_t t = 0; t < numThreads; ++t) {
+					const size_t start = t*numBlocks/numThreads;
+					const size_t end = (t+1)*numBlocks/numThreads;
+					if(start == end) { continue; }
+					
+					const T* oldPosition = _oldData + get_shifted_position(start, _newDimensions, _oldSteps);
+					copy_or_sum_traces(_newData + start*_blockSize, oldPosition, _blockSize, _traceSteps, _traceDimensions, totalTraceDim);
+					for(size_t i = start+1; i < end; ++i) {
+						increase_indices(i, oldPosition, _oldSteps, _newDimensions);
+						copy_or_sum_traces(_newData + i*_blockSize, oldPosition, _blockSize, _traceSteps, _traceDimensions, totalTraceDim);
+					}
+				}
+			} else {
+				const size_t lastIndex = numIndices-1;
+				const size_t tileDim = _newDimensions[tileIndex];
+				const size_t lastDim = _newDimensions[lastIndex];
+				const size_t numTiles = (tileDim + RESHUFFLE_TILE_SIZE - 1)/RESHUFFLE_TILE_SIZE;
+				const size_t numOuter = numBlocks/(tileDim*lastDim);
+				
+				std::vector<size_t> newSteps(numIndices, 1);
+				for(size_t i = lastIndex; i > 0; --i) {
+					newSteps[i-1] = newSteps[i]*_newDimensions[i];
+				}
+				
+				// All other indices are enumerated with the tile and last index fixed to zero
+				std::vector<size_t> outerDimensions(_newDimensions);
+				outerDimensions[tileIndex] = 1;
+				outerDimensions[lastIndex] = 1;
+				
+				#pragma omp parallel for num_threads(numThreads) schedule(static)
+				for(size_t w = 0; w < numOuter*numTiles; ++w) {
+					const size_t outer = w/numTiles;
+					const size_t tileStart = (w%numTiles)*RESHUFFLE_TILE_SIZE;
+					const size_t tileEnd = std::min(tileStart+RESHUFFLE_TILE_SIZE, tileDim);
+					T* const newOuter = _newData + get_shifted_position(outer, outerDimensions, newSteps);
+					const T* const oldOuter = _oldData + get_shifted_position(outer, outerDimensions, _oldSteps);
+					
+					for(size_t lastStart = 0; lastStart < lastDim; lastStart += RESHUFFLE_TILE_SIZE) {
+						const size_t lastEnd = std::min(lastStart+RESHUFFLE_TILE_SIZE, lastDim);
+						for(size_t k = tileStart; k < tileEnd; ++k) {
+							T* const newRow = newOuter + k*newSteps[tileIndex];
+							const T* const oldRow = oldOuter + k*_oldSteps[tileIndex];
+							for(size_t l = lastStart; l < lastEnd; ++l) {
+								copy_or_sum_traces(newRow + l, oldRow + l*_oldSteps[lastIndex], 1, _traceSteps, _traceDimensions, totalTraceDim);
+							}
+						}
+					}
+				}
+			}
+		}
+	} // namespace internal
+	
 	
 	/**
 	 * @brief: Performs a simple reshuffle. Much less powerfull then a full evaluate, but more efficient.
@@ -96,31 +256,33 @@ namespace xerus {
 			usedBase = &_base;
 		}
 		
-		_out.reset(std::move(outDimensions), usedBase->representation, Tensor::Initialisation::None);
+		if(usedBase->is_single_precision()) {
+			_out.reset(std::move(outDimensions), std::unique_ptr<float[]>(new float[usedBase->size]));
+		} else {
+			_out.reset(std::move(outDimensions), usedBase->representation, Tensor::Initialisation::None);
+		}
 		
 		if(usedBase->is_dense()) {
-			const size_t numBlocks = misc::product(usedBase->dimensions, 0, numToShuffle);
-			value_t* outPosition = _out.override_dense_data();
-			const value_t* basePosition = usedBase->get_unsanitized_dense_data();
+			// The kernel iterates over the new positions, so we need the step sizes of the new indices in the old data
+			std::vector<size_t> baseStepSizes(numToShuffle);
+			for( size_t i = 0; i < numToShuffle; ++i ) {
+				baseStepSizes[_shuffle[i]] = misc::product(usedBase->dimensions, i+1, numToShuffle)*blockSize;
+			}
+			const std::vector<size_t> shuffledDimensions(_out.dimensions.begin(), _out.dimensions.begin()+long(numToShuffle));
 			
-			if(blockSize == 1) {
-				*outPosition = *basePosition;
-				for(size_t b = 1; b < numBlocks; ++b) {
-					increase_indices(b, outPosition, stepSizes, usedBase->dimensions);
-					*outPosition = *(basePosition + b*blockSize);
-				}
+			XERUS_PA_START;
+			if(usedBase->is_single_precision()) {
+				internal::dense_reshuffle(_out.override_single_data(), usedBase->get_unsanitized_single_data(), shuffledDimensions, baseStepSizes, blockSize, {}, {});
 			} else {
-				misc::copy(outPosition, basePosition, blockSize);
-				for(size_t b = 1; b < numBlocks; ++b) {
-					increase_indices(b, outPosition, stepSizes, usedBase->dimensions);
-					misc::copy(outPosition, basePosition + b*blockSize, blockSize);
-				}
+				internal::dense_reshuffle(_out.override_dense_data(), usedBase->get_unsanitized_dense_data(), shuffledDimensions, baseStepSizes, blockSize, {}, {});
 			}
+			XERUS_PA_END("Evaluation", "Reshuffle", misc::to_string(usedBase->dimensions)+" ==> " + misc::to_string(_out.dimensions));
+			
 			_out.factor = usedBase->factor;
 			
 		} else {
-			const std::map<size_t, value_t>& baseEntries = usedBase->get_unsanitized_sparse_data();
-			std::map<size_t, value_t>& outEntries = _out.override_sparse_data();
+			const misc::FlatMap<size_t, value_t>& baseEntries = usedBase->get_unsanitized_sparse_data();
+			misc::FlatMap<size_t, value_t>& outEntries = _out.override_sparse_data();
 			
 			for(const auto& entry : baseEntries) {
 				size_t basePosition = entry.first;
@@ -131,8 +293,9 @@ namespace xerus {
 					position += (basePosition%usedBase->dimensions[i-1])*stepSizes[i-1];
 					basePosition /= usedBase->dimensions[i-1];
 				}
-				outEntries.emplace(position, usedBase->factor*entry.second);
+				outEntries.emplace_back_unsorted(position, usedBase->factor*entry.second);
 			}
+			outEntries.sort_and_sum_duplicates();
 		}
 	}
 	
@@ -144,44 +307,6 @@ namespace xerus {
 	
 	namespace internal {
 		
-		inline void increase_indices(const size_t _i, const value_t*& _oldPosition, const std::vector<size_t>& _steps, const std::vector<size_t>& _multDimensions) {
-			size_t index = _steps.size()-1;
-			_oldPosition += _steps[index];
-			size_t multStep = _multDimensions[index];
-			while(_i%multStep == 0) {
-				_oldPosition -= _multDimensions[index]*_steps[index]; // "reset" current index to 0
-				--index; // Advance to next index
-				_oldPosition += _steps[index]; // increase next index
-				multStep *= _multDimensions[index]; // next stepSize
-			}
-		}
-
-		inline void sum_traces(	value_t* const _newPosition,
-								const value_t* _oldPosition,
-								const std::vector<size_t>& _doubleSteps,
-								const std::vector<size_t>& _doubleMultDimensions,
-								const size_t _numSummations) {
-			*_newPosition = *_oldPosition;
-			for(size_t k = 1; k < _numSummations; ++k) {
-				increase_indices(k, _oldPosition, _doubleSteps, _doubleMultDimensions);
-				*_newPosition += *_oldPosition;
-			}
-		}
-		
-		inline void sum_traces(	value_t* const _newPosition,
-								const value_t* _oldPosition,
-								const std::vector<size_t>& _doubleSteps,
-								const std::vector<size_t>& _doubleMultDimensions,
-								const size_t _numSummations,
-								const size_t _orderedIndicesMultDim ) {
-			misc::copy(_newPosition, _oldPosition, _orderedIndicesMultDim);
-			for(size_t k = 1; k < _numSummations; ++k) {
-				increase_indices(k, _oldPosition, _doubleSteps, _doubleMultDimensions);
-				misc::add(_newPosition, _oldPosition, _orderedIndicesMultDim);
-			}
-		}
-		
-		
 		inline size_t get_position(const std::pair<size_t, value_t>& _entry,
 							const size_t* const _baseIndexDim,
 							const size_t* const _divisors,
@@ -317,7 +442,6 @@ namespace xerus {
 				
 				std::vector<size_t> traceStepSizes; // How much we have to move in base if the index of the i-th trace is increased
 				std::vector<size_t> traceDimensions; // The dimensions of the traces
-				size_t totalTraceDim = 1; // Total number of summantions, i.e. Product of all trace dimensions
 				
 				// Calculate stepSizes for our tensor. We will march in steps of orderedIndicesMultDim in _out.data
 				for(size_t i = 0; i < _base.indices.size()-numOrderedIndices; ++i) {
@@ -334,7 +458,6 @@ namespace xerus {
 							if(_base.indices[i] == _base.indices[j]) {
 								traceStepSizes.emplace_back(baseIndexStepSizes[i]+baseIndexStepSizes[j]);
 								traceDimensions.emplace_back(_base.indices[i].dimension());
-								totalTraceDim *= _base.indices[i].dimension();
 								break;
 							}
 						}
@@ -344,44 +467,25 @@ namespace xerus {
 				// Start performance analysis for low level part
 				XERUS_PA_START;
 				
-				// Get pointers to the data and delay the deletion of the base data in case _out and _base coincide
-				const value_t* oldPosition = _base.tensorObjectReadOnly->get_unsanitized_dense_data()+fixedIndexOffset;
-				std::shared_ptr<value_t> delaySlot;
-				if(_base.tensorObjectReadOnly == _out.tensorObjectReadOnly) { delaySlot = _out.tensorObject->get_internal_dense_data(); }
-				value_t* const newPosition = _out.tensorObject->override_dense_data();
-				
-				// Get specific sizes
-				const size_t numSteps = _out.tensorObject->size/orderedIndexDim;
+				const std::vector<size_t> shuffledDimensions(outIndexDimensions.begin(), outIndexDimensions.begin()+long(stepSizes.size()));
 				
-				if(orderedIndexDim == 1) { // We have to copy/add single entries
-					if(totalTraceDim == 1) { // We don't need to sum any traces
-						newPosition[0] = *oldPosition;
-						for(size_t i = 1; i < numSteps; ++i) {
-							increase_indices(i, oldPosition, stepSizes, outIndexDimensions);
-							newPosition[i] = *oldPosition;
-						}
-					} else { // We have to add traces
-						sum_traces(newPosition, oldPosition, traceStepSizes, traceDimensions, totalTraceDim);
-						for(size_t i = 1; i < numSteps; ++i) {
-							increase_indices(i, oldPosition, stepSizes, outIndexDimensions);
-							sum_traces(newPosition+i, oldPosition, traceStepSizes, traceDimensions, totalTraceDim);
-						}
-					}
-				} else { // We can copy/add larger blocks
-					if(totalTraceDim == 1) { // We don't need to sum any traces
-						misc::copy(newPosition, oldPosition, orderedIndexDim);
-						for(size_t i = 1; i < numSteps; ++i) {
-							increase_indices(i, oldPosition, stepSizes, outIndexDimensions);
-							misc::copy(newPosition + i*orderedIndexDim, oldPosition, orderedIndexDim);
-						}
-					} else { // We have to add traces
-						sum_traces(newPosition, oldPosition, traceStepSizes, traceDimensions, totalTraceDim, orderedIndexDim);
-						for(size_t i = 1; i < numSteps; ++i) {
-							increase_indices(i, oldPosition, stepSizes, outIndexDimensions);
-							sum_traces(newPosition + i*orderedIndexDim, oldPosition, traceStepSizes, traceDimensions, totalTraceDim, orderedIndexDim);
-						}
-					}
+				// Get pointers to the data and delay the deletion of the base data in case _out and _base coincide
+				if(_base.tensorObjectReadOnly->is_single_precision()) {
+					const float* const oldData = _base.tensorObjectReadOnly->get_unsanitized_single_data()+fixedIndexOffset;
+					Tensor delaySlot;
+					if(_base.tensorObjectReadOnly == _out.tensorObjectReadOnly) { delaySlot = *_base.tensorObjectReadOnly; }
+					float* const newData = _out.tensorObject->override_single_data();
+					
+					dense_reshuffle(newData, oldData, shuffledDimensions, stepSizes, orderedIndexDim, traceStepSizes, traceDimensions);
+				} else {
+					const value_t* const oldData = _base.tensorObjectReadOnly->get_unsanitized_dense_data()+fixedIndexOffset;
+					std::shared_ptr<value_t> delaySlot;
+					if(_base.tensorObjectReadOnly == _out.tensorObjectReadOnly) { delaySlot = _out.tensorObject->get_internal_dense_data(); }
+					value_t* const newData = _out.tensorObject->override_dense_data();
+					
+					dense_reshuffle(newData, oldData, shuffledDimensions, stepSizes, orderedIndexDim, traceStepSizes, traceDimensions);
 				}
+				
 				XERUS_PA_END("Evaluation", "Full->Full", misc::to_string(_base.tensorObjectReadOnly->dimensions)+" ==> " + misc::to_string(_out.tensorObject->dimensions));
 				
 				
@@ -428,10 +532,10 @@ namespace xerus {
 				}
 				
 				// Get direct acces to the entries and delay deletion of _base data in case _base and _out coincide
-				const std::map<size_t, value_t>& baseEntries = _base.tensorObjectReadOnly->get_unsanitized_sparse_data();
-				std::shared_ptr<std::map<size_t, value_t>> delaySlot;
+				const misc::FlatMap<size_t, value_t>& baseEntries = _base.tensorObjectReadOnly->get_unsanitized_sparse_data();
+				std::shared_ptr<misc::FlatMap<size_t, value_t>> delaySlot;
 				if(_base.tensorObjectReadOnly == _out.tensorObjectReadOnly) { delaySlot = _out.tensorObject->get_internal_sparse_data(); }
-				std::map<size_t, value_t>& outEntries = _out.tensorObject->override_sparse_data(); // Takes care that no entries are present
+				misc::FlatMap<size_t, value_t>& outEntries = _out.tensorObject->override_sparse_data(); // Takes care that no entries are present
 				
 				const value_t factor = _base.tensorObjectReadOnly->factor;
 				
@@ -440,16 +544,17 @@ namespace xerus {
 				
 				if(peacefullIndices) {
 					for(const auto& entry : baseEntries) {
-						outEntries.emplace(get_position(entry, baseIndexDimensions.data(), baseIndexStepSizes.data(), attributes, _base.indices.size()), factor*entry.second);
+						outEntries.emplace_back_unsorted(get_position(entry, baseIndexDimensions.data(), baseIndexStepSizes.data(), attributes, _base.indices.size()), factor*entry.second);
 					}
 				} else {
 					size_t newPosition;
 					for(const auto& entry : baseEntries) {
 						if(check_position(newPosition, entry, baseIndexDimensions.data(), baseIndexStepSizes.data(), attributes, fixedFlags, traceFlags, _base.indices.size())) {
-							outEntries[newPosition] += factor*entry.second;
+							outEntries.emplace_back_unsorted(newPosition, factor*entry.second);
 						}
 					}
 				}
+				outEntries.sort_and_sum_duplicates();
 				XERUS_PA_END("Evaluation", "Sparse->Sparse", misc::to_string(_base.tensorObjectReadOnly->dimensions)+" ==> " + misc::to_string(_out.tensorObjectReadOnly->dimensions));
 			}
 		}
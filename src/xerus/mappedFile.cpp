@@ -0,0 +1,327 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+/**
+ * @file
+ * @brief Implementation of the memory mapped binary storage of Tensors and TTNetworks.
+ */
+
+#include <xerus/mappedFile.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <xerus/misc/check.h>
+#include <xerus/misc/internal.h>
+
+namespace xerus { namespace misc {
+	
+	namespace {
+		constexpr const char containerMagic[8] = {'X', 'E', 'R', 'U', 'S', 'M', 'A', 'P'};
+		constexpr const uint64_t containerVersion = 1;
+		constexpr const uint64_t containerAlignment = 64;
+		
+		enum class ContainerType : uint64_t { Tensor = 0, TTTensor = 1, TTOperator = 2 };
+		
+		/// @brief The first 64 bytes of every container.
+		struct ContainerHeader {
+			char magic[8];
+			uint64_t version;
+			uint64_t type;
+			uint64_t numEntries;
+			uint64_t tableOffset;
+			uint64_t degree;
+			uint64_t canonicalized;
+			uint64_t corePosition;
+		};
+		static_assert(sizeof(ContainerHeader) == containerAlignment, "The container header must have a size of 64 bytes.");
+		
+		/// @brief The fixed part of an entry of the offset table, followed by @a degree dimensions.
+		struct EntryHeader {
+			uint64_t degree;
+			uint64_t representation; // 0 = dense, 1 = sparse
+			uint64_t dataOffset;
+			uint64_t numValues;
+			double factor;
+		};
+		static_assert(sizeof(EntryHeader) == 40, "Unexpected padding in the entry header.");
+		
+		typedef std::pair<size_t, value_t> SparseEntry;
+		static_assert(sizeof(SparseEntry) == 16 && std::is_standard_layout<SparseEntry>::value, "Sparse entries can not be stored as raw memory.");
+		
+		
+		uint64_t align(const uint64_t _offset) {
+			return (_offset + containerAlignment - 1) / containerAlignment * containerAlignment;
+		}
+		
+		
+		void write_container(const std::string& _filename, ContainerHeader _header, const std::vector<const Tensor*>& _entries) {
+			std::memcpy(_header.magic, containerMagic, sizeof(containerMagic));
+			_header.version = containerVersion;
+			_header.numEntries = _entries.size();
+			_header.tableOffset = sizeof(ContainerHeader);
+			
+			uint64_t offset = _header.tableOffset;
+			for (const Tensor* const entry : _entries) {
+				offset += sizeof(EntryHeader) + entry->degree()*sizeof(uint64_t);
+			}
+			
+			std::vector<EntryHeader> entryHeaders(_entries.size());
+			for (size_t e = 0; e < _entries.size(); ++e) {
+				const Tensor& tensor = *_entries[e];
+				offset = align(offset);
+				entryHeaders[e].degree = tensor.degree();
+				entryHeaders[e].representation = tensor.is_dense() ? 0 : 1;
+				entryHeaders[e].dataOffset = offset;
+				entryHeaders[e].numValues = tensor.is_dense() ? tensor.size : tensor.get_unsanitized_sparse_data().size();
+				entryHeaders[e].factor = tensor.factor;
+				offset += entryHeaders[e].numValues * (tensor.is_dense() ? sizeof(value_t) : sizeof(SparseEntry));
+			}
+			
+			// Existing mappings of the file must not see the new content (or a truncated file), so a new file is written and renamed.
+			// The temporary name is unique, such that concurrent writers of the same file do not write into each others temporary files.
+			static std::atomic<uint64_t> tmpCounter(0);
+			std::string tmpFilename;
+			int fd;
+			do {
+				tmpFilename = _filename + ".tmp." + std::to_string(getpid()) + "." + std::to_string(tmpCounter++);
+				fd = open(tmpFilename.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+			} while (fd < 0 && errno == EEXIST);
+			if (fd < 0) {
+				XERUS_THROW(generic_error() << "Unable to create " << tmpFilename << ": " << std::strerror(errno) << '\n');
+			}
+			close(fd);
+			
+			std::ofstream out(tmpFilename, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+			if (!out) {
+				XERUS_THROW(generic_error() << "Unable to open " << tmpFilename << " for writing.\n");
+			}
+			
+			out.write(reinterpret_cast<const char*>(&_header), sizeof(ContainerHeader));
+			for (size_t e = 0; e < _entries.size(); ++e) {
+				out.write(reinterpret_cast<const char*>(&entryHeaders[e]), sizeof(EntryHeader));
+				for (const size_t dim : _entries[e]->dimensions) {
+					const uint64_t dimension = dim;
+					out.write(reinterpret_cast<const char*>(&dimension), sizeof(uint64_t));
+				}
+			}
+			
+			static const char padding[containerAlignment] = {};
+			for (size_t e = 0; e < _entries.size(); ++e) {
+				const Tensor& tensor = *_entries[e];
+				out.write(padding, std::streamsize(entryHeaders[e].dataOffset - uint64_t(out.tellp())));
+				if (tensor.is_single_precision()) { // The container always stores double precision
+					const float* const singleData = tensor.get_unsanitized_single_data();
+					const std::vector<value_t> data(singleData, singleData+tensor.size);
+					out.write(reinterpret_cast<const char*>(data.data()), std::streamsize(tensor.size*sizeof(value_t)));
+				} else if (tensor.is_dense()) {
+					out.write(reinterpret_cast<const char*>(tensor.get_unsanitized_dense_data()), std::streamsize(tensor.size*sizeof(value_t)));
+				} else {
+					out.write(reinterpret_cast<const char*>(tensor.get_unsanitized_sparse_data().data()), std::streamsize(entryHeaders[e].numValues*sizeof(SparseEntry)));
+				}
+			}
+			
+			out.close();
+			if (!out) {
+				std::remove(tmpFilename.c_str());
+				XERUS_THROW(generic_error() << "Error while writing to " << tmpFilename << ".\n");
+			}
+			if (std::rename(tmpFilename.c_str(), _filename.c_str()) != 0) {
+				std::remove(tmpFilename.c_str());
+				XERUS_THROW(generic_error() << "Unable to replace " << _filename << ": " << std::strerror(errno) << '\n');
+			}
+		}
+		
+		
+		/// @brief A read only file mapped copy-on-write into memory, unmapped on destruction.
+		class MappedRegion {
+		public:
+			const char* address = nullptr;
+			size_t length = 0;
+			
+			explicit MappedRegion(const std::string& _filename) {
+				const int fd = open(_filename.c_str(), O_RDONLY);
+				if (fd < 0) {
+					XERUS_THROW(generic_error() << "Unable to open " << _filename << ": " << std::strerror(errno) << '\n');
+				}
+				
+				struct stat fileStatus;
+				if (fstat(fd, &fileStatus) != 0) {
+					close(fd);
+					XERUS_THROW(generic_error() << "Unable to stat " << _filename << ": " << std::strerror(errno) << '\n');
+				}
+				length = size_t(fileStatus.st_size);
+				if (length < sizeof(ContainerHeader)) {
+					close(fd);
+					XERUS_THROW(generic_error() << "The file " << _filename << " is too small to be a xerus container.\n");
+				}
+				
+				// Private writable mapping, such that Tensors can be modified in place without touching the file.
+				void* const mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+				close(fd);
+				if (mapping == MAP_FAILED) {
+					XERUS_THROW(generic_error() << "Unable to map " << _filename << ": " << std::strerror(errno) << '\n');
+				}
+				address = static_cast<const char*>(mapping);
+			}
+			
+			MappedRegion(const MappedRegion&) = delete;
+			MappedRegion& operator=(const MappedRegion&) = delete;
+			
+			~MappedRegion() {
+				munmap(const_cast<char*>(address), length);
+			}
+		};
+		
+		
+		std::vector<Tensor> read_container(const std::string& _filename, ContainerHeader& _header, const ContainerType _expectedType) {
+			const std::shared_ptr<MappedRegion> region = std::make_shared<MappedRegion>(_filename);
+			const char* const base = region->address;
+			
+			std::memcpy(&_header, base, sizeof(ContainerHeader));
+			REQUIRE(std::memcmp(_header.magic, containerMagic, sizeof(containerMagic)) == 0, "The file " << _filename << " is not a xerus container.");
+			REQUIRE(_header.version == containerVersion, "Unknown container version " << _header.version << " in file " << _filename);
+			REQUIRE(_header.type == uint64_t(_expectedType), "The file " << _filename << " contains a different type of object (" << _header.type << " instead of " << uint64_t(_expectedType) << ").");
+			
+			std::vector<Tensor> entries;
+			entries.reserve(_header.numEntries);
+			uint64_t tablePosition = _header.tableOffset;
+			for (size_t e = 0; e < _header.numEntries; ++e) {
+				REQUIRE(tablePosition + sizeof(EntryHeader) <= region->length, "Truncated offset table in file " << _filename);
+				EntryHeader entry;
+				std::memcpy(&entry, base+tablePosition, sizeof(EntryHeader));
+				tablePosition += sizeof(EntryHeader);
+				
+				REQUIRE(tablePosition + entry.degree*sizeof(uint64_t) <= region->length, "Truncated offset table in file " << _filename);
+				Tensor::DimensionTuple dimensions(entry.degree);
+				for (size_t i = 0; i < entry.degree; ++i) {
+					uint64_t dimension;
+					std::memcpy(&dimension, base+tablePosition, sizeof(uint64_t));
+					tablePosition += sizeof(uint64_t);
+					dimensions[i] = dimension;
+				}
+				
+				const size_t valueSize = entry.representation == 0 ? sizeof(value_t) : sizeof(SparseEntry);
+				REQUIRE(entry.dataOffset % containerAlignment == 0 && entry.dataOffset <= region->length && entry.numValues <= (region->length - entry.dataOffset)/valueSize, "Invalid data block of entry " << e << " in file " << _filename);
+				
+				if (entry.representation == 0) {
+					REQUIRE(entry.numValues == misc::product(dimensions), "Invalid number of values of entry " << e << " in file " << _filename);
+					
+					// The deleter keeps the mapping alive as long as the Tensor (or any copy sharing its data) uses it.
+					value_t* const data = reinterpret_cast<value_t*>(const_cast<char*>(base + entry.dataOffset));
+					entries.emplace_back(std::move(dimensions), std::shared_ptr<value_t>(data, [region](value_t*){}));
+				} else {
+					const SparseEntry* const data = reinterpret_cast<const SparseEntry*>(base + entry.dataOffset);
+					entries.emplace_back(std::move(dimensions), Tensor::Representation::Sparse);
+					const size_t size = entries.back().size;
+					REQUIRE(entry.numValues <= size, "The sparse entry " << e << " in file " << _filename << " has more entries (" << entry.numValues << ") than its size (" << size << ").");
+					
+					// The positions are used as they are, so they have to be strictly increasing and in range.
+					std::vector<SparseEntry> sparseEntries(data, data+entry.numValues);
+					for (size_t k = 0; k < sparseEntries.size(); ++k) {
+						REQUIRE(k == 0 || sparseEntries[k-1].first < sparseEntries[k].first, "Unsorted or duplicate position " << sparseEntries[k].first << " in sparse entry " << e << " of file " << _filename);
+						REQUIRE(sparseEntries[k].first < size, "Position " << sparseEntries[k].first << " out of range in sparse entry " << e << " of file " << _filename);
+					}
+					entries.back().get_unsanitized_sparse_data() = FlatMap<size_t, value_t>(std::move(sparseEntries));
+				}
+				entries.back().factor = entry.factor;
+			}
+			
+			return entries;
+		}
+	} // namespace
+	
+	
+	void save_to_mapped_file(const Tensor& _tensor, const std::string& _filename) {
+		ContainerHeader header {};
+		header.type = uint64_t(ContainerType::Tensor);
+		header.degree = _tensor.degree();
+		write_container(_filename, header, {&_tensor});
+	}
+	
+	
+	template<bool isOperator>
+	void save_to_mapped_file(const TTNetwork<isOperator>& _network, const std::string& _filename) {
+		static constexpr const size_t N = isOperator?2:1;
+		_network.require_correct_format();
+		
+		ContainerHeader header {};
+		header.type = uint64_t(isOperator ? ContainerType::TTOperator : ContainerType::TTTensor);
+		header.degree = _network.degree();
+		header.canonicalized = _network.canonicalized ? 1 : 0;
+		header.corePosition = _network.corePosition;
+		
+		std::vector<const Tensor*> components;
+		for (size_t c = 0; c < std::max(_network.degree()/N, size_t(1)); ++c) {
+			components.push_back(&_network.get_component(c));
+		}
+		write_container(_filename, header, components);
+	}
+	
+	template void save_to_mapped_file(const TTNetwork<false>& _network, const std::string& _filename);
+	template void save_to_mapped_file(const TTNetwork<true>& _network, const std::string& _filename);
+	
+	
+	void load_from_mapped_file(Tensor& _tensor, const std::string& _filename) {
+		ContainerHeader header;
+		std::vector<Tensor> entries = read_container(_filename, header, ContainerType::Tensor);
+		REQUIRE(entries.size() == 1, "A Tensor container must contain exactly one entry, " << _filename << " contains " << entries.size());
+		_tensor = std::move(entries.front());
+	}
+	
+	
+	template<bool isOperator>
+	void load_from_mapped_file(TTNetwork<isOperator>& _network, const std::string& _filename) {
+		static constexpr const size_t N = isOperator?2:1;
+		ContainerHeader header;
+		std::vector<Tensor> entries = read_container(_filename, header, isOperator ? ContainerType::TTOperator : ContainerType::TTTensor);
+		REQUIRE(header.degree % N == 0 && entries.size() == std::max(header.degree/N, uint64_t(1)), "Invalid number of components in file " << _filename);
+		
+		TTNetwork<isOperator> result(header.degree);
+		for (size_t c = 0; c < entries.size(); ++c) {
+			result.set_component(c, std::move(entries[c]));
+		}
+		
+		if (header.canonicalized != 0) {
+			result.assume_core_position(header.corePosition);
+		} else {
+			result.canonicalized = false;
+		}
+		result.require_correct_format();
+		
+		_network = std::move(result);
+	}
+	
+	template void load_from_mapped_file(TTNetwork<false>& _network, const std::string& _filename);
+	template void load_from_mapped_file(TTNetwork<true>& _network, const std::string& _filename);
+	
+}} // namespace xerus::misc
@@ -34,6 +34,7 @@
 #include <xerus/ttNetwork.h>
 #include <xerus/indexedTensor.h>
 #include <xerus/misc/internal.h>
+#include <xerus/misc/parallel.h>
  
 
 namespace xerus {
@@ -122,33 +123,57 @@ namespace xerus {
 		}
 	}
 	
-	void SinglePointMeasurementSet::measure(const TensorNetwork& _solution) {
-		REQUIRE(_solution.degree() == degree(), "Degrees of solution and measurements must match!");
-		std::vector<TensorNetwork> stack(degree()+1);
-		stack[0] = _solution;
-		stack[0].reduce_representation();
+	/// @brief Number of consecutive (sorted) positions that are evaluated by a single thread. Fixed, so that sums over the chunks do not depend on the number of threads.
+	constexpr size_t MEASUREMENT_CHUNK_SIZE = 4096;
+	
+	/**
+	 * @brief Evaluates the network @a _reducedSolution at the positions [_begin, _end) and calls @a _callback(j, value) for each of them.
+	 * @details The networks with the first i modes fixed are kept on a stack, so that only the part of the stack that differs from the previous position has to be rebuild.
+	 */
+	template<class callback_t>
+	static void evaluate_positions(const TensorNetwork& _reducedSolution, const std::vector<std::vector<size_t>>& _positions, const size_t _begin, const size_t _end, const callback_t& _callback) {
+		const size_t degree = _reducedSolution.degree();
+		std::vector<TensorNetwork> stack(degree+1);
+		stack[0] = _reducedSolution;
 		
-		const auto cSize = size();
-		for(size_t j = 0; j < cSize; ++j) {
+		for(size_t j = _begin; j < _end; ++j) {
 			size_t rebuildIndex = 0;
 			
-			if(j > 0) {
+			if(j > _begin) {
 				// Find the maximal recyclable stack position
-				for(; rebuildIndex < degree(); ++rebuildIndex) {
-					if(positions[j-1][rebuildIndex] != positions[j][rebuildIndex]) {
+				for(; rebuildIndex < degree; ++rebuildIndex) {
+					if(_positions[j-1][rebuildIndex] != _positions[j][rebuildIndex]) {
 						break;
 					}
 				}
 			}
 			
 			// Rebuild stack
-			for(size_t i = rebuildIndex; i < degree(); ++i) {
+			for(size_t i = rebuildIndex; i < degree; ++i) {
 				stack[i+1] = stack[i];
-				stack[i+1].fix_mode(0, positions[j][i]);
+				stack[i+1].fix_mode(0, _positions[j][i]);
 				stack[i+1].reduce_representation();
 			}
 			
-			measuredValues[j] = stack.back()[0];
+			_callback(j, stack.back()[0]);
+		}
+	}
+	
+	
+	void SinglePointMeasurementSet::measure(const TensorNetwork& _solution) {
+		REQUIRE(_solution.degree() == degree(), "Degrees of solution and measurements must match!");
+		TensorNetwork reducedSolution(_solution);
+		reducedSolution.reduce_representation();
+		
+		const size_t cSize = size();
+		const size_t numChunks = (cSize + MEASUREMENT_CHUNK_SIZE - 1)/MEASUREMENT_CHUNK_SIZE;
+		const size_t numThreads = misc::get_num_threads(numChunks*misc::minWorkPerThread);
+		
+		#pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+		for(size_t chunk = 0; chunk < numChunks; ++chunk) {
+			evaluate_positions(reducedSolution, positions, chunk*MEASUREMENT_CHUNK_SIZE, std::min(cSize, (chunk+1)*MEASUREMENT_CHUNK_SIZE), [&](const size_t _j, const value_t _value) {
+				measuredValues[_j] = _value;
+			});
 		}
 	}
 	
@@ -173,35 +198,28 @@ namespace xerus {
 	
 	
 	double SinglePointMeasurementSet::test(const TensorNetwork& _solution) const {
-		const auto cSize = size();
-		double error = 0.0, norm = 0.0;
-		
 		REQUIRE(_solution.degree() == degree(), "Degrees of solution and measurements must match!");
-		std::vector<TensorNetwork> stack(degree()+1);
-		stack[0] = _solution;
-		stack[0].reduce_representation();
+		TensorNetwork reducedSolution(_solution);
+		reducedSolution.reduce_representation();
 		
-		for(size_t j = 0; j < cSize; ++j) {
-			size_t rebuildIndex = 0;
-			
-			if(j > 0) {
-				// Find the maximal recyclable stack position
-				for(; rebuildIndex < degree(); ++rebuildIndex) {
-					if(positions[j-1][rebuildIndex] != positions[j][rebuildIndex]) {
-						break;
-					}
-				}
-			}
-			
-			// Rebuild stack
-			for(size_t i = rebuildIndex; i < degree(); ++i) {
-				stack[i+1] = stack[i];
-				stack[i+1].fix_mode(0, positions[j][i]);
-				stack[i+1].reduce_representation();
-			}
-			
-			error += misc::sqr(measuredValues[j] - stack.back()[0]);
-			norm += misc::sqr(measuredValues[j]);
+		const size_t cSize = size();
+		const size_t numChunks = (cSize + MEASUREMENT_CHUNK_SIZE - 1)/MEASUREMENT_CHUNK_SIZE;
+		const size_t numThreads = misc::get_num_threads(numChunks*misc::minWorkPerThread);
+		std::vector<double> chunkErrors(numChunks, 0.0), chunkNorms(numChunks, 0.0);
+		
+		#pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+		for(size_t chunk = 0; chunk < numChunks; ++chunk) {
+			evaluate_positions(reducedSolution, positions, chunk*MEASUREMENT_CHUNK_SIZE, std::min(cSize, (chunk+1)*MEASUREMENT_CHUNK_SIZE), [&](const size_t _j, const value_t _value) {
+				chunkErrors[chunk] += misc::sqr(measuredValues[_j] - _value);
+				chunkNorms[chunk] += misc::sqr(measuredValues[_j]);
+			});
+		}
+		
+		// Sum up in a fixed order to obtain deterministic results
+		double error = 0.0, norm = 0.0;
+		for(size_t chunk = 0; chunk < numChunks; ++chunk) {
+			error += chunkErrors[chunk];
+			norm += chunkNorms[chunk];
 		}
 		return std::sqrt(error/norm);
 	}
@@ -559,8 +577,8 @@ namespace xerus {
 			INTERNAL_CHECK(!_a.has_factor(), "IE");
 			INTERNAL_CHECK(!_b.has_factor(), "IE");
 			
-			const std::map<size_t, double>& dataA = _a.get_unsanitized_sparse_data();
-			const std::map<size_t, double>& dataB = _b.get_unsanitized_sparse_data();
+			const misc::FlatMap<size_t, double>& dataA = _a.get_unsanitized_sparse_data();
+			const misc::FlatMap<size_t, double>& dataB = _b.get_unsanitized_sparse_data();
 			
 			auto itrA = dataA.begin();
 			auto itrB = dataB.begin();
@@ -26,10 +26,17 @@
 #ifdef XERUS_REPLACE_ALLOCATOR
 
 	#include <xerus/misc/allocator.h>
+	#include <xerus/misc/memoryAccounting.h>
 	// #include <dlfcn.h>
 	#include <cstring>
+	#include <new>
+	#include <mutex>
+	#include <atomic>
+	#include <sys/mman.h>
+	#include <unistd.h>
 
 	using xma = xerus::misc::AllocatorStorage;
+	using xlp = xerus::misc::LargeBufferPool;
 	namespace xm = xerus::misc;
 
 	thread_local xerus::misc::AllocatorStorage xm::astore;
@@ -58,12 +65,157 @@
 		pools.emplace_back(newPool, startAddr);
 	}
 
+	size_t xm::largeBufferPoolCapacity = size_t(1) << 30;
+	bool xm::largeBufferPoolUseHugePages = false;
+	
+	namespace {
+		/// Free list of a single size class. The first bytes of every free buffer point to the next one.
+		struct SizeClassList {
+			std::mutex mutex;
+			uint8_t* head = nullptr;
+		};
+		
+		// NOTE all of these are constant initialized, so they can be used before (and after) any dynamic initialization
+		SizeClassList sizeClassLists[xlp::NUM_CLASSES];
+		std::atomic<size_t> poolHits{0}, poolMisses{0}, poolLiveBytes{0}, poolCachedBytes{0}, poolPeakBytes{0};
+		
+		size_t size_class(const size_t _n) {
+			const size_t octave = size_t(63 - __builtin_clzl(_n));
+			const size_t step = (size_t(1) << octave) / xlp::CLASSES_PER_OCTAVE;
+			const size_t sub = (_n - (size_t(1) << octave) + step - 1) / step;
+			return (octave - 20)*xlp::CLASSES_PER_OCTAVE + sub; // sub == CLASSES_PER_OCTAVE is the first class of the next octave
+		}
+		
+		size_t class_size(const size_t _class) {
+			const size_t octave = 20 + _class/xlp::CLASSES_PER_OCTAVE;
+			return (size_t(1) << octave) + (_class%xlp::CLASSES_PER_OCTAVE) * ((size_t(1) << octave) / xlp::CLASSES_PER_OCTAVE);
+		}
+		
+		void update_peak() {
+			const size_t current = poolLiveBytes + poolCachedBytes;
+			size_t peak = poolPeakBytes;
+			while (current > peak && !poolPeakBytes.compare_exchange_weak(peak, current)) { }
+		}
+		
+		/// The markers of a pooled buffer are stored in the page in front of it, such that the buffer itself can be aligned to huge pages.
+		size_t header_size() {
+			static const size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+			return pageSize;
+		}
+		
+		/// Maps a new buffer of @a _bytes bytes behind a header page, 2 MiB aligned if huge pages are requested.
+		uint8_t* map_buffer(const size_t _bytes) {
+			const size_t headerSize = header_size();
+			const size_t alignment = xm::largeBufferPoolUseHugePages ? xlp::HUGE_PAGE_SIZE : headerSize;
+			const size_t length = _bytes + alignment; // header page and at most alignment-headerSize bytes in front of the aligned buffer
+			uint8_t* const raw = static_cast<uint8_t*>(mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+			if (raw == MAP_FAILED) {
+				throw std::bad_alloc();
+			}
+			
+			// Return the unused memory in front of the header page and behind the buffer
+			uint8_t* const res = raw + headerSize + (alignment - reinterpret_cast<uintptr_t>(raw + headerSize)%alignment)%alignment;
+			if (res - headerSize > raw) {
+				munmap(raw, size_t(res - headerSize - raw));
+			}
+			if (res + _bytes < raw + length) {
+				munmap(res + _bytes, size_t((raw + length) - (res + _bytes)));
+			}
+			
+			#ifdef MADV_HUGEPAGE
+				if (xm::largeBufferPoolUseHugePages) {
+					madvise(res, _bytes, MADV_HUGEPAGE);
+				}
+			#endif
+			return res;
+		}
+		
+		void unmap_buffer(uint8_t* const _ptr, const size_t _bytes) {
+			munmap(static_cast<void*>(_ptr-header_size()), _bytes+header_size());
+		}
+		
+		void* pooled_alloc(const size_t _class) {
+			static_assert(xlp::SMALLEST_POOLED_SIZE == size_t(1) << 20, "size_class() assumes the smallest pooled size to be 2^20.");
+			const size_t bytes = class_size(_class);
+			SizeClassList& list = sizeClassLists[_class];
+			uint8_t* res = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(list.mutex);
+				if (list.head) {
+					res = list.head;
+					list.head = *reinterpret_cast<uint8_t**>(res);
+				}
+			}
+			
+			if (res) {
+				poolHits += 1;
+				poolCachedBytes -= bytes;
+			} else {
+				res = map_buffer(bytes);
+				// indicate pooled allocation and its size class
+				*(res-1) = 0xFE;
+				*(res-2) = static_cast<uint8_t>(_class);
+				poolMisses += 1;
+			}
+			poolLiveBytes += bytes;
+			update_peak();
+			xm::memoryAccounting::account_allocation(bytes);
+			return static_cast<void*>(res);
+		}
+		
+		void pooled_free(uint8_t* const _ptr) {
+			const size_t sizeClass = *(_ptr-2);
+			const size_t bytes = class_size(sizeClass);
+			poolLiveBytes -= bytes;
+			xm::memoryAccounting::account_deallocation(bytes);
+			
+			// Reserve the bytes before caching the buffer, such that concurrent frees can not exceed the capacity.
+			size_t cached = poolCachedBytes;
+			while (cached + bytes <= xm::largeBufferPoolCapacity) {
+				if (poolCachedBytes.compare_exchange_weak(cached, cached + bytes)) {
+					SizeClassList& list = sizeClassLists[sizeClass];
+					std::lock_guard<std::mutex> lock(list.mutex);
+					*reinterpret_cast<uint8_t**>(_ptr) = list.head;
+					list.head = _ptr;
+					return;
+				}
+			}
+			unmap_buffer(_ptr, bytes);
+		}
+	}
+	
+	xm::LargeBufferPoolStatistics xm::large_buffer_pool_statistics() {
+		return LargeBufferPoolStatistics{poolHits, poolMisses, poolLiveBytes, poolCachedBytes, poolPeakBytes};
+	}
+	
+	void xm::release_large_buffer_pool() {
+		for (size_t c = 0; c < xlp::NUM_CLASSES; ++c) {
+			const size_t bytes = class_size(c);
+			SizeClassList& list = sizeClassLists[c];
+			std::lock_guard<std::mutex> lock(list.mutex);
+			while (list.head) {
+				uint8_t* const buffer = list.head;
+				list.head = *reinterpret_cast<uint8_t**>(buffer);
+				unmap_buffer(buffer, bytes);
+				poolCachedBytes -= bytes;
+			}
+		}
+	}
+	
+
 	void *myalloc(size_t n) {
+		if (n >= xlp::SMALLEST_POOLED_SIZE) {
+			const size_t sizeClass = size_class(n);
+			if (sizeClass < xlp::NUM_CLASSES) {
+				return pooled_alloc(sizeClass);
+			}
+		}
+		
 		if (n >= xma::SMALLEST_NOT_CACHED_SIZE) {
-			void *res = xerus::misc::r_malloc(n+xma::ALIGNMENT+1);
+			void *res = xerus::misc::r_malloc(n+xma::LARGE_HEADER_SIZE+xma::ALIGNMENT);
 			
-			// res is increased by at least 2 bytes (as alignmentOffset < xma::ALIGNMENT)
-			res = static_cast<void*>(static_cast<uint8_t*>(res)+xma::ALIGNMENT+1);
+			// res is increased by at least LARGE_HEADER_SIZE+1 bytes (as alignmentOffset < xma::ALIGNMENT)
+			res = static_cast<void*>(static_cast<uint8_t*>(res)+xma::LARGE_HEADER_SIZE+xma::ALIGNMENT);
 			uintptr_t alignmentOffset = reinterpret_cast<uintptr_t>(res)%xma::ALIGNMENT;
 			res = static_cast<void*>(static_cast<uint8_t*>(res) - alignmentOffset);
 			
@@ -71,6 +223,9 @@
 			*(static_cast<uint8_t*>(res)-1) = 0xFF;
 			// and the alignmentOffset to be able to reconstruct the original res pointer
 			*(static_cast<uint8_t*>(res)-2) = static_cast<uint8_t>(alignmentOffset);
+			// and the size for the memory accounting
+			std::memcpy(static_cast<uint8_t*>(res)-xma::LARGE_HEADER_SIZE, &n, sizeof(size_t));
+			xm::memoryAccounting::account_allocation(n);
 			return res;
 		} else {
 			uint8_t numBucket = uint8_t( (n+1)/xma::BUCKET_SIZE );
@@ -86,6 +241,7 @@
 				res = xm::astore.buckets[numBucket].back();
 				xm::astore.buckets[numBucket].pop_back();
 			}
+			xm::memoryAccounting::account_allocation((numBucket+1)*xma::BUCKET_SIZE);
 			#ifdef XERUS_PERFORMANCE_ANALYSIS
 				xm::astore.allocCount[numBucket] += 1;
 				xm::astore.currAlloc[numBucket] += 1;
@@ -140,7 +296,10 @@
 
 	void mydelete(void *ptr) noexcept {
 		uint8_t n = *(static_cast<uint8_t*>(ptr)-1);
-		if (n<0xFF) {
+		if (n == 0xFE) {
+			pooled_free(static_cast<uint8_t*>(ptr));
+		} else if (n<0xFF) {
+			xm::memoryAccounting::account_deallocation((n+1)*xma::BUCKET_SIZE);
 			#ifdef XERUS_PERFORMANCE_ANALYSIS
 				xm::astore.currAlloc[n] -= 1;
 			#endif
@@ -149,7 +308,10 @@
 			}
 		} else {
 			uint8_t offset = *(static_cast<uint8_t*>(ptr)-2);
-			xerus::misc::r_free(static_cast<void*>(static_cast<uint8_t*>(ptr)-xma::ALIGNMENT-1+offset));
+			size_t size;
+			std::memcpy(&size, static_cast<uint8_t*>(ptr)-xma::LARGE_HEADER_SIZE, sizeof(size_t));
+			xm::memoryAccounting::account_deallocation(size);
+			xerus::misc::r_free(static_cast<void*>(static_cast<uint8_t*>(ptr)-xma::LARGE_HEADER_SIZE-xma::ALIGNMENT+offset));
 		}
 	}
 
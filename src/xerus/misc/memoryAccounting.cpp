@@ -0,0 +1,299 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+/**
+ * @file
+ * @brief Implementation of the runtime memory accounting.
+ */
+
+#include <xerus/misc/memoryAccounting.h>
+#include <xerus/misc/check.h>
+#include <xerus/misc/internal.h>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace xerus {
+	namespace misc {
+		namespace memoryAccounting {
+			namespace {
+				// NOTE all of these are constant initialized, so the new operator can use them before (and after) any dynamic initialization
+				std::atomic<int64_t> currentBytes{0};
+				std::atomic<size_t> peakBytes{0}, phasePeakBytes{0};
+				std::atomic<size_t> retiredAllocatedBytes{0}, retiredAllocations{0}, retiredDeallocations{0}; // counters of terminated threads
+				
+				/// Changes of the allocated bytes are collected per thread until they exceed this size, then they are added to currentBytes.
+				constexpr const int64_t flushThreshold = 64*1024;
+				
+				void update_maximum(std::atomic<size_t>& _maximum, const size_t _value) {
+					size_t old = _maximum.load(std::memory_order_relaxed);
+					while (_value > old && !_maximum.compare_exchange_weak(old, _value, std::memory_order_relaxed)) { }
+				}
+				
+				/// The counters of a single thread. They are only written by their thread and merged by get_statistics().
+				struct ThreadCounters {
+					std::atomic<size_t> allocatedBytes{0}, allocations{0}, deallocations{0};
+					std::atomic<int64_t> pendingBytes{0}; // not yet added to currentBytes
+					ThreadCounters* next = nullptr;
+					
+					ThreadCounters();
+					~ThreadCounters();
+				};
+				
+				std::mutex threadListMutex;
+				ThreadCounters* threadList = nullptr;
+				
+				#ifdef XERUS_REPLACE_ALLOCATOR
+				thread_local bool threadCountersDestroyed = false;
+				
+				/// Adds @a _delta to the global number of allocated bytes and updates the peaks.
+				void flush(const int64_t _delta) {
+					const int64_t current = currentBytes.fetch_add(_delta, std::memory_order_relaxed) + _delta;
+					if (_delta > 0 && current > 0) {
+						update_maximum(peakBytes, size_t(current));
+						update_maximum(phasePeakBytes, size_t(current));
+					}
+				}
+				
+				/// Increments a counter that is only written by a single thread, i.e. without an atomic read-modify-write.
+				void add_local(std::atomic<size_t>& _counter, const size_t _value) {
+					_counter.store(_counter.load(std::memory_order_relaxed) + _value, std::memory_order_relaxed);
+				}
+				
+				ThreadCounters::ThreadCounters() {
+					std::lock_guard<std::mutex> lock(threadListMutex);
+					next = threadList;
+					threadList = this;
+				}
+				
+				ThreadCounters::~ThreadCounters() {
+					std::lock_guard<std::mutex> lock(threadListMutex);
+					ThreadCounters** link = &threadList;
+					while (*link != this) { link = &(*link)->next; }
+					*link = next;
+					retiredAllocatedBytes += allocatedBytes;
+					retiredAllocations += allocations;
+					retiredDeallocations += deallocations;
+					flush(pendingBytes);
+					threadCountersDestroyed = true;
+				}
+				
+				thread_local ThreadCounters threadCounters;
+				#endif
+				
+				/// The counters of all threads, summed up.
+				struct Totals {
+					size_t currentBytes;
+					size_t allocatedBytes;
+					size_t allocations;
+					size_t deallocations;
+				};
+				
+				Totals get_totals() {
+					std::lock_guard<std::mutex> lock(threadListMutex);
+					int64_t current = currentBytes.load(std::memory_order_relaxed);
+					Totals totals{0, retiredAllocatedBytes.load(), retiredAllocations.load(), retiredDeallocations.load()};
+					for (const ThreadCounters* counters = threadList; counters; counters = counters->next) {
+						current += counters->pendingBytes.load(std::memory_order_relaxed);
+						totals.allocatedBytes += counters->allocatedBytes.load(std::memory_order_relaxed);
+						totals.allocations += counters->allocations.load(std::memory_order_relaxed);
+						totals.deallocations += counters->deallocations.load(std::memory_order_relaxed);
+					}
+					totals.currentBytes = current > 0 ? size_t(current) : 0;
+					return totals;
+				}
+				
+				struct OpenPhase {
+					std::string name;
+					size_t startBytes;
+					size_t startAllocatedBytes;
+					size_t startAllocations;
+					size_t enclosingPeakBytes;
+				};
+				
+				struct PhaseRegistry {
+					std::mutex mutex;
+					std::vector<OpenPhase> open;
+					std::vector<PhaseStatistics> completed;
+				};
+				
+				PhaseRegistry& phase_registry() {
+					static PhaseRegistry registry;
+					return registry;
+				}
+				
+				std::string format_bytes(const size_t _bytes) {
+					std::stringstream stream;
+					stream << std::fixed << std::setprecision(1);
+					if (_bytes >= (size_t(1) << 30)) {
+						stream << double(_bytes)/double(size_t(1) << 30) << " GiB";
+					} else if (_bytes >= (size_t(1) << 20)) {
+						stream << double(_bytes)/double(size_t(1) << 20) << " MiB";
+					} else if (_bytes >= (size_t(1) << 10)) {
+						stream << double(_bytes)/double(size_t(1) << 10) << " KiB";
+					} else {
+						stream << _bytes << " B";
+					}
+					return stream.str();
+				}
+			}
+			
+			
+			#ifdef XERUS_REPLACE_ALLOCATOR
+				void account_allocation(const size_t _bytes) noexcept {
+					if (threadCountersDestroyed) {
+						retiredAllocatedBytes.fetch_add(_bytes, std::memory_order_relaxed);
+						retiredAllocations.fetch_add(1, std::memory_order_relaxed);
+						flush(int64_t(_bytes));
+						return;
+					}
+					ThreadCounters& counters = threadCounters;
+					add_local(counters.allocatedBytes, _bytes);
+					add_local(counters.allocations, 1);
+					const int64_t pending = counters.pendingBytes.load(std::memory_order_relaxed) + int64_t(_bytes);
+					if (pending >= flushThreshold) {
+						flush(pending);
+						counters.pendingBytes.store(0, std::memory_order_relaxed);
+					} else {
+						counters.pendingBytes.store(pending, std::memory_order_relaxed);
+					}
+				}
+				
+				void account_deallocation(const size_t _bytes) noexcept {
+					if (threadCountersDestroyed) {
+						retiredDeallocations.fetch_add(1, std::memory_order_relaxed);
+						flush(-int64_t(_bytes));
+						return;
+					}
+					ThreadCounters& counters = threadCounters;
+					add_local(counters.deallocations, 1);
+					const int64_t pending = counters.pendingBytes.load(std::memory_order_relaxed) - int64_t(_bytes);
+					if (pending <= -flushThreshold) {
+						flush(pending);
+						counters.pendingBytes.store(0, std::memory_order_relaxed);
+					} else {
+						counters.pendingBytes.store(pending, std::memory_order_relaxed);
+					}
+				}
+				
+				bool is_available() { return true; }
+			#else
+				bool is_available() { return false; }
+			#endif
+			
+			
+			MemoryStatistics get_statistics() {
+				const Totals totals = get_totals();
+				return MemoryStatistics{totals.currentBytes, std::max(peakBytes.load(), totals.currentBytes), totals.allocations, totals.deallocations};
+			}
+			
+			
+			void reset_peak() {
+				peakBytes = get_totals().currentBytes;
+			}
+			
+			
+			void begin_phase(const std::string& _name) {
+				PhaseRegistry& registry = phase_registry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				const Totals totals = get_totals();
+				std::string name = registry.open.empty() ? _name : registry.open.back().name + " / " + _name;
+				registry.open.push_back(OpenPhase{std::move(name), totals.currentBytes, totals.allocatedBytes, totals.allocations, phasePeakBytes.exchange(totals.currentBytes)});
+				// The push_back itself may have allocated
+				update_maximum(phasePeakBytes, get_totals().currentBytes);
+			}
+			
+			
+			/// Records the statistics of the innermost open phase and closes it. Returns false if there is no open phase.
+			static bool close_innermost_phase() {
+				PhaseRegistry& registry = phase_registry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				if (registry.open.empty()) { return false; }
+				OpenPhase& phase = registry.open.back();
+				const Totals totals = get_totals();
+				const size_t peak = std::max(phasePeakBytes.load(), totals.currentBytes);
+				registry.completed.push_back(PhaseStatistics{
+					phase.name,
+					registry.open.size()-1,
+					phase.startBytes,
+					totals.currentBytes,
+					peak,
+					totals.allocatedBytes - phase.startAllocatedBytes,
+					totals.allocations - phase.startAllocations
+				});
+				// The peak of the enclosing phase includes the peak of this one
+				phasePeakBytes = std::max(phase.enclosingPeakBytes, peak);
+				registry.open.pop_back();
+				return true;
+			}
+			
+			
+			void end_phase() {
+				const bool closed = close_innermost_phase();
+				REQUIRE(closed, "end_phase() called without an open phase.");
+			}
+			
+			
+			void end_scoped_phase() noexcept {
+				try {
+					if (!close_innermost_phase()) {
+						LOG(warning, "The phase of a ScopedPhase was already ended.");
+					}
+				} catch (...) {
+					// Destructors must not throw, the statistics of this phase are lost.
+				}
+			}
+			
+			
+			std::vector<PhaseStatistics> get_phases() {
+				PhaseRegistry& registry = phase_registry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				return registry.completed;
+			}
+			
+			
+			void clear_phases() {
+				PhaseRegistry& registry = phase_registry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				registry.completed.clear();
+			}
+			
+			
+			std::string get_report() {
+				if (!is_available()) {
+					return "XERUS_REPLACE_ALLOCATOR must be set to obtain a memory report.";
+				}
+				
+				const MemoryStatistics stats = get_statistics();
+				std::stringstream stream;
+				stream << "| Memory: " << format_bytes(stats.currentBytes) << " in use, peak " << format_bytes(stats.peakBytes) 
+					<< ", " << stats.allocations << " allocations, " << stats.deallocations << " deallocations." << std::endl;
+				for (const PhaseStatistics& phase : get_phases()) {
+					stream << "| " << std::string(2*phase.depth, ' ') << phase.name << ": peak " << format_bytes(phase.peakBytes) 
+						<< " (" << format_bytes(phase.startBytes) << " -> " << format_bytes(phase.endBytes) << "), " 
+						<< format_bytes(phase.allocatedBytes) << " in " << phase.allocations << " allocations" << std::endl;
+				}
+				return stream.str();
+			}
+		} // namespace memoryAccounting
+	} // namespace misc
+} // namespace xerus
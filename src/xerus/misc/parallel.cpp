@@ -0,0 +1,49 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+ * @file
+ * @brief Implementation of the settings of the multithreaded kernels of xerus.
+ */
+
+#include <xerus/misc/parallel.h>
+#include <algorithm>
+
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+namespace xerus {
+	namespace misc {
+		size_t maxThreads = 0;
+		
+		size_t minWorkPerThread = size_t(1) << 15;
+		
+		size_t get_num_threads(const size_t _work) {
+			#ifdef _OPENMP
+				if(omp_in_parallel()) { return 1; }
+				const size_t available = maxThreads > 0 ? maxThreads : size_t(omp_get_max_threads());
+				return std::max(size_t(1), std::min(available, _work/std::max(minWorkPerThread, size_t(1))));
+			#else
+				(void)_work;
+				return 1;
+			#endif
+		}
+	} // namespace misc
+} // namespace xerus
@@ -102,6 +102,9 @@ void expose_leastSquaresAlgorithms() {
 			.def_readwrite("useResidualForEndCriterion", &ALSVariant::useResidualForEndCriterion)
 			.def_readwrite("preserveCorePosition", &ALSVariant::preserveCorePosition)
 			.def_readwrite("assumeSPD", &ALSVariant::assumeSPD)
+			.def_readwrite("localSolverMaxIterations", &ALSVariant::localSolverMaxIterations)
+			.def_readwrite("localSolverEpsilon", &ALSVariant::localSolverEpsilon)
+			.def_readwrite("localSolverPreconditioning", &ALSVariant::localSolverPreconditioning)
 			.add_property("localSolver", 
 						  +[](ALSVariant &_this){ return _this.localSolver; },
 						  +[](ALSVariant &_this, ALSVariant::LocalSolver _s){ _this.localSolver = _s; })
@@ -129,10 +132,21 @@ void expose_leastSquaresAlgorithms() {
 			.def("__call__", +[](ALSVariant &_this, TTTensor &_x, const TTTensor &_b, size_t _numHalfSweeps, PerformanceData &_pd) {
 				_this(_x, _b, _numHalfSweeps, _pd);
 			}, (arg("x"), arg("b"), arg("numHalfSweeps"), arg("perfData")=NoPerfData) )
+			
+			// block mode, the eigenvectors are returned together with the eigenvalues as python lists cannot be modified in place
+			.def("eigen", +[](ALSVariant &_this, const TTOperator &_A, std::vector<TTTensor> _x, PerformanceData &_pd) {
+				const std::vector<value_t> lambda = _this.eigen(_A, _x, _pd);
+				return boost::python::make_tuple(lambda, _x);
+			}, (arg("A"), arg("x"), arg("perfData")=NoPerfData) )
+			
+			.def("eigen", +[](ALSVariant &_this, const TTOperator &_A, TTTensor &_x, PerformanceData &_pd) {
+				return _this.eigen(_A, _x, _pd);
+			}, (arg("A"), arg("x"), arg("perfData")=NoPerfData) )
 		;
 		class_<ALSVariant::LocalSolver>("LocalSolver", boost::python::no_init);
 		als_scope.attr("lapack_solver") = object(ALSVariant::LocalSolver(&ALSVariant::lapack_solver));
 		als_scope.attr("ASD_solver") = object(ALSVariant::LocalSolver(&ALSVariant::ASD_solver));
+		als_scope.attr("cg_solver") = object(ALSVariant::LocalSolver(&ALSVariant::cg_solver));
 	}
 	scope().attr("ALS") = object(ptr(&ALS));
 	scope().attr("ALS_SPD") = object(ptr(&ALS_SPD));
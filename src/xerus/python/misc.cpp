@@ -41,6 +41,12 @@ void variable_argument_member_to_tuple_wrapper(const std::string &_name, const s
 
 using namespace internal;
 
+/// @brief Name of a memory accounting phase that is opened and closed by a python with statement.
+struct MemoryPhaseScope {
+	std::string name;
+	MemoryPhaseScope(const std::string &_name) : name(_name) {}
+};
+
 void expose_misc() {
 	def("frob_norm", +[](const Tensor& _x){ return _x.frob_norm(); });
 	def("frob_norm", +[](const TensorNetwork& _x){ return _x.frob_norm(); });
@@ -115,6 +121,67 @@ void expose_misc() {
 		return object();
 	});
 	
+	def("save_to_mapped_file", +[](const Tensor &_obj, const std::string &_filename){
+		misc::save_to_mapped_file(_obj, _filename);
+	}, (arg("object"), arg("filename")) );
+	
+	def("save_to_mapped_file", +[](const TTTensor &_obj, const std::string &_filename){
+		misc::save_to_mapped_file(_obj, _filename);
+	}, (arg("object"), arg("filename")) );
+	
+	def("save_to_mapped_file", +[](const TTOperator &_obj, const std::string &_filename){
+		misc::save_to_mapped_file(_obj, _filename);
+	}, (arg("object"), arg("filename")) );
+	
+	def("load_tensor_from_mapped_file", +[](const std::string &_filename){
+		return misc::load_from_mapped_file<Tensor>(_filename);
+	}, arg("filename"));
+	
+	def("load_tttensor_from_mapped_file", +[](const std::string &_filename){
+		return misc::load_from_mapped_file<TTTensor>(_filename);
+	}, arg("filename"));
+	
+	def("load_ttoperator_from_mapped_file", +[](const std::string &_filename){
+		return misc::load_from_mapped_file<TTOperator>(_filename);
+	}, arg("filename"));
+	
+	class_<misc::memoryAccounting::MemoryStatistics>("MemoryStatistics", no_init)
+		.def_readonly("currentBytes", &misc::memoryAccounting::MemoryStatistics::currentBytes)
+		.def_readonly("peakBytes", &misc::memoryAccounting::MemoryStatistics::peakBytes)
+		.def_readonly("allocations", &misc::memoryAccounting::MemoryStatistics::allocations)
+		.def_readonly("deallocations", &misc::memoryAccounting::MemoryStatistics::deallocations)
+	;
+	class_<misc::memoryAccounting::PhaseStatistics>("MemoryPhaseStatistics", no_init)
+		.add_property("name", +[](const misc::memoryAccounting::PhaseStatistics &_this){ return _this.name; })
+		.def_readonly("depth", &misc::memoryAccounting::PhaseStatistics::depth)
+		.def_readonly("startBytes", &misc::memoryAccounting::PhaseStatistics::startBytes)
+		.def_readonly("endBytes", &misc::memoryAccounting::PhaseStatistics::endBytes)
+		.def_readonly("peakBytes", &misc::memoryAccounting::PhaseStatistics::peakBytes)
+		.def_readonly("allocatedBytes", &misc::memoryAccounting::PhaseStatistics::allocatedBytes)
+		.def_readonly("allocations", &misc::memoryAccounting::PhaseStatistics::allocations)
+	;
+	VECTOR_TO_PY(misc::memoryAccounting::PhaseStatistics, "MemoryPhaseStatisticsVector");
+	
+	def("memory_accounting_available", &misc::memoryAccounting::is_available);
+	def("memory_statistics", &misc::memoryAccounting::get_statistics);
+	def("reset_memory_peak", &misc::memoryAccounting::reset_peak);
+	def("begin_memory_phase", &misc::memoryAccounting::begin_phase, arg("name"));
+	def("end_memory_phase", &misc::memoryAccounting::end_phase);
+	def("memory_phases", &misc::memoryAccounting::get_phases);
+	def("clear_memory_phases", &misc::memoryAccounting::clear_phases);
+	def("memory_report", &misc::memoryAccounting::get_report);
+	
+	// context manager, i.e. "with xerus.memory_phase('ALS sweep 3'): ..."
+	class_<MemoryPhaseScope>("memory_phase", init<std::string>())
+		.def("__enter__", +[](const MemoryPhaseScope &_this){
+			misc::memoryAccounting::begin_phase(_this.name);
+		})
+		.def("__exit__", +[](const MemoryPhaseScope &/*_this*/, object /*_type*/, object /*_value*/, object /*_traceback*/){
+			misc::memoryAccounting::end_phase();
+			return false;
+		})
+	;
+	
 	// identity returns the cpp name to a python object
 // 	def("identity", identity_);
 	
@@ -28,6 +28,12 @@
 void expose_ttnetwork() {
 	VECTOR_TO_PY(TTTensor, "TTTensorVector");
 	VECTOR_TO_PY(TTOperator, "TTOperatorVector");
+	VECTOR_TO_PY(std::vector<size_t>, "IntegerVectorVector");
+	
+	enum_<RoundingMode>("RoundingMode")
+		.value("Sweep", RoundingMode::Sweep)
+		.value("Gram", RoundingMode::Gram)
+	;
 	
 	class_<TTTensor, bases<TensorNetwork>>("TTTensor")
 		.def(init<const Tensor&, optional<value_t, size_t>>())
@@ -55,6 +61,7 @@ void expose_ttnetwork() {
 		.def("reduce_to_maximal_ranks", &TTTensor::reduce_to_maximal_ranks).staticmethod("reduce_to_maximal_ranks")
 // 		.def("degrees_of_freedom", static_cast<size_t (TTTensor::*)()>(&TTTensor::degrees_of_freedom))
 		.def("degrees_of_freedom", static_cast<size_t (*)(const std::vector<size_t>&, const std::vector<size_t>&)>(&TTTensor::degrees_of_freedom)).staticmethod("degrees_of_freedom")
+		.def("evaluate_batch", &TTTensor::evaluate_batch, arg("positions"))
 		.def("chop", 
 			+[](TTTensor &_this, size_t _pos) {
 				const auto result = _this.chop(_pos);
@@ -65,6 +72,9 @@ void expose_ttnetwork() {
 // 			(arg("ranks"), arg("epsilon")=EPSILON)
 // 		)
 		.def("round", static_cast<void (TTTensor::*)(double)>(&TTTensor::round))
+		.def("round", static_cast<void (TTTensor::*)(const std::vector<size_t>&, double, RoundingMode)>(&TTTensor::round),
+			(arg("ranks"), arg("epsilon"), arg("mode"))
+		)
 // 		.def("round", static_cast<void (TTTensor::*)(size_t)>(&TTTensor::round))
 		
 		.def("soft_threshold", static_cast<void (TTTensor::*)(const double, const bool)>(&TTTensor::soft_threshold),
@@ -91,6 +101,8 @@ void expose_ttnetwork() {
 	;
 	
 	def("entrywise_product", static_cast<TTTensor (*)(const TTTensor&, const TTTensor&)>(&entrywise_product));
+	def("entrywise_product", static_cast<TTTensor (*)(const TTTensor&, const TTTensor&, const std::vector<size_t>&, double)>(&entrywise_product),
+		(arg("A"), arg("B"), arg("ranks"), arg("epsilon")=EPSILON));
 	def("find_largest_entry", static_cast<size_t (*)(const TTTensor&, value_t, value_t)>(&find_largest_entry));
 	def("dyadic_product", static_cast<TTTensor (*)(const std::vector<TTTensor> &)>(&dyadic_product));
 	
@@ -120,6 +132,7 @@ void expose_ttnetwork() {
 		.def("reduce_to_maximal_ranks", &TTOperator::reduce_to_maximal_ranks).staticmethod("reduce_to_maximal_ranks")
 // 		.def("degrees_of_freedom", static_cast<size_t (TTOperator::*)()>(&TTOperator::degrees_of_freedom))
 		.def("degrees_of_freedom", static_cast<size_t (*)(const std::vector<size_t>&, const std::vector<size_t>&)>(&TTOperator::degrees_of_freedom)).staticmethod("degrees_of_freedom")
+		.def("evaluate_batch", &TTOperator::evaluate_batch, arg("positions"))
 		.def("chop", 
 			+[](TTOperator &_this, size_t _pos) {
 				const auto result = _this.chop(_pos);
@@ -130,6 +143,9 @@ void expose_ttnetwork() {
 			(arg("ranks"), arg("epsilon")=EPSILON)
 		)
 		.def("round", static_cast<void (TTOperator::*)(double)>(&TTOperator::round))
+		.def("round", static_cast<void (TTOperator::*)(const std::vector<size_t>&, double, RoundingMode)>(&TTOperator::round),
+			(arg("ranks"), arg("epsilon"), arg("mode"))
+		)
 		.def("round", static_cast<void (TTOperator::*)(size_t)>(&TTOperator::round))
 		
 		.def("soft_threshold", static_cast<void (TTOperator::*)(const double, const bool)>(&TTOperator::soft_threshold),
@@ -160,6 +176,16 @@ void expose_ttnetwork() {
 		.def("transpose", &TTOperator::transpose<>)
 	;
 	def("entrywise_product", static_cast<TTOperator (*)(const TTOperator&, const TTOperator&)>(&entrywise_product));
+	def("entrywise_product", static_cast<TTOperator (*)(const TTOperator&, const TTOperator&, const std::vector<size_t>&, double)>(&entrywise_product),
+		(arg("A"), arg("B"), arg("ranks"), arg("epsilon")=EPSILON));
 	def("find_largest_entry", static_cast<size_t (*)(const TTOperator&, value_t, value_t)>(&find_largest_entry));
 	def("dyadic_product", static_cast<TTOperator (*)(const std::vector<TTOperator> &)>(&dyadic_product));
+	
+	class_<TTSumAccumulator>("TTSumAccumulator", init<std::vector<size_t>, std::vector<size_t>, optional<double, RoundingMode>>())
+		.def(init<std::vector<size_t>, size_t, optional<double, RoundingMode>>())
+		.def("add", &TTSumAccumulator::add, (arg("x"), arg("weight")=1.0))
+		.def("sum", &TTSumAccumulator::sum)
+		.def("count", &TTSumAccumulator::count)
+		.def("clear", &TTSumAccumulator::clear)
+	;
 }
@@ -32,7 +32,8 @@
 
 namespace xerus {
     
-    XERUS_force_inline void transpose(double* const __restrict _out, const double* const __restrict _in, const size_t _leftDim, const size_t _rightDim) {
+    template<class T>
+    XERUS_force_inline void transpose(T* const __restrict _out, const T* const __restrict _in, const size_t _leftDim, const size_t _rightDim) {
         for(size_t i = 0; i < _leftDim; ++i) {
             for(size_t j = 0; j < _rightDim; ++j) {
                 _out[j*_leftDim+i] = _in[i*_rightDim+j];
@@ -40,37 +41,41 @@ namespace xerus {
         }
     }
     
-    XERUS_force_inline std::unique_ptr<double[]> transpose(const double* const _A, const size_t _leftDim, const size_t _rightDim) {
-        std::unique_ptr<double[]> AT(new double[_leftDim*_rightDim]);
+    template<class T>
+    XERUS_force_inline std::unique_ptr<T[]> transpose(const T* const _A, const size_t _leftDim, const size_t _rightDim) {
+        std::unique_ptr<T[]> AT(new T[_leftDim*_rightDim]);
         transpose(AT.get(), _A, _leftDim, _rightDim);
         return AT;
     }
     
     
-    XERUS_force_inline void transpose(std::map<size_t, double>& __restrict _out, const std::map<size_t, double>& __restrict _in, const size_t _leftDim, const size_t _rightDim) {
+    XERUS_force_inline void transpose(misc::FlatMap<size_t, double>& __restrict _out, const misc::FlatMap<size_t, double>& __restrict _in, const size_t _leftDim, const size_t _rightDim) {
         for(const auto& entry : _in) {
             const size_t i = entry.first/_rightDim;
             const size_t j = entry.first%_rightDim;
-            _out.emplace(j*_leftDim + i, entry.second);
+            _out.emplace_back_unsorted(j*_leftDim + i, entry.second);
         }
+        _out.sort_and_sum_duplicates();
     }
     
-    XERUS_force_inline std::map<size_t, double> transpose(const std::map<size_t, double>& _A, const size_t _leftDim, const size_t _rightDim) {
-        std::map<size_t, double> AT;
+    XERUS_force_inline misc::FlatMap<size_t, double> transpose(const misc::FlatMap<size_t, double>& _A, const size_t _leftDim, const size_t _rightDim) {
+        misc::FlatMap<size_t, double> AT;
         transpose(AT, _A, _leftDim, _rightDim);
         return AT;
     }
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - Mix to Full - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
     
-    void matrix_matrix_product( double* const _C,
+    // The dense factor and the result are either both double or both single precision, the sparse factor is always double.
+    template<class T>
+    void sparse_times_full( T* const _C,
                                 const size_t _leftDim,
                                 const size_t _rightDim,
                                 const double _alpha,
-                                const std::map<size_t, double>& _A,
+                                const misc::FlatMap<size_t, double>& _A,
                                 const bool _transposeA,
                                 const size_t _midDim,
-                                const double* const _B) {
+                                const T* const _B) {
 		XERUS_PA_START;
 		
         // Prepare output array
@@ -81,59 +86,109 @@ namespace xerus {
             for(const auto& entry : _A) {
                 const size_t i = entry.first/_midDim;
                 const size_t j = entry.first%_midDim;
-                misc::add_scaled(_C+i*_rightDim, _alpha*entry.second, _B+j*_rightDim, _rightDim);
+                misc::add_scaled(_C+i*_rightDim, static_cast<T>(_alpha*entry.second), _B+j*_rightDim, _rightDim);
             }
         } else {
             for(const auto& entry : _A) {
                 const size_t i = entry.first%_leftDim;
                 const size_t j = entry.first/_leftDim;
-                misc::add_scaled(_C+i*_rightDim, _alpha*entry.second, _B+j*_rightDim, _rightDim);
+                misc::add_scaled(_C+i*_rightDim, static_cast<T>(_alpha*entry.second), _B+j*_rightDim, _rightDim);
             }
         }
         
 		XERUS_PA_END("Mixed BLAS", "Matrix-Matrix-Multiplication ==> Full", misc::to_string(_leftDim)+"x"+misc::to_string(_midDim)+" * "+misc::to_string(_midDim)+"x"+misc::to_string(_rightDim));
     }
     
-    void matrix_matrix_product( double* const _C,
+    template<class T>
+    void sparse_times_full( T* const _C,
                                 const size_t _leftDim,
                                 const size_t _rightDim,
                                 const double _alpha,
-                                const std::map<size_t, double>& _A,
+                                const misc::FlatMap<size_t, double>& _A,
                                 const bool _transposeA,
                                 const size_t _midDim,
-                                const double* const _B,
+                                const T* const _B,
                                 const bool _transposeB) {
         if(_transposeB) {
-            const std::unique_ptr<double[]> BT = transpose(_B, _rightDim, _midDim);
-            matrix_matrix_product(_C, _leftDim, _rightDim, _alpha, _A, _transposeA, _midDim, BT.get());
+            const std::unique_ptr<T[]> BT = transpose(_B, _rightDim, _midDim);
+            sparse_times_full(_C, _leftDim, _rightDim, _alpha, _A, _transposeA, _midDim, BT.get());
         } else {
-            matrix_matrix_product(_C, _leftDim, _rightDim, _alpha, _A, _transposeA, _midDim, _B);
+            sparse_times_full(_C, _leftDim, _rightDim, _alpha, _A, _transposeA, _midDim, _B);
         }
     }
     
-    void matrix_matrix_product( double* const _C,
+    template<class T>
+    void full_times_sparse( T* const _C,
                                 const size_t _leftDim,
                                 const size_t _rightDim,
                                 const double _alpha,
-                                const double* const _A,
+                                const T* const _A,
                                 const bool _transposeA,
                                 const size_t _midDim,
-                                const std::map<size_t, double>& _B,
+                                const misc::FlatMap<size_t, double>& _B,
                                 const bool _transposeB) {
         // It is significantly faster to calculate (B^T * A*T)^T
-        const std::unique_ptr<double[]> CT(new double[_leftDim*_rightDim]);
-        matrix_matrix_product(CT.get(), _rightDim, _leftDim, _alpha, _B, !_transposeB, _midDim, _A, !_transposeA);
+        const std::unique_ptr<T[]> CT(new T[_leftDim*_rightDim]);
+        sparse_times_full(CT.get(), _rightDim, _leftDim, _alpha, _B, !_transposeB, _midDim, _A, !_transposeA);
         transpose(_C, CT.get(), _rightDim, _leftDim);
     }
     
+    void matrix_matrix_product( double* const _C,
+                                const size_t _leftDim,
+                                const size_t _rightDim,
+                                const double _alpha,
+                                const misc::FlatMap<size_t, double>& _A,
+                                const bool _transposeA,
+                                const size_t _midDim,
+                                const double* const _B,
+                                const bool _transposeB) {
+        sparse_times_full(_C, _leftDim, _rightDim, _alpha, _A, _transposeA, _midDim, _B, _transposeB);
+    }
+    
+    void matrix_matrix_product( double* const _C,
+                                const size_t _leftDim,
+                                const size_t _rightDim,
+                                const double _alpha,
+                                const double* const _A,
+                                const bool _transposeA,
+                                const size_t _midDim,
+                                const misc::FlatMap<size_t, double>& _B,
+                                const bool _transposeB) {
+        full_times_sparse(_C, _leftDim, _rightDim, _alpha, _A, _transposeA, _midDim, _B, _transposeB);
+    }
+    
+    void matrix_matrix_product( float* const _C,
+                                const size_t _leftDim,
+                                const size_t _rightDim,
+                                const double _alpha,
+                                const misc::FlatMap<size_t, double>& _A,
+                                const bool _transposeA,
+                                const size_t _midDim,
+                                const float* const _B,
+                                const bool _transposeB) {
+        sparse_times_full(_C, _leftDim, _rightDim, _alpha, _A, _transposeA, _midDim, _B, _transposeB);
+    }
+    
+    void matrix_matrix_product( float* const _C,
+                                const size_t _leftDim,
+                                const size_t _rightDim,
+                                const double _alpha,
+                                const float* const _A,
+                                const bool _transposeA,
+                                const size_t _midDim,
+                                const misc::FlatMap<size_t, double>& _B,
+                                const bool _transposeB) {
+        full_times_sparse(_C, _leftDim, _rightDim, _alpha, _A, _transposeA, _midDim, _B, _transposeB);
+    }
+    
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - Mix to Sparse - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
     
-    void matrix_matrix_product( std::map<size_t, double>& _C,
+    void matrix_matrix_product( misc::FlatMap<size_t, double>& _C,
                                 const size_t  /*_leftDim*/,
                                 const size_t _rightDim,
                                 const double _alpha,
-                                const std::map<size_t, double>& _A,
+                                const misc::FlatMap<size_t, double>& _A,
                                 const size_t _midDim,
                                 const double* const _B) {
 		XERUS_PA_START;
@@ -156,7 +211,7 @@ namespace xerus {
                     #pragma GCC diagnostic push
                     #pragma GCC diagnostic ignored "-Wfloat-equal"
                     if(row.get()[k] != 0) {
-                        _C.emplace(currentRow*_rightDim + k, row.get()[k]);
+                        _C.emplace_back(currentRow*_rightDim + k, row.get()[k]);
                     }
                     #pragma GCC diagnostic pop
                 }
@@ -172,7 +227,7 @@ namespace xerus {
             #pragma GCC diagnostic push
                 #pragma GCC diagnostic ignored "-Wfloat-equal"
                 if(row.get()[k] != 0) {
-                    _C.emplace(currentRow*_rightDim + k, row.get()[k]);
+                    _C.emplace_back(currentRow*_rightDim + k, row.get()[k]);
                 }
             #pragma GCC diagnostic pop
         }
@@ -180,17 +235,17 @@ namespace xerus {
 		XERUS_PA_END("Mixed BLAS", "Matrix-Matrix-Multiplication ==> Sparse", "?x"+misc::to_string(_midDim)+" * "+misc::to_string(_midDim)+"x"+misc::to_string(_rightDim));
     }
     
-    void matrix_matrix_product( std::map<size_t, double>& _C,
+    void matrix_matrix_product( misc::FlatMap<size_t, double>& _C,
                                 const size_t _leftDim,
                                 const size_t _rightDim,
                                 const double _alpha,
-                                const std::map<size_t, double>& _A,
+                                const misc::FlatMap<size_t, double>& _A,
                                 const bool _transposeA,
                                 const size_t _midDim,
                                 const double* const _B,
                                 const bool _transposeB) {
         if(_transposeA) {
-            const std::map<size_t, double> AT = transpose(_A, _midDim, _leftDim);
+            const misc::FlatMap<size_t, double> AT = transpose(_A, _midDim, _leftDim);
             if(_transposeB) {
                 std::unique_ptr<double[]> BT = transpose(_B, _rightDim, _midDim);
                 matrix_matrix_product(_C, _leftDim, _rightDim, _alpha, AT, _midDim, BT.get());
@@ -207,17 +262,17 @@ namespace xerus {
         }
     }
     
-    void matrix_matrix_product( std::map<size_t, double>& _C,
+    void matrix_matrix_product( misc::FlatMap<size_t, double>& _C,
                                 const size_t _leftDim,
                                 const size_t _rightDim,
                                 const double _alpha,
                                 const double* const _A,
                                 const bool _transposeA,
                                 const size_t _midDim,
-                                const std::map<size_t, double>& _B,
+                                const misc::FlatMap<size_t, double>& _B,
                                 const bool _transposeB) {
         // It is significantly faster to calculate (B^T * A*T)^T (this is only benchmarked for mix -> Full yet...)
-        std::map<size_t, double> CT;
+        misc::FlatMap<size_t, double> CT;
         matrix_matrix_product(CT, _rightDim, _leftDim, _alpha, _B, !_transposeB, _midDim, _A, !_transposeA);
         transpose(_C, CT, _rightDim, _leftDim);
     }
@@ -60,7 +60,7 @@ namespace xerus {
 				misc::set_zero(denseData.get(), size);
 			}
 		} else {
-			sparseData.reset(new std::map<size_t, value_t>());
+			sparseData.reset(new misc::FlatMap<size_t, value_t>());
 		}
 	}
 	
@@ -110,12 +110,14 @@ namespace xerus {
 	
 	Tensor::Tensor(DimensionTuple _dimensions, const size_t _N, const std::function<std::pair<size_t, value_t>(size_t, size_t)>& _f) : Tensor(std::move(_dimensions), Representation::Sparse, Initialisation::Zero) {
 		REQUIRE(_N <= size, "Cannot create more non zero entries that the dimension of the Tensor.");
+		sparseData->reserve(_N);
 		for (size_t i = 0; i < _N; ++i) {
-			std::pair<size_t, value_t> entry = _f(i, size);
+			const std::pair<size_t, value_t> entry = _f(i, size);
 			REQUIRE(entry.first < size, "Postion is out of bounds " << entry.first);
-			REQUIRE(!misc::contains(*sparseData, entry.first), "Allready contained " << entry.first);
-			sparseData->insert(std::move(entry));
+			sparseData->emplace_back_unsorted(entry.first, entry.second);
 		}
+		sparseData->sort_and_sum_duplicates();
+		REQUIRE(sparseData->size() == _N, "The given function created " << _N-sparseData->size() << " entries more than once.");
 	}
 	
 	
@@ -218,17 +220,26 @@ namespace xerus {
 	
 	
 	bool Tensor::is_dense() const {
-		INTERNAL_CHECK((representation == Representation::Dense && denseData && !sparseData) || (representation == Representation::Sparse && sparseData && !denseData), "Internal Error: " << bool(representation) << bool(denseData) << bool(sparseData));
+		INTERNAL_CHECK((representation == Representation::Dense && precision == Precision::Double && denseData && !singleData && !sparseData) 
+					|| (representation == Representation::Dense && precision == Precision::Single && singleData && !denseData && !sparseData) 
+					|| (representation == Representation::Sparse && precision == Precision::Double && sparseData && !denseData && !singleData), "Internal Error: " << bool(representation) << (precision == Precision::Single) << bool(denseData) << bool(singleData) << bool(sparseData));
 		return representation == Representation::Dense;
 	}
 	
 	
 	bool Tensor::is_sparse() const {
-		INTERNAL_CHECK((representation == Representation::Dense && denseData && !sparseData) || (representation == Representation::Sparse && sparseData && !denseData), "Internal Error: " << bool(representation) << bool(denseData) << bool(sparseData));
+		INTERNAL_CHECK((representation == Representation::Dense && precision == Precision::Double && denseData && !singleData && !sparseData) 
+					|| (representation == Representation::Dense && precision == Precision::Single && singleData && !denseData && !sparseData) 
+					|| (representation == Representation::Sparse && precision == Precision::Double && sparseData && !denseData && !singleData), "Internal Error: " << bool(representation) << (precision == Precision::Single) << bool(denseData) << bool(singleData) << bool(sparseData));
 		return representation == Representation::Sparse;
 	}
 	
 	
+	bool Tensor::is_single_precision() const {
+		return is_dense() && precision == Precision::Single;
+	}
+	
+	
 	size_t Tensor::sparsity() const {
 		if(is_sparse()) {
 			return sparseData->size();
@@ -238,6 +249,13 @@ namespace xerus {
 	
 	
 	size_t Tensor::count_non_zero_entries(const value_t _eps) const {
+		if(is_single_precision()) {
+			size_t count = 0;
+			for(size_t i = 0; i < size; ++i) {
+				if(std::abs(singleData.get()[i]) > _eps ) { count++; }
+			}
+			return count;
+		}
 		if(is_dense()) {
 			size_t count = 0;
 			for(size_t i = 0; i < size; ++i) {
@@ -254,7 +272,11 @@ namespace xerus {
 	
 	
 	bool Tensor::all_entries_valid() const {
-		if(is_dense()) {
+		if(is_single_precision()) {
+			for(size_t i = 0; i < size; ++i) {
+				if(!std::isfinite(singleData.get()[i])) { return false; } 
+			}
+		} else if(is_dense()) {
 			for(size_t i = 0; i < size; ++i) {
 				if(!std::isfinite(denseData.get()[i])) { return false; } 
 			}
@@ -273,6 +295,9 @@ namespace xerus {
 	
 	
 	value_t Tensor::one_norm() const {
+		if(is_single_precision()) {
+			return std::abs(factor)*blasWrapper::one_norm(singleData.get(), size);
+		}
 		if(is_dense()) {
 			return std::abs(factor)*blasWrapper::one_norm(denseData.get(), size);
 		} 
@@ -284,6 +309,9 @@ namespace xerus {
 	}
 	
 	value_t Tensor::frob_norm() const {
+		if(is_single_precision()) {
+			return std::abs(factor)*blasWrapper::two_norm(singleData.get(), size);
+		}
 		if(is_dense()) {
 			return std::abs(factor)*blasWrapper::two_norm(denseData.get(), size);
 		} 
@@ -324,6 +352,7 @@ namespace xerus {
 	value_t& Tensor::operator[](const size_t _position) {
 		REQUIRE(_position < size, "Position " << _position << " does not exist in Tensor of dimensions " << dimensions);
 		
+		use_double_precision();
 		ensure_own_data_and_apply_factor();
 		
 		if(is_dense()) {
@@ -341,10 +370,13 @@ namespace xerus {
 	value_t Tensor::operator[](const size_t _position) const {
 		REQUIRE(_position < size, "Position " << _position << " does not exist in Tensor of dimensions " << dimensions);
 		
+		if(is_single_precision()) {
+			return factor*singleData.get()[_position];
+		}
 		if(is_dense()) {
 			return factor*denseData.get()[_position];
 		} 
-		const std::map<size_t, value_t>::const_iterator entry = sparseData->find(_position);
+		const misc::FlatMap<size_t, value_t>::const_iterator entry = sparseData->find(_position);
 		if(entry == sparseData->end()) {
 			return 0.0;
 		}
@@ -365,6 +397,7 @@ namespace xerus {
 	value_t& Tensor::at(const size_t _position) {
 		REQUIRE(_position < size, "Position " << _position << " does not exist in Tensor of dimensions " << dimensions);
 		REQUIRE(!has_factor(), "at() must not be called if there is a factor.");
+		use_double_precision();
 		REQUIRE((is_dense() && denseData.unique()) || (is_sparse() && sparseData.unique()) , "Data must be unique to call at().");
 		
 		if(is_dense()) {
@@ -385,10 +418,13 @@ namespace xerus {
 		REQUIRE(_position < size, "Position " << _position << " does not exist in Tensor of dimensions " << dimensions);
 		REQUIRE(!has_factor(), "at() must not be called if there is a factor.");
 		
+		if(is_single_precision()) {
+			return singleData.get()[_position];
+		}
 		if(is_dense()) {
 			return denseData.get()[_position];
 		} 
-			const std::map<size_t, value_t>::const_iterator entry = sparseData->find(_position);
+			const misc::FlatMap<size_t, value_t>::const_iterator entry = sparseData->find(_position);
 			if(entry == sparseData->end()) {
 				return 0.0;
 			} 
@@ -400,6 +436,7 @@ namespace xerus {
 	
 	value_t* Tensor::get_dense_data() {
 		use_dense_representation();
+		use_double_precision();
 		ensure_own_data_and_apply_factor();
 		return denseData.get();
 	}
@@ -407,12 +444,14 @@ namespace xerus {
 	
 	value_t* Tensor::get_unsanitized_dense_data() {
 		REQUIRE(is_dense(), "Unsanitized dense data requested, but representation is not dense!");
+		use_double_precision();
 		return denseData.get();
 	}
 	
 	
 	const value_t* Tensor::get_unsanitized_dense_data() const  {
 		REQUIRE(is_dense(), "Unsanitized dense data requested, but representation is not dense!");
+		REQUIRE(!is_single_precision(), "Unsanitized dense data requested, but precision is single!");
 		return denseData.get();
 	}
 	
@@ -421,8 +460,10 @@ namespace xerus {
 		factor = 1.0;
 		if(!denseData.unique()) {
 			sparseData.reset();
+			singleData.reset();
 			denseData.reset(new value_t[size], internal::array_deleter_vt);
 			representation = Representation::Dense;
+			precision = Precision::Double;
 		}
 		return denseData.get();
 	}
@@ -430,11 +471,37 @@ namespace xerus {
 	
 	const std::shared_ptr<value_t>& Tensor::get_internal_dense_data() {
 		REQUIRE(is_dense(), "Internal dense data requested, but representation is not dense!");
+		use_double_precision();
 		return denseData;
 	}
 	
 	
-	std::map<size_t, value_t>& Tensor::get_sparse_data() {
+	float* Tensor::get_unsanitized_single_data() {
+		REQUIRE(is_single_precision(), "Unsanitized single precision data requested, but precision is not single!");
+		return singleData.get();
+	}
+	
+	
+	const float* Tensor::get_unsanitized_single_data() const {
+		REQUIRE(is_single_precision(), "Unsanitized single precision data requested, but precision is not single!");
+		return singleData.get();
+	}
+	
+	
+	float* Tensor::override_single_data() {
+		factor = 1.0;
+		if(!singleData.unique()) {
+			sparseData.reset();
+			denseData.reset();
+			singleData.reset(new float[size], internal::array_deleter_ft);
+			representation = Representation::Dense;
+			precision = Precision::Single;
+		}
+		return singleData.get();
+	}
+	
+	
+	misc::FlatMap<size_t, value_t>& Tensor::get_sparse_data() {
 		CHECK(is_sparse(), warning, "Request for sparse data although the Tensor is not sparse.");
 		use_sparse_representation();
 		ensure_own_data_and_apply_factor();
@@ -442,34 +509,36 @@ namespace xerus {
 	}
 	
 	
-	std::map<size_t, value_t>& Tensor::get_unsanitized_sparse_data() {
+	misc::FlatMap<size_t, value_t>& Tensor::get_unsanitized_sparse_data() {
 		REQUIRE(is_sparse(), "Unsanitized sparse data requested, but representation is not sparse!");
 		return *sparseData.get();
 	}
 	
 	
-	const std::map<size_t, value_t>& Tensor::get_unsanitized_sparse_data() const  {
+	const misc::FlatMap<size_t, value_t>& Tensor::get_unsanitized_sparse_data() const  {
 		REQUIRE(is_sparse(), "Unsanitized sparse data requested, but representation is not sparse!");
 		return *sparseData.get();
 	}
 	
 	
-	std::map<size_t, value_t>& Tensor::override_sparse_data() {
+	misc::FlatMap<size_t, value_t>& Tensor::override_sparse_data() {
 		factor = 1.0;
 		if(sparseData.unique()) {
 			INTERNAL_CHECK(is_sparse(), "Internal Error");
 			sparseData->clear();
 		} else {
 			denseData.reset();
-			sparseData.reset(new std::map<size_t, value_t>());
+			singleData.reset();
+			sparseData.reset(new misc::FlatMap<size_t, value_t>());
 			representation = Representation::Sparse;
+			precision = Precision::Double;
 		}
 		
 		return *sparseData.get();
 	}
 	
 	
-	const std::shared_ptr<std::map<size_t, value_t>>& Tensor::get_internal_sparse_data() {
+	const std::shared_ptr<misc::FlatMap<size_t, value_t>>& Tensor::get_internal_sparse_data() {
 		REQUIRE(is_sparse(), "Internal sparse data requested, but representation is not sparse!");
 		return sparseData;
 	}
@@ -502,6 +571,8 @@ namespace xerus {
 		dimensions = std::move(_newDim);
 		size = misc::product(dimensions);
 		factor = 1.0;
+		singleData.reset();
+		precision = Precision::Double;
 		
 		if(_representation == Representation::Dense) {
 			if(representation == Representation::Dense) {
@@ -522,11 +593,11 @@ namespace xerus {
 				if(sparseData.unique()) {
 					sparseData->clear();
 				} else {
-					sparseData.reset(new std::map<size_t, value_t>());
+					sparseData.reset(new misc::FlatMap<size_t, value_t>());
 				}
 			} else {
 				denseData.reset();
-				sparseData.reset(new std::map<size_t, value_t>());
+				sparseData.reset(new misc::FlatMap<size_t, value_t>());
 				representation = _representation;
 			}
 		}
@@ -538,6 +609,8 @@ namespace xerus {
 		dimensions = std::move(_newDim);
 		size = misc::product(dimensions);
 		factor = 1.0;
+		singleData.reset();
+		precision = Precision::Double;
 		
 		if(representation == Representation::Dense) {
 			if(oldDataSize != size || !denseData.unique()) {
@@ -551,7 +624,7 @@ namespace xerus {
 			if(sparseData.unique()) {
 				sparseData->clear();
 			} else {
-				sparseData.reset(new std::map<size_t, value_t>());
+				sparseData.reset(new misc::FlatMap<size_t, value_t>());
 			}
 		}
 	}
@@ -559,6 +632,8 @@ namespace xerus {
 	void Tensor::reset() {
 		dimensions.clear();
 		factor = 1.0;
+		singleData.reset();
+		precision = Precision::Double;
 		
 		if(representation == Representation::Dense) {
 			if(size != 1 || !denseData.unique()) {
@@ -569,7 +644,7 @@ namespace xerus {
 			if(sparseData.unique()) {
 				sparseData->clear();
 			} else {
-				sparseData.reset(new std::map<size_t, value_t>());
+				sparseData.reset(new misc::FlatMap<size_t, value_t>());
 			}
 		}
 		size = 1;
@@ -580,6 +655,8 @@ namespace xerus {
 		dimensions = std::move(_newDim);
 		size = misc::product(dimensions);
 		factor = 1.0;
+		singleData.reset();
+		precision = Precision::Double;
 		
 		if(representation == Representation::Sparse) {
 			sparseData.reset();
@@ -594,6 +671,8 @@ namespace xerus {
 		dimensions = std::move(_newDim);
 		size = misc::product(dimensions);
 		factor = 1.0;
+		singleData.reset();
+		precision = Precision::Double;
 		
 		if(representation == Representation::Sparse) {
 			sparseData.reset();
@@ -603,17 +682,32 @@ namespace xerus {
 		denseData.reset(_newData.release());
 	}
 	
-	void Tensor::reset(DimensionTuple _newDim, std::map<size_t, value_t>&& _newData) {
+	
+	void Tensor::reset(DimensionTuple _newDim, std::unique_ptr<float[]>&& _newData) {
 		dimensions = std::move(_newDim);
 		size = misc::product(dimensions);
 		factor = 1.0;
+		denseData.reset();
+		sparseData.reset();
+		representation = Representation::Dense;
+		precision = Precision::Single;
+		
+		singleData.reset(_newData.release(), internal::array_deleter_ft);
+	}
+	
+	void Tensor::reset(DimensionTuple _newDim, misc::FlatMap<size_t, value_t>&& _newData) {
+		dimensions = std::move(_newDim);
+		size = misc::product(dimensions);
+		factor = 1.0;
+		singleData.reset();
+		precision = Precision::Double;
 		
 		if(representation == Representation::Dense) {
 			denseData.reset();
 			representation = Representation::Sparse;
 		}
 		
-		std::shared_ptr<std::map<size_t, value_t>> newD(new std::map<size_t, value_t>(std::move(_newData)));
+		std::shared_ptr<misc::FlatMap<size_t, value_t>> newD(new misc::FlatMap<size_t, value_t>(std::move(_newData)));
 		sparseData = std::move(newD);
 	}
 		
@@ -623,6 +717,61 @@ namespace xerus {
 	}
 	
 	
+	/// @brief Creates the dense data of a tensor in which one mode is resized, see Tensor::resize_mode().
+	template<class T>
+	static std::unique_ptr<T[]> resize_dense_mode(const T* const _data, const size_t _blockCount, const size_t _oldDim, const size_t _newDim, const size_t _cutPos, const size_t _dimStepSize) {
+		const size_t oldStepSize = _oldDim*_dimStepSize;
+		const size_t newStepSize = _newDim*_dimStepSize;
+		std::unique_ptr<T[]> tmpData(new T[_blockCount*newStepSize]);
+		
+		if (_newDim > _oldDim) { // Add new slates
+			const size_t insertBlockSize = (_newDim-_oldDim)*_dimStepSize;
+			if(_cutPos == 0) {
+				for ( size_t i = 0; i < _blockCount; ++i ) {
+					T* const currData = tmpData.get()+i*newStepSize;
+					misc::set_zero(currData, insertBlockSize);
+					misc::copy(currData+insertBlockSize, _data+i*oldStepSize, oldStepSize);
+				}
+			} else if(_cutPos == _oldDim) {
+				for ( size_t i = 0; i < _blockCount; ++i ) {
+					T* const currData = tmpData.get()+i*newStepSize;
+					misc::copy(currData, _data+i*oldStepSize, oldStepSize);
+					misc::set_zero(currData+oldStepSize, insertBlockSize);
+				}
+			} else {
+				const size_t preBlockSize = _cutPos*_dimStepSize;
+				const size_t postBlockSize = (_oldDim-_cutPos)*_dimStepSize;
+				for (size_t i = 0; i < _blockCount; ++i) {
+					T* const currData = tmpData.get()+i*newStepSize;
+					misc::copy(currData, _data+i*oldStepSize, preBlockSize);
+					misc::set_zero(currData+preBlockSize, insertBlockSize);
+					misc::copy(currData+preBlockSize+insertBlockSize, _data+i*oldStepSize+preBlockSize, postBlockSize);
+				}
+			}
+		} else { // Remove slates
+			if (_cutPos < _oldDim) {
+				const size_t removedSlates = (_oldDim-_newDim);
+				const size_t removedBlockSize = removedSlates*_dimStepSize;
+				const size_t preBlockSize = (_cutPos-removedSlates)*_dimStepSize;
+				const size_t postBlockSize = (_oldDim-_cutPos)*_dimStepSize;
+				
+				INTERNAL_CHECK(removedBlockSize+preBlockSize+postBlockSize == oldStepSize && preBlockSize+postBlockSize == newStepSize, "IE");
+				
+				for (size_t i = 0; i < _blockCount; ++i) {
+					T* const currData = tmpData.get()+i*newStepSize;
+					misc::copy(currData, _data+i*oldStepSize, preBlockSize);
+					misc::copy(currData+preBlockSize, _data+i*oldStepSize+preBlockSize+removedBlockSize, postBlockSize);
+				}
+			} else {
+				for (size_t i = 0; i < _blockCount; ++i) {
+					misc::copy(tmpData.get()+i*newStepSize, _data+i*oldStepSize, newStepSize);
+				}
+			}
+		}
+		return tmpData;
+	}
+	
+	
 	void Tensor::resize_mode(const size_t _mode, const size_t _newDim, size_t _cutPos) {
 		REQUIRE(_mode < degree(), "Can't resize mode " << _mode << " as the tensor is only order " << degree());
 
@@ -641,56 +790,15 @@ namespace xerus {
 		const size_t newsize = blockCount*newStepSize;
 		
 		if(is_dense()) {
-			std::unique_ptr<value_t[]> tmpData(new value_t[newsize]);
-			
-			if (_newDim > oldDim) { // Add new slates
-				const size_t insertBlockSize = (_newDim-oldDim)*dimStepSize;
-				if(_cutPos == 0) {
-					for ( size_t i = 0; i < blockCount; ++i ) {
-						value_t* const currData = tmpData.get()+i*newStepSize;
-						misc::set_zero(currData, insertBlockSize);
-						misc::copy(currData+insertBlockSize, denseData.get()+i*oldStepSize, oldStepSize);
-					}
-				} else if(_cutPos == oldDim) {
-					for ( size_t i = 0; i < blockCount; ++i ) {
-						value_t* const currData = tmpData.get()+i*newStepSize;
-						misc::copy(currData, denseData.get()+i*oldStepSize, oldStepSize);
-						misc::set_zero(currData+oldStepSize, insertBlockSize);
-					}
-				} else {
-					const size_t preBlockSize = _cutPos*dimStepSize;
-					const size_t postBlockSize = (oldDim-_cutPos)*dimStepSize;
-					for (size_t i = 0; i < blockCount; ++i) {
-						value_t* const currData = tmpData.get()+i*newStepSize;
-						misc::copy(currData, denseData.get()+i*oldStepSize, preBlockSize);
-						misc::set_zero(currData+preBlockSize, insertBlockSize);
-						misc::copy(currData+preBlockSize+insertBlockSize, denseData.get()+i*oldStepSize+preBlockSize, postBlockSize);
-					}
-				}
-			} else { // Remove slates
-				if (_cutPos < oldDim) {
-					const size_t removedSlates = (oldDim-_newDim);
-					const size_t removedBlockSize = removedSlates*dimStepSize;
-					const size_t preBlockSize = (_cutPos-removedSlates)*dimStepSize;
-					const size_t postBlockSize = (oldDim-_cutPos)*dimStepSize;
-					
-					INTERNAL_CHECK(removedBlockSize+preBlockSize+postBlockSize == oldStepSize && preBlockSize+postBlockSize == newStepSize, "IE");
-					
-					for (size_t i = 0; i < blockCount; ++i) {
-						value_t* const currData = tmpData.get()+i*newStepSize;
-						misc::copy(currData, denseData.get()+i*oldStepSize, preBlockSize);
-						misc::copy(currData+preBlockSize, denseData.get()+i*oldStepSize+preBlockSize+removedBlockSize, postBlockSize);
-					}
-				} else {
-					for (size_t i = 0; i < blockCount; ++i) {
-						misc::copy(tmpData.get()+i*newStepSize, denseData.get()+i*oldStepSize, newStepSize);
-					}
-				}
+			if(is_single_precision()) {
+				singleData.reset(resize_dense_mode(singleData.get(), blockCount, oldDim, _newDim, _cutPos, dimStepSize).release(), internal::array_deleter_ft);
+			} else {
+				denseData.reset(resize_dense_mode(denseData.get(), blockCount, oldDim, _newDim, _cutPos, dimStepSize).release(), internal::array_deleter_vt);
 			}
-			denseData.reset(tmpData.release(), internal::array_deleter_vt);
-		
 		} else {
-			std::unique_ptr<std::map<size_t, value_t>> tmpData(new std::map<size_t, value_t>());
+			// The mapping of positions is monotone, so the new entries are created in sorted order.
+			std::unique_ptr<misc::FlatMap<size_t, value_t>> tmpData(new misc::FlatMap<size_t, value_t>());
+			tmpData->reserve(sparseData->size());
 			
 			if (_newDim > oldDim) { // Add new slates
 				const size_t slatesAdded = _newDim-oldDim;
@@ -701,9 +809,9 @@ namespace xerus {
 					const size_t i = entry.first/oldStepSize;
 					
 					if(j < _cutPos) { // Entry remains at current position j
-						tmpData->emplace(i*newStepSize+j*dimStepSize+k, entry.second);
+						tmpData->emplace_back(i*newStepSize+j*dimStepSize+k, entry.second);
 					} else { // Entry moves to position j+slatesAdded
-						tmpData->emplace(i*newStepSize+(j+slatesAdded)*dimStepSize+k, entry.second);
+						tmpData->emplace_back(i*newStepSize+(j+slatesAdded)*dimStepSize+k, entry.second);
 					}
 				}
 			} else { // Remove slates
@@ -715,9 +823,9 @@ namespace xerus {
 					const size_t i = entry.first/oldStepSize;
 					
 					if(j < _cutPos-slatesRemoved) { // Entry remains at current position j
-						tmpData->emplace(i*newStepSize+j*dimStepSize+k, entry.second);
+						tmpData->emplace_back(i*newStepSize+j*dimStepSize+k, entry.second);
 					} else if(j >= _cutPos) { // Entry advances in position j
-						tmpData->emplace(i*newStepSize+(j-slatesRemoved)*dimStepSize+k, entry.second);
+						tmpData->emplace_back(i*newStepSize+(j-slatesRemoved)*dimStepSize+k, entry.second);
 					}
 				}
 			}
@@ -729,6 +837,17 @@ namespace xerus {
 	}
 	
 	
+	/// @brief Copies the slates at @a _slateOffset of the dense data @a _data into a new array, see Tensor::fix_mode().
+	template<class T>
+	static std::unique_ptr<T[]> fix_dense_mode(const T* const _data, const size_t _stepCount, const size_t _stepSize, const size_t _slateOffset, const size_t _blockSize) {
+		std::unique_ptr<T[]> tmpData(new T[_stepCount*_blockSize]);
+		for(size_t i = 0; i < _stepCount; ++i) {
+			misc::copy(tmpData.get()+i*_blockSize, _data+i*_stepSize+_slateOffset, _blockSize);
+		}
+		return tmpData;
+	}
+	
+	
 	void Tensor::fix_mode(const size_t _mode, const size_t _slatePosition) {
 		REQUIRE(_slatePosition < dimensions[_mode], "The given slatePosition must be smaller than the corresponding dimension. Here " << _slatePosition << " >= " << dimensions[_mode] << ", dim = " << dimensions << "=" << size << " mode " << _mode);
 		
@@ -737,17 +856,12 @@ namespace xerus {
 		const size_t stepSize = dimensions[_mode]*blockSize;
 		const size_t slateOffset = _slatePosition*blockSize;
 		
-		if(is_dense()) {
-			std::unique_ptr<value_t[]> tmpData(new value_t[stepCount*blockSize]);
-			
-			// Copy data
-			for(size_t i = 0; i < stepCount; ++i) {
-				misc::copy(tmpData.get()+i*blockSize, denseData.get()+i*stepSize+slateOffset, blockSize);
-			}
-			
-			denseData.reset(tmpData.release(), &internal::array_deleter_vt);
+		if(is_single_precision()) {
+			singleData.reset(fix_dense_mode(singleData.get(), stepCount, stepSize, slateOffset, blockSize).release(), &internal::array_deleter_ft);
+		} else if(is_dense()) {
+			denseData.reset(fix_dense_mode(denseData.get(), stepCount, stepSize, slateOffset, blockSize).release(), &internal::array_deleter_vt);
 		} else {
-			std::unique_ptr<std::map<size_t, value_t>> tmpData(new std::map<size_t, value_t>());
+			std::unique_ptr<misc::FlatMap<size_t, value_t>> tmpData(new misc::FlatMap<size_t, value_t>());
 			
 			for(const auto& entry : *sparseData.get()) {
 				// Decode the position as i*stepSize + j*blockSize + k
@@ -756,7 +870,7 @@ namespace xerus {
 				const size_t i = entry.first/stepSize;
 				
 				if(j == _slatePosition) {
-					tmpData->emplace(i*blockSize+k, entry.second);
+					tmpData->emplace_back(i*blockSize+k, entry.second);
 				}
 			}
 			
@@ -778,6 +892,27 @@ namespace xerus {
 	}
 	
 	
+	/// @brief Calculates the (scaled) trace of the dense data @a _data, see Tensor::perform_trace().
+	template<class T>
+	static std::unique_ptr<T[]> trace_dense_data(const T* const _data, const T _factor, const size_t _front, const size_t _mid, const size_t _back, const size_t _traceDim) {
+		const size_t frontStepSize = _traceDim*_mid*_traceDim*_back;
+		const size_t traceStepSize = _mid*_traceDim*_back+_back;
+		const size_t midStepSize = _traceDim*_back;
+		
+		std::unique_ptr<T[]> newData(new T[_front*_mid*_back]);
+		misc::set_zero(newData.get(), _front*_mid*_back);
+		
+		for(size_t f = 0; f < _front; ++f) {
+			for(size_t t = 0; t < _traceDim; ++t) {
+				for(size_t m = 0; m < _mid; ++m) {
+					misc::add_scaled(newData.get()+(f*_mid+m)*_back, _factor, _data+f*frontStepSize+t*traceStepSize+m*midStepSize, _back);
+				}
+			}
+		}
+		return newData;
+	}
+	
+	
 	void Tensor::perform_trace(size_t _firstMode, size_t _secondMode) {
 		REQUIRE(_firstMode != _secondMode, "Given indices must not coincide");
 		REQUIRE(dimensions[_firstMode] == dimensions[_secondMode], "Dimensions of trace indices must coincide.");
@@ -790,27 +925,15 @@ namespace xerus {
 		const size_t mid = misc::product(dimensions, _firstMode+1, _secondMode);
 		const size_t back = misc::product(dimensions, _secondMode+1, degree());
 		const size_t traceDim = dimensions[_firstMode];
-		const size_t frontStepSize = traceDim*mid*traceDim*back;
-		const size_t traceStepSize = mid*traceDim*back+back;
-		const size_t midStepSize = traceDim*back;
 		
 		size = front*mid*back;
 		
-		if(is_dense()) {
-			std::unique_ptr<value_t[]> newData(new value_t[size]);
-			misc::set_zero(newData.get(), size);
-			
-			for(size_t f = 0; f < front; ++f) {
-				for(size_t t = 0; t < traceDim; ++t) {
-					for(size_t m = 0; m < mid; ++m) {
-						misc::add_scaled(newData.get()+(f*mid+m)*back, factor, denseData.get()+f*frontStepSize+t*traceStepSize+m*midStepSize, back);
-					}
-				}
-			}
-			
-			denseData.reset(newData.release(), internal::array_deleter_vt);
+		if(is_single_precision()) {
+			singleData.reset(trace_dense_data(singleData.get(), static_cast<float>(factor), front, mid, back, traceDim).release(), internal::array_deleter_ft);
+		} else if(is_dense()) {
+			denseData.reset(trace_dense_data(denseData.get(), factor, front, mid, back, traceDim).release(), internal::array_deleter_vt);
 		} else {
-			std::unique_ptr<std::map<size_t, value_t>> newData( new std::map<size_t, value_t>());
+			std::unique_ptr<misc::FlatMap<size_t, value_t>> newData( new misc::FlatMap<size_t, value_t>());
 			
 			for(const auto& entry : *sparseData) {
 				size_t pos = entry.first;
@@ -825,9 +948,10 @@ namespace xerus {
 				const size_t frontIdx = pos;
 				
 				if(traceFrontIdx == traceBackIdx) {
-					(*newData)[(frontIdx*mid + midIdx)*back + backIdx] += factor*entry.second;
+					newData->emplace_back_unsorted((frontIdx*mid + midIdx)*back + backIdx, factor*entry.second);
 				}
 			}
+			newData->sort_and_sum_duplicates();
 			
 			sparseData.reset(newData.release());
 		}
@@ -839,6 +963,7 @@ namespace xerus {
 	
 	
 	void Tensor::modify_diagonal_entries(const std::function<void(value_t&)>& _f) {
+		use_double_precision();
 		ensure_own_data_and_apply_factor();
 		
 		if(degree() == 0) {
@@ -860,6 +985,7 @@ namespace xerus {
 	
 	
 	void Tensor::modify_diagonal_entries(const std::function<void(value_t&, const size_t)>& _f) {
+		use_double_precision();
 		ensure_own_data_and_apply_factor();
 		
 		if(degree() == 0) {
@@ -880,77 +1006,81 @@ namespace xerus {
 	}
 	
 	
+	/// @brief Applies @a _f to all @a _size entries of the given sparse data, rebuilding it in a single sorted pass.
+	template<class function_t>
+	static void modify_sparse_entries(misc::FlatMap<size_t, value_t>& _data, const size_t _size, const function_t& _f) {
+		misc::FlatMap<size_t, value_t> newData;
+		newData.reserve(_data.size());
+		auto oldEntry = _data.cbegin();
+		for(size_t i = 0; i < _size; ++i) {
+			value_t val = 0.0;
+			if(oldEntry != _data.cend() && oldEntry->first == i) {
+				val = oldEntry->second;
+				++oldEntry;
+			}
+			_f(val, i);
+			if(misc::hard_not_equal(val, 0.0)) {
+				newData.emplace_back(i, val);
+			}
+		}
+		_data = std::move(newData);
+	}
+	
+	
 	void Tensor::modify_entries(const std::function<void(value_t&)>& _f) {
+		use_double_precision();
 		ensure_own_data_and_apply_factor();
 		if(is_dense()) {
 			for(size_t i = 0; i < size; ++i) { _f(at(i)); }
 		} else {
-			for(size_t i = 0; i < size; ++i) {
-				value_t val = cat(i);
-				const value_t oldVal = val;
-				_f(val);
-				if(misc::hard_not_equal(val, 0.0)) {
-					at(i) = val;
-				} else if( misc::hard_not_equal(oldVal, 0.0)) {
-					IF_CHECK( size_t succ =) sparseData->erase(i);
-					INTERNAL_CHECK(succ == 1, "Internal Error");
-				}
-			}
+			modify_sparse_entries(*sparseData, size, [&](value_t& _val, const size_t){ _f(_val); });
+			use_dense_representation_if_desirable();
 		}
 	}
 	
 
 	void Tensor::modify_entries(const std::function<void(value_t&, const size_t)>& _f) {
+		use_double_precision();
 		ensure_own_data_and_apply_factor();
 		if(is_dense()) {
 			for(size_t i = 0; i < size; ++i) { _f(at(i), i); }
 		} else {
-			for(size_t i = 0; i < size; ++i) {
-				value_t val = cat(i);
-				const value_t oldVal = val;
-				_f(val, i);
-				if(misc::hard_not_equal(val, 0.0)) {
-					at(i) = val;
-				} else if( misc::hard_not_equal(oldVal, 0.0)) {
-					IF_CHECK( size_t succ =) sparseData->erase(i);
-					INTERNAL_CHECK(succ == 1, "Internal Error");
-				}
-			}
+			modify_sparse_entries(*sparseData, size, _f);
+			use_dense_representation_if_desirable();
 		}
 	}
 	
 	
 	void Tensor::modify_entries(const std::function<void(value_t&, const MultiIndex&)>& _f) {
+		use_double_precision();
 		ensure_own_data_and_apply_factor();
 		
 		MultiIndex multIdx(degree(), 0);
-		size_t idx = 0;
-		while (true) {
-			if(is_dense()) {
-				_f(at(idx), multIdx);
-			} else {
-				value_t val = cat(idx);
-				const value_t oldVal = val;
-				_f(val, multIdx);
-				if(misc::hard_not_equal(val, 0.0)) {
-					at(idx) = val;
-				} else if( misc::hard_not_equal(oldVal, 0.0)) {
-					IF_CHECK( size_t succ =) sparseData->erase(idx);
-					INTERNAL_CHECK(succ == 1, "Internal Error");
-				}
-			}
-			
-			// Increase indices
-			idx++;
+		const auto increase_multIdx = [&]() {
 			size_t changingIndex = degree()-1;
 			multIdx[changingIndex]++;
 			while(multIdx[changingIndex] == dimensions[changingIndex]) {
 				multIdx[changingIndex] = 0;
 				changingIndex--;
 				// Return on overflow 
-				if(changingIndex >= degree()) { return; }
+				if(changingIndex >= degree()) { return false; }
 				multIdx[changingIndex]++;
 			}
+			return true;
+		};
+		
+		if(is_dense()) {
+			size_t idx = 0;
+			do {
+				_f(at(idx), multIdx);
+				idx++;
+			} while(increase_multIdx());
+		} else {
+			modify_sparse_entries(*sparseData, size, [&](value_t& _val, const size_t) {
+				_f(_val, multIdx);
+				if(degree() > 0) { increase_multIdx(); }
+			});
+			use_dense_representation_if_desirable();
 		}
 	}
 	
@@ -975,6 +1105,13 @@ namespace xerus {
 			}
 		)
 		
+		if(_other.is_single_precision()) {
+			Tensor otherDouble(_other);
+			otherDouble.use_double_precision();
+			offset_add(otherDouble, _offsets);
+			return;
+		}
+		
 		if(_other.is_dense()) {
 			use_dense_representation();
 			
@@ -1015,11 +1152,15 @@ namespace xerus {
 					dataPtr[newPos] += _other.factor*entry.second;
 				}
 			} else {
-				std::map<size_t, value_t>& data = get_sparse_data(); 
+				// The mapping of positions is monotone, so the shifted entries are created in sorted order and can be merged in one pass.
+				std::shared_ptr<misc::FlatMap<size_t, value_t>> shiftedData(new misc::FlatMap<size_t, value_t>());
+				shiftedData->reserve(_other.sparseData->size());
 				for(const auto& entry : _other.get_unsanitized_sparse_data()) {
 					const size_t newPos = multiIndex_to_position(position_to_multiIndex(entry.first, _other.dimensions), dimensions) + offset;
-					data[newPos] += _other.factor*entry.second;
+					shiftedData->emplace_back(newPos, entry.second);
 				}
+				ensure_own_data_and_apply_factor();
+				add_sparse_to_sparse(sparseData, _other.factor, shiftedData);
 			}
 		}
 	}
@@ -1048,11 +1189,12 @@ namespace xerus {
 	
 	
 	void Tensor::use_sparse_representation(const value_t _eps) {
+		use_double_precision();
 		if(is_dense()) {
-			sparseData.reset(new std::map<size_t, value_t>());
+			sparseData.reset(new misc::FlatMap<size_t, value_t>());
 			for(size_t i = 0; i < size; ++i) {
 				if(std::abs(factor*denseData.get()[i]) >= _eps) {
-					sparseData->emplace_hint(sparseData->end(), i, factor*denseData.get()[i]);
+					sparseData->emplace_back(i, factor*denseData.get()[i]);
 				}
 			}
 			
@@ -1061,6 +1203,33 @@ namespace xerus {
 			representation = Representation::Sparse;
 		}
 	}
+	
+	
+	void Tensor::use_single_precision() {
+		use_dense_representation();
+		if(!is_single_precision()) {
+			singleData.reset(new float[size], internal::array_deleter_ft);
+			const value_t* const oldData = denseData.get();
+			for(size_t i = 0; i < size; ++i) {
+				singleData.get()[i] = static_cast<float>(oldData[i]);
+			}
+			denseData.reset();
+			precision = Precision::Single;
+		}
+	}
+	
+	
+	void Tensor::use_double_precision() {
+		if(is_single_precision()) {
+			denseData.reset(new value_t[size], internal::array_deleter_vt);
+			const float* const oldData = singleData.get();
+			for(size_t i = 0; i < size; ++i) {
+				denseData.get()[i] = static_cast<value_t>(oldData[i]);
+			}
+			singleData.reset();
+			precision = Precision::Double;
+		}
+	}
 
 	
 	/*- - - - - - - - - - - - - - - - - - - - - - - - - - Miscellaneous - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
@@ -1087,6 +1256,27 @@ namespace xerus {
 	void Tensor::plus_minus_equal(Tensor& _me, const Tensor& _other) {
 		REQUIRE(_me.dimensions == _other.dimensions, "In Tensor sum the dimensions must coincide.");
 		
+		// _me keeps its precision, a summand of the other precision is rounded or widened respectively
+		if(_me.is_single_precision()) {
+			Tensor otherSingle(_other);
+			otherSingle.use_single_precision();
+			_me.ensure_own_data_and_apply_factor();
+			misc::add_scaled(_me.singleData.get(), static_cast<float>(sign*otherSingle.factor), otherSingle.singleData.get(), _me.size);
+			return;
+		}
+		
+		if(_other.is_single_precision()) {
+			_me.use_dense_representation();
+			_me.ensure_own_data_and_apply_factor();
+			value_t* const data = _me.denseData.get();
+			const float* const otherData = _other.singleData.get();
+			const value_t otherFactor = sign*_other.factor;
+			for(size_t i = 0; i < _me.size; ++i) {
+				data[i] += otherFactor*value_t(otherData[i]);
+			}
+			return;
+		}
+		
 		if(_me.is_dense()) {
 			_me.ensure_own_data_and_apply_factor();
 			if(_other.is_dense()) {
@@ -1111,20 +1301,39 @@ namespace xerus {
 	}
 	
 	
-	void Tensor::add_sparse_to_full(const std::shared_ptr<value_t>& _denseData, const value_t _factor, const std::shared_ptr<const std::map<size_t, value_t>>& _sparseData) {
+	void Tensor::add_sparse_to_full(const std::shared_ptr<value_t>& _denseData, const value_t _factor, const std::shared_ptr<const misc::FlatMap<size_t, value_t>>& _sparseData) {
 		for(const auto& entry : *_sparseData) {
 			_denseData.get()[entry.first] += _factor*entry.second;
 		}
 	}
 	
 	
-	void Tensor::add_sparse_to_sparse(const std::shared_ptr<std::map<size_t, value_t>>& _sum, const value_t _factor, const std::shared_ptr<const std::map<size_t, value_t>>& _summand) {
-		for(const auto& entry : *_summand) {
-			std::pair<std::map<size_t, value_t>::iterator, bool> result = _sum->emplace(entry.first, _factor*entry.second);
-			if(!result.second) {
-				result.first->second += _factor*entry.second;
+	void Tensor::add_sparse_to_sparse(const std::shared_ptr<misc::FlatMap<size_t, value_t>>& _sum, const value_t _factor, const std::shared_ptr<const misc::FlatMap<size_t, value_t>>& _summand) {
+		// Both operands are sorted, so a single linear merge suffices.
+		misc::FlatMap<size_t, value_t> result;
+		result.reserve(_sum->size() + _summand->size());
+		auto sumEntry = _sum->cbegin();
+		auto summandEntry = _summand->cbegin();
+		while(sumEntry != _sum->cend() && summandEntry != _summand->cend()) {
+			if(sumEntry->first < summandEntry->first) {
+				result.emplace_back(sumEntry->first, sumEntry->second);
+				++sumEntry;
+			} else if(summandEntry->first < sumEntry->first) {
+				result.emplace_back(summandEntry->first, _factor*summandEntry->second);
+				++summandEntry;
+			} else {
+				result.emplace_back(sumEntry->first, sumEntry->second + _factor*summandEntry->second);
+				++sumEntry;
+				++summandEntry;
 			}
 		}
+		for(; sumEntry != _sum->cend(); ++sumEntry) {
+			result.emplace_back(sumEntry->first, sumEntry->second);
+		}
+		for(; summandEntry != _summand->cend(); ++summandEntry) {
+			result.emplace_back(summandEntry->first, _factor*summandEntry->second);
+		}
+		*_sum = std::move(result);
 	}
 	
 	
@@ -1156,7 +1365,13 @@ namespace xerus {
 	
 	
 	void Tensor::ensure_own_data() {
-		if(is_dense()) {
+		if(is_single_precision()) {
+			if(!singleData.unique()) {
+				float* const oldDataPtr = singleData.get();
+				singleData.reset(new float[size], internal::array_deleter_ft);
+				misc::copy(singleData.get(), oldDataPtr, size);
+			}
+		} else if(is_dense()) {
 			if(!denseData.unique()) {
 				value_t* const oldDataPtr = denseData.get();
 				denseData.reset(new value_t[size], internal::array_deleter_vt);
@@ -1164,20 +1379,24 @@ namespace xerus {
 			}
 		} else {
 			if(!sparseData.unique()) {
-				sparseData.reset(new std::map<size_t, value_t>(*sparseData));
+				sparseData.reset(new misc::FlatMap<size_t, value_t>(*sparseData));
 			}
 		}
 	}
 	
 	
 	void Tensor::ensure_own_data_no_copy() {
-		if(is_dense()) {
+		if(is_single_precision()) {
+			if(!singleData.unique()) {
+				singleData.reset(new float[size], internal::array_deleter_ft);
+			}
+		} else if(is_dense()) {
 			if(!denseData.unique()) {
 				denseData.reset(new value_t[size], internal::array_deleter_vt);
 			}
 		} else {
 			if(!sparseData.unique()) {
-				sparseData.reset(new std::map<size_t, value_t>());
+				sparseData.reset(new misc::FlatMap<size_t, value_t>());
 			}
 		}
 	}
@@ -1185,7 +1404,15 @@ namespace xerus {
 	
 	void Tensor::apply_factor() {
 		if(has_factor()) {
-			if(is_dense()) {
+			if(is_single_precision()) {
+				if(singleData.unique()) {
+					misc::scale(singleData.get(), static_cast<float>(factor), size);
+				} else {
+					float* const oldDataPtr = singleData.get();
+					singleData.reset(new float[size], internal::array_deleter_ft);
+					misc::copy_scaled(singleData.get(), static_cast<float>(factor), oldDataPtr, size);
+				}
+			} else if(is_dense()) {
 				if(denseData.unique()) {
 					misc::scale(denseData.get(), factor, size);
 				} else {
@@ -1195,10 +1422,10 @@ namespace xerus {
 				}
 			} else {
 				if(!sparseData.unique()) {
-					sparseData.reset(new std::map<size_t, value_t>(*sparseData));
+					sparseData.reset(new misc::FlatMap<size_t, value_t>(*sparseData));
 				}
 				
-				for(std::pair<const size_t, value_t>& entry : *sparseData) {
+				for(std::pair<size_t, value_t>& entry : *sparseData) {
 					entry.second *= factor;
 				}
 			}
@@ -1249,6 +1476,23 @@ namespace xerus {
 	
 	
 	/*- - - - - - - - - - - - - - - - - - - - - - - - - - External functions - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
+	/// @brief Returns @a _tensor if it uses single precision, otherwise a single precision copy of it stored in @a _tmp.
+	static const Tensor& as_single_precision(const Tensor& _tensor, Tensor& _tmp) {
+		if(_tensor.is_single_precision()) { return _tensor; }
+		_tmp = _tensor;
+		_tmp.use_single_precision();
+		return _tmp;
+	}
+	
+	/// @brief Returns @a _tensor if it uses double precision, otherwise a double precision copy of it stored in @a _tmp.
+	static const Tensor& as_double_precision(const Tensor& _tensor, Tensor& _tmp) {
+		if(!_tensor.is_single_precision()) { return _tensor; }
+		_tmp = _tensor;
+		_tmp.use_double_precision();
+		return _tmp;
+	}
+	
+	
 	void contract(Tensor& _result, const Tensor& _lhs, const bool _lhsTrans, const Tensor& _rhs, const bool _rhsTrans, const size_t _numModes) {
 		REQUIRE(_numModes <= _lhs.degree() && _numModes <= _rhs.degree(), "Cannot contract more indices than both tensors have. we have: " 
 			<< _lhs.degree() << " and " << _rhs.degree() << " but want to contract: " << _numModes);
@@ -1275,7 +1519,8 @@ namespace xerus {
 		const size_t sparsityExpectation = size_t(double(finalSize)*(1.0 - misc::pow(1.0 - double(_lhs.sparsity()*_rhs.sparsity())/(double(_lhs.size)*double(_rhs.size)), midDim)));
 		REQUIRE(sparsityExpectation <= std::min(leftDim*_rhs.sparsity(), rightDim*_lhs.sparsity()), "IE");
 		// TODO allow Sparse*sparse --> Full
-		const bool sparseResult = (_lhs.is_sparse() && _rhs.is_sparse()) || (finalSize > 64 && Tensor::sparsityFactor*sparsityExpectation < finalSize*2) ;
+		const bool singleResult = _lhs.is_single_precision() || _rhs.is_single_precision();
+		const bool sparseResult = !singleResult && ((_lhs.is_sparse() && _rhs.is_sparse()) || (finalSize > 64 && Tensor::sparsityFactor*sparsityExpectation < finalSize*2));
 		const Tensor::Representation resultRepresentation = sparseResult ? Tensor::Representation::Sparse : Tensor::Representation::Dense;
 		
 		
@@ -1306,7 +1551,25 @@ namespace xerus {
 		}
 		
 		
-		if(!_lhs.is_sparse() && !_rhs.is_sparse()) { // Full * Full => Full
+		if(singleResult) { // Anything * Single => Single, the factors are kept in double precision
+			Tensor lhsTmp, rhsTmp;
+			float* const resultData = usedResult->override_single_data();
+			if(_lhs.is_sparse()) {
+				matrix_matrix_product(resultData, leftDim, rightDim, 1.0, 
+									_lhs.get_unsanitized_sparse_data(), _lhsTrans, midDim, 
+									_rhs.get_unsanitized_single_data(), _rhsTrans);
+			} else if(_rhs.is_sparse()) {
+				matrix_matrix_product(resultData, leftDim, rightDim, 1.0, 
+									_lhs.get_unsanitized_single_data(), _lhsTrans, midDim, 
+									_rhs.get_unsanitized_sparse_data(), _rhsTrans);
+			} else {
+				blasWrapper::matrix_matrix_product(resultData, leftDim, rightDim, 1.0f, 
+												as_single_precision(_lhs, lhsTmp).get_unsanitized_single_data(), _lhsTrans, midDim, 
+												as_single_precision(_rhs, rhsTmp).get_unsanitized_single_data(), _rhsTrans);
+			}
+			usedResult->factor = _lhs.factor*_rhs.factor;
+			
+		} else if(!_lhs.is_sparse() && !_rhs.is_sparse()) { // Full * Full => Full
 			blasWrapper::matrix_matrix_product(usedResult->override_dense_data(), leftDim, rightDim, _lhs.factor*_rhs.factor, 
 											_lhs.get_unsanitized_dense_data(), _lhsTrans, midDim, 
 											_rhs.get_unsanitized_dense_data(), _rhsTrans);
@@ -1368,11 +1631,22 @@ namespace xerus {
 		return std::make_tuple(lhsSize, rhsSize, rank);
 	}
 	
+	/// @brief Resets @a _tensor to @a _dimensions without initialisation, a single precision input gives single precision outputs.
+	XERUS_force_inline void reset_factorization_output(Tensor& _tensor, Tensor::DimensionTuple _dimensions, const Tensor::Representation _rep, const Tensor::Precision _precision) {
+		if(_precision == Tensor::Precision::Single) {
+			const size_t size = misc::product(_dimensions);
+			_tensor.reset(std::move(_dimensions), std::unique_ptr<float[]>(new float[size]));
+		} else {
+			_tensor.reset(std::move(_dimensions), _rep, Tensor::Initialisation::None);
+		}
+	}
+	
 	XERUS_force_inline void prepare_factorization_output(Tensor& _lhs, Tensor& _rhs, const Tensor& _input, const size_t _splitPos, const size_t _rank, Tensor::Representation _rep) {
 		_lhs.factor = 1.0;
 		_rhs.factor = 1.0;
 		
 		if (_lhs.representation != _rep
+			|| _lhs.precision != _input.precision
 			|| _lhs.degree() != _splitPos+1
 			|| _lhs.dimensions.back() != _rank 
 			|| !std::equal(_input.dimensions.begin(), _input.dimensions.begin() + _splitPos, _lhs.dimensions.begin())) 
@@ -1380,10 +1654,11 @@ namespace xerus {
 			Tensor::DimensionTuple newDimU;
 			newDimU.insert(newDimU.end(), _input.dimensions.begin(), _input.dimensions.begin() + _splitPos);
 			newDimU.push_back(_rank);
-			_lhs.reset(std::move(newDimU), _rep, Tensor::Initialisation::None);
+			reset_factorization_output(_lhs, std::move(newDimU), _rep, _input.precision);
 		}
 		
 		if (_rhs.representation != _rep
+			|| _rhs.precision != _input.precision
 			|| _rhs.degree() != _input.degree()-_splitPos+1 
 			|| _rank != _rhs.dimensions.front() 
 			|| !std::equal(_input.dimensions.begin() + _splitPos, _input.dimensions.end(), _rhs.dimensions.begin()+1)) 
@@ -1391,12 +1666,13 @@ namespace xerus {
 			Tensor::DimensionTuple newDimVt;
 			newDimVt.push_back(_rank);
 			newDimVt.insert(newDimVt.end(), _input.dimensions.begin() + _splitPos, _input.dimensions.end());
-			_rhs.reset(std::move(newDimVt), _rep, Tensor::Initialisation::None);
+			reset_factorization_output(_rhs, std::move(newDimVt), _rep, _input.precision);
 		}
 	}
 	
-	XERUS_force_inline void set_factorization_output(Tensor& _lhs, std::unique_ptr<value_t[]>&& _lhsData, Tensor& _rhs, 
-										   std::unique_ptr<value_t[]>&& _rhsData, const Tensor& _input, const size_t _splitPos, const size_t _rank) {
+	template<class T>
+	XERUS_force_inline void set_factorization_output(Tensor& _lhs, std::unique_ptr<T[]>&& _lhsData, Tensor& _rhs, 
+										   std::unique_ptr<T[]>&& _rhsData, const Tensor& _input, const size_t _splitPos, const size_t _rank) {
 		Tensor::DimensionTuple newDim;
 		newDim.insert(newDim.end(), _input.dimensions.begin(), _input.dimensions.begin() + _splitPos);
 		newDim.push_back(_rank);
@@ -1408,8 +1684,8 @@ namespace xerus {
 		_rhs.reset(std::move(newDim), std::move(_rhsData));
 	}
 	
-	XERUS_force_inline void set_factorization_output(Tensor& _lhs, std::map<size_t, value_t>&& _lhsData, Tensor& _rhs, 
-										   std::map<size_t, value_t>&& _rhsData, const Tensor& _input, const size_t _splitPos, const size_t _rank) {
+	XERUS_force_inline void set_factorization_output(Tensor& _lhs, misc::FlatMap<size_t, value_t>&& _lhsData, Tensor& _rhs, 
+										   misc::FlatMap<size_t, value_t>&& _rhsData, const Tensor& _input, const size_t _splitPos, const size_t _rank) {
 		Tensor::DimensionTuple newDim;
 		newDim.insert(newDim.end(), _input.dimensions.begin(), _input.dimensions.begin() + _splitPos);
 		newDim.push_back(_rank);
@@ -1440,7 +1716,14 @@ namespace xerus {
 		}
 		
 		// Calculate the actual SVD
-		if(_input.is_sparse()) {
+		if(_input.is_single_precision()) {
+			std::unique_ptr<float[]> singleS(new float[rank]);
+			prepare_factorization_output(_U, _Vt, _input, _splitPos, rank, Tensor::Representation::Dense);
+			blasWrapper::svd(_U.override_single_data(), singleS.get(), _Vt.override_single_data(), _input.get_unsanitized_single_data(), lhsSize, rhsSize);
+			for(size_t i = 0; i < rank; ++i) {
+				tmpS[i] = static_cast<value_t>(singleS[i]);
+			}
+		} else if(_input.is_sparse()) {
 			// calculate QC in both directions
 			calculate_qc(_U, _input, _input, _splitPos);
 			calculate_cq(_input, _Vt, _input, 1);
@@ -1492,8 +1775,11 @@ namespace xerus {
 	void calculate_qr(Tensor& _Q, Tensor& _R, Tensor _input, const size_t _splitPos) {
 		size_t lhsSize, rhsSize, rank;
 		std::tie(lhsSize, rhsSize, rank) = calculate_factorization_sizes(_input, _splitPos);
-		if (_input.is_sparse()) {
-			std::map<size_t, double> qdata, rdata;
+		if (_input.is_single_precision()) {
+			prepare_factorization_output(_Q, _R, _input, _splitPos, rank, Tensor::Representation::Dense);
+			blasWrapper::qr(_Q.override_single_data(), _R.override_single_data(), _input.get_unsanitized_single_data(), lhsSize, rhsSize);
+		} else if (_input.is_sparse()) {
+			misc::FlatMap<size_t, double> qdata, rdata;
 			std::tie(qdata, rdata, rank) = internal::CholmodSparse::qc(_input.get_unsanitized_sparse_data(), false, lhsSize, rhsSize, true);
 			INTERNAL_CHECK(rank == std::min(lhsSize, rhsSize), "IE, sparse qr reduced rank");
 			set_factorization_output(_Q, std::move(qdata), _R, std::move(rdata), _input, _splitPos, rank);
@@ -1513,7 +1799,9 @@ namespace xerus {
 		std::tie(lhsSize, rhsSize, rank) = calculate_factorization_sizes(_input, _splitPos);
 		prepare_factorization_output(_R, _Q, _input, _splitPos, rank, Tensor::Representation::Dense);
 		
-		if(_input.is_sparse()) {
+		if(_input.is_single_precision()) {
+			blasWrapper::rq(_R.override_single_data(), _Q.override_single_data(), _input.get_unsanitized_single_data(), lhsSize, rhsSize);
+		} else if(_input.is_sparse()) {
 			LOG_ONCE(warning, "Sparse RQ not yet implemented. falling back to the dense variant"); // TODO
 			_input.use_dense_representation();
 			blasWrapper::rq(_R.override_dense_data(), _Q.override_dense_data(), _input.get_unsanitized_dense_data(), lhsSize, rhsSize);
@@ -1529,8 +1817,12 @@ namespace xerus {
 		size_t lhsSize, rhsSize, rank;
 		std::tie(lhsSize, rhsSize, rank) = calculate_factorization_sizes(_input, _splitPos);
 		
-		if(_input.is_sparse()) {
-			std::map<size_t, double> qdata, cdata;
+		if(_input.is_single_precision()) {
+			std::unique_ptr<float[]> QData, CData;
+			std::tie(QData, CData, rank) = blasWrapper::qc(_input.get_unsanitized_single_data(), lhsSize, rhsSize);
+			set_factorization_output(_Q, std::move(QData), _C, std::move(CData), _input, _splitPos, rank);
+		} else if(_input.is_sparse()) {
+			misc::FlatMap<size_t, double> qdata, cdata;
 			std::tie(qdata, cdata, rank) = internal::CholmodSparse::qc(_input.get_unsanitized_sparse_data(), false, lhsSize, rhsSize, false);
 			set_factorization_output(_Q, std::move(qdata), _C, std::move(cdata), _input, _splitPos, rank);
 			_Q.use_dense_representation_if_desirable();
@@ -1549,8 +1841,12 @@ namespace xerus {
 		size_t lhsSize, rhsSize, rank;
 		std::tie(lhsSize, rhsSize, rank) = calculate_factorization_sizes(_input, _splitPos);
 		
-		if(_input.is_sparse()) {
-			std::map<size_t, double> qdata, cdata;
+		if(_input.is_single_precision()) {
+			std::unique_ptr<float[]> CData, QData;
+			std::tie(CData, QData, rank) = blasWrapper::cq(_input.get_unsanitized_single_data(), lhsSize, rhsSize);
+			set_factorization_output(_C, std::move(CData), _Q, std::move(QData), _input, _splitPos, rank);
+		} else if(_input.is_sparse()) {
+			misc::FlatMap<size_t, double> qdata, cdata;
 			std::tie(cdata, qdata, rank) = internal::CholmodSparse::cq(_input.get_unsanitized_sparse_data(), false, rhsSize, lhsSize, false);
 			set_factorization_output(_C, std::move(cdata), _Q, std::move(qdata), _input, _splitPos, rank);
 			_Q.use_dense_representation_if_desirable();
@@ -1582,6 +1878,11 @@ namespace xerus {
 	
 	void solve_least_squares(Tensor& _X, const Tensor& _A, const Tensor& _B, const size_t _extraDegree) {
 		REQUIRE(&_X != &_B && &_X != &_A, "Not supportet yet");
+		if(_A.is_single_precision() || _B.is_single_precision()) {
+			Tensor tmpA, tmpB;
+			solve_least_squares(_X, as_double_precision(_A, tmpA), as_double_precision(_B, tmpB), _extraDegree);
+			return;
+		}
 		const size_t degM = _B.degree() - _extraDegree;
 		const size_t degN = _A.degree() - degM;
 		
@@ -1652,6 +1953,11 @@ namespace xerus {
 	
 	
 	void solve(Tensor& _X, const Tensor& _A, const Tensor& _B, const size_t _extraDegree) {
+		if(_A.is_single_precision() || _B.is_single_precision()) {
+			Tensor tmpA, tmpB;
+			solve(_X, as_double_precision(_A, tmpA), as_double_precision(_B, tmpB), _extraDegree);
+			return;
+		}
 		if (_A.is_sparse()) { // TODO
 			solve_least_squares(_X, _A, _B, _extraDegree);
 			return;
@@ -1707,6 +2013,10 @@ namespace xerus {
 	
 	Tensor entrywise_product(const Tensor &_A, const Tensor &_B) {
 		REQUIRE(_A.dimensions == _B.dimensions, "Entrywise product ill-defined for non-equal dimensions.");
+		if(_A.is_single_precision() || _B.is_single_precision()) {
+			Tensor tmpA, tmpB;
+			return entrywise_product(as_double_precision(_A, tmpA), as_double_precision(_B, tmpB));
+		}
 		if(_A.is_dense() && _B.is_dense()) {
 			Tensor result(_A);
 			
@@ -1721,7 +2031,7 @@ namespace xerus {
 		if(_A.is_sparse()) {
 			Tensor result(_A);
 			
-			for(std::pair<const size_t, value_t>& entry : result.get_sparse_data()) {
+			for(std::pair<size_t, value_t>& entry : result.get_sparse_data()) {
 				entry.second *= _B[entry.first];
 			}
 			return result;
@@ -1729,7 +2039,7 @@ namespace xerus {
 		// _B.is_sparse()
 		Tensor result(_B);
 		
-		for(std::pair<const size_t, value_t>& entry : result.get_sparse_data()) {
+		for(std::pair<size_t, value_t>& entry : result.get_sparse_data()) {
 			entry.second *= _A[entry.first];
 		}
 		return result;
@@ -1777,6 +2087,93 @@ namespace xerus {
 	
 	namespace misc {
 		
+		/// @brief Number of entries per block of the binary sparse encoding, bounds the size of the temporary buffers.
+		static const size_t sparseStreamBlockSize = 1ul<<16;
+		
+		static void append_varint(std::vector<unsigned char>& _buffer, size_t _value) {
+			while (_value >= 0x80) {
+				_buffer.push_back(static_cast<unsigned char>(_value | 0x80));
+				_value >>= 7;
+			}
+			_buffer.push_back(static_cast<unsigned char>(_value));
+		}
+		
+		static size_t read_varint(const unsigned char*& _pos, const unsigned char* const _end) {
+			size_t value = 0;
+			for (size_t shift = 0; ; shift += 7) {
+				REQUIRE(_pos < _end && shift < 64, "Corrupted index block in reading sparse Tensor.");
+				const unsigned char byte = *(_pos++);
+				value |= size_t(byte & 0x7F) << shift;
+				if (!(byte & 0x80)) { return value; }
+			}
+		}
+		
+		/**
+		 * @brief Writes the sparse data of @a _obj in blocks of at most sparseStreamBlockSize entries.
+		 * @details Each block consists of the number of entries, the number of bytes of the index array, the index array (differences to the
+		 * previous position as LEB128 varints, typically one or two bytes instead of eight) and the value array (with the factor applied).
+		 */
+		static void write_sparse_blocks(std::ostream &_stream, const Tensor &_obj) {
+			const FlatMap<size_t, value_t>& data = _obj.get_unsanitized_sparse_data();
+			write_to_stream<size_t>(_stream, data.size(), FileFormat::BINARY);
+			
+			std::vector<unsigned char> indexBuffer;
+			std::vector<value_t> valueBuffer;
+			indexBuffer.reserve(2*sparseStreamBlockSize);
+			valueBuffer.reserve(sparseStreamBlockSize);
+			
+			size_t lastPosition = 0;
+			for (auto blockStart = data.begin(); blockStart != data.end(); ) {
+				const auto blockEnd = blockStart + long(std::min(sparseStreamBlockSize, size_t(data.end() - blockStart)));
+				indexBuffer.clear();
+				valueBuffer.clear();
+				for (auto entry = blockStart; entry != blockEnd; ++entry) {
+					append_varint(indexBuffer, entry->first - lastPosition);
+					valueBuffer.push_back(_obj.factor*entry->second);
+					lastPosition = entry->first;
+				}
+				
+				write_to_stream<size_t>(_stream, valueBuffer.size(), FileFormat::BINARY);
+				write_to_stream<size_t>(_stream, indexBuffer.size(), FileFormat::BINARY);
+				_stream.write(reinterpret_cast<const char*>(indexBuffer.data()), std::streamsize(indexBuffer.size()));
+				_stream.write(reinterpret_cast<const char*>(valueBuffer.data()), std::streamsize(valueBuffer.size()*sizeof(value_t)));
+				blockStart = blockEnd;
+			}
+		}
+		
+		/// @brief Reads the blocks written by write_sparse_blocks() directly into the (ordered) sparse storage of @a _obj.
+		static void read_sparse_blocks(std::istream &_stream, Tensor &_obj) {
+			FlatMap<size_t, value_t>& data = _obj.get_unsanitized_sparse_data();
+			const size_t num = read_from_stream<size_t>(_stream, FileFormat::BINARY);
+			REQUIRE(num <= _obj.size, "The stored sparse Tensor has more entries (" << num << ") than its size (" << _obj.size << ").");
+			data.reserve(num);
+			
+			std::vector<unsigned char> indexBuffer;
+			std::vector<value_t> valueBuffer;
+			size_t position = 0;
+			while (data.size() < num) {
+				const size_t blockEntries = read_from_stream<size_t>(_stream, FileFormat::BINARY);
+				const size_t blockBytes = read_from_stream<size_t>(_stream, FileFormat::BINARY);
+				REQUIRE(_stream && blockEntries > 0 && blockEntries <= num - data.size() && blockBytes <= 10*blockEntries, "Corrupted block header in reading sparse Tensor.");
+				
+				indexBuffer.resize(blockBytes);
+				valueBuffer.resize(blockEntries);
+				_stream.read(reinterpret_cast<char*>(indexBuffer.data()), std::streamsize(blockBytes));
+				_stream.read(reinterpret_cast<char*>(valueBuffer.data()), std::streamsize(blockEntries*sizeof(value_t)));
+				REQUIRE(_stream, "Unexpected end of stream in reading sparse Tensor.");
+				
+				const unsigned char* pos = indexBuffer.data();
+				const unsigned char* const end = indexBuffer.data() + indexBuffer.size();
+				for (size_t i = 0; i < blockEntries; ++i) {
+					const size_t delta = read_varint(pos, end);
+					REQUIRE(delta > 0 || data.empty(), "Duplicate position in reading sparse Tensor.");
+					position += delta;
+					REQUIRE(position < _obj.size, "Position " << position << " out of range in reading sparse Tensor.");
+					data.emplace_back(position, valueBuffer[i]);
+				}
+			}
+		}
+		
 		
 		void stream_writer(std::ostream &_stream, const Tensor &_obj, const FileFormat _format) {
 			if(_format == FileFormat::TSV) {
@@ -1790,9 +2187,16 @@ namespace xerus {
 			
 			if (_obj.representation == Tensor::Representation::Dense) {
 				write_to_stream<size_t>(_stream, 1, _format);
-				for (size_t i = 0; i < _obj.size; ++i) {
-					write_to_stream<value_t>(_stream, _obj[i], _format);
+				if (_format == FileFormat::BINARY && !_obj.has_factor() && !_obj.is_single_precision()) {
+					_stream.write(reinterpret_cast<const char*>(_obj.get_unsanitized_dense_data()), std::streamsize(_obj.size*sizeof(value_t)));
+				} else {
+					for (size_t i = 0; i < _obj.size; ++i) {
+						write_to_stream<value_t>(_stream, _obj[i], _format);
+					}
 				}
+			} else if (_format == FileFormat::BINARY) {
+				write_to_stream<size_t>(_stream, 3, _format);
+				write_sparse_blocks(_stream, _obj);
 			} else {
 				write_to_stream<size_t>(_stream, 2, _format);
 				write_to_stream<size_t>(_stream, _obj.get_unsanitized_sparse_data().size(), _format);
@@ -1826,7 +2230,11 @@ namespace xerus {
 					_stream.read(reinterpret_cast<char*>(_obj.get_unsanitized_dense_data()), std::streamoff(_obj.size*sizeof(value_t)));
 				}
 				REQUIRE(_stream, "Unexpected end of stream in reading dense Tensor.");
-			} else { // Sparse 
+			} else if (rep == 3) { // Sparse, block encoded
+				REQUIRE(_format == FileFormat::BINARY, "Block encoded sparse data is only supported in binary streams.");
+				_obj.reset(std::move(dims), Tensor::Representation::Sparse);
+				read_sparse_blocks(_stream, _obj);
+			} else { // Sparse, entry by entry
 				REQUIRE(rep == 2, "Unknown tensor representation " << rep << " in stream");
 				_obj.reset(std::move(dims), Tensor::Representation::Sparse);
 				
@@ -1838,8 +2246,10 @@ namespace xerus {
 					// NOTE inline function calls can be called in any order by the compiler, so we have to cache the results to ensure correct order
 					uint64 pos = read_from_stream<size_t>(_stream, _format);
 					value_t val = read_from_stream<value_t>(_stream, _format);
-					_obj.get_unsanitized_sparse_data().emplace(pos, val);
+					_obj.get_unsanitized_sparse_data().emplace_back_unsorted(pos, val);
 				}
+				// Keep the first occurrence of any duplicate position.
+				_obj.get_unsanitized_sparse_data().sort_and_combine_duplicates([](value_t&, const value_t&){});
 				REQUIRE(_stream, "Unexpected end of stream in reading dense Tensor.");
 			}
 		}
@@ -25,6 +25,10 @@
 #include <xerus/tensorNetwork.h>
 
 #include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <numeric>
 
 #include <xerus/misc/stringUtilities.h>
 #include <xerus/misc/containerSupport.h>
@@ -32,6 +36,7 @@
 #include <xerus/misc/missingFunctions.h>
 #include <xerus/misc/fileIO.h>
 #include <xerus/misc/internal.h>
+#include <xerus/misc/parallel.h>
 
 #include <xerus/basic.h>
 #include <xerus/index.h>
@@ -1034,196 +1039,206 @@ namespace xerus {
 	}
 	
 	
-	void TensorNetwork::contract(const size_t _nodeId1, const size_t _nodeId2) {
-		TensorNode &node1 = nodes[_nodeId1];
-		TensorNode &node2 = nodes[_nodeId2];
-		
-		REQUIRE(!node1.erased, "It appears node1 = " << _nodeId1 << "  was already contracted?");
-		REQUIRE(!node2.erased, "It appears node2 = " << _nodeId2 << "  was already contracted?");
-		INTERNAL_CHECK(externalLinks.size() == degree(), "Internal Error: " << externalLinks.size() << " != " << degree());
-		
-		std::vector<TensorNetwork::Link> newLinks;
-		newLinks.reserve(node1.degree() + node2.degree());
+	/**
+	 * @brief Contracts the tensor objects of the nodes @a _nodeId1 and @a _nodeId2, storing the result in the first one.
+	 * @details The links of the network are only read, cf. merge_node_links(). If @a _lock is given it must be held on entry. It is released 
+	 * while the two tensor objects are reshuffled and contracted and reacquired before returning, i.e. it only protects the access to the links.
+	 */
+	static void contract_node_tensors(TensorNetwork &_network, const size_t _nodeId1, const size_t _nodeId2, std::unique_lock<std::mutex> *_lock) {
+		TensorNetwork::TensorNode &node1 = _network.nodes[_nodeId1];
+		TensorNetwork::TensorNode &node2 = _network.nodes[_nodeId2];
 		
 		if (!node1.tensorObject) {
 			INTERNAL_CHECK(!node2.tensorObject, "Internal Error.");
-			
-			// Determine the links of the resulting tensor (first half)
-			for ( const Link& l : node1.neighbors ) {
-				if (!l.links(_nodeId1) && !l.links(_nodeId2)) {
-					newLinks.emplace_back(l);
-				}
-			}
-			// Determine the links of the resulting tensor (second half)
-			for ( const Link& l : node2.neighbors ) {
-				if (!l.links(_nodeId2) && !l.links(_nodeId1)) {
-					newLinks.emplace_back(l);
+			return;
+		}
+		INTERNAL_CHECK(node2.tensorObject, "Internal Error.");
+		
+		size_t contractedDimCount = 0;
+		bool separated1;
+		bool separated2;
+		bool matchingOrder;
+		
+		// first pass of the links of node1 to determine
+		//   1. the number of links between the two nodes,
+		//   2. determine whether node1 is separated (ownlinks-commonlinks) or transposed separated (commonlinks-ownlinks)
+		if(node1.degree() > 1) {
+			uint_fast8_t switches = 0;
+			bool previous = node1.neighbors[0].links(_nodeId2);
+			for (const TensorNetwork::Link& l : node1.neighbors) {
+				if (l.links(_nodeId2)) {
+					contractedDimCount++;
+					if (!previous) {
+						switches++;
+						previous = true;
+					}
+				} else if (previous) {
+					switches++;
+					previous = false;
 				}
 			}
+			separated1 = (switches < 2);
 		} else {
-			INTERNAL_CHECK(node2.tensorObject, "Internal Error.");
-			
-			size_t contractedDimCount = 0;
-			bool separated1;
-			bool separated2;
-			bool matchingOrder;
-			
-			// first pass of the links of node1 to determine
-			//   1. the number of links between the two nodes,
-			//   2. determine whether node1 is separated (ownlinks-commonlinks) or transposed separated (commonlinks-ownlinks)
-			//   3. determine the links of the resulting tensor (first half)
-			if(node1.degree() > 1) {
-				uint_fast8_t switches = 0;
-				bool previous = node1.neighbors[0].links(_nodeId2);
-				for (const Link& l : node1.neighbors) {
-					if (l.links(_nodeId2)) {
-						contractedDimCount++;
-						if (!previous) {
-							switches++;
-							previous = true;
-						}
-					} else {
-						newLinks.emplace_back(l);
-						if (previous) {
-							switches++;
-							previous = false;
-						}
-					}
-				}
-				separated1 = (switches < 2);
-			} else {
-				if(!node1.neighbors.empty()) {
-					if(node1.neighbors[0].links(_nodeId2)) {
-						contractedDimCount = 1;
-					} else {
-						newLinks.emplace_back(node1.neighbors[0]);
+			if(!node1.neighbors.empty() && node1.neighbors[0].links(_nodeId2)) {
+				contractedDimCount = 1;
+			}
+			separated1 = true;
+		}
+		
+		// first pass of the links of node2 to determine
+		//   1. whether the order of common links is correct
+		//   2. whether any self-links exist
+		//   3. whether the second node is separated
+		if(node2.degree() > 1 && contractedDimCount > 0) {
+			bool previous = node2.neighbors[0].links(_nodeId1);
+			uint_fast8_t switches = 0;
+			size_t lastPosOfCommon = 0;
+			matchingOrder = true;
+			for (const TensorNetwork::Link& l : node2.neighbors) {
+				if (l.links(_nodeId1)) {
+					if (l.indexPosition < lastPosOfCommon) {
+						matchingOrder = false;
 					}
-				}
-				separated1 = true;
-			}
-			
-			// first pass of the links of node2 to determine
-			//   1. whether the order of common links is correct
-			//   2. whether any self-links exist
-			//   3. whether the second node is separated
-			//   4. determine the links of the resulting tensor (second half)
-			if(node2.degree() > 1 && contractedDimCount > 0) {
-				bool previous = node2.neighbors[0].links(_nodeId1);
-				uint_fast8_t switches = 0;
-				size_t lastPosOfCommon = 0;
-				matchingOrder = true;
-				for (const Link& l : node2.neighbors) {
-					if (l.links(_nodeId1)) {
-						if (l.indexPosition < lastPosOfCommon) {
-							matchingOrder = false;
-						}
-						lastPosOfCommon = l.indexPosition;
-						if (!previous) {
-							switches++;
-							previous = true;
-						}
-					} else {
-						newLinks.emplace_back(l);
-						if (previous) {
-							switches++;
-							previous = false;
-						}
+					lastPosOfCommon = l.indexPosition;
+					if (!previous) {
+						switches++;
+						previous = true;
 					}
+				} else if (previous) {
+					switches++;
+					previous = false;
 				}
-				separated2 = (switches < 2);
+			}
+			separated2 = (switches < 2);
+		} else {
+			separated2 = true;
+			matchingOrder = true;
+		}
+		
+		// Determine which (if any) node should be reshuffled
+		// if order of common links does not match, reshuffle the smaller one
+		if (!matchingOrder && separated1 && separated2) {
+			if (node1.size() < node2.size()) {
+				separated1 = false;
 			} else {
-				if(contractedDimCount == 0) {
-					newLinks.insert(newLinks.end(), node2.neighbors.begin(), node2.neighbors.end());
-				}
-				
-				separated2 = true;
-				matchingOrder = true;
+				separated2 = false;
 			}
+		}
+		
+		// shuffle of the first node
+		std::vector<size_t> shuffle1;
+		if (!separated1) {
+			shuffle1.resize(node1.degree());
+			size_t pos = 0;
 			
-			// Determine which (if any) node should be reshuffled
-			// if order of common links does not match, reshuffle the smaller one
-			if (!matchingOrder && separated1 && separated2) {
-				if (node1.size() < node2.size()) {
-					separated1 = false;
-				} else {
-					separated2 = false;
+			for (size_t d = 0; d < node1.degree(); ++d) {
+				if (!node1.neighbors[d].links(_nodeId2)) {
+					shuffle1[d] = pos++;
 				}
 			}
 			
-			// reshuffle first node
-			if (!separated1) {
-				std::vector<size_t> shuffle(node1.degree());
-				size_t pos = 0;
-				
-				for (size_t d = 0; d < node1.degree(); ++d) {
-					if (!node1.neighbors[d].links(_nodeId2)) {
-						shuffle[d] = pos++;
-					}
-				}
-				
-				for (const Link& l : node2.neighbors) {
-					if (l.links(_nodeId1)) {
-						shuffle[l.indexPosition] = pos++;
-					}
+			for (const TensorNetwork::Link& l : node2.neighbors) {
+				if (l.links(_nodeId1)) {
+					shuffle1[l.indexPosition] = pos++;
 				}
-				
-				INTERNAL_CHECK(pos == node1.degree(), "IE");
-				reshuffle(*node1.tensorObject, *node1.tensorObject, shuffle);
-				
-				matchingOrder = true;
 			}
 			
-			// reshuffle second node
-			if (!separated2) {
-				std::vector<size_t> shuffle(node2.degree());
-				size_t pos = 0;
-				
-				if (matchingOrder) {
-					// Add common links in order as they appear in node2 to avoid both nodes changing to the opposite link order
-					for (size_t d = 0; d < node2.degree(); ++d) {
-						if (node2.neighbors[d].links(_nodeId1)) {
-							shuffle[d] = pos++;
-						}
-					}
-				} else {
-					for (const Link& l : node1.neighbors) {
-						if (l.links(_nodeId2)) {
-							shuffle[l.indexPosition] = pos++;
-						}
+			INTERNAL_CHECK(pos == node1.degree(), "IE");
+			matchingOrder = true;
+		}
+		
+		// shuffle of the second node
+		std::vector<size_t> shuffle2;
+		if (!separated2) {
+			shuffle2.resize(node2.degree());
+			size_t pos = 0;
+			
+			if (matchingOrder) {
+				// Add common links in order as they appear in node2 to avoid both nodes changing to the opposite link order
+				for (size_t d = 0; d < node2.degree(); ++d) {
+					if (node2.neighbors[d].links(_nodeId1)) {
+						shuffle2[d] = pos++;
 					}
 				}
-				
-				for (size_t d = 0; d < node2.degree(); ++d) {
-					if (!node2.neighbors[d].links(_nodeId1)) {
-						shuffle[d] = pos++;
+			} else {
+				for (const TensorNetwork::Link& l : node1.neighbors) {
+					if (l.links(_nodeId2)) {
+						shuffle2[l.indexPosition] = pos++;
 					}
 				}
-				
-				INTERNAL_CHECK(pos == node2.degree(), "IE");
-				reshuffle(*node2.tensorObject, *node2.tensorObject, shuffle);
 			}
 			
-			const bool trans1 = separated1 && !node1.neighbors.empty() && node1.neighbors[0].links(_nodeId2);
-			const bool trans2 = separated2 &&!node2.neighbors.empty() &&!(node2.neighbors[0].links(_nodeId1));
+			for (size_t d = 0; d < node2.degree(); ++d) {
+				if (!node2.neighbors[d].links(_nodeId1)) {
+					shuffle2[d] = pos++;
+				}
+			}
 			
-			xerus::contract(*node1.tensorObject, *node1.tensorObject, trans1, *node2.tensorObject, trans2, contractedDimCount);
+			INTERNAL_CHECK(pos == node2.degree(), "IE");
+		}
+		
+		const bool trans1 = separated1 && !node1.neighbors.empty() && node1.neighbors[0].links(_nodeId2);
+		const bool trans2 = separated2 &&!node2.neighbors.empty() &&!(node2.neighbors[0].links(_nodeId1));
+		
+		// The numerical part only touches the two tensor objects
+		if (_lock) { _lock->unlock(); }
+		
+		if (!separated1) {
+			reshuffle(*node1.tensorObject, *node1.tensorObject, shuffle1);
+		}
+		if (!separated2) {
+			reshuffle(*node2.tensorObject, *node2.tensorObject, shuffle2);
+		}
+		xerus::contract(*node1.tensorObject, *node1.tensorObject, trans1, *node2.tensorObject, trans2, contractedDimCount);
+		
+		if (_lock) { _lock->lock(); }
+	}
+	
+	
+	/// @brief Replaces the links of @a _nodeId1 by those of the contraction with @a _nodeId2 (as computed by contract_node_tensors()) and erases @a _nodeId2.
+	static void merge_node_links(TensorNetwork &_network, const size_t _nodeId1, const size_t _nodeId2) {
+		TensorNetwork::TensorNode &node1 = _network.nodes[_nodeId1];
+		TensorNetwork::TensorNode &node2 = _network.nodes[_nodeId2];
+		
+		// The remaining links of node1 followed by those of node2, which is the mode order of the contracted tensor
+		std::vector<TensorNetwork::Link> newLinks;
+		newLinks.reserve(node1.degree() + node2.degree());
+		for (const TensorNetwork::Link& l : node1.neighbors) {
+			if (!l.links(_nodeId2)) {
+				newLinks.emplace_back(l);
+			}
+		}
+		for (const TensorNetwork::Link& l : node2.neighbors) {
+			if (!l.links(_nodeId1)) {
+				newLinks.emplace_back(l);
+			}
 		}
 		
 		// Set Nodes
-		nodes[_nodeId1].neighbors = std::move(newLinks);
-		nodes[_nodeId2].erase();
+		node1.neighbors = std::move(newLinks);
+		node2.erase();
 		
 		// Fix indices of other nodes // note that the indices that were previously part of node1 might also have changed
-		for (size_t d = 0; d < nodes[_nodeId1].neighbors.size(); ++d) {
-			const Link& l = nodes[_nodeId1].neighbors[d];
+		for (size_t d = 0; d < node1.neighbors.size(); ++d) {
+			const TensorNetwork::Link& l = node1.neighbors[d];
 			if (l.external) {
-				externalLinks[l.indexPosition].other = _nodeId1;
-				externalLinks[l.indexPosition].indexPosition = d;
+				_network.externalLinks[l.indexPosition].other = _nodeId1;
+				_network.externalLinks[l.indexPosition].indexPosition = d;
 			} else {
-				nodes[l.other].neighbors[l.indexPosition].other = _nodeId1;
-				nodes[l.other].neighbors[l.indexPosition].indexPosition = d;
+				_network.nodes[l.other].neighbors[l.indexPosition].other = _nodeId1;
+				_network.nodes[l.other].neighbors[l.indexPosition].indexPosition = d;
 			}
 		}
+	}
+	
+	
+	void TensorNetwork::contract(const size_t _nodeId1, const size_t _nodeId2) {
+		REQUIRE(!nodes[_nodeId1].erased, "It appears node1 = " << _nodeId1 << "  was already contracted?");
+		REQUIRE(!nodes[_nodeId2].erased, "It appears node2 = " << _nodeId2 << "  was already contracted?");
+		INTERNAL_CHECK(externalLinks.size() == degree(), "Internal Error: " << externalLinks.size() << " != " << degree());
+		
+		contract_node_tensors(*this, _nodeId1, _nodeId2, nullptr);
+		merge_node_links(*this, _nodeId1, _nodeId2);
 		
 		require_valid_network(false);
 	}
@@ -1237,19 +1252,182 @@ namespace xerus {
 			return static_cast<double>(nodes[_nodeId1].size()); // Costs of a trace
 		}
 		
-		//TODO add correct calculation for sparse matrices
-		
-		// Assume cost of mxr * rxn = m*n*r (which is a rough approximation of the actual cost for openBlas/Atlas)
-		size_t cost = nodes[_nodeId1].size();
+		// Assume cost of mxr * rxn = m*n*r (which is a rough approximation of the actual cost for openBlas/Atlas), unless the nodes are sparse
+		double m = 1, n = 1, r = 1;
+		for(const Link& neighbor : nodes[_nodeId1].neighbors) {
+			if(neighbor.links(_nodeId2)) {
+				r *= static_cast<double>(neighbor.dimension);
+			} else {
+				m *= static_cast<double>(neighbor.dimension);
+			}
+		}
 		for(const Link& neighbor : nodes[_nodeId2].neighbors) {
 			if(!neighbor.links(_nodeId1)) {
-				cost *= neighbor.dimension;
+				n *= static_cast<double>(neighbor.dimension);
 			}
 		}
-		return static_cast<double>(cost);
+		return internal::contraction_cost(m, n, r, node_sparsity(_nodeId1), node_sparsity(_nodeId2));
+	}
+	
+	
+	double TensorNetwork::node_sparsity(const size_t _nodeId) const {
+		const TensorNode& node = nodes[_nodeId];
+		return static_cast<double>(node.tensorObject ? node.tensorObject->sparsity() : node.size());
 	}
 
 
+	/**
+	 * @brief Estimates the number of entries of the result and the cost of every step of the contraction order @a _contractions.
+	 * @details All nodes are assumed to be dense. Every node is described by the sorted (edge, dimension) pairs of its links.
+	 */
+	static void estimate_contraction_steps(const TensorNetwork &_network, const std::vector<std::pair<size_t, size_t>> &_contractions, std::vector<double> &_sizes, std::vector<double> &_costs) {
+		std::vector<std::vector<std::pair<size_t, size_t>>> edges(_network.nodes.size());
+		size_t numEdges = 0;
+		for (size_t id = 0; id < _network.nodes.size(); ++id) {
+			for (const TensorNetwork::Link &l : _network.nodes[id].neighbors) {
+				if (l.external || id <= l.other) {
+					edges[id].emplace_back(numEdges++, l.dimension);
+				} else {
+					edges[id].emplace_back(edges[l.other][l.indexPosition].first, l.dimension);
+				}
+			}
+		}
+		for (std::vector<std::pair<size_t, size_t>> &nodeEdges : edges) {
+			std::sort(nodeEdges.begin(), nodeEdges.end());
+		}
+		
+		_sizes.resize(_contractions.size());
+		_costs.resize(_contractions.size());
+		std::vector<std::pair<size_t, size_t>> merged;
+		for (size_t k = 0; k < _contractions.size(); ++k) {
+			std::vector<std::pair<size_t, size_t>> &a = edges[_contractions[k].first];
+			std::vector<std::pair<size_t, size_t>> &b = edges[_contractions[k].second];
+			
+			double size = 1.0, common = 1.0;
+			merged.clear();
+			auto itrA = a.begin(), itrB = b.begin();
+			while (itrA != a.end() || itrB != b.end()) {
+				if (itrB == b.end() || (itrA != a.end() && itrA->first < itrB->first)) {
+					size *= static_cast<double>(itrA->second);
+					merged.emplace_back(*(itrA++));
+				} else if (itrA == a.end() || itrB->first < itrA->first) {
+					size *= static_cast<double>(itrB->second);
+					merged.emplace_back(*(itrB++));
+				} else {
+					common *= static_cast<double>(itrA->second);
+					++itrA; ++itrB;
+				}
+			}
+			
+			_sizes[k] = size;
+			_costs[k] = size*common;
+			a.swap(merged);
+			b.clear();
+		}
+	}
+	
+	
+	/**
+	 * @brief Performs the pairwise contractions @a _contractions in the network.
+	 * @details Each step depends on the last preceding steps that involve either of its nodes. If this dependency graph has independent 
+	 * branches, the steps are executed concurrently: every thread repeatedly takes the first ready step (in the given order) and contracts 
+	 * its tensor objects, while the links of the network are only accessed under a common lock. A step is only started if the estimated
+	 * size of all intermediate results that exist at the same time stays below internal::parallelContractionMemory.
+	 */
+	static void execute_contractions(TensorNetwork &_network, const std::vector<std::pair<size_t, size_t>> &_contractions) {
+		const size_t numSteps = _contractions.size();
+		
+		std::vector<size_t> lastStep(_network.nodes.size(), ~0ul);
+		std::vector<std::vector<size_t>> inputs(numSteps);
+		std::vector<std::vector<size_t>> dependents(numSteps);
+		std::set<size_t> ready;
+		for (size_t k = 0; k < numSteps; ++k) {
+			for (const size_t id : {_contractions[k].first, _contractions[k].second}) {
+				if (lastStep[id] < numSteps) {
+					inputs[k].emplace_back(lastStep[id]);
+					dependents[lastStep[id]].emplace_back(k);
+				}
+				lastStep[id] = k;
+			}
+			if (inputs[k].empty()) {
+				ready.emplace_hint(ready.end(), k);
+			}
+		}
+		
+		// In a contraction tree with a single leaf every step depends on its predecessor
+		size_t numThreads = 1;
+		std::vector<double> sizes, costs;
+		if (ready.size() > 1 && misc::get_num_threads(~0ul) > 1) {
+			estimate_contraction_steps(_network, _contractions, sizes, costs);
+			const double totalCost = std::accumulate(costs.begin(), costs.end(), 0.0);
+			numThreads = std::min(ready.size(), misc::get_num_threads(static_cast<size_t>(std::min(totalCost, 1e18))));
+		}
+		
+		if (numThreads < 2) {
+			for (const std::pair<size_t, size_t> &c : _contractions) {
+				_network.contract(c.first, c.second);
+			}
+			return;
+		}
+		
+		std::vector<size_t> missingInputs(numSteps);
+		for (size_t k = 0; k < numSteps; ++k) {
+			missingInputs[k] = inputs[k].size();
+		}
+		
+		std::mutex mutex; // Guards the links of the network and the scheduling state
+		std::condition_variable stepFinished;
+		double liveSize = 0.0; // Estimated number of entries of all intermediate results that are being computed or not yet consumed
+		size_t running = 0, finished = 0;
+		std::exception_ptr error;
+		
+		#pragma omp parallel num_threads(numThreads)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (finished < numSteps && !error) {
+				// If nothing is running the first ready step is taken regardless of its size to ensure progress
+				auto next = ready.begin();
+				while (next != ready.end() && running > 0 && liveSize + sizes[*next] > static_cast<double>(internal::parallelContractionMemory)) {
+					++next;
+				}
+				if (next == ready.end()) {
+					stepFinished.wait(lock);
+					continue;
+				}
+				
+				const size_t k = *next;
+				ready.erase(next);
+				running++;
+				liveSize += sizes[k];
+				
+				try {
+					contract_node_tensors(_network, _contractions[k].first, _contractions[k].second, &lock);
+					merge_node_links(_network, _contractions[k].first, _contractions[k].second);
+				} catch (...) {
+					if (!lock.owns_lock()) { lock.lock(); }
+					error = std::current_exception();
+				}
+				
+				running--;
+				finished++;
+				for (const size_t input : inputs[k]) {
+					liveSize -= sizes[input];
+				}
+				for (const size_t dependent : dependents[k]) {
+					if (--missingInputs[dependent] == 0) {
+						ready.emplace(dependent);
+					}
+				}
+				stepFinished.notify_all();
+			}
+		}
+		
+		if (error) { std::rethrow_exception(error); }
+		
+		_network.require_valid_network(false);
+	}
+	
+	
 	size_t TensorNetwork::contract(const std::set<size_t>& _ids) {
 		// Trace out all single-node traces
 		for ( const size_t id : _ids ) {
@@ -1294,10 +1472,14 @@ namespace xerus {
 					sc *= static_cast<double>(nc.neighbors[d].dimension);
 				}
 			}
-			// cost of contraction a-b first etc.
-			double costAB = sa*sb*sac*sbc*(sab+sc); // (sa*sac)*sab*(sb*sbc) + sa*sb*sac*sbc*sc;
-			double costAC = sa*sc*sab*sbc*(sac+sb); 
-			double costBC = sb*sc*sab*sac*(sbc+sa);
+			// cost of contraction a-b first etc. (for dense nodes e.g. costAB = (sa*sac)*sab*(sb*sbc) + sa*sb*sac*sbc*sc)
+			const double spa = node_sparsity(a), spb = node_sparsity(b), spc = node_sparsity(c);
+			const double costAB = internal::contraction_cost(sa*sac, sb*sbc, sab, spa, spb) 
+				+ internal::contraction_cost(sa*sb, sc, sac*sbc, internal::contraction_sparsity(sa*sac, sb*sbc, sab, spa, spb), spc);
+			const double costAC = internal::contraction_cost(sa*sab, sc*sbc, sac, spa, spc) 
+				+ internal::contraction_cost(sa*sc, sb, sab*sbc, internal::contraction_sparsity(sa*sab, sc*sbc, sac, spa, spc), spb);
+			const double costBC = internal::contraction_cost(sb*sab, sc*sac, sbc, spb, spc) 
+				+ internal::contraction_cost(sb*sc, sa, sab*sac, internal::contraction_sparsity(sb*sab, sc*sac, sbc, spb, spc), spa);
 			
 			if (costAB < costAC && costAB < costBC) {
 				LOG(TNContract, "contraction of ab first " << sa << " " << sb << " " << sc << " " << sab << " " << sbc << " " << sac);
@@ -1313,21 +1495,53 @@ namespace xerus {
 		}
 		
 		
-		TensorNetwork strippedNetwork = stripped_subnet([&](size_t _id){ return misc::contains(_ids, _id); }); 
-		double bestCost = std::numeric_limits<double>::max();
-		std::vector<std::pair<size_t, size_t>> bestOrder;
+		// Describe the structure of the subnetwork, which determines the contraction order
+		const std::vector<size_t> ids(_ids.begin(), _ids.end());
+		std::vector<size_t> localIds(nodes.size(), 0);
+		for (size_t k = 0; k < ids.size(); ++k) { localIds[ids[k]] = k+1; }
 		
-		// Ask the heuristics
-		for (const internal::ContractionHeuristic &c : internal::contractionHeuristics) {
-			c(bestCost, bestOrder, strippedNetwork);
+		std::vector<size_t> structure;
+		structure.emplace_back(ids.size());
+		for (const size_t id : ids) {
+			structure.emplace_back(nodes[id].degree());
+			structure.emplace_back(internal::sparsity_class(nodes[id].size(), static_cast<size_t>(node_sparsity(id))));
+			for (const Link &l : nodes[id].neighbors) {
+				structure.emplace_back(l.dimension);
+				structure.emplace_back(l.external ? 0 : localIds[l.other]);
+			}
 		}
 		
-		INTERNAL_CHECK(bestCost < std::numeric_limits<double>::max() && !bestOrder.empty(), "Internal Error.");
-		
-		for (const std::pair<size_t,size_t> &c : bestOrder) {
-			contract(c.first, c.second);
+		std::vector<std::pair<size_t, size_t>> bestOrder;
+		if (internal::find_cached_contractions(structure, bestOrder)) {
+			for (std::pair<size_t, size_t> &c : bestOrder) {
+				c.first = ids[c.first];
+				c.second = ids[c.second];
+			}
+		} else {
+			TensorNetwork strippedNetwork = stripped_subnet([&](size_t _id){ return misc::contains(_ids, _id); }); 
+			std::vector<double> sparsities(nodes.size(), 0.0);
+			for (const size_t id : _ids) {
+				sparsities[id] = node_sparsity(id);
+			}
+			double bestCost = std::numeric_limits<double>::max();
+			
+			// Ask the heuristics
+			for (const internal::ContractionHeuristic &c : internal::contractionHeuristics) {
+				c(bestCost, bestOrder, strippedNetwork, sparsities);
+			}
+			
+			INTERNAL_CHECK(bestCost < std::numeric_limits<double>::max() && !bestOrder.empty(), "Internal Error.");
+			
+			std::vector<std::pair<size_t, size_t>> localOrder(bestOrder);
+			for (std::pair<size_t, size_t> &c : localOrder) {
+				c.first = localIds[c.first]-1;
+				c.second = localIds[c.second]-1;
+			}
+			internal::cache_contractions(std::move(structure), std::move(localOrder));
 		}
 		
+		execute_contractions(*this, bestOrder);
+		
 		// Note: no sanitization as eg. TTStacks require the indices not to change after calling this function
 		return bestOrder.back().first;
 	}
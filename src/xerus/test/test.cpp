@@ -106,6 +106,7 @@ namespace xerus { namespace misc {
 #endif
 		}
 		::xerus::misc::randomEngine.seed(_seed);
+		::xerus::misc::defaultNormalDistribution.reset(); // drops a cached sample, otherwise the random data depends on the previous tests
 		
 		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 		try {
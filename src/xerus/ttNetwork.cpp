@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <functional>
 
 #include <xerus/ttNetwork.h>
 
@@ -34,6 +35,8 @@
 
 #include <xerus/basic.h>
 #include <xerus/misc/basicArraySupport.h>
+#include <xerus/misc/parallel.h>
+#include <xerus/blasLapackWrapper.h>
 #include <xerus/index.h>
 #include <xerus/tensor.h>
 #include <xerus/ttStack.h>
@@ -511,6 +514,126 @@ namespace xerus {
 	}
 	
 	
+	/// Reorders the dense data of a component from (left, slice, right) to (slice, left, right), widening single precision data to double.
+	template<class T>
+	static void copy_component_slices(value_t* const _slices, const T* const _data, const value_t _factor, const size_t _leftRank, const size_t _numSlices, const size_t _rightRank) {
+		for (size_t l = 0; l < _leftRank; ++l) {
+			for (size_t s = 0; s < _numSlices; ++s) {
+				for (size_t r = 0; r < _rightRank; ++r) {
+					_slices[(s*_leftRank + l)*_rightRank + r] = _factor*static_cast<value_t>(_data[(l*_numSlices + s)*_rightRank + r]);
+				}
+			}
+		}
+	}
+	
+	
+	template<bool isOperator>
+	std::vector<value_t> TTNetwork<isOperator>::evaluate_batch(const std::vector<Tensor::MultiIndex>& _positions) const {
+		require_correct_format();
+		IF_CHECK(
+			for (const Tensor::MultiIndex& position : _positions) {
+				REQUIRE(position.size() == degree(), "Position " << position << " has wrong degree, expected " << degree() << ".");
+				for (size_t i = 0; i < degree(); ++i) {
+					REQUIRE(position[i] < dimensions[i], "Position " << position << " out of range for dimensions " << dimensions << ".");
+				}
+			}
+		);
+		
+		const size_t numComponents = degree()/N;
+		const size_t batchSize = _positions.size();
+		
+		if (numComponents == 0) {
+			return std::vector<value_t>(batchSize, (*nodes[0].tensorObject)[0]);
+		}
+		
+		// Store the slices of each component contiguously, i.e. reorder each component to (slice, left, right)
+		std::vector<std::vector<value_t>> slices(numComponents);
+		size_t work = 0;
+		for (size_t i = 0; i < numComponents; ++i) {
+			const Tensor& comp = get_component(i);
+			const size_t leftRank = comp.dimensions.front();
+			const size_t rightRank = comp.dimensions.back();
+			const size_t numSlices = comp.size/(leftRank*rightRank);
+			slices[i].resize(comp.size, 0.0);
+			
+			if (comp.is_single_precision()) {
+				copy_component_slices(slices[i].data(), comp.get_unsanitized_single_data(), comp.factor, leftRank, numSlices, rightRank);
+			} else if (comp.is_dense()) {
+				copy_component_slices(slices[i].data(), comp.get_unsanitized_dense_data(), comp.factor, leftRank, numSlices, rightRank);
+			} else {
+				for (const auto& entry : comp.get_unsanitized_sparse_data()) {
+					const size_t l = entry.first/(numSlices*rightRank);
+					const size_t s = (entry.first/rightRank)%numSlices;
+					const size_t r = entry.first%rightRank;
+					slices[i][(s*leftRank + l)*rightRank + r] = comp.factor*entry.second;
+				}
+			}
+			work += leftRank*rightRank;
+		}
+		
+		const value_t boundaryFactor = (*nodes.front().tensorObject)[0] * (*nodes.back().tensorObject)[0];
+		std::vector<value_t> result(batchSize);
+		
+		const size_t numThreads = misc::get_num_threads(batchSize*work);
+		
+		#pragma omp parallel for num_threads(numThreads) schedule(static)
+		for (size_t thread = 0; thread < numThreads; ++thread) {
+			const size_t begin = thread*batchSize/numThreads;
+			const size_t end = (thread+1)*batchSize/numThreads;
+			const size_t localSize = end - begin;
+			
+			// Row k of current holds the partial product of the position order[k]
+			std::vector<size_t> order(localSize), newOrder(localSize), sliceStart, sliceFill;
+			for (size_t k = 0; k < localSize; ++k) { order[k] = begin + k; }
+			std::vector<value_t> current(localSize, boundaryFactor), gathered, next;
+			
+			for (size_t i = 0; i < numComponents; ++i) {
+				const Tensor& comp = get_component(i);
+				const size_t leftRank = comp.dimensions.front();
+				const size_t rightRank = comp.dimensions.back();
+				const size_t numSlices = comp.size/(leftRank*rightRank);
+				const auto slice_of = [&](const size_t _position) {
+					return isOperator ? _positions[_position][i]*dimensions[numComponents+i] + _positions[_position][numComponents+i] : _positions[_position][i];
+				};
+				
+				// Group the partial products by the slice they have to be multiplied with (stable counting sort)
+				sliceStart.assign(numSlices+1, 0);
+				for (size_t k = 0; k < localSize; ++k) {
+					sliceStart[slice_of(order[k])+1]++;
+				}
+				for (size_t s = 0; s < numSlices; ++s) {
+					sliceStart[s+1] += sliceStart[s];
+				}
+				
+				sliceFill.assign(sliceStart.begin(), sliceStart.end()-1);
+				gathered.resize(localSize*leftRank);
+				for (size_t k = 0; k < localSize; ++k) {
+					const size_t target = sliceFill[slice_of(order[k])]++;
+					newOrder[target] = order[k];
+					misc::copy(gathered.data()+target*leftRank, current.data()+k*leftRank, leftRank);
+				}
+				
+				// One matrix-matrix product per slice
+				next.resize(localSize*rightRank);
+				for (size_t s = 0; s < numSlices; ++s) {
+					const size_t count = sliceStart[s+1] - sliceStart[s];
+					if (count == 0) { continue; }
+					blasWrapper::matrix_matrix_product(next.data()+sliceStart[s]*rightRank, count, rightRank, 1.0, gathered.data()+sliceStart[s]*leftRank, false, leftRank, slices[i].data()+s*leftRank*rightRank, false);
+				}
+				
+				std::swap(order, newOrder);
+				std::swap(current, next);
+			}
+			
+			for (size_t k = 0; k < localSize; ++k) {
+				result[order[k]] = current[k];
+			}
+		}
+		
+		return result;
+	}
+	
+	
 	template<bool isOperator>
 	std::pair<TensorNetwork, TensorNetwork> TTNetwork<isOperator>::chop(const size_t _position) const {
 		require_correct_format();
@@ -665,6 +788,184 @@ namespace xerus {
 	}
 	
 	
+	/**
+	 * @brief Eigendecomposition of the Gram matrix @a _gram of a bond.
+	 * @returns the positions of the eigenvalues that are numerically nonzero, in descending order of the eigenvalues.
+	 */
+	static std::vector<size_t> gram_eigen_decomposition(std::unique_ptr<value_t[]>& _V, std::unique_ptr<value_t[]>& _lambda, Tensor _gram) {
+		const size_t r = _gram.dimensions[0];
+		_gram.use_dense_representation();
+		_V.reset(new value_t[r*r]);
+		_lambda.reset(new value_t[r]);
+		blasWrapper::symmetric_eigen_decomposition(_V.get(), _lambda.get(), _gram.get_dense_data(), r);
+		
+		// Eigenvalues below the accuracy of the Gram matrix are treated as zero
+		const value_t threshold = static_cast<value_t>(r)*EPSILON*_lambda[r-1];
+		std::vector<size_t> nonzero;
+		for (size_t i = r; i > 0 && _lambda[i-1] > threshold; --i) {
+			nonzero.push_back(i-1);
+		}
+		return nonzero;
+	}
+	
+	
+	/**
+	 * @brief Calculates the factors that truncate a single bond, given the Gram matrices of its left and right interface.
+	 * @details With the eigendecompositions G_L = V_L D_L V_L^T and G_R = V_R D_R V_R^T, the singular values of the matrification at the bond
+	 * are those of M = D_L^(1/2) V_L^T V_R D_R^(1/2) = U S W^T. Truncating this SVD to rank s, the bond is replaced by the product of 
+	 * P = V_L D_L^(-1/2) U_s S_s^(1/2) and Q = S_s^(1/2) W_s^T D_R^(-1/2) V_R^T.
+	 * @returns the pair (P, Q).
+	 */
+	static std::pair<Tensor, Tensor> gram_bond_truncation(const Tensor& _leftGram, const Tensor& _rightGram, const size_t _maxRank, const double _eps) {
+		const size_t r = _leftGram.dimensions[0];
+		
+		std::unique_ptr<value_t[]> leftV, leftLambda, rightV, rightLambda;
+		const std::vector<size_t> left = gram_eigen_decomposition(leftV, leftLambda, _leftGram);
+		const std::vector<size_t> right = gram_eigen_decomposition(rightV, rightLambda, _rightGram);
+		
+		if (left.empty() || right.empty()) {
+			return std::make_pair(Tensor({r, 1}), Tensor({1, r}));
+		}
+		
+		const size_t numLeft = left.size(), numRight = right.size();
+		std::unique_ptr<value_t[]> M(new value_t[numLeft*numRight]);
+		for (size_t a = 0; a < numLeft; ++a) {
+			for (size_t b = 0; b < numRight; ++b) {
+				value_t overlap = 0.0;
+				for (size_t j = 0; j < r; ++j) {
+					overlap += leftV[j*r+left[a]]*rightV[j*r+right[b]];
+				}
+				M[a*numRight+b] = std::sqrt(leftLambda[left[a]]*rightLambda[right[b]])*overlap;
+			}
+		}
+		
+		const size_t maxRank = std::min(numLeft, numRight);
+		std::unique_ptr<value_t[]> U(new value_t[numLeft*maxRank]), S(new value_t[maxRank]), Wt(new value_t[maxRank*numRight]);
+		blasWrapper::svd_destructive(U.get(), S.get(), Wt.get(), M.get(), numLeft, numRight);
+		
+		size_t rank = std::min(maxRank, _maxRank);
+		for (size_t s = 1; s < rank; ++s) {
+			if (S[s] <= _eps*S[0]) {
+				rank = s;
+				break;
+			}
+		}
+		
+		Tensor P({r, rank}, Tensor::Representation::Dense), Q({rank, r}, Tensor::Representation::Dense);
+		value_t* const pData = P.get_dense_data();
+		value_t* const qData = Q.get_dense_data();
+		for (size_t a = 0; a < numLeft; ++a) {
+			const value_t scale = 1.0/std::sqrt(leftLambda[left[a]]);
+			for (size_t s = 0; s < rank; ++s) {
+				const value_t factor = scale*U[a*maxRank+s]*std::sqrt(S[s]);
+				for (size_t j = 0; j < r; ++j) {
+					pData[j*rank+s] += leftV[j*r+left[a]]*factor;
+				}
+			}
+		}
+		for (size_t b = 0; b < numRight; ++b) {
+			const value_t scale = 1.0/std::sqrt(rightLambda[right[b]]);
+			for (size_t s = 0; s < rank; ++s) {
+				const value_t factor = scale*Wt[s*numRight+b]*std::sqrt(S[s]);
+				for (size_t j = 0; j < r; ++j) {
+					qData[s*r+j] += rightV[j*r+right[b]]*factor;
+				}
+			}
+		}
+		
+		return std::make_pair(std::move(P), std::move(Q));
+	}
+	
+	
+	template<bool isOperator>
+	void TTNetwork<isOperator>::round(const std::vector<size_t>& _maxRanks, const double _eps, const RoundingMode _mode) {
+		if (_mode == RoundingMode::Sweep) {
+			round(_maxRanks, _eps);
+			return;
+		}
+		REQUIRE(_mode == RoundingMode::Gram, "Unknown rounding mode.");
+		
+		require_correct_format();
+		const size_t numComponents = degree()/N;
+		REQUIRE(_eps < 1, "_eps must be smaller than one. " << _eps << " was given.");
+		REQUIRE(_maxRanks.size()+1 == numComponents || (_maxRanks.empty() && numComponents == 0), "There must be exactly degree/N-1 maxRanks. Here " << _maxRanks.size() << " instead of " << numComponents-1 << " are given.");
+		REQUIRE(!misc::contains(_maxRanks, size_t(0)), "Trying to round a TTTensor to rank 0 is not possible.");
+		
+		if (numComponents < 2) { return; }
+		
+		const bool initialCanonicalization = canonicalized;
+		const size_t initialCorePosition = corePosition;
+		
+		size_t work = 0;
+		for (size_t k = 0; k < numComponents; ++k) {
+			const Tensor& comp = get_component(k);
+			work += comp.size*std::max(comp.dimensions.front(), comp.dimensions.back());
+		}
+		const size_t numThreads = misc::get_num_threads(work);
+		
+		// leftGram[k] belongs to the interface of the components 0,...,k and rightGram[k] to that of the components k+1,...,numComponents-1
+		std::vector<Tensor> leftGram(numComponents-1), rightGram(numComponents-1);
+		#pragma omp parallel sections num_threads(std::min(numThreads, size_t(2)))
+		{
+			#pragma omp section
+			{
+				Tensor tmp;
+				const Tensor& first = get_component(0);
+				xerus::contract(leftGram[0], first, true, first, false, N+1);
+				for (size_t k = 1; k+1 < numComponents; ++k) {
+					const Tensor& comp = get_component(k);
+					xerus::contract(tmp, leftGram[k-1], false, comp, false, 1);
+					xerus::contract(leftGram[k], comp, true, tmp, false, N+1);
+				}
+			}
+			
+			#pragma omp section
+			{
+				Tensor tmp;
+				const Tensor& last = get_component(numComponents-1);
+				xerus::contract(rightGram[numComponents-2], last, false, last, true, N+1);
+				for (size_t k = numComponents-2; k > 0; --k) {
+					const Tensor& comp = get_component(k);
+					xerus::contract(tmp, comp, false, rightGram[k], false, 1);
+					xerus::contract(rightGram[k-1], tmp, false, comp, true, N+1);
+				}
+			}
+		}
+		
+		// leftFactors[k] is applied to the right of component k and rightFactors[k] to the left of component k+1
+		std::vector<Tensor> leftFactors(numComponents-1), rightFactors(numComponents-1);
+		#pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+		for (size_t k = 0; k < numComponents-1; ++k) {
+			std::tie(leftFactors[k], rightFactors[k]) = gram_bond_truncation(leftGram[k], rightGram[k], _maxRanks[k], _eps);
+		}
+		
+		std::vector<Tensor> newComponents(numComponents);
+		#pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+		for (size_t k = 0; k < numComponents; ++k) {
+			Tensor tmp;
+			const Tensor* comp = &get_component(k);
+			if (k > 0) {
+				xerus::contract(tmp, rightFactors[k-1], false, *comp, false, 1);
+				comp = &tmp;
+			}
+			if (k+1 < numComponents) {
+				xerus::contract(newComponents[k], *comp, false, leftFactors[k], false, 1);
+			} else {
+				newComponents[k] = std::move(tmp);
+			}
+		}
+		
+		for (size_t k = 0; k < numComponents; ++k) {
+			set_component(k, std::move(newComponents[k]));
+		}
+		canonicalized = false;
+		
+		if(initialCanonicalization) {
+			move_core(initialCorePosition);
+		}
+	}
+	
+	
 	template<bool isOperator>
 	void TTNetwork<isOperator>::round(const size_t _maxRank) {
 		round(std::vector<size_t>(num_ranks(), _maxRank), EPSILON);
@@ -1257,7 +1558,7 @@ namespace xerus {
 			}
 		} else {
 			const std::vector<std::vector<std::tuple<size_t, size_t, value_t>>> groupedEntriesB = get_grouped_entries<isOperator>(_componentB);
-			std::map<size_t, value_t>& dataMap = _newComponent.get_sparse_data();
+			misc::FlatMap<size_t, value_t>& dataMap = _newComponent.get_sparse_data();
 			INTERNAL_CHECK(dataMap.empty(), "IE");
 			for(const auto& entryA : _componentA.get_unsanitized_sparse_data()) {
 				const size_t r2 = entryA.first%_componentA.dimensions.back();
@@ -1265,9 +1566,10 @@ namespace xerus {
 				const size_t r1 = (entryA.first/_componentA.dimensions.back())/externalDim;				
 				
 				for(const std::tuple<size_t, size_t, value_t>& entryB : groupedEntriesB[n]) {
-					dataMap.emplace((((r1*_componentB.dimensions.front() + std::get<0>(entryB))*externalDim + n)*_componentA.dimensions.back()+r2)*_componentB.dimensions.back()+std::get<1>(entryB), _componentA.factor*entryA.second*std::get<2>(entryB));
+					dataMap.emplace_back_unsorted((((r1*_componentB.dimensions.front() + std::get<0>(entryB))*externalDim + n)*_componentA.dimensions.back()+r2)*_componentB.dimensions.back()+std::get<1>(entryB), _componentA.factor*entryA.second*std::get<2>(entryB));
 				}
 			}
+			dataMap.sort_and_sum_duplicates();
 		}
 	}
 	
@@ -1314,6 +1616,154 @@ namespace xerus {
 	template TTNetwork<true> entrywise_product(const TTNetwork<true> &_A, const TTNetwork<true> &_B);
 	
 	
+	/**
+	 * @brief Builds a TTNetwork of degree @a _degree component by component, truncating every bond directly after its creation (zip-up).
+	 * @details @a _producer(product, carry, c) has to set product(l, n..., rA, rB) to the contraction of the carry(l, lA, lB) of the previous 
+	 * bond with the c-th components of both factors, whose right ranks are rA and rB. The product is split by a truncated SVD, the left factor 
+	 * becomes the c-th component and the remainder is carried on to the next component. Truncation errors of late bonds can only be 
+	 * controlled if the right parts of the factors are orthogonal, so callers should move the cores of both factors to the first component.
+	 * As the intermediate truncations are done with 0.1*@a _eps, the result is finally rounded to @a _maxRanks and @a _eps.
+	 */
+	template<bool isOperator>
+	static TTNetwork<isOperator> zip_up_truncation(const size_t _degree, const std::vector<size_t>& _maxRanks, const double _eps, const std::function<void(Tensor&, const Tensor&, const size_t)>& _producer) {
+		static constexpr const size_t N = isOperator?2:1;
+		const size_t numComponents = _degree/N;
+		
+		TTNetwork<isOperator> result(_degree);
+		const Index i, j, r1, r2;
+		Tensor carry = Tensor::ones({1, 1, 1});
+		Tensor product, U, S, Vt;
+		for (size_t c = 0; c < numComponents; ++c) {
+			_producer(product, carry, c);
+			
+			if (c+1 < numComponents) {
+				(U(i^(N+1), r1), S(r1, r2), Vt(r2, j^2)) = SVD(product(i^(N+1), j^2), _maxRanks[c], 0.1*_eps);
+				result.set_component(c, std::move(U));
+				carry(r1, j^2) = S(r1, r2) * Vt(r2, j^2);
+				carry.use_dense_representation();
+			} else {
+				Tensor::DimensionTuple dimensions(product.dimensions);
+				dimensions.pop_back();
+				product.reinterpret_dimensions(std::move(dimensions));
+				result.set_component(c, std::move(product));
+			}
+		}
+		
+		result.assume_core_position(numComponents-1);
+		result.round(_maxRanks, _eps);
+		return result;
+	}
+	
+	
+	template<bool isOperator>
+	TTNetwork<isOperator> entrywise_product(const TTNetwork<isOperator>& _A, const TTNetwork<isOperator>& _B, const std::vector<size_t>& _maxRanks, const double _eps) {
+		static constexpr const size_t N = isOperator?2:1;
+		REQUIRE(_A.dimensions == _B.dimensions, "Entrywise_product ill-defined for different external dimensions.");
+		const size_t numComponents = _A.degree()/N;
+		REQUIRE(_maxRanks.size()+1 == numComponents || (_maxRanks.empty() && numComponents == 0), "There must be exactly degree/N-1 maxRanks. Here " << _maxRanks.size() << " instead of " << numComponents-1 << " are given.");
+		REQUIRE(!misc::contains(_maxRanks, size_t(0)), "Trying to round a TTTensor to rank 0 is not possible.");
+		
+		if(numComponents == 0) {
+			TTNetwork<isOperator> result(_A);
+			result *= _B[0];
+			return result;
+		}
+		
+		TTNetwork<isOperator> A(_A), B(_B);
+		A.move_core(0);
+		B.move_core(0);
+		
+		std::vector<value_t> sliceA, sliceB, tmp;
+		return zip_up_truncation<isOperator>(_A.degree(), _maxRanks, _eps, [&](Tensor &_product, const Tensor &_carry, const size_t _c) {
+			Tensor componentA(A.get_component(_c));
+			Tensor componentB(B.get_component(_c));
+			componentA.use_dense_representation();
+			componentB.use_dense_representation();
+			const value_t* const dataA = componentA.get_dense_data();
+			const value_t* const dataB = componentB.get_dense_data();
+			const value_t* const dataCarry = _carry.get_unsanitized_dense_data();
+			
+			const size_t leftDim = _carry.dimensions[0];
+			const size_t leftA = componentA.dimensions.front(), rightA = componentA.dimensions.back();
+			const size_t leftB = componentB.dimensions.front(), rightB = componentB.dimensions.back();
+			const size_t externalDim = isOperator ? componentA.dimensions[1]*componentA.dimensions[2] : componentA.dimensions[1];
+			
+			Tensor::DimensionTuple productDimensions(componentA.dimensions);
+			productDimensions.front() = leftDim;
+			productDimensions.push_back(rightB);
+			_product.reset(std::move(productDimensions), Tensor::Representation::Dense, Tensor::Initialisation::None);
+			value_t* const dataProduct = _product.get_unsanitized_dense_data();
+			
+			// product(l, n, rA, rB) = sum_{lA, lB} carry(l, lA, lB) * A(lA, n, rA) * B(lB, n, rB), one external index n at a time
+			sliceA.resize(leftA*rightA);
+			sliceB.resize(leftB*rightB);
+			tmp.resize(leftDim*leftA*rightB);
+			for(size_t n = 0; n < externalDim; ++n) {
+				for(size_t l = 0; l < leftA; ++l) {
+					misc::copy(sliceA.data()+l*rightA, dataA+(l*externalDim+n)*rightA, rightA);
+				}
+				for(size_t l = 0; l < leftB; ++l) {
+					misc::copy(sliceB.data()+l*rightB, dataB+(l*externalDim+n)*rightB, rightB);
+				}
+				
+				blasWrapper::matrix_matrix_product(tmp.data(), leftDim*leftA, rightB, _carry.factor, dataCarry, false, leftB, sliceB.data(), false);
+				for(size_t l = 0; l < leftDim; ++l) {
+					blasWrapper::matrix_matrix_product(dataProduct+(l*externalDim+n)*rightA*rightB, rightA, rightB, 1.0, sliceA.data(), true, leftA, tmp.data()+l*leftA*rightB, false);
+				}
+			}
+		});
+	}
+	
+	
+	//Explicit instantiation for both types
+	template TTNetwork<false> entrywise_product(const TTNetwork<false> &_A, const TTNetwork<false> &_B, const std::vector<size_t>& _maxRanks, const double _eps);
+	template TTNetwork<true> entrywise_product(const TTNetwork<true> &_A, const TTNetwork<true> &_B, const std::vector<size_t>& _maxRanks, const double _eps);
+	
+	
+	template<bool isOperator>
+	TTNetwork<isOperator> apply_and_round(const TTOperator& _A, const TTNetwork<isOperator>& _x, const std::vector<size_t>& _maxRanks, const double _eps) {
+		static constexpr const size_t N = isOperator?2:1;
+		_A.require_correct_format();
+		_x.require_correct_format();
+		const size_t numComponents = _A.degree()/2;
+		REQUIRE(_x.degree()/N == numComponents, "Operator and tensor must have the same number of components. Here " << numComponents << " vs. " << _x.degree()/N);
+		REQUIRE(std::equal(_A.dimensions.begin()+long(numComponents), _A.dimensions.end(), _x.dimensions.begin()), "The column dimensions of the operator " << _A.dimensions << " do not match the dimensions " << _x.dimensions);
+		REQUIRE(_maxRanks.size()+1 == numComponents || (_maxRanks.empty() && numComponents == 0), "There must be exactly degree/N-1 maxRanks. Here " << _maxRanks.size() << " instead of " << numComponents-1 << " are given.");
+		REQUIRE(!misc::contains(_maxRanks, size_t(0)), "Trying to round a TTTensor to rank 0 is not possible.");
+		
+		if (numComponents == 0) {
+			TTNetwork<isOperator> result(_x);
+			result *= _A[0];
+			return result;
+		}
+		
+		TTNetwork<isOperator> x(_x);
+		x.move_core(0);
+		
+		const Index left, leftA, leftX, n, m, k, rightA, rightX;
+		return zip_up_truncation<isOperator>(N*numComponents, _maxRanks, _eps, [&](Tensor &_product, const Tensor &_carry, const size_t _c) {
+			if (isOperator) {
+				_product(left, n, k, rightA, rightX) = _carry(left, leftA, leftX) * _A.get_component(_c)(leftA, n, m, rightA) * x.get_component(_c)(leftX, m, k, rightX);
+			} else {
+				_product(left, n, rightA, rightX) = _carry(left, leftA, leftX) * _A.get_component(_c)(leftA, n, m, rightA) * x.get_component(_c)(leftX, m, rightX);
+			}
+		});
+	}
+	
+	
+	template<bool isOperator>
+	TTNetwork<isOperator> apply_and_round(const TTOperator& _A, const TTNetwork<isOperator>& _x, const size_t _maxRank, const double _eps) {
+		return apply_and_round(_A, _x, std::vector<size_t>(_x.ranks().size(), _maxRank), _eps);
+	}
+	
+	
+	//Explicit instantiation for both types
+	template TTNetwork<false> apply_and_round(const TTOperator& _A, const TTNetwork<false>& _x, const std::vector<size_t>& _maxRanks, const double _eps);
+	template TTNetwork<true> apply_and_round(const TTOperator& _A, const TTNetwork<true>& _x, const std::vector<size_t>& _maxRanks, const double _eps);
+	template TTNetwork<false> apply_and_round(const TTOperator& _A, const TTNetwork<false>& _x, const size_t _maxRank, const double _eps);
+	template TTNetwork<true> apply_and_round(const TTOperator& _A, const TTNetwork<true>& _x, const size_t _maxRank, const double _eps);
+	
+	
 	
 	template<bool isOperator>
 	TTNetwork<isOperator> dyadic_product(const TTNetwork<isOperator> &_lhs, const TTNetwork<isOperator> &_rhs) {
@@ -0,0 +1,99 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2017 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+/**
+* @file
+* @brief Implementation of the TTSumAccumulator class.
+*/
+
+#include <xerus/ttSumAccumulator.h>
+#include <xerus/misc/check.h>
+#include <xerus/misc/internal.h>
+
+namespace xerus {
+	TTSumAccumulator::TTSumAccumulator(std::vector<size_t> _dimensions, std::vector<size_t> _maxRanks, const double _eps, const RoundingMode _mode) :
+		dimensions(std::move(_dimensions)), maxRanks(std::move(_maxRanks)), eps(_eps), roundingMode(_mode), numAdded(0) {
+		REQUIRE(maxRanks.size()+1 == dimensions.size() || (maxRanks.empty() && dimensions.empty()), "There must be exactly degree-1 maxRanks. Here " << maxRanks.size() << " instead of " << dimensions.size()-1 << " are given.");
+		REQUIRE(!misc::contains(maxRanks, size_t(0)), "Rank zero is not possible.");
+		REQUIRE(eps < 1, "_eps must be smaller than one. " << eps << " was given.");
+	}
+	
+	
+	TTSumAccumulator::TTSumAccumulator(std::vector<size_t> _dimensions, const size_t _maxRank, const double _eps, const RoundingMode _mode) :
+		TTSumAccumulator(_dimensions, std::vector<size_t>(_dimensions.empty() ? 0 : _dimensions.size()-1, _maxRank), _eps, _mode) {}
+	
+	
+	void TTSumAccumulator::add(const TTTensor& _x, const value_t _weight) {
+		REQUIRE(_x.dimensions == dimensions, "The dimensions of the added tensor " << _x.dimensions << " do not match those of the accumulator " << dimensions);
+		
+		TTTensor carry(_x);
+		carry *= _weight;
+		const std::vector<size_t> ranks = carry.ranks();
+		for (size_t i = 0; i < ranks.size(); ++i) {
+			if (ranks[i] > maxRanks[i]) {
+				carry.round(maxRanks, eps, roundingMode);
+				break;
+			}
+		}
+		
+		size_t level = 0;
+		for (; (numAdded >> level) & 1; ++level) {
+			carry += partialSums[level];
+			carry.round(maxRanks, eps, roundingMode);
+			partialSums[level] = TTTensor();
+		}
+		
+		if (level < partialSums.size()) {
+			partialSums[level] = std::move(carry);
+		} else {
+			partialSums.emplace_back(std::move(carry));
+		}
+		numAdded++;
+	}
+	
+	
+	TTTensor TTSumAccumulator::sum() const {
+		TTTensor result(dimensions);
+		bool empty = true;
+		for (size_t level = 0; level < partialSums.size(); ++level) {
+			if ((numAdded >> level) & 1) {
+				if (empty) {
+					result = partialSums[level];
+					empty = false;
+				} else {
+					result += partialSums[level];
+					result.round(maxRanks, eps, roundingMode);
+				}
+			}
+		}
+		return result;
+	}
+	
+	
+	size_t TTSumAccumulator::count() const {
+		return numAdded;
+	}
+	
+	
+	void TTSumAccumulator::clear() {
+		partialSums.clear();
+		numAdded = 0;
+	}
+}